@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+
+#include "bridge_stats.h"
+
+#define MODULE file_stats
+#include "fs_event.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_MSC_LOG_LEVEL);
+
+#if CONFIG_FS_FATFS_LFN
+#define FILE_NAME         "Stats.txt"
+#else
+#define FILE_NAME         "STATS.TXT"
+#endif
+
+#define FILE_CONTENTS_LEN_MAX 512
+
+static char file_contents[FILE_CONTENTS_LEN_MAX];
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_fs_event(aeh)) {
+		const struct fs_event *event =
+			cast_fs_event(aeh);
+		char fname[64];
+		size_t len;
+		int err;
+
+		/* The file is refreshed every time the disk is mounted. */
+		/* The write helper appends, so remove the old contents first. */
+		err = snprintf(fname, sizeof(fname), "%s/%s", event->mnt_point, FILE_NAME);
+		if (err <= 0 || err >= sizeof(fname)) {
+			return false;
+		}
+
+		(void)fs_unlink(fname);
+
+		len = bridge_stats_print(file_contents, sizeof(file_contents));
+
+		err = fs_event_helper_file_write(
+			event->mnt_point,
+			FILE_NAME,
+			file_contents,
+			len);
+		if (err) {
+			LOG_WRN("fs_event_helper_file_write: %d", err);
+		}
+
+		return false;
+	}
+
+	/* If event is unhandled, unsubscribe. */
+	__ASSERT_NO_MSG(false);
+
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, fs_event);
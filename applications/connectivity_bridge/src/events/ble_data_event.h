@@ -29,6 +29,7 @@ struct ble_data_event {
 
 	uint8_t *buf;
 	size_t len;
+	uint32_t timestamp;
 };
 
 APP_EVENT_TYPE_DECLARE(ble_data_event);
@@ -30,6 +30,7 @@ struct uart_data_event {
 	uint8_t dev_idx;
 	uint8_t *buf;
 	size_t len;
+	uint32_t timestamp;
 };
 
 APP_EVENT_TYPE_DECLARE(uart_data_event);
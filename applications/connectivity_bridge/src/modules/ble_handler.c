@@ -6,7 +6,6 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
-#include <zephyr/sys/ring_buffer.h>
 
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/uuid.h>
@@ -14,6 +13,9 @@
 #include <zephyr/bluetooth/hci.h>
 #include <bluetooth/services/nus.h>
 
+#include "bridge_buf.h"
+#include "bridge_stats.h"
+
 #define MODULE ble_handler
 #include "module_state_event.h"
 #include "peer_conn_event.h"
@@ -28,17 +30,33 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_BRIDGE_BLE_LOG_LEVEL);
 #define BLE_RX_BUF_COUNT 4
 #define BLE_SLAB_ALIGNMENT 4
 
-#define BLE_TX_BUF_SIZE (CONFIG_BRIDGE_BUF_SIZE * 2)
+#define BLE_TX_QUEUE_SIZE CONFIG_BRIDGE_BLE_TX_QUEUE_SIZE
+#define BLE_TX_QUEUE_ALIGNMENT 4
+#define BLE_TX_BUF_MAX CONFIG_BRIDGE_BLE_TX_BUF_MAX
+
+/* Both UART instances share the buffer blocks, */
+/* and each needs two of them for continuous reception. */
+BUILD_ASSERT(BLE_TX_BUF_MAX <= (2 * CONFIG_BRIDGE_UART_BUF_COUNT - 4),
+	     "BLE may hold UART buffer blocks needed for reception");
 
 #define BLE_AD_IDX_FLAGS 0
 #define BLE_AD_IDX_NAME 1
 
 #define ATT_MIN_PAYLOAD 20 /* Minimum L2CAP MTU minus ATT header */
 
+/* UART RX data waiting for transmission. The chunks hold a reference */
+/* to the UART RX buffer, so the data is sent without copying. */
+struct ble_tx_chunk {
+	const uint8_t *buf;
+	size_t len;
+	uint32_t timestamp;
+};
+
 static void bt_send_work_handler(struct k_work *work);
 
 K_MEM_SLAB_DEFINE(ble_rx_slab, BLE_RX_BLOCK_SIZE, BLE_RX_BUF_COUNT, BLE_SLAB_ALIGNMENT);
-RING_BUF_DECLARE(ble_tx_ring_buf, BLE_TX_BUF_SIZE);
+K_MSGQ_DEFINE(ble_tx_queue, sizeof(struct ble_tx_chunk), BLE_TX_QUEUE_SIZE,
+	      BLE_TX_QUEUE_ALIGNMENT);
 
 static K_SEM_DEFINE(ble_tx_sem, 0, 1);
 
@@ -49,6 +67,13 @@ static struct bt_gatt_exchange_params exchange_params;
 static uint32_t nus_max_send_len;
 static atomic_t ready;
 static atomic_t active;
+static atomic_t tx_flush;
+/* Number of bytes of the first queued chunk that are already sent */
+static size_t tx_offset;
+/* UART buffer blocks held by the queued chunks. Consecutive chunks */
+/* usually come from the same block. Only accessed from the system workqueue. */
+static size_t tx_bufs_held;
+static const uint8_t *tx_last_buf;
 
 static char bt_device_name[CONFIG_BT_DEVICE_NAME_MAX + 1] = CONFIG_BT_DEVICE_NAME;
 
@@ -89,7 +114,8 @@ static void connected(struct bt_conn *conn, uint8_t err)
 		LOG_WRN("bt_gatt_exchange_mtu: %d", err);
 	}
 
-	ring_buf_reset(&ble_tx_ring_buf);
+	atomic_set(&tx_flush, true);
+	k_work_submit(&bt_send_work);
 
 	struct peer_conn_event *event = new_peer_conn_event();
 
@@ -112,6 +138,9 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 		current_conn = NULL;
 	}
 
+	atomic_set(&tx_flush, true);
+	k_work_submit(&bt_send_work);
+
 	struct peer_conn_event *event = new_peer_conn_event();
 
 	event->peer_id = PEER_ID_BLE;
@@ -126,34 +155,60 @@ static struct bt_conn_cb conn_callbacks = {
 	.disconnected = disconnected,
 };
 
+static void tx_chunk_release(const struct ble_tx_chunk *chunk)
+{
+	struct ble_tx_chunk next;
+
+	if ((k_msgq_peek(&ble_tx_queue, &next) != 0) ||
+	    !bridge_buf_same(chunk->buf, next.buf)) {
+		__ASSERT_NO_MSG(tx_bufs_held > 0);
+		tx_bufs_held--;
+	}
+
+	bridge_buf_unref(chunk->buf);
+	tx_offset = 0;
+}
+
+static void tx_queue_purge(void)
+{
+	struct ble_tx_chunk chunk;
+
+	while (k_msgq_get(&ble_tx_queue, &chunk, K_NO_WAIT) == 0) {
+		bridge_stats_dropped(BRIDGE_STATS_UART_0_TO_BLE, chunk.len - tx_offset);
+		tx_chunk_release(&chunk);
+	}
+}
+
 static void bt_send_work_handler(struct k_work *work)
 {
+	struct ble_tx_chunk chunk;
 	uint16_t len;
-	uint8_t *buf;
 	int err;
-	bool notif_disabled = false;
 
-	do {
-		len = ring_buf_get_claim(&ble_tx_ring_buf, &buf, nus_max_send_len);
+	if (atomic_set(&tx_flush, false)) {
+		tx_queue_purge();
+	}
+
+	while (k_msgq_peek(&ble_tx_queue, &chunk) == 0) {
+		len = MIN(chunk.len - tx_offset, nus_max_send_len);
 
-		err = bt_nus_send(current_conn, buf, len);
+		err = bt_nus_send(current_conn, &chunk.buf[tx_offset], len);
 		if (err == -EINVAL) {
-			notif_disabled = true;
-			len = 0;
+			/* Peer has not enabled notifications: don't accumulate data */
+			tx_queue_purge();
+			break;
 		} else if (err) {
-			len = 0;
-		}
-
-		err = ring_buf_get_finish(&ble_tx_ring_buf, len);
-		if (err) {
-			LOG_ERR("ring_buf_get_finish: %d", err);
+			/* Sending continues from the sent callback */
 			break;
 		}
-	} while (len != 0 && !ring_buf_is_empty(&ble_tx_ring_buf));
 
-	if (notif_disabled) {
-		/* Peer has not enabled notifications: don't accumulate data */
-		ring_buf_reset(&ble_tx_ring_buf);
+		tx_offset += len;
+		if (tx_offset == chunk.len) {
+			bridge_stats_sent(BRIDGE_STATS_UART_0_TO_BLE, chunk.len, chunk.timestamp);
+
+			(void)k_msgq_get(&ble_tx_queue, &chunk, K_NO_WAIT);
+			tx_chunk_release(&chunk);
+		}
 	}
 }
 
@@ -184,13 +239,14 @@ static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data,
 
 		event->buf = buf;
 		event->len = copy_len;
+		event->timestamp = bridge_stats_timestamp();
 		APP_EVENT_SUBMIT(event);
 	} while (remainder);
 }
 
 static void bt_sent_cb(struct bt_conn *conn)
 {
-	if (ring_buf_is_empty(&ble_tx_ring_buf)) {
+	if (k_msgq_num_used_get(&ble_tx_queue) == 0) {
 		return;
 	}
 
@@ -297,24 +353,39 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			return false;
 		}
 
-		uint32_t written = ring_buf_put(
-			&ble_tx_ring_buf,
-			event->buf,
-			event->len);
-		if (written != event->len) {
+		struct ble_tx_chunk chunk = {
+			.buf = event->buf,
+			.len = event->len,
+			.timestamp = event->timestamp,
+		};
+		bool new_buf = (k_msgq_num_used_get(&ble_tx_queue) == 0) ||
+			       !bridge_buf_same(tx_last_buf, event->buf);
+
+		/* Holding another block could starve UART reception */
+		if (new_buf && (tx_bufs_held >= BLE_TX_BUF_MAX)) {
+			bridge_stats_dropped(BRIDGE_STATS_UART_0_TO_BLE, event->len);
 			LOG_WRN("UART_%d -> BLE overflow", event->dev_idx);
+			return false;
 		}
 
-		uint32_t buf_utilization =
-			(ring_buf_capacity_get(&ble_tx_ring_buf) -
-			ring_buf_space_get(&ble_tx_ring_buf));
+		/* Keep the UART RX buffer until the data is sent */
+		bridge_buf_ref(event->buf);
 
-		/* Simple check to start transmission. */
-		/* If bt_send_work is already running, this has no effect */
-		if (buf_utilization == written) {
-			k_work_submit(&bt_send_work);
+		if (k_msgq_put(&ble_tx_queue, &chunk, K_NO_WAIT)) {
+			bridge_buf_unref(event->buf);
+			bridge_stats_dropped(BRIDGE_STATS_UART_0_TO_BLE, event->len);
+			LOG_WRN("UART_%d -> BLE overflow", event->dev_idx);
+			return false;
 		}
 
+		if (new_buf) {
+			tx_bufs_held++;
+		}
+		tx_last_buf = event->buf;
+
+		/* If bt_send_work is already running, this has no effect */
+		k_work_submit(&bt_send_work);
+
 		return false;
 	}
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+
+#include "bridge_buf.h"
+
+/* Both UART instances receive into the same pool */
+#define BUF_UART_DEVICE_COUNT 2
+#define BUF_BLOCK_SIZE sizeof(struct bridge_buf)
+#define BUF_BLOCK_COUNT (BUF_UART_DEVICE_COUNT * CONFIG_BRIDGE_UART_BUF_COUNT)
+#define BUF_ALIGNMENT 4
+
+struct bridge_buf {
+	atomic_t ref_counter;
+	uint8_t data[BRIDGE_BUF_DATA_SIZE];
+};
+
+BUILD_ASSERT((sizeof(struct bridge_buf) % BUF_ALIGNMENT) == 0);
+
+K_MEM_SLAB_DEFINE(bridge_buf_slab, BUF_BLOCK_SIZE, BUF_BLOCK_COUNT, BUF_ALIGNMENT);
+
+static inline struct bridge_buf *block_start_get(const uint8_t *data)
+{
+	size_t block_num;
+
+	__ASSERT_NO_MSG((data >= (uint8_t *)bridge_buf_slab.buffer) &&
+			(data < (uint8_t *)bridge_buf_slab.buffer +
+				BUF_BLOCK_SIZE * BUF_BLOCK_COUNT));
+
+	/* blocks are fixed size units from a continuous memory slab: */
+	/* round down to the closest unit size to find beginning of block. */
+
+	block_num =
+		(((size_t)data - (size_t)bridge_buf_slab.buffer) / BUF_BLOCK_SIZE);
+
+	return (struct bridge_buf *) &bridge_buf_slab.buffer[block_num * BUF_BLOCK_SIZE];
+}
+
+uint8_t *bridge_buf_alloc(void)
+{
+	struct bridge_buf *buf;
+	int err;
+
+	err = k_mem_slab_alloc(&bridge_buf_slab, (void **) &buf, K_NO_WAIT);
+	if (err) {
+		return NULL;
+	}
+
+	atomic_set(&buf->ref_counter, 1);
+
+	return buf->data;
+}
+
+void bridge_buf_ref(const uint8_t *data)
+{
+	__ASSERT_NO_MSG(data);
+
+	atomic_inc(&(block_start_get(data)->ref_counter));
+}
+
+void bridge_buf_unref(const uint8_t *data)
+{
+	__ASSERT_NO_MSG(data);
+
+	struct bridge_buf *buf = block_start_get(data);
+	atomic_t ref_counter = atomic_dec(&buf->ref_counter);
+
+	/* ref_counter is the buf->ref_counter value prior to decrement */
+	if (ref_counter == 1) {
+		k_mem_slab_free(&bridge_buf_slab, (void **)&buf);
+	}
+}
+
+bool bridge_buf_same(const uint8_t *a, const uint8_t *b)
+{
+	__ASSERT_NO_MSG(a && b);
+
+	return block_start_get(a) == block_start_get(b);
+}
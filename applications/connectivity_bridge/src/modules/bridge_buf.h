@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _BRIDGE_BUF_H_
+#define _BRIDGE_BUF_H_
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Reference counted buffers shared between the bridge modules.
+ * UART RX data is received into these buffers and passed as is to the
+ * transmitting modules. Every module that keeps the data after handling the
+ * UART data event takes its own reference.
+ */
+
+#define BRIDGE_BUF_DATA_SIZE CONFIG_BRIDGE_BUF_SIZE
+
+/* Allocate a buffer with a single reference.
+ * Returns the start of the data area or NULL if the pool is empty.
+ */
+uint8_t *bridge_buf_alloc(void);
+
+/* Take a reference. The pointer may point anywhere within the data area. */
+void bridge_buf_ref(const uint8_t *data);
+
+/* Release a reference. The buffer is freed when the last one is released. */
+void bridge_buf_unref(const uint8_t *data);
+
+/* Check if two pointers point within the same buffer. */
+bool bridge_buf_same(const uint8_t *a, const uint8_t *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BRIDGE_BUF_H_ */
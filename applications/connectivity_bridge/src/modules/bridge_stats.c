@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "bridge_stats.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(bridge_stats, CONFIG_BRIDGE_STATS_LOG_LEVEL);
+
+#define STATS_PRINT_BUF_SIZE 512
+
+struct path_stats {
+	uint64_t bytes;
+	uint64_t dropped;
+	uint64_t latency_sum_us;
+	uint32_t latency_max_us;
+	uint32_t latency_cnt;
+
+	/* Byte count at the previous print, used for the throughput */
+	uint64_t bytes_prev;
+};
+
+static const char * const path_names[] = {
+#define X(_path, _name) [BRIDGE_STATS_##_path] = _name,
+	BRIDGE_STATS_PATH_LIST
+#undef X
+};
+
+static struct path_stats stats[BRIDGE_STATS_PATH_COUNT];
+static int64_t print_prev_time;
+static struct k_spinlock lock;
+
+void bridge_stats_sent(enum bridge_stats_path path, size_t len, uint32_t rx_timestamp)
+{
+	uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - rx_timestamp);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct path_stats *s = &stats[path];
+
+	s->bytes += len;
+	s->latency_sum_us += latency_us;
+	s->latency_max_us = MAX(s->latency_max_us, latency_us);
+	s->latency_cnt++;
+
+	k_spin_unlock(&lock, key);
+}
+
+void bridge_stats_dropped(enum bridge_stats_path path, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stats[path].dropped += len;
+
+	k_spin_unlock(&lock, key);
+}
+
+size_t bridge_stats_print(char *buf, size_t buf_size)
+{
+	struct path_stats snapshot[BRIDGE_STATS_PATH_COUNT];
+	int64_t now = k_uptime_get();
+	int64_t elapsed_ms;
+	size_t pos = 0;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	memcpy(snapshot, stats, sizeof(snapshot));
+	for (size_t i = 0; i < ARRAY_SIZE(stats); i++) {
+		stats[i].bytes_prev = stats[i].bytes;
+	}
+
+	elapsed_ms = now - print_prev_time;
+	print_prev_time = now;
+
+	k_spin_unlock(&lock, key);
+
+	for (size_t i = 0; (i < ARRAY_SIZE(snapshot)) && (pos < buf_size); i++) {
+		const struct path_stats *s = &snapshot[i];
+		uint32_t throughput = 0;
+		uint32_t latency_avg_us = 0;
+		int len;
+
+		if (elapsed_ms > 0) {
+			throughput = ((s->bytes - s->bytes_prev) * MSEC_PER_SEC) /
+				     (uint64_t)elapsed_ms;
+		}
+
+		if (s->latency_cnt > 0) {
+			latency_avg_us = s->latency_sum_us / s->latency_cnt;
+		}
+
+		len = snprintf(&buf[pos], buf_size - pos,
+			       "%s: sent %llu B, %u B/s, dropped %llu B, latency avg %u us max %u us\r\n",
+			       path_names[i],
+			       (unsigned long long)s->bytes,
+			       throughput,
+			       (unsigned long long)s->dropped,
+			       latency_avg_us,
+			       s->latency_max_us);
+		if (len < 0) {
+			break;
+		}
+
+		pos += len;
+	}
+
+	return MIN(pos, buf_size);
+}
+
+#if CONFIG_BRIDGE_STATS_LOG_INTERVAL > 0
+static void stats_log_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(stats_log_work, stats_log_work_handler);
+
+static void stats_log_work_handler(struct k_work *work)
+{
+	static char print_buf[STATS_PRINT_BUF_SIZE];
+	char *line = print_buf;
+	char *line_end;
+
+	bridge_stats_print(print_buf, sizeof(print_buf));
+
+	while ((line_end = strstr(line, "\r\n")) != NULL) {
+		*line_end = '\0';
+		LOG_INF("%s", line);
+		line = line_end + 2;
+	}
+
+	k_work_schedule(&stats_log_work, K_SECONDS(CONFIG_BRIDGE_STATS_LOG_INTERVAL));
+}
+
+static int stats_log_init(void)
+{
+	k_work_schedule(&stats_log_work, K_SECONDS(CONFIG_BRIDGE_STATS_LOG_INTERVAL));
+
+	return 0;
+}
+
+SYS_INIT(stats_log_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif /* CONFIG_BRIDGE_STATS_LOG_INTERVAL > 0 */
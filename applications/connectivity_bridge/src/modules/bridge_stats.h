@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _BRIDGE_STATS_H_
+#define _BRIDGE_STATS_H_
+
+#include <stddef.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Data paths of the bridge.
+ * Format: (_path, _name)
+ */
+#define BRIDGE_STATS_PATH_LIST \
+	X(UART_0_TO_CDC_0, "UART_0->CDC_0") \
+	X(UART_1_TO_CDC_1, "UART_1->CDC_1") \
+	X(CDC_0_TO_UART_0, "CDC_0->UART_0") \
+	X(CDC_1_TO_UART_1, "CDC_1->UART_1") \
+	X(UART_0_TO_BLE, "UART_0->BLE") \
+	X(BLE_TO_UART_0, "BLE->UART_0")
+
+enum bridge_stats_path {
+#define X(_path, _name) BRIDGE_STATS_##_path,
+	BRIDGE_STATS_PATH_LIST
+#undef X
+
+	BRIDGE_STATS_PATH_COUNT
+};
+
+/* Paths of the UART and CDC instances with the same index */
+#define BRIDGE_STATS_UART_TO_CDC(_idx) (BRIDGE_STATS_UART_0_TO_CDC_0 + (_idx))
+#define BRIDGE_STATS_CDC_TO_UART(_idx) (BRIDGE_STATS_CDC_0_TO_UART_0 + (_idx))
+
+/* Receive time of data, stored in the data events */
+static inline uint32_t bridge_stats_timestamp(void)
+{
+	return k_cycle_get_32();
+}
+
+#if CONFIG_BRIDGE_STATS
+
+/* Record data passed to the transmitting interface */
+void bridge_stats_sent(enum bridge_stats_path path, size_t len, uint32_t rx_timestamp);
+
+/* Record data dropped because the transmitting interface could not keep up */
+void bridge_stats_dropped(enum bridge_stats_path path, size_t len);
+
+/* Print the counters of all paths as text.
+ * Returns the length of the text.
+ */
+size_t bridge_stats_print(char *buf, size_t buf_size);
+
+#else
+
+static inline void bridge_stats_sent(enum bridge_stats_path path, size_t len,
+				     uint32_t rx_timestamp)
+{
+}
+
+static inline void bridge_stats_dropped(enum bridge_stats_path path, size_t len)
+{
+}
+
+#endif /* CONFIG_BRIDGE_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BRIDGE_STATS_H_ */
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/reboot.h>
+
+#include <app_event_manager.h>
+#include "uart_data_event.h"
+#include "cdc_data_event.h"
+#include "ble_data_event.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(event_alloc, CONFIG_BRIDGE_EVENT_ALLOC_LOG_LEVEL);
+
+/* A data event is submitted for every received chunk. */
+/* Serve them from a slab to avoid a heap allocation per chunk. */
+/* Larger events and the overflow are allocated from the heap. */
+#define EVENT_SLAB_ALIGNMENT 4
+#define EVENT_SLAB_BLOCK_SIZE \
+	ROUND_UP(MAX(sizeof(struct uart_data_event), \
+		     MAX(sizeof(struct cdc_data_event), sizeof(struct ble_data_event))), \
+		 EVENT_SLAB_ALIGNMENT)
+#define EVENT_SLAB_BLOCK_COUNT CONFIG_BRIDGE_EVENT_SLAB_BLOCK_COUNT
+
+K_MEM_SLAB_DEFINE(event_slab, EVENT_SLAB_BLOCK_SIZE, EVENT_SLAB_BLOCK_COUNT,
+		  EVENT_SLAB_ALIGNMENT);
+
+static bool is_slab_block(const void *addr)
+{
+	return ((const char *)addr >= event_slab.buffer) &&
+	       ((const char *)addr < event_slab.buffer +
+				     EVENT_SLAB_BLOCK_SIZE * EVENT_SLAB_BLOCK_COUNT);
+}
+
+void *app_event_manager_alloc(size_t size)
+{
+	void *event;
+
+	if ((size <= EVENT_SLAB_BLOCK_SIZE) &&
+	    !k_mem_slab_alloc(&event_slab, &event, K_NO_WAIT)) {
+		return event;
+	}
+
+	event = k_malloc(size);
+	if (unlikely(!event)) {
+		LOG_ERR("Event allocation failed");
+		__ASSERT_NO_MSG(false);
+		sys_reboot(SYS_REBOOT_WARM);
+	}
+
+	return event;
+}
+
+void app_event_manager_free(void *addr)
+{
+	if (is_slab_block(addr)) {
+		k_mem_slab_free(&event_slab, &addr);
+	} else {
+		k_free(addr);
+	}
+}
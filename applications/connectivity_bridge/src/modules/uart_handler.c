@@ -9,6 +9,9 @@
 #include <zephyr/drivers/uart.h>
 #include <zephyr/pm/device.h>
 
+#include "bridge_buf.h"
+#include "bridge_stats.h"
+
 #define MODULE uart_handler
 #include "module_state_event.h"
 #include "peer_conn_event.h"
@@ -28,10 +31,13 @@ static const struct device *devices[] = {
 
 #define UART_BUF_SIZE CONFIG_BRIDGE_BUF_SIZE
 
-#define UART_SLAB_BLOCK_SIZE sizeof(struct uart_rx_buf)
-#define UART_SLAB_BLOCK_COUNT (UART_DEVICE_COUNT * CONFIG_BRIDGE_UART_BUF_COUNT)
-#define UART_SLAB_ALIGNMENT 4
 #define UART_RX_TIMEOUT_USEC 1000
+#define UART_RX_RETRY_DELAY K_MSEC(10)
+
+/* Pieces of data waiting in a TX ringbuffer, used to record */
+/* the statistics once the data is transmitted. */
+#define UART_TX_SEG_COUNT 16
+#define UART_TX_SEG_ALIGNMENT 4
 
 #if defined(CONFIG_PM_DEVICE)
 #define UART_SET_PM_STATE true
@@ -39,130 +45,85 @@ static const struct device *devices[] = {
 #define UART_SET_PM_STATE false
 #endif
 
-struct uart_rx_buf {
-	atomic_t ref_counter;
-	size_t len;
-	uint8_t buf[UART_BUF_SIZE];
-};
-
 struct uart_tx_buf {
 	struct ring_buf rb;
 	uint8_t buf[UART_BUF_SIZE];
 };
 
-BUILD_ASSERT((sizeof(struct uart_rx_buf) % UART_SLAB_ALIGNMENT) == 0);
+struct uart_tx_seg {
+	enum bridge_stats_path path;
+	uint32_t len;
+	uint32_t timestamp;
+};
 
-/* Blocks from the same slab is used for RX for all UART instances */
-/* TX has inidividual ringbuffers per UART instance */
+struct uart_tx_segs {
+	struct k_msgq msgq;
+	char msgq_buf[UART_TX_SEG_COUNT * sizeof(struct uart_tx_seg)] __aligned(UART_TX_SEG_ALIGNMENT);
+	/* Number of bytes of the first segment that are already transmitted */
+	uint32_t offset;
+};
 
-K_MEM_SLAB_DEFINE(uart_rx_slab, UART_SLAB_BLOCK_SIZE, UART_SLAB_BLOCK_COUNT, UART_SLAB_ALIGNMENT);
+/* RX buffers are shared by all UART instances and passed to the */
+/* subscribers without copying. TX has individual ringbuffers per UART instance */
 
 static struct uart_tx_buf uart_tx_ringbufs[UART_DEVICE_COUNT];
+static struct uart_tx_segs uart_tx_segs[UART_DEVICE_COUNT];
 static uint32_t uart_default_baudrate[UART_DEVICE_COUNT];
 /* UART RX only enabled when there is one or more subscribers (power saving) */
 static int subscriber_count[UART_DEVICE_COUNT];
-static bool enable_rx_retry[UART_DEVICE_COUNT];
 static atomic_t uart_tx_started[UART_DEVICE_COUNT];
+/* Enabling RX is retried until the buffers held by the subscribers are freed */
+static struct k_work_delayable rx_retry_work[UART_DEVICE_COUNT];
 
-static void enable_uart_rx(uint8_t dev_idx);
+static int enable_uart_rx(uint8_t dev_idx);
 static void disable_uart_rx(uint8_t dev_idx);
 static void set_uart_power_state(uint8_t dev_idx, bool active);
 static int uart_tx_start(uint8_t dev_idx);
 static void uart_tx_finish(uint8_t dev_idx, size_t len);
 
-static inline struct uart_rx_buf *block_start_get(uint8_t *buf)
-{
-	size_t block_num;
-
-	/* blocks are fixed size units from a continuous memory slab: */
-	/* round down to the closest unit size to find beginning of block. */
-
-	block_num =
-		(((size_t)buf - (size_t)uart_rx_slab.buffer) / UART_SLAB_BLOCK_SIZE);
-
-	return (struct uart_rx_buf *) &uart_rx_slab.buffer[block_num * UART_SLAB_BLOCK_SIZE];
-}
-
-static struct uart_rx_buf *uart_rx_buf_alloc(void)
-{
-	struct uart_rx_buf *buf;
-	int err;
-
-	/* Async UART driver returns pointers to received data as */
-	/* offsets from beginning of RX buffer block. */
-	/* This code uses a reference counter to keep track of the number of */
-	/* references within a single RX buffer block */
-
-	err = k_mem_slab_alloc(&uart_rx_slab, (void **) &buf, K_NO_WAIT);
-	if (err) {
-		return NULL;
-	}
-
-	atomic_set(&buf->ref_counter, 1);
-
-	return buf;
-}
-
-static void uart_rx_buf_ref(void *buf)
-{
-	__ASSERT_NO_MSG(buf);
-
-	atomic_inc(&(block_start_get(buf)->ref_counter));
-}
-
-static void uart_rx_buf_unref(void *buf)
-{
-	__ASSERT_NO_MSG(buf);
-
-	struct uart_rx_buf *uart_buf = block_start_get(buf);
-	atomic_t ref_counter = atomic_dec(&uart_buf->ref_counter);
-
-	/* ref_counter is the uart_buf->ref_counter value prior to decrement */
-	if (ref_counter == 1) {
-		k_mem_slab_free(&uart_rx_slab, (void **)&uart_buf);
-	}
-}
-
 static void uart_callback(const struct device *dev, struct uart_event *evt,
 			  void *user_data)
 {
 	int dev_idx = (int) user_data;
 	struct uart_data_event *event;
-	struct uart_rx_buf *buf;
+	uint8_t *buf;
 	int err;
 
 	switch (evt->type) {
 	case UART_RX_RDY:
-		uart_rx_buf_ref(evt->data.rx.buf);
+		bridge_buf_ref(evt->data.rx.buf);
 
 		event = new_uart_data_event();
 		event->dev_idx = dev_idx;
 		event->buf = &evt->data.rx.buf[evt->data.rx.offset];
 		event->len = evt->data.rx.len;
+		event->timestamp = bridge_stats_timestamp();
 		APP_EVENT_SUBMIT(event);
 		break;
 	case UART_RX_BUF_RELEASED:
 		if (evt->data.rx_buf.buf) {
-			uart_rx_buf_unref(evt->data.rx_buf.buf);
+			bridge_buf_unref(evt->data.rx_buf.buf);
 		}
 		break;
 	case UART_RX_BUF_REQUEST:
-		buf = uart_rx_buf_alloc();
+		buf = bridge_buf_alloc();
 		if (buf == NULL) {
+			/* RX is disabled when the current buffer is full */
+			/* and enabled again from UART_RX_DISABLED. */
 			LOG_WRN("UART_%d RX overflow", dev_idx);
 			break;
 		}
 
-		err = uart_rx_buf_rsp(dev, buf->buf, sizeof(buf->buf));
+		err = uart_rx_buf_rsp(dev, buf, BRIDGE_BUF_DATA_SIZE);
 		if (err) {
 			LOG_ERR("uart_rx_buf_rsp: %d", err);
-			uart_rx_buf_unref(buf);
+			bridge_buf_unref(buf);
 		}
 		break;
 	case UART_RX_DISABLED:
-		if (enable_rx_retry[dev_idx]) {
-			enable_uart_rx(dev_idx);
-			enable_rx_retry[dev_idx] = false;
+		if (subscriber_count[dev_idx] > 0) {
+			/* Stopped by an error or a buffer overflow */
+			(void)enable_uart_rx(dev_idx);
 		} else if (UART_SET_PM_STATE) {
 			set_uart_power_state(dev_idx, false);
 		}
@@ -181,13 +142,11 @@ static void uart_callback(const struct device *dev, struct uart_event *evt,
 		atomic_set(&uart_tx_started[dev_idx], false);
 		break;
 	case UART_RX_STOPPED:
-		LOG_WRN("UART_%d stop reason %d", dev_idx, evt->data.rx_stop.reason);
-
-		/* Retry automatically in case of unexpected stop.
+		/* RX is enabled again from UART_RX_DISABLED.
 		 * Typically happens when the peer does not drive its TX GPIO,
 		 * or if there is a baud rate mismatch.
 		 */
-		enable_rx_retry[dev_idx] = true;
+		LOG_WRN("UART_%d stop reason %d", dev_idx, evt->data.rx_stop.reason);
 		break;
 	default:
 		LOG_ERR("Unexpected event: %d", evt->type);
@@ -241,29 +200,42 @@ static void set_uart_power_state(uint8_t dev_idx, bool active)
 #endif
 }
 
-static void enable_uart_rx(uint8_t dev_idx)
+static int enable_uart_rx(uint8_t dev_idx)
 {
 	const struct device *dev = devices[dev_idx];
 	int err;
-	struct uart_rx_buf *buf;
+	uint8_t *buf;
 
 	err = uart_callback_set(dev, uart_callback, (void *) (int) dev_idx);
 	if (err) {
 		LOG_ERR("uart_callback_set: %d", err);
-		return;
+		return err;
 	}
 
-	buf = uart_rx_buf_alloc();
+	buf = bridge_buf_alloc();
 	if (!buf) {
-		LOG_ERR("uart_rx_buf_alloc error");
-		return;
+		LOG_DBG("UART_%d RX buffers in use, retrying", dev_idx);
+		k_work_reschedule(&rx_retry_work[dev_idx], UART_RX_RETRY_DELAY);
+		return -ENOMEM;
 	}
 
-	err = uart_rx_enable(dev, buf->buf, sizeof(buf->buf), UART_RX_TIMEOUT_USEC);
+	err = uart_rx_enable(dev, buf, BRIDGE_BUF_DATA_SIZE, UART_RX_TIMEOUT_USEC);
 	if (err) {
-		uart_rx_buf_unref(buf);
+		bridge_buf_unref(buf);
 		LOG_ERR("uart_rx_enable: %d", err);
-		return;
+		return err;
+	}
+
+	return 0;
+}
+
+static void rx_retry_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	uint8_t dev_idx = dwork - rx_retry_work;
+
+	if (subscriber_count[dev_idx] > 0) {
+		(void)enable_uart_rx(dev_idx);
 	}
 }
 
@@ -300,27 +272,70 @@ static int uart_tx_start(uint8_t dev_idx)
 	return 0;
 }
 
+static void uart_tx_segs_finish(uint8_t dev_idx, size_t len)
+{
+	struct uart_tx_segs *segs = &uart_tx_segs[dev_idx];
+	struct uart_tx_seg seg;
+
+	while ((len > 0) && (k_msgq_peek(&segs->msgq, &seg) == 0)) {
+		uint32_t seg_len = MIN(seg.len - segs->offset, len);
+
+		bridge_stats_sent(seg.path, seg_len, seg.timestamp);
+
+		len -= seg_len;
+		segs->offset += seg_len;
+		if (segs->offset == seg.len) {
+			(void)k_msgq_get(&segs->msgq, &seg, K_NO_WAIT);
+			segs->offset = 0;
+		}
+	}
+}
+
 static void uart_tx_finish(uint8_t dev_idx, size_t len)
 {
 	int err;
 
+	uart_tx_segs_finish(dev_idx, len);
+
 	err = ring_buf_get_finish(&uart_tx_ringbufs[dev_idx].rb, len);
 	if (err) {
 		LOG_ERR("ring_buf_get_finish: %d", err);
 	}
 }
 
-static int uart_tx_enqueue(uint8_t *data, size_t data_len, uint8_t dev_idx)
+static int uart_tx_enqueue(uint8_t *data, size_t data_len, uint8_t dev_idx,
+			   enum bridge_stats_path path, uint32_t timestamp)
 {
 	atomic_t started;
 	uint32_t written;
 	int err;
 
+	/* Reserve the segment first, so that the data is only enqueued */
+	/* if its statistics can be recorded once transmitted. */
+	if (k_msgq_num_free_get(&uart_tx_segs[dev_idx].msgq) == 0) {
+		bridge_stats_dropped(path, data_len);
+		return -ENOMEM;
+	}
+
 	written = ring_buf_put(&uart_tx_ringbufs[dev_idx].rb, data, data_len);
+	if (written != data_len) {
+		bridge_stats_dropped(path, data_len - written);
+	}
+
 	if (written == 0) {
 		return -ENOMEM;
 	}
 
+	struct uart_tx_seg seg = {
+		.path = path,
+		.len = written,
+		.timestamp = timestamp,
+	};
+
+	/* The event handler is the only producer, so there is room */
+	err = k_msgq_put(&uart_tx_segs[dev_idx].msgq, &seg, K_NO_WAIT);
+	__ASSERT_NO_MSG(err == 0);
+
 	started = atomic_set(&uart_tx_started[dev_idx], true);
 	if (!started) {
 		err = uart_tx_start(dev_idx);
@@ -347,8 +362,9 @@ static bool app_event_handler(const struct app_event_header *aeh)
 		const struct uart_data_event *event =
 			cast_uart_data_event(aeh);
 
-		/* All subscribers have gotten a chance to copy data at this point */
-		uart_rx_buf_unref(event->buf);
+		/* All subscribers have gotten a chance to copy data */
+		/* or take a reference at this point */
+		bridge_buf_unref(event->buf);
 
 		return true;
 	}
@@ -365,7 +381,9 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			return false;
 		}
 
-		err = uart_tx_enqueue(event->buf, event->len, event->dev_idx);
+		err = uart_tx_enqueue(event->buf, event->len, event->dev_idx,
+				      BRIDGE_STATS_CDC_TO_UART(event->dev_idx),
+				      event->timestamp);
 		if (err == -ENOMEM) {
 			LOG_WRN("CDC_%d->UART_%d overflow",
 				event->dev_idx,
@@ -387,7 +405,8 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			return false;
 		}
 
-		err = uart_tx_enqueue(event->buf, event->len, dev_idx);
+		err = uart_tx_enqueue(event->buf, event->len, dev_idx,
+				      BRIDGE_STATS_BLE_TO_UART_0, event->timestamp);
 		if (err == -ENOMEM) {
 			LOG_WRN("BLE->UART_%d overflow", dev_idx);
 		} else if (err) {
@@ -426,6 +445,7 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			set_uart_baudrate(
 				event->dev_idx,
 				uart_default_baudrate[event->dev_idx]);
+			k_work_cancel_delayable(&rx_retry_work[event->dev_idx]);
 			disable_uart_rx(event->dev_idx);
 		} else if (prev_count == 0) {
 			LOG_DBG("First subscriber. Open UART_%d RX", event->dev_idx);
@@ -461,7 +481,7 @@ static bool app_event_handler(const struct app_event_header *aeh)
 				}
 				uart_default_baudrate[i] = cfg.baudrate;
 				subscriber_count[i] = 0;
-				enable_rx_retry[i] = false;
+				k_work_init_delayable(&rx_retry_work[i], rx_retry_work_handler);
 
 				atomic_set(&uart_tx_started[i], false);
 
@@ -469,6 +489,9 @@ static bool app_event_handler(const struct app_event_header *aeh)
 					&uart_tx_ringbufs[i].rb,
 					sizeof(uart_tx_ringbufs[i].buf),
 					uart_tx_ringbufs[i].buf);
+				k_msgq_init(&uart_tx_segs[i].msgq, uart_tx_segs[i].msgq_buf,
+					    sizeof(struct uart_tx_seg), UART_TX_SEG_COUNT);
+				uart_tx_segs[i].offset = 0;
 
 				if (UART_SET_PM_STATE) {
 					set_uart_power_state(i, false);
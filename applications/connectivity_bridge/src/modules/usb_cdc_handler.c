@@ -8,6 +8,8 @@
 #include <zephyr/drivers/uart.h>
 #include <zephyr/usb/usb_device.h>
 
+#include "bridge_stats.h"
+
 #define MODULE usb_cdc
 #include "module_state_event.h"
 #include "peer_conn_event.h"
@@ -125,6 +127,7 @@ static void cdc_uart_interrupt_handler(const struct device *dev, void *user_data
 				event->dev_idx = dev_idx;
 				event->buf = rx_buf;
 				event->len = data_length;
+				event->timestamp = bridge_stats_timestamp();
 				APP_EVENT_SUBMIT(event);
 			} else {
 				k_mem_slab_free(&cdc_rx_slab, &rx_buf);
@@ -188,12 +191,19 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			return false;
 		}
 
+		/* Data is passed straight from the UART RX buffer */
 		tx_written = uart_fifo_fill(
 			devices[event->dev_idx],
 			event->buf,
 			event->len);
+		tx_written = MAX(tx_written, 0);
+
+		bridge_stats_sent(BRIDGE_STATS_UART_TO_CDC(event->dev_idx),
+				  tx_written, event->timestamp);
 
 		if (tx_written != event->len) {
+			bridge_stats_dropped(BRIDGE_STATS_UART_TO_CDC(event->dev_idx),
+					     event->len - tx_written);
 			LOG_DBG("UART_%d->CDC_%d overflow",
 				event->dev_idx,
 				event->dev_idx);
@@ -75,18 +75,7 @@ enum state {
 
 #define AXIS_COUNT (IS_ENABLED(CONFIG_DESKTOP_HID_REPORT_MOUSE_SUPPORT) * MOUSE_REPORT_AXIS_COUNT)
 
-/**@brief HID state item. */
-struct item {
-	uint16_t usage_id; /**< HID usage ID. */
-	int16_t value; /**< HID value. */
-};
-
-/**@brief Structure keeping state for a single target HID report. */
-struct items {
-	uint8_t item_count_max; /**< Maximal numer of items in this set. */
-	uint8_t item_count; /**< Current number of items in this set. */
-	struct item item[ITEM_COUNT]; /**< Items set. Browse from the end. */
-};
+#include "hid_state_items.h"
 
 /**@brief Enqueued HID state item. */
 struct item_event {
@@ -150,6 +139,11 @@ static uint8_t report_data_index[REPORT_ID_COUNT];
 static uint8_t report_state_index[REPORT_ID_COUNT];
 static struct hid_state state;
 
+/* Every event queue holds at most CONFIG_DESKTOP_HID_EVENT_QUEUE_SIZE events. */
+K_MEM_SLAB_DEFINE_STATIC(item_event_slab, sizeof(struct item_event),
+			 INPUT_REPORT_DATA_COUNT * CONFIG_DESKTOP_HID_EVENT_QUEUE_SIZE,
+			 sizeof(void *));
+
 
 static bool report_send(struct report_state *rs,
 			struct report_data *rd,
@@ -219,13 +213,9 @@ static struct hid_keymap *hid_keymap_get(uint16_t key_id)
 	return map;
 }
 
-/**@brief Compare two usage values. */
-static int usage_id_compare(const void *a, const void *b)
+static void item_event_free(struct item_event *event)
 {
-	const struct item *p_a = a;
-	const struct item *p_b = b;
-
-	return (p_a->usage_id - p_b->usage_id);
+	k_mem_slab_free(&item_event_slab, (void **)&event);
 }
 
 static void eventq_reset(struct eventq *eventq)
@@ -236,7 +226,7 @@ static void eventq_reset(struct eventq *eventq)
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&eventq->root, event, tmp, node) {
 		sys_slist_remove(&eventq->root, NULL, &event->node);
 
-		k_free(event);
+		item_event_free(event);
 	}
 
 	sys_slist_init(&eventq->root);
@@ -273,9 +263,9 @@ static struct item_event *eventq_get(struct eventq *eventq)
 
 static void eventq_append(struct eventq *eventq, uint16_t usage_id, int16_t value)
 {
-	struct item_event *hid_event = k_malloc(sizeof(*hid_event));
+	struct item_event *hid_event;
 
-	if (!hid_event) {
+	if (k_mem_slab_alloc(&item_event_slab, (void **)&hid_event, K_NO_WAIT)) {
 		LOG_ERR("Failed to allocate HID event");
 		/* Should never happen. */
 		__ASSERT_NO_MSG(false);
@@ -302,7 +292,7 @@ static void eventq_region_purge(struct eventq *eventq,
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&eventq->root, tmp, tmp_safe) {
 		sys_slist_remove(&eventq->root, NULL, tmp);
 
-		k_free(CONTAINER_OF(tmp, struct item_event, node));
+		item_event_free(CONTAINER_OF(tmp, struct item_event, node));
 		cnt++;
 
 		if (tmp == last_to_purge) {
@@ -407,25 +397,6 @@ static void eventq_cleanup(struct eventq *eventq, uint32_t timestamp)
 	}
 }
 
-static void sort_by_usage_id(struct item items[], size_t array_size)
-{
-	for (size_t k = 0; k < array_size; k++) {
-		size_t id = k;
-
-		for (size_t l = k + 1; l < array_size; l++) {
-			if (items[l].usage_id < items[id].usage_id) {
-				id = l;
-			}
-		}
-		if (id != k) {
-			struct item tmp = items[k];
-
-			items[k] = items[id];
-			items[id] = tmp;
-		}
-	}
-}
-
 static void clear_items(struct items *items)
 {
 	memset(items->item, 0, sizeof(items->item));
@@ -506,77 +477,6 @@ static struct subscriber *get_linked_subscriber(uint8_t report_id)
 	return rs ? rs->subscriber : NULL;
 }
 
-static bool key_value_set(struct items *items, uint16_t usage_id, int16_t value)
-{
-	const uint8_t prev_item_count = items->item_count;
-
-	bool update_needed = false;
-	struct item *p_item;
-
-	__ASSERT_NO_MSG(usage_id != 0);
-	__ASSERT_NO_MSG(items->item_count_max > 0);
-
-	/* Report equal to zero brings no change. This should never happen. */
-	__ASSERT_NO_MSG(value != 0);
-
-	struct item i = {
-		.usage_id = usage_id,
-	};
-
-	p_item = bsearch(&i,
-			 (uint8_t *)items->item,
-			 ARRAY_SIZE(items->item),
-			 sizeof(items->item[0]),
-			 usage_id_compare);
-
-	if (p_item) {
-		/* Item is present in the array - update its value. */
-		p_item->value += value;
-		if (p_item->value == 0) {
-			__ASSERT_NO_MSG(items->item_count != 0);
-			items->item_count -= 1;
-			p_item->usage_id = 0;
-		}
-
-		update_needed = true;
-	} else if (value < 0) {
-		/* For items with absolute value, the value is used as
-		 * a reference counter and must not fall below zero. This
-		 * could happen if a key up event is lost and the state
-		 * receives an unpaired key down event.
-		 */
-	} else if (prev_item_count >= items->item_count_max) {
-		/* Configuration should allow the HID module to hold data
-		 * about the maximum number of simultaneously pressed keys.
-		 * Generate a warning if an item cannot be recorded.
-		 */
-		LOG_WRN("No place on the list to store HID item!");
-	} else {
-		/* After sort operation, free slots (zeros) are stored
-		 * at the beginning of the array.
-		 */
-		size_t const idx = ARRAY_SIZE(items->item) - prev_item_count - 1;
-
-		__ASSERT_NO_MSG(items->item[idx].usage_id == 0);
-
-		/* Record this value change. */
-		items->item[idx].usage_id = usage_id;
-		items->item[idx].value = value;
-		items->item_count += 1;
-
-		update_needed = true;
-	}
-
-	if (prev_item_count != items->item_count) {
-		/* Sort elements on the list. Use simple algorithm
-		 * with small footprint.
-		 */
-		sort_by_usage_id(items->item, ARRAY_SIZE(items->item));
-	}
-
-	return update_needed;
-}
-
 static void send_report_keyboard(struct report_state *rs, struct report_data *rd)
 {
 	__ASSERT_NO_MSG((IS_ENABLED(CONFIG_DESKTOP_HID_REPORT_KEYBOARD_SUPPORT) &&
@@ -843,7 +743,7 @@ static bool update_report(struct report_data *rd)
 		rd->linked_rs->update_needed = rd->linked_rs->update_needed || update_needed;
 
 
-		k_free(event);
+		item_event_free(event);
 
 		/* If no item was changed, try next event. */
 	}
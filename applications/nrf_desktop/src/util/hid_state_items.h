@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HID_STATE_ITEMS_H_
+#define _HID_STATE_ITEMS_H_
+
+/**
+ * @file hid_state_items.h
+ *
+ * @brief Items of the HID reports kept by the HID state module.
+ *
+ * The file must be included after ITEM_COUNT is defined and a log module is
+ * registered.
+ */
+
+#include <string.h>
+#include <zephyr/types.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/__assert.h>
+#include <zephyr/logging/log.h>
+
+#ifndef ITEM_COUNT
+#error "ITEM_COUNT must be defined"
+#endif
+
+/**@brief HID state item. */
+struct item {
+	uint16_t usage_id; /**< HID usage ID. */
+	int16_t value; /**< HID value. */
+};
+
+/**@brief Structure keeping state for a single target HID report. */
+struct items {
+	uint8_t item_count_max; /**< Maximal numer of items in this set. */
+	uint8_t item_count; /**< Current number of items in this set. */
+	struct item item[ITEM_COUNT]; /**< Items set. Browse from the end. */
+};
+
+/**@brief Find position of the first item with usage ID not lower than the given one.
+ *
+ * Items must be sorted by usage ID.
+ */
+static size_t items_lower_bound(const struct item items[], size_t start, size_t end,
+				uint16_t usage_id)
+{
+	while (start < end) {
+		size_t mid = start + (end - start) / 2;
+
+		if (items[mid].usage_id < usage_id) {
+			start = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+
+	return start;
+}
+
+/**@brief Apply a value change of the item with the given usage ID.
+ *
+ * @return true if the items were changed and the report must be updated.
+ */
+static bool key_value_set(struct items *items, uint16_t usage_id, int16_t value)
+{
+	const uint8_t prev_item_count = items->item_count;
+
+	bool update_needed = false;
+	struct item *p_item;
+
+	__ASSERT_NO_MSG(usage_id != 0);
+	__ASSERT_NO_MSG(items->item_count_max > 0);
+
+	/* Report equal to zero brings no change. This should never happen. */
+	__ASSERT_NO_MSG(value != 0);
+
+	/* Items are kept sorted by usage ID, free slots (zeros) are stored
+	 * at the beginning of the array.
+	 */
+	size_t const first = ARRAY_SIZE(items->item) - prev_item_count;
+	size_t const pos = items_lower_bound(items->item, first,
+					     ARRAY_SIZE(items->item), usage_id);
+
+	p_item = ((pos < ARRAY_SIZE(items->item)) && (items->item[pos].usage_id == usage_id)) ?
+		 &items->item[pos] : NULL;
+
+	if (p_item) {
+		/* Item is present in the array - update its value. */
+		p_item->value += value;
+		if (p_item->value == 0) {
+			__ASSERT_NO_MSG(items->item_count != 0);
+
+			/* Close the gap by moving lower items up. */
+			memmove(&items->item[first + 1], &items->item[first],
+				(pos - first) * sizeof(items->item[0]));
+			items->item[first].usage_id = 0;
+			items->item[first].value = 0;
+			items->item_count -= 1;
+		}
+
+		update_needed = true;
+	} else if (value < 0) {
+		/* For items with absolute value, the value is used as
+		 * a reference counter and must not fall below zero. This
+		 * could happen if a key up event is lost and the state
+		 * receives an unpaired key down event.
+		 */
+	} else if (prev_item_count >= items->item_count_max) {
+		/* Configuration should allow the HID module to hold data
+		 * about the maximum number of simultaneously pressed keys.
+		 * Generate a warning if an item cannot be recorded.
+		 */
+		LOG_WRN("No place on the list to store HID item!");
+	} else {
+		__ASSERT_NO_MSG(items->item[first - 1].usage_id == 0);
+
+		/* Make room for the item by moving lower items down. */
+		memmove(&items->item[first - 1], &items->item[first],
+			(pos - first) * sizeof(items->item[0]));
+
+		/* Record this value change. */
+		items->item[pos - 1].usage_id = usage_id;
+		items->item[pos - 1].value = value;
+		items->item_count += 1;
+
+		update_needed = true;
+	}
+
+	return update_needed;
+}
+
+#endif /* _HID_STATE_ITEMS_H_ */
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""Host side of the SLM multiplexed mode (AT#XMUX).
+
+Frame format:
+  | SOF (0xF9) | channel | type | length (LE16) | payload | FCS |
+FCS is CRC-8-CCITT (initial value 0xFF) over channel, type, length and payload.
+
+Run with --loopback to test the framing and flow control against a loopback UART,
+or with --port to send AT commands on channel 0 of a device in multiplexed mode.
+"""
+
+import argparse
+import logging
+import struct
+import sys
+
+import serial
+
+SOF = 0xF9
+FCS_INIT = 0xFF
+
+FRAME_DATA = 0
+FRAME_CREDIT = 1
+FRAME_CLOSE = 2
+
+AT_CHANNEL = 0
+DEFAULT_FRAME_SIZE = 1024
+DEFAULT_RX_CREDITS = 4
+
+
+def crc8_ccitt(val, data):
+    """CRC-8 with polynomial 0x07, same as crc8_ccitt() in Zephyr."""
+    for byte in data:
+        val ^= byte
+        for _ in range(8):
+            val = ((val << 1) ^ 0x07) & 0xFF if val & 0x80 else (val << 1) & 0xFF
+    return val
+
+
+def encode_frame(channel, frame_type, payload=b''):
+    hdr = struct.pack('<BBH', channel, frame_type, len(payload))
+    fcs = crc8_ccitt(crc8_ccitt(FCS_INIT, hdr), payload)
+    return bytes([SOF]) + hdr + payload + bytes([fcs])
+
+
+class FrameDecoder:
+    """Byte-wise frame parser that resynchronizes on the next SOF after an error."""
+
+    def __init__(self, frame_size=DEFAULT_FRAME_SIZE):
+        self.frame_size = frame_size
+        self.fcs_errors = 0
+        self._buf = bytearray()
+
+    def feed(self, data):
+        """Return the list of (channel, type, payload) frames completed by data."""
+        frames = []
+        self._buf += data
+        while True:
+            start = self._buf.find(bytes([SOF]))
+            if start < 0:
+                self._buf.clear()
+                break
+            del self._buf[:start]
+            if len(self._buf) < 5:
+                break
+            channel, frame_type, length = struct.unpack_from('<BBH', self._buf, 1)
+            if length > self.frame_size:
+                logging.warning('Frame too long: %d', length)
+                del self._buf[:1]
+                continue
+            if len(self._buf) < 6 + length:
+                break
+            payload = bytes(self._buf[5:5 + length])
+            fcs = crc8_ccitt(FCS_INIT, self._buf[1:5 + length])
+            if fcs != self._buf[5 + length]:
+                logging.warning('FCS mismatch on channel %d', channel)
+                self.fcs_errors += 1
+                del self._buf[:1]
+                continue
+            del self._buf[:6 + length]
+            frames.append((channel, frame_type, payload))
+        return frames
+
+
+class MuxHost:
+    """Credit-aware host endpoint of the multiplexed mode."""
+
+    def __init__(self, port, frame_size=DEFAULT_FRAME_SIZE, rx_credits=DEFAULT_RX_CREDITS):
+        self.port = port
+        self.frame_size = frame_size
+        self.rx_credits = rx_credits
+        self.decoder = FrameDecoder(frame_size)
+        self.tx_credits = {}
+        self.rx_data = {}
+        self.closed = set()
+
+    def open_channel(self, channel):
+        """Grant the initial credits to the device for a newly mapped channel."""
+        self.rx_data[channel] = bytearray()
+        self.port.write(encode_frame(channel, FRAME_CREDIT, bytes([self.rx_credits])))
+
+    def send(self, channel, data):
+        """Send data, splitting it into frames. Returns the number of bytes sent.
+
+        Data channels stop at the first frame without credit.
+        """
+        sent = 0
+        while sent < len(data):
+            if channel != AT_CHANNEL:
+                if self.tx_credits.get(channel, 0) <= 0:
+                    break
+                self.tx_credits[channel] -= 1
+            chunk = data[sent:sent + self.frame_size]
+            self.port.write(encode_frame(channel, FRAME_DATA, chunk))
+            sent += len(chunk)
+        return sent
+
+    def close(self, channel):
+        self.port.write(encode_frame(channel, FRAME_CLOSE))
+
+    def poll(self):
+        """Read from the port and process the received frames."""
+        data = self.port.read(max(1, self.port.in_waiting))
+        for channel, frame_type, payload in self.decoder.feed(data):
+            if frame_type == FRAME_DATA:
+                self.rx_data.setdefault(channel, bytearray()).extend(payload)
+                if channel != AT_CHANNEL:
+                    self.port.write(encode_frame(channel, FRAME_CREDIT, b'\x01'))
+            elif frame_type == FRAME_CREDIT and payload:
+                self.tx_credits[channel] = self.tx_credits.get(channel, 0) + payload[0]
+            elif frame_type == FRAME_CLOSE:
+                self.closed.add(channel)
+
+    def drain(self, rounds=16):
+        for _ in range(rounds):
+            self.poll()
+
+
+def loopback_test():
+    """Everything written to the loopback port is read back, so the host talks to itself."""
+    port = serial.serial_for_url('loop://', timeout=0.05)
+    frame_size = 16
+    host = MuxHost(port, frame_size=frame_size, rx_credits=2)
+
+    # Framing: the AT channel is not flow controlled and long data is split.
+    cmd = b'AT#XMUXCH?\r\nAT+CFUN?\r\n'
+    assert host.send(AT_CHANNEL, cmd) == len(cmd)
+    host.drain()
+    assert bytes(host.rx_data[AT_CHANNEL]) == cmd, 'AT channel payload mismatch'
+
+    # FCS: a corrupted frame is dropped and the next frame is still received.
+    bad = bytearray(encode_frame(AT_CHANNEL, FRAME_DATA, b'corrupted'))
+    bad[-1] ^= 0xFF
+    host.rx_data[AT_CHANNEL].clear()
+    port.write(b'\x00\x01' + bytes(bad) + encode_frame(AT_CHANNEL, FRAME_DATA, b'OK'))
+    host.drain()
+    assert host.decoder.fcs_errors == 1, 'FCS error not detected'
+    assert bytes(host.rx_data[AT_CHANNEL]) == b'OK', 'No resync after FCS error'
+
+    # Credits: sending stops without credit and resumes when credits are returned.
+    host.open_channel(1)
+    host.drain()
+    assert host.tx_credits[1] == 2, 'Initial credits not received'
+    data = bytes(range(256)) * 2
+    sent = host.send(1, data)
+    assert sent == 2 * frame_size, 'Sent without credit'
+    host.drain()
+    assert host.tx_credits[1] == 2, 'Credits not returned'
+    while sent < len(data):
+        sent += host.send(1, data[sent:])
+        host.drain()
+    assert bytes(host.rx_data[1]) == data, 'Channel payload mismatch'
+
+    # Close.
+    host.close(1)
+    host.drain()
+    assert 1 in host.closed, 'Close frame not received'
+
+    print('Loopback test passed')
+    return 0
+
+
+def at_session(port_name, baudrate, commands):
+    port = serial.Serial(port_name, baudrate, timeout=0.1)
+    host = MuxHost(port)
+    for cmd in commands:
+        host.rx_data[AT_CHANNEL] = bytearray()
+        host.send(AT_CHANNEL, cmd.encode() + b'\r\n')
+        host.drain(rounds=20)
+        print(host.rx_data[AT_CHANNEL].decode(errors='replace'), end='')
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='SLM multiplexed mode host.',
+                                     allow_abbrev=False)
+    parser.add_argument('--loopback', action='store_true', help='Run the loopback self-test')
+    parser.add_argument('--port', help='Serial port of the SLM')
+    parser.add_argument('--baudrate', type=int, default=115200, help='Baud rate')
+    parser.add_argument('commands', nargs='*', help='AT commands to send on channel 0')
+    parser.add_argument('--log', default='WARNING', help='Log level')
+    args = parser.parse_args()
+
+    logging.basicConfig(level=args.log.upper())
+
+    if args.loopback:
+        return loopback_test()
+    if args.port:
+        return at_session(args.port, args.baudrate, args.commands)
+
+    parser.print_help()
+    return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -24,6 +24,7 @@
 #include "slm_util.h"
 #include "slm_settings.h"
 #include "slm_at_host.h"
+#include "slm_uart_handler.h"
 #include "slm_at_tcp_proxy.h"
 #include "slm_at_udp_proxy.h"
 #include "slm_at_socket.h"
@@ -51,6 +52,9 @@
 #if defined(CONFIG_SLM_TWI)
 #include "slm_at_twi.h"
 #endif
+#if defined(CONFIG_SLM_MUX)
+#include "slm_at_mux.h"
+#endif
 #if defined(CONFIG_SLM_GPIO)
 #include "slm_at_gpio.h"
 #endif
@@ -508,6 +512,15 @@ int handle_at_gpio_operate(enum at_cmd_type cmd_type);
 int handle_at_carrier(enum at_cmd_type cmd_type);
 #endif
 
+#if defined(CONFIG_SLM_MUX)
+int handle_at_mux(enum at_cmd_type cmd_type);
+int handle_at_muxch(enum at_cmd_type cmd_type);
+#endif
+
+#if defined(CONFIG_SLM_AT_CMD_STATS)
+static int handle_at_slmstat(enum at_cmd_type cmd_type);
+#endif
+
 static struct slm_at_cmd {
 	char *string;
 	slm_at_handler_t handler;
@@ -622,8 +635,172 @@ static struct slm_at_cmd {
 	{"AT#XCARRIER", handle_at_carrier},
 #endif
 
+#if defined(CONFIG_SLM_MUX)
+	{"AT#XMUX", handle_at_mux},
+	{"AT#XMUXCH", handle_at_muxch},
+#endif
+
+#if defined(CONFIG_SLM_AT_CMD_STATS)
+	{"AT#XSLMSTAT", handle_at_slmstat},
+#endif
 };
 
+/* Open addressing hash table of indexes into slm_at_cmd_list, offset by one (0 is empty). */
+#define SLM_AT_CMD_HASH_SIZE 128
+
+BUILD_ASSERT(ARRAY_SIZE(slm_at_cmd_list) <= SLM_AT_CMD_HASH_SIZE / 2,
+	     "Hash table too small for the AT command list");
+
+static uint8_t slm_at_cmd_hash[SLM_AT_CMD_HASH_SIZE];
+
+#if defined(CONFIG_SLM_AT_CMD_STATS)
+/* Upper bounds in microseconds of the handler latency histogram bins. */
+static const uint32_t slm_at_latency_bins_us[] = {100, 1000, 10000, 100000};
+
+static struct slm_at_cmd_stats {
+	uint32_t count;
+	uint32_t latency_hist[ARRAY_SIZE(slm_at_latency_bins_us) + 1];
+} slm_at_cmd_stats[ARRAY_SIZE(slm_at_cmd_list)];
+#endif
+
+/* Length of the command name, excluding any operation, parameters and terminator. */
+static size_t cmd_name_len(const char *at_cmd)
+{
+	size_t len = 0;
+
+	while (at_cmd[len] != '\0' && at_cmd[len] != '=' && at_cmd[len] != '?' &&
+	       at_cmd[len] != '\r' && at_cmd[len] != '\n') {
+		len++;
+	}
+
+	return len;
+}
+
+/* Case-insensitive FNV-1a hash. */
+static uint32_t cmd_name_hash(const char *name, size_t len)
+{
+	uint32_t hash = 2166136261u;
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ (uint8_t)toupper((int)name[i])) * 16777619u;
+	}
+
+	return hash;
+}
+
+static void cmd_hash_init(void)
+{
+	memset(slm_at_cmd_hash, 0, sizeof(slm_at_cmd_hash));
+
+	for (int i = 0; i < ARRAY_SIZE(slm_at_cmd_list); i++) {
+		const char *name = slm_at_cmd_list[i].string;
+		uint32_t idx = cmd_name_hash(name, strlen(name));
+
+		while (slm_at_cmd_hash[idx % SLM_AT_CMD_HASH_SIZE] != 0) {
+			idx++;
+		}
+		slm_at_cmd_hash[idx % SLM_AT_CMD_HASH_SIZE] = i + 1;
+	}
+}
+
+/** @return Index of the command in slm_at_cmd_list, or -1 if not found. */
+static int cmd_find(const char *at_cmd)
+{
+	size_t len = cmd_name_len(at_cmd);
+	uint32_t idx = cmd_name_hash(at_cmd, len);
+	uint8_t entry;
+
+	while ((entry = slm_at_cmd_hash[idx % SLM_AT_CMD_HASH_SIZE]) != 0) {
+		const char *name = slm_at_cmd_list[entry - 1].string;
+
+		if (strlen(name) == len && slm_util_cmd_casecmp(at_cmd, name)) {
+			return entry - 1;
+		}
+		idx++;
+	}
+
+	return -1;
+}
+
+#if defined(CONFIG_SLM_AT_CMD_STATS)
+static void cmd_stats_update(int cmd_idx, uint32_t cycles)
+{
+	struct slm_at_cmd_stats *stats = &slm_at_cmd_stats[cmd_idx];
+	uint32_t latency_us = k_cyc_to_us_floor32(cycles);
+	int bin;
+
+	for (bin = 0; bin < ARRAY_SIZE(slm_at_latency_bins_us); bin++) {
+		if (latency_us < slm_at_latency_bins_us[bin]) {
+			break;
+		}
+	}
+
+	stats->count++;
+	stats->latency_hist[bin]++;
+}
+
+/** @brief Handles AT#XSLMSTAT commands.
+ *  AT#XSLMSTAT[=<op>]
+ *  AT#XSLMSTAT? not supported
+ *  AT#XSLMSTAT=?
+ */
+static int handle_at_slmstat(enum at_cmd_type cmd_type)
+{
+	int ret = 0;
+	uint16_t op = 1;
+
+	switch (cmd_type) {
+	case AT_CMD_TYPE_SET_COMMAND:
+		if (at_params_valid_count_get(&at_param_list) > 1) {
+			ret = at_params_unsigned_short_get(&at_param_list, 1, &op);
+			if (ret) {
+				return ret;
+			}
+		}
+		if (op == 0) {
+			memset(slm_at_cmd_stats, 0, sizeof(slm_at_cmd_stats));
+			slm_uart_tx_stats_reset();
+		} else if (op == 1) {
+			for (int i = 0; i < ARRAY_SIZE(slm_at_cmd_list); i++) {
+				const struct slm_at_cmd_stats *stats = &slm_at_cmd_stats[i];
+
+				if (stats->count == 0) {
+					continue;
+				}
+				rsp_send("\r\n#XSLMSTAT: \"%s\",%u,%u,%u,%u,%u,%u\r\n",
+					 slm_at_cmd_list[i].string, stats->count,
+					 stats->latency_hist[0], stats->latency_hist[1],
+					 stats->latency_hist[2], stats->latency_hist[3],
+					 stats->latency_hist[4]);
+			}
+		} else {
+			ret = -EINVAL;
+		}
+		break;
+
+	case AT_CMD_TYPE_READ_COMMAND: {
+		struct slm_uart_tx_stats tx_stats;
+
+		slm_uart_tx_stats_get(&tx_stats);
+		rsp_send("\r\n#XSLMSTAT: %u,%u,%u,%u,%u,%u\r\n", tx_stats.bytes,
+			 tx_stats.busy_ms, tx_stats.stall_ms, tx_stats.stalls,
+			 tx_stats.elapsed_ms, tx_stats.utilization);
+		break;
+	}
+
+	case AT_CMD_TYPE_TEST_COMMAND:
+		rsp_send("\r\n#XSLMSTAT: (0,1)\r\n");
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	return ret;
+}
+#endif /* CONFIG_SLM_AT_CMD_STATS */
+
 int handle_at_clac(enum at_cmd_type cmd_type)
 {
 	int ret = -EINVAL;
@@ -642,24 +819,32 @@ int handle_at_clac(enum at_cmd_type cmd_type)
 
 int slm_at_parse(const char *at_cmd)
 {
-	int ret = UNKNOWN_AT_COMMAND_RET;
-	int total = ARRAY_SIZE(slm_at_cmd_list);
+	int ret;
+	int i = cmd_find(at_cmd);
+	enum at_cmd_type type;
 
-	for (int i = 0; i < total; i++) {
-		if (slm_util_cmd_casecmp(at_cmd, slm_at_cmd_list[i].string)) {
-			enum at_cmd_type type = at_parser_cmd_type_get(at_cmd);
+	if (i < 0) {
+		return UNKNOWN_AT_COMMAND_RET;
+	}
 
-			at_params_list_clear(&at_param_list);
-			ret = at_parser_params_from_str(at_cmd, NULL, &at_param_list);
-			if (ret) {
-				LOG_ERR("Failed to parse AT command %d", ret);
-				return -EINVAL;
-			}
-			ret = slm_at_cmd_list[i].handler(type);
-			break;
-		}
+	type = at_parser_cmd_type_get(at_cmd);
+
+	at_params_list_clear(&at_param_list);
+	ret = at_parser_params_from_str(at_cmd, NULL, &at_param_list);
+	if (ret) {
+		LOG_ERR("Failed to parse AT command %d", ret);
+		return -EINVAL;
 	}
 
+#if defined(CONFIG_SLM_AT_CMD_STATS)
+	uint32_t start = k_cycle_get_32();
+
+	ret = slm_at_cmd_list[i].handler(type);
+	cmd_stats_update(i, k_cycle_get_32() - start);
+#else
+	ret = slm_at_cmd_list[i].handler(type);
+#endif
+
 	return ret;
 }
 
@@ -667,6 +852,8 @@ int slm_at_init(void)
 {
 	int err;
 
+	cmd_hash_init();
+
 	k_work_init_delayable(&slm_work.uart_work, set_uart_wk);
 	k_work_init_delayable(&slm_work.sleep_work, go_sleep_wk);
 
@@ -765,6 +952,13 @@ int slm_at_init(void)
 		return -EFAULT;
 	}
 #endif
+#if defined(CONFIG_SLM_MUX)
+	err = slm_at_mux_init();
+	if (err) {
+		LOG_ERR("MUX could not be initialized: %d", err);
+		return -EFAULT;
+	}
+#endif
 
 	return err;
 }
@@ -859,4 +1053,10 @@ void slm_at_uninit(void)
 		LOG_ERR("LwM2M carrier could not be uninitialized: %d", err);
 	}
 #endif
+#if defined(CONFIG_SLM_MUX)
+	err = slm_at_mux_uninit();
+	if (err) {
+		LOG_ERR("MUX could not be uninitialized: %d", err);
+	}
+#endif
 }
@@ -14,6 +14,9 @@
 #include "slm_at_host.h"
 #include "slm_at_fota.h"
 #include "slm_uart_handler.h"
+#if defined(CONFIG_SLM_MUX)
+#include "slm_at_mux.h"
+#endif
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(slm_at_host, CONFIG_SLM_LOG_LEVEL);
@@ -441,6 +444,16 @@ static void format_final_result(char *buf, size_t buf_len, size_t buf_max_len)
 	}
 }
 
+static int at_tx_write(const uint8_t *data, size_t len)
+{
+#if defined(CONFIG_SLM_MUX)
+	if (slm_mux_active()) {
+		return slm_mux_tx(SLM_MUX_AT_CHANNEL, data, len);
+	}
+#endif
+	return slm_uart_tx_write(data, len);
+}
+
 static void cmd_send(uint8_t *buf, uint16_t cmd_length, uint16_t buf_size)
 {
 	int err;
@@ -478,7 +491,7 @@ static void cmd_send(uint8_t *buf, uint16_t cmd_length, uint16_t buf_size)
 	 */
 	if (strlen(buf) > strlen(CRLF_STR)) {
 		format_final_result(at_buf, strlen(at_buf), sizeof(at_buf));
-		err = slm_uart_tx_write(buf, strlen(buf));
+		err = at_tx_write(buf, strlen(buf));
 		if (err) {
 			LOG_ERR("AT command response failed: %d", err);
 		}
@@ -600,6 +613,19 @@ static size_t null_handler(const uint8_t *buf, const size_t len)
 	return processed;
 }
 
+#if defined(CONFIG_SLM_MUX)
+static void mux_at_rx(const uint8_t *buf, size_t len)
+{
+	size_t ret;
+
+	while (len > 0) {
+		ret = cmd_rx_handler(buf, len);
+		buf += ret;
+		len -= ret;
+	}
+}
+#endif
+
 static void rx_handler_callback(const uint8_t *buf, size_t len)
 {
 	enum slm_operation_mode mode;
@@ -607,6 +633,13 @@ static void rx_handler_callback(const uint8_t *buf, size_t len)
 
 	k_timer_stop(&inactivity_timer);
 
+#if defined(CONFIG_SLM_MUX)
+	if (slm_mux_active()) {
+		slm_mux_rx(buf, len, mux_at_rx);
+		return;
+	}
+#endif
+
 	while (len > 0) {
 
 		mode = get_slm_mode();
@@ -619,7 +652,7 @@ static void rx_handler_callback(const uint8_t *buf, size_t len)
 			ret = null_handler(buf, len);
 		} else {
 			LOG_ERR("Internal error: Unknown SLM mode.");
-			(void)slm_uart_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
+			(void)at_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
 			break;
 		}
 
@@ -628,7 +661,7 @@ static void rx_handler_callback(const uint8_t *buf, size_t len)
 			len -= ret;
 		} else {
 			LOG_ERR("Internal error: Command overflow.");
-			(void)slm_uart_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
+			(void)at_tx_write(FATAL_STR, sizeof(FATAL_STR) - 1);
 			break;
 		}
 	}
@@ -644,19 +677,19 @@ AT_MONITOR(at_notify, ANY, notification_handler);
 static void notification_handler(const char *notification)
 {
 	if (get_slm_mode() == SLM_AT_COMMAND_MODE) {
-		(void)slm_uart_tx_write(CRLF_STR, strlen(CRLF_STR));
-		(void)slm_uart_tx_write(notification, strlen(notification));
+		(void)at_tx_write(CRLF_STR, strlen(CRLF_STR));
+		(void)at_tx_write(notification, strlen(notification));
 	}
 }
 
 void rsp_send_ok(void)
 {
-	(void)slm_uart_tx_write(OK_STR, sizeof(OK_STR) - 1);
+	(void)at_tx_write(OK_STR, sizeof(OK_STR) - 1);
 }
 
 void rsp_send_error(void)
 {
-	(void)slm_uart_tx_write(ERROR_STR, sizeof(ERROR_STR) - 1);
+	(void)at_tx_write(ERROR_STR, sizeof(ERROR_STR) - 1);
 }
 
 void rsp_send(const char *fmt, ...)
@@ -667,18 +700,52 @@ void rsp_send(const char *fmt, ...)
 	vsnprintf(rsp_buf, sizeof(rsp_buf), fmt, arg_ptr);
 	va_end(arg_ptr);
 
-	(void)slm_uart_tx_write(rsp_buf, strlen(rsp_buf));
+	(void)at_tx_write(rsp_buf, strlen(rsp_buf));
 }
 
 void data_send(const uint8_t *data, size_t len)
 {
 	LOG_HEXDUMP_DBG(data, MIN(len, HEXDUMP_DATAMODE_MAX), "TX-DATA");
-	(void)slm_uart_tx_write(data, len);
+	(void)at_tx_write(data, len);
+}
+
+uint8_t *data_buf_get(void)
+{
+	uint8_t *buf = slm_uart_tx_buf_alloc(K_NO_WAIT);
+
+	return buf ? buf : data_buf;
+}
+
+void data_buf_send(uint8_t *buf, size_t len)
+{
+	LOG_HEXDUMP_DBG(buf, MIN(len, HEXDUMP_DATAMODE_MAX), "TX-DATA");
+#if defined(CONFIG_SLM_MUX)
+	if (slm_mux_active()) {
+		(void)slm_mux_tx(SLM_MUX_AT_CHANNEL, buf, len);
+		slm_uart_tx_buf_unref(buf);
+		return;
+	}
+#endif
+	(void)slm_uart_tx_buf_send(buf, len);
+	slm_uart_tx_buf_unref(buf);
+}
+
+void data_buf_put(uint8_t *buf)
+{
+	slm_uart_tx_buf_unref(buf);
 }
 
 
 int enter_datamode(slm_datamode_handler_t handler)
 {
+#if defined(CONFIG_SLM_MUX)
+	/* Socket data is carried on the multiplexed channels instead. */
+	if (slm_mux_active()) {
+		LOG_INF("Multiplexed mode active, not enter datamode");
+		return -EBUSY;
+	}
+#endif
+
 	k_mutex_lock(&mutex_mode, K_FOREVER);
 
 	if (handler == NULL || datamode_handler != NULL || set_slm_mode(SLM_DATA_MODE) == false) {
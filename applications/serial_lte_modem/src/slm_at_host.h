@@ -79,6 +79,31 @@ void rsp_send_error(void);
  */
 void data_send(const uint8_t *data, size_t len);
 
+/**
+ * @brief Get a buffer of SLM_MAX_MESSAGE_SIZE bytes for socket data
+ *
+ * A zero-copy UART buffer is returned when one is available, so the data can
+ * be sent by @ref data_buf_send without copying it.
+ *
+ * @return Pointer to the buffer. Release it with @ref data_buf_send or @ref data_buf_put.
+ */
+uint8_t *data_buf_get(void);
+
+/**
+ * @brief Send raw data from a buffer got by @ref data_buf_get and release the buffer
+ *
+ * @param buf Buffer got by @ref data_buf_get
+ * @param len Length of raw data
+ */
+void data_buf_send(uint8_t *buf, size_t len);
+
+/**
+ * @brief Release a buffer got by @ref data_buf_get without sending it
+ *
+ * @param buf Buffer got by @ref data_buf_get
+ */
+void data_buf_put(uint8_t *buf);
+
 /**
  * @brief Request SLM AT host to enter data mode
  *
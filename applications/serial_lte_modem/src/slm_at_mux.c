@@ -0,0 +1,656 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/logging/log.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include "slm_util.h"
+#include "slm_at_host.h"
+#include "slm_at_mux.h"
+#include "slm_uart_handler.h"
+
+LOG_MODULE_REGISTER(slm_mux, CONFIG_SLM_LOG_LEVEL);
+
+#define THREAD_STACK_SIZE	KB(2)
+#define THREAD_PRIORITY		K_LOWEST_APPLICATION_THREAD_PRIO
+
+/* Let the final response be sent before switching the framing on or off. */
+#define MUX_SWITCH_DELAY_MS	50
+#define MUX_POLL_TIMEOUT_MS	100
+
+/*
+ * Frame format:
+ * | SOF (0xF9) | channel | type | length (LE16) | payload | FCS |
+ * FCS is CRC-8-CCITT over channel, type, length and payload.
+ */
+#define MUX_SOF			0xF9
+#define MUX_HDR_LEN		4
+#define MUX_FCS_INIT		0xFF
+#define MUX_CHANNEL_COUNT	(CONFIG_SLM_MUX_CHANNELS + 1)
+#define MUX_FRAME_MAX		CONFIG_SLM_MUX_FRAME_SIZE
+
+/**@brief Frame types. */
+enum slm_mux_frame_type {
+	MUX_FRAME_DATA,		/* Channel payload */
+	MUX_FRAME_CREDIT,	/* Payload is the number of frames the sender may receive */
+	MUX_FRAME_CLOSE		/* Close the channel, or leave multiplexed mode on channel 0 */
+};
+
+/**@brief Multiplexed mode operations. */
+enum slm_mux_operation {
+	MUX_STOP,
+	MUX_START
+};
+
+enum mux_rx_state {
+	MUX_RX_SOF,
+	MUX_RX_HDR,
+	MUX_RX_PAYLOAD,
+	MUX_RX_FCS
+};
+
+static struct mux_channel {
+	int fd;			/* Mapped socket, or INVALID_SOCKET */
+	atomic_t tx_credits;	/* Frames that may be sent to the host */
+	uint16_t rx_credits;	/* Frames that the host may send */
+	bool tx_stalled;	/* Waiting for credits from the host */
+	uint32_t rx_bytes;
+	uint32_t tx_bytes;
+	uint32_t rx_dropped;
+	uint32_t tx_stalls;
+} channels[MUX_CHANNEL_COUNT];
+
+static struct mux_rx {
+	enum mux_rx_state state;
+	uint8_t hdr[MUX_HDR_LEN];
+	size_t count;
+	uint16_t len;
+	uint8_t payload[MUX_FRAME_MAX];
+	uint32_t fcs_errors;
+} rx;
+
+/* Data frame received from the host, waiting to be sent to the socket. */
+struct mux_rx_frame {
+	void *fifo_reserved;
+	int fd;
+	uint8_t channel;
+	uint16_t len;
+	uint8_t data[MUX_FRAME_MAX];
+};
+
+/* Each receive credit granted to the host reserves a frame. */
+static K_MEM_SLAB_DEFINE(mux_rx_slab, sizeof(struct mux_rx_frame),
+			 CONFIG_SLM_MUX_CHANNELS * CONFIG_SLM_MUX_RX_CREDITS, 4);
+static K_FIFO_DEFINE(mux_rx_fifo);
+
+static atomic_t mux_active;
+static struct k_work_delayable mux_switch_work;
+static enum slm_mux_operation mux_switch_op;
+
+static K_MUTEX_DEFINE(mux_tx_mutex); /* Keeps frames from different contexts apart. */
+static K_MUTEX_DEFINE(mux_ch_mutex); /* Protects the channel table and mux_active changes. */
+static K_SEM_DEFINE(mux_sem, 0, 1); /* Wakes up the thread on credits or mapping changes. */
+
+static struct k_thread mux_thread;
+static K_THREAD_STACK_DEFINE(mux_thread_stack, THREAD_STACK_SIZE);
+static struct k_thread mux_sock_thread;
+static K_THREAD_STACK_DEFINE(mux_sock_thread_stack, THREAD_STACK_SIZE);
+static uint8_t mux_tx_buf[MUX_FRAME_MAX];
+
+/* global variable defined in different files */
+extern struct at_param_list at_param_list;
+
+static int mux_frame_send(uint8_t channel, uint8_t type, const uint8_t *data, uint16_t len)
+{
+	int err;
+	uint8_t sof = MUX_SOF;
+	uint8_t hdr[MUX_HDR_LEN] = { channel, type };
+	uint8_t fcs;
+
+	sys_put_le16(len, &hdr[2]);
+	fcs = crc8_ccitt(MUX_FCS_INIT, hdr, sizeof(hdr));
+	fcs = crc8_ccitt(fcs, data, len);
+
+	k_mutex_lock(&mux_tx_mutex, K_FOREVER);
+	err = slm_uart_tx_write(&sof, sizeof(sof));
+	if (!err) {
+		err = slm_uart_tx_write(hdr, sizeof(hdr));
+	}
+	if (!err && len > 0) {
+		err = slm_uart_tx_write(data, len);
+	}
+	if (!err) {
+		err = slm_uart_tx_write(&fcs, sizeof(fcs));
+	}
+	k_mutex_unlock(&mux_tx_mutex);
+
+	return err;
+}
+
+/* Grant credits to the host, if the socket is still mapped to the channel. */
+static void mux_credit_grant(uint8_t channel, int fd, uint8_t credits)
+{
+	bool mapped;
+
+	k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+	mapped = (channels[channel].fd == fd);
+	if (mapped) {
+		channels[channel].rx_credits += credits;
+	}
+	k_mutex_unlock(&mux_ch_mutex);
+
+	if (mapped && slm_mux_active()) {
+		(void)mux_frame_send(channel, MUX_FRAME_CREDIT, &credits, sizeof(credits));
+	}
+}
+
+static void mux_channel_reset(struct mux_channel *ch)
+{
+	memset(ch, 0, sizeof(*ch));
+	ch->fd = INVALID_SOCKET;
+}
+
+/* Close the channel, if the socket is still mapped to it. */
+static void mux_channel_close(uint8_t channel, int fd)
+{
+	bool active;
+
+	k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+	if (channels[channel].fd != fd) {
+		k_mutex_unlock(&mux_ch_mutex);
+		return;
+	}
+	mux_channel_reset(&channels[channel]);
+	active = slm_mux_active();
+	k_mutex_unlock(&mux_ch_mutex);
+
+	if (active) {
+		(void)mux_frame_send(channel, MUX_FRAME_CLOSE, NULL, 0);
+	}
+	k_sem_give(&mux_sem);
+}
+
+static void mux_start(void)
+{
+	int fd;
+
+	if (in_datamode()) {
+		LOG_ERR("Data mode entered, not enter multiplexed mode");
+		return;
+	}
+
+	k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+	rx.state = MUX_RX_SOF;
+	atomic_set(&mux_active, 1);
+	k_mutex_unlock(&mux_ch_mutex);
+
+	/* Let the host send data to the already mapped channels. */
+	for (uint8_t i = 1; i < MUX_CHANNEL_COUNT; i++) {
+		k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+		fd = channels[i].fd;
+		channels[i].rx_credits = 0;
+		k_mutex_unlock(&mux_ch_mutex);
+
+		if (fd != INVALID_SOCKET) {
+			mux_credit_grant(i, fd, CONFIG_SLM_MUX_RX_CREDITS);
+		}
+	}
+
+	k_sem_give(&mux_sem);
+	LOG_INF("Enter multiplexed mode");
+}
+
+static void mux_stop(void)
+{
+	/* The forwarding thread sends data frames only while holding the lock. */
+	k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+	atomic_set(&mux_active, 0);
+	k_mutex_unlock(&mux_ch_mutex);
+	LOG_INF("Exit multiplexed mode");
+}
+
+static void mux_switch_wk(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (mux_switch_op == MUX_START) {
+		mux_start();
+	} else {
+		mux_stop();
+	}
+}
+
+/* Runs in the UART RX work, so the frame is queued for the socket thread instead of blocking
+ * in send().
+ */
+static void mux_data_rx(uint8_t channel, const uint8_t *data, uint16_t len)
+{
+	struct mux_channel *ch = &channels[channel];
+	struct mux_rx_frame *frame = NULL;
+	int credit_fd = INVALID_SOCKET;
+
+	k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+	if (ch->fd != INVALID_SOCKET && ch->rx_credits > 0) {
+		ch->rx_credits--;
+		if (k_mem_slab_alloc(&mux_rx_slab, (void **)&frame, K_NO_WAIT) == 0) {
+			frame->fd = ch->fd;
+			frame->channel = channel;
+			frame->len = len;
+		} else {
+			/* The frame used a credit, so it is returned to the host. */
+			credit_fd = ch->fd;
+		}
+	}
+	if (!frame) {
+		ch->rx_dropped += len;
+	}
+	k_mutex_unlock(&mux_ch_mutex);
+
+	if (!frame) {
+		LOG_WRN("Channel %d: %d dropped", channel, len);
+		if (credit_fd != INVALID_SOCKET) {
+			mux_credit_grant(channel, credit_fd, 1);
+		}
+		return;
+	}
+
+	memcpy(frame->data, data, len);
+	k_fifo_put(&mux_rx_fifo, frame);
+}
+
+static void mux_frame_rx(slm_mux_at_rx_t at_rx)
+{
+	uint8_t channel = rx.hdr[0];
+	uint8_t type = rx.hdr[1];
+
+	if (channel >= MUX_CHANNEL_COUNT) {
+		LOG_WRN("Invalid channel %d", channel);
+		return;
+	}
+
+	switch (type) {
+	case MUX_FRAME_DATA:
+		if (channel == SLM_MUX_AT_CHANNEL) {
+			at_rx(rx.payload, rx.len);
+		} else {
+			mux_data_rx(channel, rx.payload, rx.len);
+		}
+		break;
+	case MUX_FRAME_CREDIT:
+		if (rx.len >= 1) {
+			atomic_add(&channels[channel].tx_credits, rx.payload[0]);
+			k_sem_give(&mux_sem);
+		}
+		break;
+	case MUX_FRAME_CLOSE:
+		if (channel == SLM_MUX_AT_CHANNEL) {
+			mux_stop();
+		} else {
+			mux_channel_close(channel, channels[channel].fd);
+		}
+		break;
+	default:
+		LOG_WRN("Invalid frame type %d", type);
+		break;
+	}
+}
+
+void slm_mux_rx(const uint8_t *buf, size_t len, slm_mux_at_rx_t at_rx)
+{
+	uint8_t fcs;
+
+	for (size_t i = 0; i < len && slm_mux_active(); i++) {
+		uint8_t byte = buf[i];
+
+		switch (rx.state) {
+		case MUX_RX_SOF:
+			if (byte == MUX_SOF) {
+				rx.count = 0;
+				rx.state = MUX_RX_HDR;
+			}
+			break;
+		case MUX_RX_HDR:
+			rx.hdr[rx.count++] = byte;
+			if (rx.count == MUX_HDR_LEN) {
+				rx.len = sys_get_le16(&rx.hdr[2]);
+				rx.count = 0;
+				if (rx.len > MUX_FRAME_MAX) {
+					LOG_WRN("Frame too long: %d", rx.len);
+					rx.state = MUX_RX_SOF;
+				} else {
+					rx.state = (rx.len > 0) ? MUX_RX_PAYLOAD : MUX_RX_FCS;
+				}
+			}
+			break;
+		case MUX_RX_PAYLOAD:
+			rx.payload[rx.count++] = byte;
+			if (rx.count == rx.len) {
+				rx.state = MUX_RX_FCS;
+			}
+			break;
+		case MUX_RX_FCS:
+			fcs = crc8_ccitt(MUX_FCS_INIT, rx.hdr, sizeof(rx.hdr));
+			fcs = crc8_ccitt(fcs, rx.payload, rx.len);
+			if (fcs == byte) {
+				mux_frame_rx(at_rx);
+			} else {
+				LOG_WRN("FCS mismatch, frame dropped");
+				rx.fcs_errors++;
+			}
+			rx.state = MUX_RX_SOF;
+			break;
+		}
+	}
+}
+
+int slm_mux_tx(uint8_t channel, const uint8_t *data, size_t len)
+{
+	int err = 0;
+
+	while (len > 0 && !err) {
+		uint16_t frame_len = MIN(len, MUX_FRAME_MAX);
+
+		err = mux_frame_send(channel, MUX_FRAME_DATA, data, frame_len);
+		data += frame_len;
+		len -= frame_len;
+	}
+
+	return err;
+}
+
+bool slm_mux_active(void)
+{
+	return atomic_get(&mux_active) != 0;
+}
+
+/* Send the frames received from the host to the sockets. */
+static void mux_sock_thread_func(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	struct mux_rx_frame *frame;
+	size_t offset;
+	bool mapped;
+	int ret;
+
+	while (true) {
+		frame = k_fifo_get(&mux_rx_fifo, K_FOREVER);
+		offset = 0;
+
+		k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+		mapped = (channels[frame->channel].fd == frame->fd);
+		k_mutex_unlock(&mux_ch_mutex);
+
+		/* Data of a closed channel is not sent to the socket. */
+		while (mapped && offset < frame->len) {
+			ret = send(frame->fd, frame->data + offset, frame->len - offset, 0);
+			if (ret < 0) {
+				LOG_ERR("Channel %d: send() failed: %d", frame->channel, -errno);
+				break;
+			}
+			offset += ret;
+		}
+
+		k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+		if (channels[frame->channel].fd == frame->fd) {
+			channels[frame->channel].rx_bytes += offset;
+			channels[frame->channel].rx_dropped += frame->len - offset;
+		}
+		k_mutex_unlock(&mux_ch_mutex);
+
+		/* The frame has been consumed, return the credit. */
+		mux_credit_grant(frame->channel, frame->fd, 1);
+		k_mem_slab_free(&mux_rx_slab, (void **)&frame);
+	}
+}
+
+/* Forward data from the socket to the host. The channel may have been closed or remapped while
+ * polling, so it is checked again under the lock.
+ */
+static void mux_channel_forward(uint8_t channel, int fd, short revents)
+{
+	struct mux_channel *ch = &channels[channel];
+	bool close = false;
+	int ret;
+
+	k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+	if (!slm_mux_active() || ch->fd != fd || atomic_get(&ch->tx_credits) <= 0) {
+		k_mutex_unlock(&mux_ch_mutex);
+		return;
+	}
+
+	if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
+		LOG_WRN("Channel %d: poll() events 0x%08x", channel, revents);
+		close = true;
+	} else {
+		ret = recv(fd, mux_tx_buf, sizeof(mux_tx_buf), MSG_DONTWAIT);
+		if (ret == 0) {
+			close = true;
+		} else if (ret > 0) {
+			atomic_dec(&ch->tx_credits);
+			ch->tx_bytes += ret;
+			/* Sent under the lock, so that no data follows the close frame. */
+			(void)mux_frame_send(channel, MUX_FRAME_DATA, mux_tx_buf, ret);
+		} else if (errno != EAGAIN) {
+			LOG_WRN("Channel %d: recv() error: %d", channel, -errno);
+		}
+	}
+	k_mutex_unlock(&mux_ch_mutex);
+
+	if (close) {
+		mux_channel_close(channel, fd);
+	}
+}
+
+/* Forward socket data to the host on channels that have credits. */
+static void mux_thread_func(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	struct pollfd fds[CONFIG_SLM_MUX_CHANNELS];
+	uint8_t fd_channel[CONFIG_SLM_MUX_CHANNELS];
+	int nfds;
+	int ret;
+
+	while (true) {
+		nfds = 0;
+
+		k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+		for (uint8_t i = 1; i < MUX_CHANNEL_COUNT && slm_mux_active(); i++) {
+			struct mux_channel *ch = &channels[i];
+
+			if (ch->fd == INVALID_SOCKET) {
+				continue;
+			}
+			if (atomic_get(&ch->tx_credits) <= 0) {
+				if (!ch->tx_stalled) {
+					ch->tx_stalled = true;
+					ch->tx_stalls++;
+				}
+				continue;
+			}
+			ch->tx_stalled = false;
+			fds[nfds].fd = ch->fd;
+			fds[nfds].events = POLLIN;
+			fd_channel[nfds] = i;
+			nfds++;
+		}
+		k_mutex_unlock(&mux_ch_mutex);
+
+		if (nfds == 0) {
+			k_sem_take(&mux_sem, K_FOREVER);
+			continue;
+		}
+
+		ret = poll(fds, nfds, MUX_POLL_TIMEOUT_MS);
+		if (ret < 0) {
+			LOG_WRN("poll() error: %d", -errno);
+			k_sleep(K_MSEC(MUX_POLL_TIMEOUT_MS));
+			continue;
+		}
+
+		for (int i = 0; i < nfds && ret > 0; i++) {
+			if (fds[i].revents == 0) {
+				continue;
+			}
+			mux_channel_forward(fd_channel[i], fds[i].fd, fds[i].revents);
+			ret--;
+		}
+	}
+}
+
+/** @brief Handles AT#XMUX commands.
+ *  AT#XMUX=<op>
+ *  AT#XMUX?
+ *  AT#XMUX=?
+ */
+int handle_at_mux(enum at_cmd_type cmd_type)
+{
+	int err = -EINVAL;
+	uint16_t op;
+
+	switch (cmd_type) {
+	case AT_CMD_TYPE_SET_COMMAND:
+		err = at_params_unsigned_short_get(&at_param_list, 1, &op);
+		if (err) {
+			return err;
+		}
+		if (op == MUX_START && !slm_mux_active()) {
+			if (in_datamode()) {
+				return -EBUSY;
+			}
+		} else if (op != MUX_STOP || !slm_mux_active()) {
+			return -EINVAL;
+		}
+		mux_switch_op = op;
+		k_work_reschedule(&mux_switch_work, K_MSEC(MUX_SWITCH_DELAY_MS));
+		break;
+
+	case AT_CMD_TYPE_READ_COMMAND:
+		rsp_send("\r\n#XMUX: %d,%d,%u\r\n", slm_mux_active(), CONFIG_SLM_MUX_CHANNELS,
+			 rx.fcs_errors);
+		err = 0;
+		break;
+
+	case AT_CMD_TYPE_TEST_COMMAND:
+		rsp_send("\r\n#XMUX: (%d,%d)\r\n", MUX_STOP, MUX_START);
+		err = 0;
+		break;
+
+	default:
+		break;
+	}
+
+	return err;
+}
+
+/** @brief Handles AT#XMUXCH commands.
+ *  AT#XMUXCH=<channel>,<handle>
+ *  AT#XMUXCH?
+ *  AT#XMUXCH=?
+ */
+int handle_at_muxch(enum at_cmd_type cmd_type)
+{
+	int err = -EINVAL;
+	uint16_t channel;
+	int handle;
+
+	switch (cmd_type) {
+	case AT_CMD_TYPE_SET_COMMAND:
+		err = at_params_unsigned_short_get(&at_param_list, 1, &channel);
+		if (err) {
+			return err;
+		}
+		err = at_params_int_get(&at_param_list, 2, &handle);
+		if (err) {
+			return err;
+		}
+		if (channel == SLM_MUX_AT_CHANNEL || channel >= MUX_CHANNEL_COUNT) {
+			return -EINVAL;
+		}
+		if (handle < 0) {
+			if (channels[channel].fd == INVALID_SOCKET) {
+				return -EINVAL;
+			}
+			mux_channel_close(channel, channels[channel].fd);
+			break;
+		}
+		for (int i = 1; i < MUX_CHANNEL_COUNT; i++) {
+			if (channels[i].fd == handle) {
+				LOG_ERR("Socket %d already mapped to channel %d", handle, i);
+				return -EBUSY;
+			}
+		}
+
+		k_mutex_lock(&mux_ch_mutex, K_FOREVER);
+		mux_channel_reset(&channels[channel]);
+		channels[channel].fd = handle;
+		k_mutex_unlock(&mux_ch_mutex);
+
+		mux_credit_grant(channel, handle, CONFIG_SLM_MUX_RX_CREDITS);
+		k_sem_give(&mux_sem);
+		break;
+
+	case AT_CMD_TYPE_READ_COMMAND:
+		for (int i = 1; i < MUX_CHANNEL_COUNT; i++) {
+			const struct mux_channel *ch = &channels[i];
+
+			if (ch->fd == INVALID_SOCKET) {
+				continue;
+			}
+			rsp_send("\r\n#XMUXCH: %d,%d,%d,%u,%u,%u,%u\r\n", i, ch->fd,
+				 (int)atomic_get(&ch->tx_credits), ch->rx_bytes, ch->tx_bytes,
+				 ch->rx_dropped, ch->tx_stalls);
+		}
+		err = 0;
+		break;
+
+	case AT_CMD_TYPE_TEST_COMMAND:
+		rsp_send("\r\n#XMUXCH: (1-%d),<handle>\r\n", CONFIG_SLM_MUX_CHANNELS);
+		err = 0;
+		break;
+
+	default:
+		break;
+	}
+
+	return err;
+}
+
+int slm_at_mux_init(void)
+{
+	for (int i = 0; i < MUX_CHANNEL_COUNT; i++) {
+		mux_channel_reset(&channels[i]);
+	}
+	atomic_set(&mux_active, 0);
+	k_work_init_delayable(&mux_switch_work, mux_switch_wk);
+
+	k_thread_create(&mux_thread, mux_thread_stack,
+			K_THREAD_STACK_SIZEOF(mux_thread_stack),
+			mux_thread_func, NULL, NULL, NULL,
+			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+	k_thread_create(&mux_sock_thread, mux_sock_thread_stack,
+			K_THREAD_STACK_SIZEOF(mux_sock_thread_stack),
+			mux_sock_thread_func, NULL, NULL, NULL,
+			THREAD_PRIORITY, K_USER, K_NO_WAIT);
+
+	return 0;
+}
+
+int slm_at_mux_uninit(void)
+{
+	mux_stop();
+	k_thread_abort(&mux_thread);
+	k_thread_abort(&mux_sock_thread);
+
+	return 0;
+}
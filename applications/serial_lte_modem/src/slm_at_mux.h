@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SLM_AT_MUX_
+#define SLM_AT_MUX_
+
+/**@file slm_at_mux.h
+ *
+ * @brief Vendor-specific AT commands and framing for multiplexed mode.
+ *
+ * In multiplexed mode, all traffic on the SLM UART is carried in frames.
+ * Channel 0 carries AT commands and responses. The other channels carry
+ * the data of sockets mapped to them, with credit-based flow control.
+ * @{
+ */
+
+#include <zephyr/types.h>
+
+/** Channel that carries AT commands, responses and notifications. */
+#define SLM_MUX_AT_CHANNEL 0
+
+/**@brief Receive handler for AT channel payload.
+ *
+ * @param buf Received data
+ * @param len Length of data
+ */
+typedef void (*slm_mux_at_rx_t)(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Initialize multiplexed mode AT command parser.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_at_mux_init(void);
+
+/**
+ * @brief Uninitialize multiplexed mode AT command parser.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_at_mux_uninit(void);
+
+/**
+ * @brief Check whether multiplexed mode is active.
+ *
+ * @retval true if yes, false if no.
+ */
+bool slm_mux_active(void);
+
+/**
+ * @brief Process data received from the UART in multiplexed mode.
+ *
+ * @param buf Received data
+ * @param len Length of data
+ * @param at_rx Handler for the payload of the AT channel.
+ */
+void slm_mux_rx(const uint8_t *buf, size_t len, slm_mux_at_rx_t at_rx);
+
+/**
+ * @brief Send data on a channel in multiplexed mode.
+ *
+ * @param channel Channel number
+ * @param data Data to send
+ * @param len Length of data
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_mux_tx(uint8_t channel, const uint8_t *data, size_t len);
+/** @} */
+
+#endif /* SLM_AT_MUX_ */
@@ -61,7 +61,6 @@ static struct slm_socket sock;
 
 /* global variable defined in different files */
 extern struct at_param_list at_param_list;
-extern uint8_t data_buf[SLM_MAX_MESSAGE_SIZE];
 
 /* forward declarations */
 #define SOCKET_SEND_TMO_SEC      30
@@ -711,6 +710,7 @@ static int do_recv(int timeout, int flags)
 {
 	int ret;
 	int sockfd = sock.fd;
+	uint8_t *buf;
 
 	/* For TCP/TLS Server, receive from incoming socket */
 	if (sock.type == SOCK_STREAM && sock.role == AT_SOCKET_ROLE_SERVER) {
@@ -726,9 +726,11 @@ static int do_recv(int timeout, int flags)
 	if (ret) {
 		return ret;
 	}
-	ret = recv(sockfd, (void *)data_buf, sizeof(data_buf), flags);
+	buf = data_buf_get();
+	ret = recv(sockfd, (void *)buf, SLM_MAX_MESSAGE_SIZE, flags);
 	if (ret < 0) {
 		LOG_WRN("recv() error: %d", -errno);
+		data_buf_put(buf);
 		return -errno;
 	}
 	/**
@@ -740,9 +742,10 @@ static int do_recv(int timeout, int flags)
 	 */
 	if (ret == 0) {
 		LOG_WRN("recv() return 0");
+		data_buf_put(buf);
 	} else {
 		rsp_send("\r\n#XRECV: %d\r\n", ret);
-		data_send(data_buf, ret);
+		data_buf_send(buf, ret);
 		ret = 0;
 	}
 
@@ -835,14 +838,17 @@ static int do_recvfrom(int timeout, int flags)
 	int ret;
 	struct sockaddr remote;
 	socklen_t addrlen = sizeof(struct sockaddr);
+	uint8_t *buf;
 
 	ret = socket_poll(sock.fd, POLLIN, timeout);
 	if (ret) {
 		return ret;
 	}
-	ret = recvfrom(sock.fd, (void *)data_buf, sizeof(data_buf), flags, &remote, &addrlen);
+	buf = data_buf_get();
+	ret = recvfrom(sock.fd, (void *)buf, SLM_MAX_MESSAGE_SIZE, flags, &remote, &addrlen);
 	if (ret < 0) {
 		LOG_ERR("recvfrom() error: %d", -errno);
+		data_buf_put(buf);
 		return -errno;
 	}
 	/**
@@ -852,6 +858,7 @@ static int do_recvfrom(int timeout, int flags)
 	 */
 	if (ret == 0) {
 		LOG_WRN("recvfrom() return 0");
+		data_buf_put(buf);
 	} else {
 		char peer_addr[NET_IPV6_ADDR_LEN] = {0};
 
@@ -863,7 +870,7 @@ static int do_recvfrom(int timeout, int flags)
 			    peer_addr, sizeof(peer_addr));
 		}
 		rsp_send("\r\n#XRECVFROM: %d,\"%s\"\r\n", ret, peer_addr);
-		data_send(data_buf, ret);
+		data_buf_send(buf, ret);
 	}
 
 	return 0;
@@ -51,7 +51,6 @@ static struct tcp_proxy {
 
 /* global variable defined in different files */
 extern struct at_param_list at_param_list;
-extern uint8_t data_buf[SLM_MAX_MESSAGE_SIZE];
 
 /** forward declaration of thread function **/
 static void tcpcli_thread_func(void *p1, void *p2, void *p3);
@@ -431,6 +430,7 @@ static void tcpsvr_thread_func(void *p1, void *p2, void *p3)
 {
 	int ret;
 	struct pollfd fds[2];
+	uint8_t *buf;
 
 	ARG_UNUSED(p1);
 	ARG_UNUSED(p2);
@@ -543,20 +543,19 @@ client_events:
 			if ((fds[1].revents & POLLIN) != POLLIN) {
 				continue;
 			}
-			ret = recv(fds[1].fd, (void *)data_buf, sizeof(data_buf), 0);
-			if (ret < 0) {
-				LOG_WRN("recv() error: %d", -errno);
-				continue;
-			}
-			if (ret == 0) {
+			buf = data_buf_get();
+			ret = recv(fds[1].fd, (void *)buf, SLM_MAX_MESSAGE_SIZE, 0);
+			if (ret <= 0) {
+				if (ret < 0) {
+					LOG_WRN("recv() error: %d", -errno);
+				}
+				data_buf_put(buf);
 				continue;
 			}
-			if (in_datamode()) {
-				data_send(data_buf, ret);
-			} else {
+			if (!in_datamode()) {
 				rsp_send("\r\n#XTCPDATA: %d\r\n", ret);
-				data_send(data_buf, ret);
 			}
+			data_buf_send(buf, ret);
 		}
 	}
 
@@ -581,6 +580,7 @@ static void tcpcli_thread_func(void *p1, void *p2, void *p3)
 {
 	int ret;
 	static struct pollfd fds;
+	uint8_t *buf;
 
 	ARG_UNUSED(p1);
 	ARG_UNUSED(p2);
@@ -619,20 +619,19 @@ static void tcpcli_thread_func(void *p1, void *p2, void *p3)
 		if ((fds.revents & POLLIN) != POLLIN) {
 			continue;
 		}
-		ret = recv(fds.fd, (void *)data_buf, sizeof(data_buf), 0);
-		if (ret < 0) {
-			LOG_WRN("recv() error: %d", -errno);
-			continue;
-		}
-		if (ret == 0) {
+		buf = data_buf_get();
+		ret = recv(fds.fd, (void *)buf, SLM_MAX_MESSAGE_SIZE, 0);
+		if (ret <= 0) {
+			if (ret < 0) {
+				LOG_WRN("recv() error: %d", -errno);
+			}
+			data_buf_put(buf);
 			continue;
 		}
-		if (in_datamode()) {
-			data_send(data_buf, ret);
-		} else {
+		if (!in_datamode()) {
 			rsp_send("\r\n#XTCPDATA: %d\r\n", ret);
-			data_send(data_buf, ret);
 		}
+		data_buf_send(buf, ret);
 	}
 
 	if (in_datamode()) {
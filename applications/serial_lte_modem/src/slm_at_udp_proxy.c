@@ -57,7 +57,6 @@ static struct udp_proxy {
 
 /* global variable defined in different files */
 extern struct at_param_list at_param_list;
-extern uint8_t data_buf[SLM_MAX_MESSAGE_SIZE];
 
 /** forward declaration of thread function **/
 static void udp_thread_func(void *p1, void *p2, void *p3);
@@ -370,6 +369,7 @@ static void udp_thread_func(void *p1, void *p2, void *p3)
 {
 	int ret;
 	struct pollfd fds;
+	uint8_t *buf;
 
 	ARG_UNUSED(p1);
 	ARG_UNUSED(p2);
@@ -409,37 +409,36 @@ static void udp_thread_func(void *p1, void *p2, void *p3)
 			continue;
 		}
 
+		buf = data_buf_get();
 		if (proxy.role == UDP_ROLE_SERVER) {
 			/* remember remote from last recvfrom */
 			if (proxy.family == AF_INET) {
 				int size = sizeof(struct sockaddr_in);
 
 				memset(&proxy.remote, 0, sizeof(struct sockaddr_in));
-				ret = recvfrom(proxy.sock, (void *)data_buf, sizeof(data_buf), 0,
+				ret = recvfrom(proxy.sock, (void *)buf, SLM_MAX_MESSAGE_SIZE, 0,
 					(struct sockaddr *)&(proxy.remote), &size);
 			} else {
 				int size = sizeof(struct sockaddr_in6);
 
 				memset(&proxy.remote6, 0, sizeof(struct sockaddr_in6));
-				ret = recvfrom(proxy.sock, (void *)data_buf, sizeof(data_buf), 0,
+				ret = recvfrom(proxy.sock, (void *)buf, SLM_MAX_MESSAGE_SIZE, 0,
 					(struct sockaddr *)&(proxy.remote6), &size);
 			}
 		} else {
-			ret = recv(proxy.sock, (void *)data_buf, sizeof(data_buf), 0);
+			ret = recv(proxy.sock, (void *)buf, SLM_MAX_MESSAGE_SIZE, 0);
 		}
-		if (ret < 0) {
-			LOG_WRN("recv() error: %d", -errno);
-			continue;
-		}
-		if (ret == 0) {
+		if (ret <= 0) {
+			if (ret < 0) {
+				LOG_WRN("recv() error: %d", -errno);
+			}
+			data_buf_put(buf);
 			continue;
 		}
-		if (in_datamode()) {
-			data_send(data_buf, ret);
-		} else {
+		if (!in_datamode()) {
 			rsp_send("\r\n#XUDPDATA: %d\r\n", ret);
-			data_send(data_buf, ret);
 		}
+		data_buf_send(buf, ret);
 	} while (true);
 
 	if (in_datamode()) {
@@ -51,6 +51,40 @@ K_MSGQ_DEFINE(rx_event_queue, sizeof(struct rx_event_t), UART_RX_EVENT_COUNT, 4)
 RING_BUF_DECLARE(tx_buf, CONFIG_SLM_UART_TX_BUF_SIZE);
 K_MUTEX_DEFINE(mutex_tx_put); /* Protects the tx_buf from multiple writes. */
 
+/* Reference counted buffers that are sent without copying them to tx_buf. */
+struct tx_zc_buf_t {
+	atomic_t ref_counter;
+	uint8_t buf[SLM_UART_TX_ZC_BUF_SIZE];
+};
+
+#if CONFIG_SLM_UART_TX_ZC_BUF_COUNT > 0
+#define UART_TX_SLAB_BLOCK_SIZE sizeof(struct tx_zc_buf_t)
+BUILD_ASSERT((sizeof(struct tx_zc_buf_t) % UART_SLAB_ALIGNMENT) == 0);
+K_MEM_SLAB_DEFINE(tx_slab, UART_TX_SLAB_BLOCK_SIZE, CONFIG_SLM_UART_TX_ZC_BUF_COUNT,
+		  UART_SLAB_ALIGNMENT);
+#endif
+
+/* Scatter-gather TX queue. Each entry is either a zero-copy buffer, or a run of */
+/* bytes in tx_buf. Entries are sent in order, one UART transfer at a time. */
+struct tx_desc_t {
+	uint8_t *buf;	/* Zero-copy data, or NULL for data in tx_buf */
+	size_t len;
+};
+#define UART_TX_DESC_COUNT (2 * CONFIG_SLM_UART_TX_ZC_BUF_COUNT + 2)
+static struct tx_desc_t tx_queue[UART_TX_DESC_COUNT];
+static size_t tx_queue_head;
+static size_t tx_queue_count;
+static struct k_spinlock tx_queue_lock;
+
+static struct {
+	uint32_t bytes;
+	uint32_t busy_ms;
+	uint32_t stall_ms;
+	uint32_t stalls;
+	uint32_t start_time;
+	uint32_t tx_start_time;
+} tx_stats;
+
 enum uart_recovery_state {
 	RECOVERY_IDLE,
 	RECOVERY_ONGOING,
@@ -58,7 +92,8 @@ enum uart_recovery_state {
 };
 static atomic_t recovery_state;
 
-K_SEM_DEFINE(tx_done_sem, 0, 1);
+K_SEM_DEFINE(tx_done_sem, 0, 1); /* Available when no UART transfer is ongoing. */
+K_SEM_DEFINE(tx_space_sem, 0, 1); /* Given when a UART transfer completes. */
 
 slm_uart_rx_callback_t rx_callback_t;
 
@@ -190,12 +225,119 @@ static void rx_process(struct k_work *work)
 	rx_recovery();
 }
 
+#if CONFIG_SLM_UART_TX_ZC_BUF_COUNT > 0
+static inline struct tx_zc_buf_t *tx_block_start_get(const uint8_t *buf)
+{
+	size_t block_num;
+
+	/* Zero-copy data can start anywhere within a block, like RX data. */
+	block_num =
+		(((size_t)buf - (size_t)tx_slab.buffer) / UART_TX_SLAB_BLOCK_SIZE);
+
+	return (struct tx_zc_buf_t *) &tx_slab.buffer[block_num * UART_TX_SLAB_BLOCK_SIZE];
+}
+
+static bool tx_is_zc_buf(const uint8_t *buf)
+{
+	return buf >= (uint8_t *)tx_slab.buffer &&
+	       buf < (uint8_t *)tx_slab.buffer +
+		     UART_TX_SLAB_BLOCK_SIZE * CONFIG_SLM_UART_TX_ZC_BUF_COUNT;
+}
+#endif
+
+uint8_t *slm_uart_tx_buf_alloc(k_timeout_t timeout)
+{
+#if CONFIG_SLM_UART_TX_ZC_BUF_COUNT > 0
+	struct tx_zc_buf_t *buf;
+
+	if (k_mem_slab_alloc(&tx_slab, (void **)&buf, timeout)) {
+		return NULL;
+	}
+
+	atomic_set(&buf->ref_counter, 1);
+
+	return buf->buf;
+#else
+	ARG_UNUSED(timeout);
+
+	return NULL;
+#endif
+}
+
+void slm_uart_tx_buf_ref(const uint8_t *buf)
+{
+#if CONFIG_SLM_UART_TX_ZC_BUF_COUNT > 0
+	if (tx_is_zc_buf(buf)) {
+		atomic_inc(&(tx_block_start_get(buf)->ref_counter));
+	}
+#else
+	ARG_UNUSED(buf);
+#endif
+}
+
+void slm_uart_tx_buf_unref(const uint8_t *buf)
+{
+#if CONFIG_SLM_UART_TX_ZC_BUF_COUNT > 0
+	struct tx_zc_buf_t *zc_buf;
+	atomic_t ref_counter;
+
+	if (!tx_is_zc_buf(buf)) {
+		return;
+	}
+	zc_buf = tx_block_start_get(buf);
+	ref_counter = atomic_dec(&zc_buf->ref_counter);
+
+	/* ref_counter is the zc_buf->ref_counter value prior to decrement */
+	if (ref_counter == 1) {
+		k_mem_slab_free(&tx_slab, (void **)&zc_buf);
+	}
+#else
+	ARG_UNUSED(buf);
+#endif
+}
+
+/* Check whether data written to tx_buf can be added to the TX queue. */
+static bool tx_queue_ring_ready(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&tx_queue_lock);
+	bool ready = tx_queue_count < UART_TX_DESC_COUNT ||
+		     tx_queue[(tx_queue_head + tx_queue_count - 1) % UART_TX_DESC_COUNT].buf == NULL;
+
+	k_spin_unlock(&tx_queue_lock, key);
+
+	return ready;
+}
+
+/* Add len bytes written to tx_buf to the TX queue. Only called with mutex_tx_put held, */
+/* after tx_queue_ring_ready(), so there is room for the bytes. */
+static void tx_queue_ring_add(size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&tx_queue_lock);
+	struct tx_desc_t *tail;
+
+	if (tx_queue_count > 0) {
+		tail = &tx_queue[(tx_queue_head + tx_queue_count - 1) % UART_TX_DESC_COUNT];
+		if (tail->buf == NULL) {
+			tail->len += len;
+			k_spin_unlock(&tx_queue_lock, key);
+			return;
+		}
+	}
+	tail = &tx_queue[(tx_queue_head + tx_queue_count) % UART_TX_DESC_COUNT];
+	tail->buf = NULL;
+	tail->len = len;
+	tx_queue_count++;
+	k_spin_unlock(&tx_queue_lock, key);
+}
+
 static int tx_start(void)
 {
+	struct tx_desc_t desc;
 	uint8_t *buf;
-	size_t ret;
+	size_t len;
 	int err;
 	enum pm_device_state state = PM_DEVICE_STATE_OFF;
+	k_spinlock_key_t key;
 
 	(void)pm_device_state_get(uart_dev, &state);
 	if (state != PM_DEVICE_STATE_ACTIVE) {
@@ -203,17 +345,95 @@ static int tx_start(void)
 		return -ENODEV;
 	}
 
-	ret = ring_buf_get_claim(&tx_buf, &buf, ring_buf_capacity_get(&tx_buf));
-	err = uart_tx(uart_dev, buf, ret, SYS_FOREVER_US);
+	key = k_spin_lock(&tx_queue_lock);
+	if (tx_queue_count == 0) {
+		k_spin_unlock(&tx_queue_lock, key);
+		return -ENODATA;
+	}
+	desc = tx_queue[tx_queue_head];
+	k_spin_unlock(&tx_queue_lock, key);
+
+	if (desc.buf) {
+		buf = desc.buf;
+		len = desc.len;
+	} else {
+		len = ring_buf_get_claim(&tx_buf, &buf, desc.len);
+	}
+
+	tx_stats.tx_start_time = k_uptime_get_32();
+	err = uart_tx(uart_dev, buf, len, SYS_FOREVER_US);
 	if (err) {
 		LOG_ERR("UART TX error: %d", err);
-		(void)ring_buf_get_finish(&tx_buf, 0);
+		if (desc.buf == NULL) {
+			(void)ring_buf_get_finish(&tx_buf, 0);
+		}
 		return err;
 	}
 
 	return 0;
 }
 
+/* Start TX unless a transfer is already ongoing. */
+static int tx_kick(void)
+{
+	int err;
+
+	if (k_sem_take(&tx_done_sem, K_NO_WAIT) != 0) {
+		/* TX already in progress. */
+		return 0;
+	}
+
+	err = tx_start();
+	if (err) {
+		k_sem_give(&tx_done_sem);
+	}
+
+	return (err == -ENODATA) ? 0 : err;
+}
+
+/* Release the sent part of the head of the TX queue. */
+static void tx_complete(size_t len)
+{
+	struct tx_desc_t *head;
+	uint8_t *zc_buf = NULL;
+	int err;
+	k_spinlock_key_t key = k_spin_lock(&tx_queue_lock);
+
+	tx_stats.bytes += len;
+	tx_stats.busy_ms += k_uptime_get_32() - tx_stats.tx_start_time;
+
+	head = &tx_queue[tx_queue_head];
+	if (tx_queue_count == 0) {
+		k_spin_unlock(&tx_queue_lock, key);
+		return;
+	}
+	if (head->buf) {
+		/* Zero-copy buffers are sent as a whole, or dropped if aborted. */
+		zc_buf = head->buf;
+		head->len = 0;
+	} else {
+		err = ring_buf_get_finish(&tx_buf, len);
+		if (err) {
+			LOG_ERR("UART TX finish failure: %d", err);
+		}
+		head->len -= MIN(len, head->len);
+	}
+	if (head->len == 0) {
+		tx_queue_head = (tx_queue_head + 1) % UART_TX_DESC_COUNT;
+		tx_queue_count--;
+	}
+	k_spin_unlock(&tx_queue_lock, key);
+
+	if (zc_buf) {
+		slm_uart_tx_buf_unref(zc_buf);
+	}
+	k_sem_give(&tx_space_sem);
+
+	if (tx_start() != 0) {
+		k_sem_give(&tx_done_sem);
+	}
+}
+
 static void uart_callback(const struct device *dev, struct uart_event *evt, void *user_data)
 {
 	struct rx_buf_t *buf;
@@ -225,26 +445,11 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 
 	switch (evt->type) {
 	case UART_TX_DONE:
-		err = ring_buf_get_finish(&tx_buf, evt->data.tx.len);
-		if (err) {
-			LOG_ERR("UART_TX_DONE failure: %d", err);
-		}
-		if (ring_buf_is_empty(&tx_buf) == false) {
-			(void)tx_start();
-		} else {
-			k_sem_give(&tx_done_sem);
-		}
+		tx_complete(evt->data.tx.len);
 		break;
 	case UART_TX_ABORTED:
-		err = ring_buf_get_finish(&tx_buf, evt->data.tx.len);
-		if (err) {
-			LOG_ERR("UART_TX_ABORTED failure: %d", err);
-		}
-		if (ring_buf_is_empty(&tx_buf) == false) {
-			(void)tx_start();
-		} else {
-			k_sem_give(&tx_done_sem);
-		}
+		LOG_WRN("UART_TX_ABORTED, sent: %d", evt->data.tx.len);
+		tx_complete(evt->data.tx.len);
 		break;
 	case UART_RX_RDY:
 		rx_buf_ref(evt->data.rx.buf);
@@ -312,7 +517,7 @@ int poweron_uart(void)
 	}
 
 	k_sem_give(&tx_done_sem);
-	(void)tx_start();
+	(void)tx_kick();
 
 	return 0;
 }
@@ -347,6 +552,15 @@ int slm_uart_configure(void)
 	return err;
 }
 
+static void tx_stall_wait(void)
+{
+	uint32_t start = k_uptime_get_32();
+
+	k_sem_take(&tx_space_sem, K_FOREVER);
+	tx_stats.stall_ms += k_uptime_get_32() - start;
+	tx_stats.stalls++;
+}
+
 /* Write the data to tx_buffer and trigger sending. */
 int slm_uart_tx_write(const uint8_t *data, size_t len)
 {
@@ -356,40 +570,121 @@ int slm_uart_tx_write(const uint8_t *data, size_t len)
 
 	k_mutex_lock(&mutex_tx_put, K_FOREVER);
 	while (sent < len) {
-		ret = ring_buf_put(&tx_buf, data + sent, len - sent);
+		/* The queue may be full of zero-copy buffers. */
+		ret = tx_queue_ring_ready() ? ring_buf_put(&tx_buf, data + sent, len - sent) : 0;
 		if (ret) {
+			tx_queue_ring_add(ret);
 			sent += ret;
-		} else {
-			/* Buffer full, block and and start TX. */
-			k_sem_take(&tx_done_sem, K_FOREVER);
-			err = tx_start();
-			if (err) {
-				LOG_ERR("TX buf overflow, %d dropped. Unable to send: %d",
-					len - sent,
-					err);
-				k_sem_give(&tx_done_sem);
-				k_mutex_unlock(&mutex_tx_put);
-				return err;
-			}
+			continue;
 		}
+		/* Buffer full, start TX and block until a transfer completes. */
+		err = tx_kick();
+		if (err) {
+			LOG_ERR("TX buf overflow, %d dropped. Unable to send: %d",
+				len - sent,
+				err);
+			k_mutex_unlock(&mutex_tx_put);
+			return err;
+		}
+		tx_stall_wait();
 	}
 	k_mutex_unlock(&mutex_tx_put);
 
-	if (k_sem_take(&tx_done_sem, K_NO_WAIT) == 0) {
-		err = tx_start();
-		if (err == -ENODEV) {
-			k_sem_give(&tx_done_sem);
-			return 0;
-		} else if (err) {
-			LOG_ERR("TX start failed: %d", err);
-			k_sem_give(&tx_done_sem);
+	err = tx_kick();
+	if (err == -ENODEV) {
+		/* Sent when the UART is powered on. */
+		return 0;
+	} else if (err) {
+		LOG_ERR("TX start failed: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+
+int slm_uart_tx_buf_send(const uint8_t *buf, size_t len)
+{
+#if CONFIG_SLM_UART_TX_ZC_BUF_COUNT > 0
+	k_spinlock_key_t key;
+	struct tx_desc_t *tail;
+	int err;
+
+	if (!tx_is_zc_buf(buf)) {
+		return slm_uart_tx_write(buf, len);
+	}
+	if (len == 0) {
+		return 0;
+	}
+
+	/* Keep the order with slm_uart_tx_write(). */
+	k_mutex_lock(&mutex_tx_put, K_FOREVER);
+	while (true) {
+		key = k_spin_lock(&tx_queue_lock);
+		if (tx_queue_count < UART_TX_DESC_COUNT) {
+			break;
+		}
+		k_spin_unlock(&tx_queue_lock, key);
+
+		err = tx_kick();
+		if (err) {
+			LOG_ERR("TX queue full, %d dropped. Unable to send: %d", len, err);
+			k_mutex_unlock(&mutex_tx_put);
 			return err;
 		}
-	} else {
-		/* TX already in progress. */
+		tx_stall_wait();
+	}
+	slm_uart_tx_buf_ref(buf);
+	tail = &tx_queue[(tx_queue_head + tx_queue_count) % UART_TX_DESC_COUNT];
+	tail->buf = (uint8_t *)buf;
+	tail->len = len;
+	tx_queue_count++;
+	k_spin_unlock(&tx_queue_lock, key);
+	k_mutex_unlock(&mutex_tx_put);
+
+	err = tx_kick();
+	if (err == -ENODEV) {
+		/* Sent when the UART is powered on. */
+		return 0;
+	} else if (err) {
+		LOG_ERR("TX start failed: %d", err);
+		return err;
 	}
 
 	return 0;
+#else
+	return slm_uart_tx_write(buf, len);
+#endif
+}
+
+void slm_uart_tx_stats_get(struct slm_uart_tx_stats *stats)
+{
+	uint32_t elapsed_ms = k_uptime_get_32() - tx_stats.start_time;
+	uint64_t capacity;
+
+	stats->bytes = tx_stats.bytes;
+	stats->busy_ms = tx_stats.busy_ms;
+	stats->stall_ms = tx_stats.stall_ms;
+	stats->stalls = tx_stats.stalls;
+	stats->elapsed_ms = elapsed_ms;
+
+	/* Start bit, data bits, optional parity bit and stop bits. */
+	capacity = (uint64_t)slm_uart.baudrate * elapsed_ms /
+		   (MSEC_PER_SEC * (1 + 5 + slm_uart.data_bits +
+				   (slm_uart.parity != UART_CFG_PARITY_NONE) +
+				   (slm_uart.stop_bits >= UART_CFG_STOP_BITS_1_5 ? 2 : 1)));
+	stats->utilization = capacity ? (uint32_t)(100 * (uint64_t)tx_stats.bytes / capacity) : 0;
+}
+
+void slm_uart_tx_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&tx_queue_lock);
+
+	tx_stats.bytes = 0;
+	tx_stats.busy_ms = 0;
+	tx_stats.stall_ms = 0;
+	tx_stats.stalls = 0;
+	tx_stats.start_time = k_uptime_get_32();
+	k_spin_unlock(&tx_queue_lock, key);
 }
 
 int slm_uart_handler_init(slm_uart_rx_callback_t callback_t)
@@ -455,6 +750,7 @@ int slm_uart_handler_init(slm_uart_rx_callback_t callback_t)
 	k_work_init_delayable(&rx_process_work, rx_process);
 
 	k_sem_give(&tx_done_sem);
+	slm_uart_tx_stats_reset();
 
 	err = slm_uart_tx_write(SLM_SYNC_STR, sizeof(SLM_SYNC_STR)-1);
 	if (err) {
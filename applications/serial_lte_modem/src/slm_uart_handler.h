@@ -7,8 +7,14 @@
 #ifndef SLM_UART_HANDLER_
 #define SLM_UART_HANDLER_
 
+#include <zephyr/kernel.h>
+#include "slm_defines.h"
+
 #define UART_RX_MARGIN_MS	10
 
+/** Size of a zero-copy TX buffer. */
+#define SLM_UART_TX_ZC_BUF_SIZE	SLM_MAX_MESSAGE_SIZE
+
 /**@file slm_uart_handler.h
  *
  * @brief UART handler for serial LTE modem
@@ -33,6 +39,73 @@ typedef void (*slm_uart_rx_callback_t)(const uint8_t *data, size_t len);
  */
 int slm_uart_tx_write(const uint8_t *data, size_t len);
 
+/**
+ * @brief Allocate a zero-copy TX buffer of @ref SLM_UART_TX_ZC_BUF_SIZE bytes.
+ *
+ * The buffer is returned with one reference held by the caller.
+ *
+ * @param timeout Time to wait for a free buffer.
+ *
+ * @return Pointer to the buffer, or NULL if none is available or
+ *         CONFIG_SLM_UART_TX_ZC_BUF_COUNT is 0.
+ */
+uint8_t *slm_uart_tx_buf_alloc(k_timeout_t timeout);
+
+/**
+ * @brief Take a reference to a zero-copy TX buffer.
+ *
+ * Other pointers are ignored.
+ *
+ * @param buf Pointer within the buffer
+ */
+void slm_uart_tx_buf_ref(const uint8_t *buf);
+
+/**
+ * @brief Release a reference to a zero-copy TX buffer.
+ *
+ * The buffer is freed when the last reference is released. Other pointers are ignored.
+ *
+ * @param buf Pointer within the buffer
+ */
+void slm_uart_tx_buf_unref(const uint8_t *buf);
+
+/**
+ * @brief Queue data of a zero-copy TX buffer for sending without copying it.
+ *
+ * A reference to the buffer is held until the data has been sent, so the caller
+ * may release its own reference right away. Data that is not in a zero-copy
+ * buffer is written with @ref slm_uart_tx_write.
+ *
+ * @param buf Data to send
+ * @param len Length of data
+ *
+ * @retval 0 If the data was successfully queued.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_uart_tx_buf_send(const uint8_t *buf, size_t len);
+
+/**@brief UART TX statistics. */
+struct slm_uart_tx_stats {
+	uint32_t bytes;		/* Bytes sent */
+	uint32_t busy_ms;	/* Time spent in UART transfers */
+	uint32_t stall_ms;	/* Time writers were blocked waiting for TX space */
+	uint32_t stalls;	/* Number of times writers were blocked */
+	uint32_t elapsed_ms;	/* Time since the statistics were reset */
+	uint32_t utilization;	/* Bytes sent, in percent of what the baud rate allows */
+};
+
+/**
+ * @brief Get UART TX statistics.
+ *
+ * @param stats Statistics to fill
+ */
+void slm_uart_tx_stats_get(struct slm_uart_tx_stats *stats);
+
+/**
+ * @brief Reset UART TX statistics.
+ */
+void slm_uart_tx_stats_reset(void);
+
 /**
  * @brief Initialize SLM UART handler for serial LTE modem
  *
@@ -17,6 +17,9 @@
 #include "host_rpu_common_if.h"
 #include "osal_api.h"
 #include "bal_api.h"
+#ifdef CONFIG_NRF700X_TX_COALESCE
+#include "hal_tx_coalesce.h"
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 
 #define MAX_HAL_RPU_READY_WAIT (1 * 1000 * 1000) /* 1 sec */
 
@@ -180,6 +183,7 @@ struct wifi_nrf_hal_buf_map_info {
  * @num_events: Debug counter for number of events received from the RPU.
  * @num_events_resubmit: Debug counter for number of event pointers
  *                       resubmitted back to the RPU.
+ * @tx_coalesce: Context used to coalesce the writes of TX frames to the RPU.
  *
  * This structure maintains the context information necessary for the
  * operation of the HAL. Some of the elements of the structure need to be
@@ -219,6 +223,9 @@ struct wifi_nrf_hal_dev_ctx {
 	unsigned long addr_rpu_pktram_base_rx;
 	unsigned long addr_rpu_pktram_base_rx_pool[MAX_NUM_OF_RX_QUEUES];
 	unsigned long tx_frame_offset;
+#ifdef CONFIG_NRF700X_TX_COALESCE
+	struct hal_tx_coalesce tx_coalesce;
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 #ifdef CONFIG_NRF_WIFI_LOW_POWER
 	enum RPU_PS_STATE rpu_ps_state;
 	void *rpu_ps_timer;
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @brief Header containing declarations for coalescing the TX frame writes
+ * to the RPU packet RAM in the HAL Layer of the Wi-Fi driver.
+ */
+
+#ifndef __HAL_TX_COALESCE_H__
+#define __HAL_TX_COALESCE_H__
+
+#include "osal_api.h"
+
+/**
+ * hal_tx_coalesce_write_fn - Callback used to write a block to the RPU memory.
+ * @ctx: Context passed to hal_tx_coalesce_add() / hal_tx_coalesce_flush().
+ * @rpu_addr: Absolute RPU memory address where the block is to be written.
+ * @data: Pointer to the host memory holding the block.
+ * @len: Length (in bytes) of the block.
+ */
+typedef enum wifi_nrf_status (*hal_tx_coalesce_write_fn)(void *ctx,
+							 unsigned int rpu_addr,
+							 void *data,
+							 unsigned int len);
+
+/**
+ * struct hal_tx_coalesce_stats - Bus statistics of the TX coalescing layer.
+ * @bus_writes: Number of write transactions issued on the bus.
+ * @bus_bytes: Number of bytes written on the bus (including padding).
+ * @frames: Number of frames passed to the coalescing layer.
+ */
+struct hal_tx_coalesce_stats {
+	unsigned long bus_writes;
+	unsigned long bus_bytes;
+	unsigned long frames;
+};
+
+/**
+ * struct hal_tx_coalesce - TX coalescing context.
+ * @opriv: Pointer to the OSAL context.
+ * @buf: Staging buffer in host memory.
+ * @buf_size: Size (in bytes) of the staging buffer.
+ * @start_addr: RPU memory address of the first staged byte.
+ * @len: Number of staged bytes.
+ * @stats: Bus statistics.
+ *
+ * Frames which are placed back to back in the RPU packet RAM are collected
+ * in the staging buffer and written to the RPU in a single bus transaction.
+ */
+struct hal_tx_coalesce {
+	struct wifi_nrf_osal_priv *opriv;
+	unsigned char *buf;
+	unsigned int buf_size;
+	unsigned int start_addr;
+	unsigned int len;
+	struct hal_tx_coalesce_stats stats;
+};
+
+/**
+ * hal_tx_coalesce_init() - Initialize the TX coalescing context.
+ * @txc: Pointer to the TX coalescing context.
+ * @opriv: Pointer to the OSAL context.
+ * @buf: Staging buffer. If NULL, every frame is written directly.
+ * @buf_size: Size (in bytes) of the staging buffer.
+ */
+void hal_tx_coalesce_init(struct hal_tx_coalesce *txc,
+			  struct wifi_nrf_osal_priv *opriv,
+			  void *buf,
+			  unsigned int buf_size);
+
+/**
+ * hal_tx_coalesce_add() - Add a frame to be written to the RPU memory.
+ * @txc: Pointer to the TX coalescing context.
+ * @rpu_addr: Absolute RPU memory address where the frame is to be written.
+ * @data: Pointer to the frame in host memory.
+ * @len: Length (in bytes) of the frame.
+ * @write: Callback used to write to the RPU memory.
+ * @ctx: Context passed to @write.
+ *
+ * The frame is copied to the staging buffer if it is placed after the
+ * staged frames and fits in the buffer, any gap in between is zero filled.
+ * Otherwise the staged frames are flushed first. Frames which do not fit in
+ * an empty staging buffer are written directly.
+ *
+ * Return: Status
+ *		Pass : %WIFI_NRF_STATUS_SUCCESS
+ *		Error: %WIFI_NRF_STATUS_FAIL
+ */
+enum wifi_nrf_status hal_tx_coalesce_add(struct hal_tx_coalesce *txc,
+					 unsigned int rpu_addr,
+					 void *data,
+					 unsigned int len,
+					 hal_tx_coalesce_write_fn write,
+					 void *ctx);
+
+/**
+ * hal_tx_coalesce_flush() - Write the staged frames to the RPU memory.
+ * @txc: Pointer to the TX coalescing context.
+ * @write: Callback used to write to the RPU memory.
+ * @ctx: Context passed to @write.
+ *
+ * Return: Status
+ *		Pass : %WIFI_NRF_STATUS_SUCCESS
+ *		Error: %WIFI_NRF_STATUS_FAIL
+ */
+enum wifi_nrf_status hal_tx_coalesce_flush(struct hal_tx_coalesce *txc,
+					   hal_tx_coalesce_write_fn write,
+					   void *ctx);
+
+/**
+ * hal_tx_coalesce_discard() - Drop the staged frames without writing them.
+ * @txc: Pointer to the TX coalescing context.
+ */
+void hal_tx_coalesce_discard(struct hal_tx_coalesce *txc);
+
+#endif /* __HAL_TX_COALESCE_H__ */
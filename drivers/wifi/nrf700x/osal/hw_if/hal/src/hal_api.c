@@ -172,6 +172,20 @@ out:
 }
 
 
+#ifdef CONFIG_NRF700X_TX_COALESCE
+static enum wifi_nrf_status hal_tx_coalesce_rpu_write(void *ctx,
+						      unsigned int rpu_addr,
+						      void *data,
+						      unsigned int len)
+{
+	return hal_rpu_mem_write((struct wifi_nrf_hal_dev_ctx *)ctx,
+				 rpu_addr,
+				 data,
+				 len);
+}
+#endif /* CONFIG_NRF700X_TX_COALESCE */
+
+
 unsigned long wifi_nrf_hal_buf_map_tx(struct wifi_nrf_hal_dev_ctx *hal_dev_ctx,
 				      unsigned long buf,
 				      unsigned int buf_len,
@@ -209,6 +223,19 @@ unsigned long wifi_nrf_hal_buf_map_tx(struct wifi_nrf_hal_dev_ctx *hal_dev_ctx,
 
 	if (buf_indx == 0) {
 		hal_dev_ctx->tx_frame_offset = tx_token_base_addr;
+#ifdef CONFIG_NRF700X_TX_COALESCE
+		/* Frames of a new aggregate, make sure nothing staged
+		 * for a previous one is left behind.
+		 */
+		if (hal_tx_coalesce_flush(&hal_dev_ctx->tx_coalesce,
+					  hal_tx_coalesce_rpu_write,
+					  hal_dev_ctx) != WIFI_NRF_STATUS_SUCCESS) {
+			wifi_nrf_osal_log_err(hal_dev_ctx->hpriv->opriv,
+					      "%s: Copying TX frames to RPU failed\n",
+					      __func__);
+			goto out;
+		}
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 	}
 
 	bounce_buf_addr = hal_dev_ctx->tx_frame_offset;
@@ -230,10 +257,27 @@ unsigned long wifi_nrf_hal_buf_map_tx(struct wifi_nrf_hal_dev_ctx *hal_dev_ctx,
 	       buf_len,
 	       hal_dev_ctx->tx_frame_offset);
 
+#ifdef CONFIG_NRF700X_TX_COALESCE
+	/* Written to the RPU when the TX command is sent */
+	if (hal_tx_coalesce_add(&hal_dev_ctx->tx_coalesce,
+				(unsigned int)rpu_addr,
+				(void *)buf,
+				buf_len,
+				hal_tx_coalesce_rpu_write,
+				hal_dev_ctx) != WIFI_NRF_STATUS_SUCCESS) {
+		wifi_nrf_osal_log_err(hal_dev_ctx->hpriv->opriv,
+				      "%s: Copying TX frame to RPU failed\n",
+				      __func__);
+		/* The aggregate will not be sent, drop what is staged for it */
+		hal_tx_coalesce_discard(&hal_dev_ctx->tx_coalesce);
+		goto out;
+	}
+#else
 	hal_rpu_mem_write(hal_dev_ctx,
 			  (unsigned int)rpu_addr,
 			  (void *)buf,
 			  buf_len);
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 
 	addr_to_map = bounce_buf_addr;
 
@@ -246,6 +290,9 @@ unsigned long wifi_nrf_hal_buf_map_tx(struct wifi_nrf_hal_dev_ctx *hal_dev_ctx,
 		wifi_nrf_osal_log_err(hal_dev_ctx->hpriv->opriv,
 				      "%s: DMA map failed\n",
 				      __func__);
+#ifdef CONFIG_NRF700X_TX_COALESCE
+		hal_tx_coalesce_discard(&hal_dev_ctx->tx_coalesce);
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 		goto out;
 	}
 	tx_buf_info->buf_len = buf_len;
@@ -944,6 +991,24 @@ enum wifi_nrf_status wifi_nrf_hal_data_cmd_send(struct wifi_nrf_hal_dev_ctx *hal
 		host_addr |= RPU_MCU_CORE_INDIRECT_BASE;
 	}
 
+#ifdef CONFIG_NRF700X_TX_COALESCE
+	/* The frames need to be in the RPU before the command referring
+	 * to them.
+	 */
+	if (cmd_type == WIFI_NRF_HAL_MSG_TYPE_CMD_DATA_TX) {
+		status = hal_tx_coalesce_flush(&hal_dev_ctx->tx_coalesce,
+					       hal_tx_coalesce_rpu_write,
+					       hal_dev_ctx);
+
+		if (status != WIFI_NRF_STATUS_SUCCESS) {
+			wifi_nrf_osal_log_err(hal_dev_ctx->hpriv->opriv,
+					      "%s: Copying TX frames to RPU failed\n",
+					      __func__);
+			goto out;
+		}
+	}
+#endif /* CONFIG_NRF700X_TX_COALESCE */
+
 	/* Copy the information to the suggested address */
 	status = hal_rpu_mem_write(hal_dev_ctx,
 				   host_addr,
@@ -1196,6 +1261,20 @@ struct wifi_nrf_hal_dev_ctx *wifi_nrf_hal_dev_add(struct wifi_nrf_hal_priv *hpri
 				      __func__);
 		goto rx_buf_free;
 	}
+#ifdef CONFIG_NRF700X_TX_COALESCE
+	hal_tx_coalesce_init(&hal_dev_ctx->tx_coalesce,
+			     hpriv->opriv,
+			     wifi_nrf_osal_mem_alloc(hpriv->opriv,
+						     CONFIG_NRF700X_TX_COALESCE_BUF_SIZE),
+			     CONFIG_NRF700X_TX_COALESCE_BUF_SIZE);
+
+	if (!hal_dev_ctx->tx_coalesce.buf) {
+		wifi_nrf_osal_log_err(hpriv->opriv,
+				      "%s: No space for TX coalescing buffer\n",
+				      __func__);
+		goto tx_buf_free;
+	}
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 #endif /* CONFIG_NRF700X_DATA_TX */
 
 	status = wifi_nrf_hal_rpu_pktram_buf_map_init(hal_dev_ctx);
@@ -1205,7 +1284,11 @@ struct wifi_nrf_hal_dev_ctx *wifi_nrf_hal_dev_add(struct wifi_nrf_hal_priv *hpri
 				      "%s: Buffer map init failed\n",
 				      __func__);
 #ifdef CONFIG_NRF700X_DATA_TX
+#ifdef CONFIG_NRF700X_TX_COALESCE
+		goto tx_coalesce_free;
+#else
 		goto tx_buf_free;
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 #endif /* CONFIG_NRF700X_DATA_TX */
 	}
 #endif /* !CONFIG_NRF700X_RADIO_TEST */
@@ -1213,6 +1296,12 @@ struct wifi_nrf_hal_dev_ctx *wifi_nrf_hal_dev_add(struct wifi_nrf_hal_priv *hpri
 	return hal_dev_ctx;
 #ifndef CONFIG_NRF700X_RADIO_TEST
 #ifdef CONFIG_NRF700X_DATA_TX
+#ifdef CONFIG_NRF700X_TX_COALESCE
+tx_coalesce_free:
+	wifi_nrf_osal_mem_free(hpriv->opriv,
+			       hal_dev_ctx->tx_coalesce.buf);
+	hal_dev_ctx->tx_coalesce.buf = NULL;
+#endif /* CONFIG_NRF700X_TX_COALESCE */
 tx_buf_free:
 	wifi_nrf_osal_mem_free(hpriv->opriv,
 			       hal_dev_ctx->tx_buf_info);
@@ -1263,6 +1352,12 @@ void wifi_nrf_hal_dev_rem(struct wifi_nrf_hal_dev_ctx *hal_dev_ctx)
 			       hal_dev_ctx->tx_buf_info);
 	hal_dev_ctx->tx_buf_info = NULL;
 
+#ifdef CONFIG_NRF700X_TX_COALESCE
+	wifi_nrf_osal_mem_free(hal_dev_ctx->hpriv->opriv,
+			       hal_dev_ctx->tx_coalesce.buf);
+	hal_dev_ctx->tx_coalesce.buf = NULL;
+#endif /* CONFIG_NRF700X_TX_COALESCE */
+
 	for (i = 0; i < MAX_NUM_OF_RX_QUEUES; i++) {
 		wifi_nrf_osal_mem_free(hal_dev_ctx->hpriv->opriv,
 				       hal_dev_ctx->rx_buf_info[i]);
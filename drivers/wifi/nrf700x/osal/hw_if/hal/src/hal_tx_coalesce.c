@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @brief File containing the TX coalescing layer of the HAL Layer of the
+ * Wi-Fi driver.
+ */
+
+#include "hal_tx_coalesce.h"
+
+static enum wifi_nrf_status hal_tx_coalesce_write(struct hal_tx_coalesce *txc,
+						  unsigned int rpu_addr,
+						  void *data,
+						  unsigned int len,
+						  hal_tx_coalesce_write_fn write,
+						  void *ctx)
+{
+	txc->stats.bus_writes++;
+	txc->stats.bus_bytes += len;
+
+	return write(ctx, rpu_addr, data, len);
+}
+
+
+void hal_tx_coalesce_init(struct hal_tx_coalesce *txc,
+			  struct wifi_nrf_osal_priv *opriv,
+			  void *buf,
+			  unsigned int buf_size)
+{
+	txc->opriv = opriv;
+	txc->buf = buf;
+	txc->buf_size = buf ? buf_size : 0;
+	txc->start_addr = 0;
+	txc->len = 0;
+
+	wifi_nrf_osal_mem_set(opriv,
+			      &txc->stats,
+			      0,
+			      sizeof(txc->stats));
+}
+
+
+enum wifi_nrf_status hal_tx_coalesce_flush(struct hal_tx_coalesce *txc,
+					   hal_tx_coalesce_write_fn write,
+					   void *ctx)
+{
+	enum wifi_nrf_status status = WIFI_NRF_STATUS_SUCCESS;
+
+	if (!txc->len) {
+		return status;
+	}
+
+	status = hal_tx_coalesce_write(txc,
+				       txc->start_addr,
+				       txc->buf,
+				       txc->len,
+				       write,
+				       ctx);
+
+	txc->len = 0;
+
+	return status;
+}
+
+
+void hal_tx_coalesce_discard(struct hal_tx_coalesce *txc)
+{
+	txc->len = 0;
+}
+
+
+enum wifi_nrf_status hal_tx_coalesce_add(struct hal_tx_coalesce *txc,
+					 unsigned int rpu_addr,
+					 void *data,
+					 unsigned int len,
+					 hal_tx_coalesce_write_fn write,
+					 void *ctx)
+{
+	enum wifi_nrf_status status = WIFI_NRF_STATUS_SUCCESS;
+	unsigned int end_addr = txc->start_addr + txc->len;
+	unsigned int offset = 0;
+
+	txc->stats.frames++;
+
+	if (txc->len &&
+	    ((rpu_addr < end_addr) ||
+	     ((rpu_addr - txc->start_addr + len) > txc->buf_size))) {
+		status = hal_tx_coalesce_flush(txc, write, ctx);
+
+		if (status != WIFI_NRF_STATUS_SUCCESS) {
+			return status;
+		}
+	}
+
+	if (len > txc->buf_size) {
+		return hal_tx_coalesce_write(txc,
+					     rpu_addr,
+					     data,
+					     len,
+					     write,
+					     ctx);
+	}
+
+	if (!txc->len) {
+		txc->start_addr = rpu_addr;
+	}
+
+	offset = rpu_addr - txc->start_addr;
+
+	if (offset > txc->len) {
+		wifi_nrf_osal_mem_set(txc->opriv,
+				      txc->buf + txc->len,
+				      0,
+				      offset - txc->len);
+	}
+
+	wifi_nrf_osal_mem_cpy(txc->opriv,
+			      txc->buf + offset,
+			      data,
+			      len);
+
+	txc->len = offset + len;
+
+	return status;
+}
@@ -14,6 +14,7 @@
 #include <sys/time.h>
 
 #include <zephyr/kernel.h>
+#include <zephyr/init.h>
 #include <zephyr/sys/printk.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/logging/log.h>
@@ -352,11 +353,53 @@ out:
 	return pkt;
 }
 
+#ifdef CONFIG_NRF700X_LLIST_NODE_POOL
+/* Nodes needed when the driver is fully loaded: the aggregated frames of all TX tokens,
+ * a full pending queue for each of the four access categories and one RX/event queue
+ * entry per RX buffer.
+ */
+#define ZEP_SHIM_LLIST_NODE_POOL_SIZE \
+	(CONFIG_NRF700X_MAX_TX_TOKENS * CONFIG_NRF700X_MAX_TX_AGGREGATION + \
+	 4 * CONFIG_NRF700X_MAX_TX_PENDING_QLEN + \
+	 CONFIG_NRF700X_RX_NUM_BUFS)
+
+static char __aligned(sizeof(void *)) zep_shim_llist_node_pool_buf[
+	ZEP_SHIM_LLIST_NODE_POOL_SIZE * sizeof(struct zep_shim_llist_node)];
+static struct k_mem_slab zep_shim_llist_node_pool;
+
+static bool zep_shim_llist_node_is_pooled(void *llist_node)
+{
+	char *node = llist_node;
+
+	return node >= zep_shim_llist_node_pool_buf &&
+	       node < zep_shim_llist_node_pool_buf + sizeof(zep_shim_llist_node_pool_buf);
+}
+
+static int zep_shim_llist_node_pool_init(void)
+{
+	return k_mem_slab_init(&zep_shim_llist_node_pool,
+			       zep_shim_llist_node_pool_buf,
+			       sizeof(struct zep_shim_llist_node),
+			       ZEP_SHIM_LLIST_NODE_POOL_SIZE);
+}
+
+SYS_INIT(zep_shim_llist_node_pool_init, POST_KERNEL, 0);
+#endif /* CONFIG_NRF700X_LLIST_NODE_POOL */
+
 static void *zep_shim_llist_node_alloc(void)
 {
 	struct zep_shim_llist_node *llist_node = NULL;
 
+#ifdef CONFIG_NRF700X_LLIST_NODE_POOL
+	/* Fall back to the heap only if the pool has been exhausted */
+	if (k_mem_slab_alloc(&zep_shim_llist_node_pool, (void **)&llist_node, K_NO_WAIT) == 0) {
+		llist_node->data = NULL;
+	} else {
+		llist_node = k_calloc(sizeof(*llist_node), sizeof(char));
+	}
+#else
 	llist_node = k_calloc(sizeof(*llist_node), sizeof(char));
+#endif /* CONFIG_NRF700X_LLIST_NODE_POOL */
 
 	if (!llist_node) {
 		LOG_ERR("%s: Unable to allocate memory for linked list node\n", __func__);
@@ -370,6 +413,12 @@ static void *zep_shim_llist_node_alloc(void)
 
 static void zep_shim_llist_node_free(void *llist_node)
 {
+#ifdef CONFIG_NRF700X_LLIST_NODE_POOL
+	if (zep_shim_llist_node_is_pooled(llist_node)) {
+		k_mem_slab_free(&zep_shim_llist_node_pool, &llist_node);
+		return;
+	}
+#endif /* CONFIG_NRF700X_LLIST_NODE_POOL */
 	k_free(llist_node);
 }
 
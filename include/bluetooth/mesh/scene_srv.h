@@ -67,6 +67,20 @@ struct bt_mesh_scene_srv;
 						 _srv),                        \
 			 &_bt_mesh_scene_setup_srv_cb)
 
+/** Scene recall statistics. */
+struct bt_mesh_scene_srv_recall_stats {
+	/** Number of recalled scenes. */
+	uint32_t recalls;
+	/** Number of scenes recalled from the scene cache. */
+	uint32_t cache_hits;
+	/** Duration of the last scene recall in microseconds. */
+	uint32_t last_us;
+	/** Longest scene recall duration in microseconds. */
+	uint32_t max_us;
+	/** Total duration of all scene recalls in microseconds. */
+	uint64_t total_us;
+};
+
 /** Scene Server model instance */
 struct bt_mesh_scene_srv {
 	/** All known scenes. */
@@ -107,6 +121,10 @@ struct bt_mesh_scene_srv {
 	/** Publication message buffer. */
 	uint8_t buf[BT_MESH_MODEL_BUF_LEN(BT_MESH_SCENE_OP_STATUS,
 					  BT_MESH_SCENE_MSG_MAXLEN_STATUS)];
+#if defined(CONFIG_BT_MESH_SCENE_SRV_RECALL_STATS)
+	/** Scene recall statistics. */
+	struct bt_mesh_scene_srv_recall_stats recall_stats;
+#endif
 	/** @endcond */
 };
 
@@ -235,6 +253,28 @@ bt_mesh_scene_srv_current_scene_get(const struct bt_mesh_scene_srv *srv);
 uint16_t
 bt_mesh_scene_srv_target_scene_get(const struct bt_mesh_scene_srv *srv);
 
+/** @brief Get the scene recall statistics.
+ *
+ *  The duration of a scene recall is measured from the start of loading the
+ *  scene data until all models have been notified that the recall is
+ *  complete. It does not include the transition time.
+ *
+ *  Requires @kconfig{CONFIG_BT_MESH_SCENE_SRV_RECALL_STATS}.
+ *
+ *  @param[in]  srv   Scene Server model.
+ *  @param[out] stats Scene recall statistics.
+ */
+void bt_mesh_scene_srv_recall_stats_get(const struct bt_mesh_scene_srv *srv,
+					struct bt_mesh_scene_srv_recall_stats *stats);
+
+/** @brief Reset the scene recall statistics.
+ *
+ *  Requires @kconfig{CONFIG_BT_MESH_SCENE_SRV_RECALL_STATS}.
+ *
+ *  @param[in] srv Scene Server model.
+ */
+void bt_mesh_scene_srv_recall_stats_reset(struct bt_mesh_scene_srv *srv);
+
 /** @cond INTERNAL_HIDDEN */
 extern const struct bt_mesh_model_cb _bt_mesh_scene_srv_cb;
 extern const struct bt_mesh_model_op _bt_mesh_scene_srv_op[];
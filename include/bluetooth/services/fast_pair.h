@@ -142,6 +142,18 @@ size_t bt_fast_pair_adv_data_size(struct bt_fast_pair_adv_config fp_adv_config);
 int bt_fast_pair_adv_data_fill(struct bt_data *adv_data, uint8_t *buf, size_t buf_size,
 			       struct bt_fast_pair_adv_config fp_adv_config);
 
+/** Request a new Salt for the Fast Pair not discoverable advertising data.
+ *
+ * With the CONFIG_BT_FAST_PAIR_ADV_AK_FILTER_CACHE Kconfig option enabled, the Salt and the
+ * Account Key Filter hashes derived from it are reused by @ref bt_fast_pair_adv_data_fill until
+ * this function is called. The function must be called at least on every Resolvable Private
+ * Address rotation to prevent tracking. Otherwise, a new Salt is drawn on every advertising data
+ * fill and the function has no effect.
+ *
+ * Caller shall call this function from the same context as @ref bt_fast_pair_adv_data_fill.
+ */
+void bt_fast_pair_adv_salt_rotate(void);
+
 /** Enable or disable Fast Pair pairing mode.
  *
  * Pairing mode must be enabled if discoverable Fast Pair advertising is used.
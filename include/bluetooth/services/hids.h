@@ -18,6 +18,7 @@
 extern "C" {
 #endif
 
+#include <zephyr/sys/atomic.h>
 #include <bluetooth/gatt_pool.h>
 #include <zephyr/bluetooth/gatt.h>
 #include <bluetooth/conn_ctx.h>
@@ -34,6 +35,14 @@ extern "C" {
 #define CONFIG_BT_HIDS_FEATURE_REP_MAX 0
 #endif
 
+#ifndef CONFIG_BT_HIDS_NOTIFY_STATS_PENDING_MAX
+#define CONFIG_BT_HIDS_NOTIFY_STATS_PENDING_MAX 1
+#endif
+
+#ifndef CONFIG_BT_HIDS_NOTIFY_STATS_CB_MAX
+#define CONFIG_BT_HIDS_NOTIFY_STATS_CB_MAX 1
+#endif
+
 /** Length of the Boot Mouse Input Report. */
 #define BT_HIDS_BOOT_MOUSE_REP_LEN     8
 /** Length of the Boot Keyboard Input Report. */
@@ -54,10 +63,13 @@ extern "C" {
 	BT_CONN_CTX_DEF(_name,						       \
 			CONFIG_BT_HIDS_MAX_CLIENT_COUNT,		       \
 			_BT_HIDS_CONN_CTX_SIZE_CALC(__VA_ARGS__));	       \
+	static uint8_t CONCAT(_name, _inp_rep_shared)[			       \
+		_BT_HIDS_REP_SIZE_CALC(__VA_ARGS__)];			       \
 	static struct bt_hids _name =				       \
 	{								       \
 		.gp = BT_GATT_POOL_INIT(CONFIG_BT_HIDS_ATTR_MAX),	       \
 		.conn_ctx = &CONCAT(_name, _ctx_lib),			       \
+		.inp_rep_shared = CONCAT(_name, _inp_rep_shared),	       \
 	}
 
 
@@ -65,8 +77,10 @@ extern "C" {
  *        the link context size for HIDS instance.
  */
 #define _BT_HIDS_CONN_CTX_SIZE_CALC(...)		   \
-	(FOR_EACH(_BT_HIDS_GET_ARG1, (+), __VA_ARGS__)	+ \
+	(_BT_HIDS_REP_SIZE_CALC(__VA_ARGS__)	+ \
 	sizeof(struct bt_hids_conn_data))
+#define _BT_HIDS_REP_SIZE_CALC(...)		   \
+	(FOR_EACH(_BT_HIDS_GET_ARG1, (+), __VA_ARGS__))
 #define _BT_HIDS_GET_ARG1(...) GET_ARG_N(1, __VA_ARGS__)
 
 /** @brief Possible values for the Protocol Mode Characteristic value.
@@ -177,6 +191,18 @@ typedef void (*bt_hids_rep_handler_t) (struct bt_hids_rep *rep,
 				       struct bt_conn *conn,
 				       bool write);
 
+struct bt_hids_inp_rep;
+
+/** @brief Notification complete callback of an Input Report.
+ */
+struct bt_hids_notify_cb {
+	/** Input Report the callback belongs to, NULL if the entry is free. */
+	struct bt_hids_inp_rep *rep;
+
+	/** Notification complete callback given by the application. */
+	bt_gatt_complete_func_t func;
+};
+
 /** @brief Input Report.
  */
 struct bt_hids_inp_rep {
@@ -227,6 +253,24 @@ struct bt_hids_inp_rep {
 
 	/** Callback with the notification event. */
 	bt_hids_notify_handler_t handler;
+
+	/** Connections subscribed to the report, indexed by the connection index. */
+	ATOMIC_DEFINE(subscribed, CONFIG_BT_MAX_CONN);
+
+	/** Connections that use the shared report buffer instead of their own
+	 *  copy of the report, indexed by the connection index.
+	 */
+	ATOMIC_DEFINE(shared_refs, CONFIG_BT_MAX_CONN);
+
+	/** Subscription change counter value the subscribed bitmap is valid for. */
+	atomic_val_t sub_gen;
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	/** Notification complete callbacks of the report, passed with the
+	 *  timed notifications.
+	 */
+	struct bt_hids_notify_cb notify_cbs[CONFIG_BT_HIDS_NOTIFY_STATS_CB_MAX];
+#endif
 };
 
 
@@ -416,6 +460,41 @@ struct bt_hids_init_param {
 	bool is_kb;
 };
 
+/** @brief Notification statistics of a connection.
+ */
+struct bt_hids_notify_stats {
+	/** Number of completed Input Report notifications. */
+	uint32_t notify_cnt;
+
+	/** Latency of the last notification in microseconds. */
+	uint32_t latency_last_us;
+
+	/** Lowest notification latency in microseconds. */
+	uint32_t latency_min_us;
+
+	/** Highest notification latency in microseconds. */
+	uint32_t latency_max_us;
+
+	/** Sum of the notification latencies in microseconds. */
+	uint64_t latency_total_us;
+};
+
+/** @brief Notification timing of a connection.
+ */
+struct bt_hids_notify_timing {
+	/** Notification statistics. */
+	struct bt_hids_notify_stats stats;
+
+	/** Send timestamps of the pending notifications, in cycles. */
+	uint32_t ts[CONFIG_BT_HIDS_NOTIFY_STATS_PENDING_MAX];
+
+	/** Number of notifications sent. */
+	uint32_t tx_seq;
+
+	/** Number of notifications completed. */
+	uint32_t rx_seq;
+};
+
 /** @brief HID Service structure.
  */
 struct bt_hids {
@@ -460,6 +539,14 @@ struct bt_hids {
 
 	/** Bluetooth connection contexts. */
 	struct bt_conn_ctx_lib *conn_ctx;
+
+	/** Input Reports last sent to all subscribed connections. */
+	uint8_t *inp_rep_shared;
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	/** Notification timing, indexed by the connection index. */
+	struct bt_hids_notify_timing notify_timing[CONFIG_BT_MAX_CONN];
+#endif
 };
 
 /** @brief HID Connection context data structure.
@@ -591,6 +678,31 @@ int bt_hids_boot_kb_inp_rep_send(struct bt_hids *hids_obj, struct bt_conn *conn,
 				 uint8_t const *rep, uint16_t len,
 				 bt_gatt_complete_func_t cb);
 
+/** @brief Get Input Report notification statistics of a connection.
+ *
+ *  The latency is measured from the moment a report is passed to
+ *  @ref bt_hids_inp_rep_send until its notification complete callback.
+ *
+ *  @param hids_obj Pointer to HIDS instance.
+ *  @param conn Pointer to Connection Object.
+ *  @param stats Pointer to the structure where the statistics are stored.
+ *
+ *  @return 0 If the operation was successful. Otherwise, a (negative) error
+ *	      code is returned.
+ */
+int bt_hids_notify_stats_get(struct bt_hids *hids_obj, struct bt_conn *conn,
+			     struct bt_hids_notify_stats *stats);
+
+/** @brief Reset Input Report notification statistics of a connection.
+ *
+ *  @param hids_obj Pointer to HIDS instance.
+ *  @param conn Pointer to Connection Object.
+ *
+ *  @return 0 If the operation was successful. Otherwise, a (negative) error
+ *	      code is returned.
+ */
+int bt_hids_notify_stats_reset(struct bt_hids *hids_obj, struct bt_conn *conn);
+
 
 #ifdef __cplusplus
 }
@@ -47,6 +47,26 @@ enum bt_nus_send_status {
 	BT_NUS_SEND_STATUS_DISABLED,
 };
 
+/** @brief NUS stream statistics. */
+struct bt_nus_stream_stats {
+	/** Number of bytes waiting in the stream buffer. */
+	size_t queued;
+
+	/** Number of bytes sent since the last statistics reset. */
+	uint32_t sent;
+
+	/** Average throughput since the last statistics reset in bytes per second. */
+	uint32_t throughput;
+
+	/** Number of notifications currently queued in the Bluetooth stack. */
+	uint8_t inflight;
+
+	/** Highest number of notifications queued in the Bluetooth stack since the last
+	 *  statistics reset.
+	 */
+	uint8_t inflight_peak;
+};
+
 /** @brief Pointers to the callback functions for service events. */
 struct bt_nus_cb {
 	/** @brief Data received callback.
@@ -113,6 +133,48 @@ int bt_nus_init(struct bt_nus_cb *callbacks);
  */
 int bt_nus_send(struct bt_conn *conn, const uint8_t *data, uint16_t len);
 
+/**@brief Queue data for streaming.
+ *
+ * @details This function copies the data to the stream buffer of the
+ *          connection. The data is sent as notifications of the maximum
+ *          size allowed by the negotiated ATT MTU, with up to
+ *          CONFIG_BT_NUS_STREAM_INFLIGHT_MAX notifications queued in the
+ *          Bluetooth stack at the same time. The @ref bt_nus_cb.sent
+ *          callback is called for every sent notification and can be used
+ *          to queue more data. Data that was not sent is dropped on
+ *          disconnection.
+ *
+ *          Requires the CONFIG_BT_NUS_STREAM Kconfig option.
+ *
+ * @param[in] conn Pointer to connection object.
+ * @param[in] data Pointer to a data buffer.
+ * @param[in] len  Length of the data in the buffer.
+ *
+ * @return Number of queued bytes, which is less than @p len if the stream
+ *         buffer is full. Otherwise, a negative value is returned.
+ */
+int bt_nus_stream_send(struct bt_conn *conn, const uint8_t *data, size_t len);
+
+/**@brief Get stream statistics.
+ *
+ * @details Requires the CONFIG_BT_NUS_STREAM Kconfig option.
+ *
+ * @param[in]  conn  Pointer to connection object.
+ * @param[out] stats Stream statistics.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a negative value is returned.
+ */
+int bt_nus_stream_stats_get(struct bt_conn *conn, struct bt_nus_stream_stats *stats);
+
+/**@brief Reset stream statistics.
+ *
+ * @details Requires the CONFIG_BT_NUS_STREAM Kconfig option.
+ *
+ * @param[in] conn Pointer to connection object.
+ */
+void bt_nus_stream_stats_reset(struct bt_conn *conn);
+
 /**@brief Get maximum data length that can be used for @ref bt_nus_send.
  *
  * @param[in] conn Pointer to connection Object.
@@ -31,6 +31,19 @@ struct sensor_data_aggregator_event {
 	enum sensor_state sensor_state;
 	uint8_t sample_cnt;
 	uint8_t values_in_sample;
+
+	/** System uptime in microseconds at which the first sample was stored. */
+	int64_t timestamp;
+
+	/** Timestamps of the samples in microseconds, relative to the timestamp field.
+	 *  NULL unless CONFIG_CAF_SENSOR_DATA_AGGREGATOR_SAMPLE_TIMESTAMPS is enabled.
+	 */
+	uint32_t *sample_timestamps;
+
+	/** Number of samples dropped right before the first sample, because no buffer was
+	 *  available. A non-zero value indicates a gap in the data.
+	 */
+	uint32_t dropped_cnt;
 };
 
 /** @brief Sensor data aggregator release buffer event.
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SENSOR_DATA_AGGREGATOR_H_
+#define _SENSOR_DATA_AGGREGATOR_H_
+
+/**
+ * @file
+ * @defgroup caf_sensor_data_aggregator CAF Sensor Data Aggregator
+ * @{
+ * @brief CAF Sensor Data Aggregator producer API.
+ *
+ * The API allows a sensor data producer to write samples directly into the active buffer of
+ * the aggregator, instead of submitting a sensor_event for each sample. Only a single producer
+ * may use the API for a given sensor description.
+ */
+
+#include <zephyr/drivers/sensor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Claim space for a sample in the active aggregator buffer.
+ *
+ * The sample is added to the buffer when it is committed. If the sample is not committed, the
+ * next claim returns the same space.
+ *
+ * @param[in]  sensor_descr Sensor description, the same pointer as used by the aggregator.
+ * @param[in]  value_cnt    Number of sensor values in the sample.
+ * @param[out] data         Pointer to the claimed space.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if there is no aggregator for the sensor description.
+ * @retval -EBADMSG if value_cnt does not match the sample size of the aggregator.
+ * @retval -ENOBUFS if no buffer is available. The sample is counted as dropped.
+ */
+int sensor_data_aggregator_sample_claim(const char *sensor_descr, size_t value_cnt,
+					struct sensor_value **data);
+
+/** @brief Commit the sample written to the claimed space.
+ *
+ * The aggregator buffer is sent in a sensor_data_aggregator_event when it is full.
+ *
+ * @param[in] sensor_descr Sensor description, the same pointer as used by the aggregator.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if there is no aggregator for the sensor description.
+ * @retval -ENOBUFS if the buffer was sent while the sample was written. The sample is counted
+ *	   as dropped.
+ */
+int sensor_data_aggregator_sample_commit(const char *sensor_descr);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _SENSOR_DATA_AGGREGATOR_H_ */
@@ -34,6 +34,10 @@
  * 4. Call @c dfu_multi_image_done function to release open resources and verify that all
  *    data declared in the header have been written properly.
  *
+ * When @c CONFIG_DFU_MULTI_IMAGE_ASYNC is enabled, the image writers are called from a
+ * dedicated thread and an error reported by a writer is returned by a subsequent call to
+ * @c dfu_multi_image_write or @c dfu_multi_image_done.
+ *
  * @{
  */
 
@@ -95,6 +99,23 @@ struct dfu_image_writer {
 	dfu_image_close_t close;
 };
 
+/**
+ * @brief Write statistics of a single image from DFU Multi Image package.
+ */
+struct dfu_multi_image_stats {
+	/** Number of bytes passed to the image writer. */
+	size_t bytes_written;
+
+	/** Time since the image was opened until it was closed, or until now. */
+	uint32_t elapsed_ms;
+
+	/** Time spent in the image writer functions. */
+	uint32_t busy_ms;
+
+	/** Average write throughput over @c elapsed_ms. */
+	uint32_t bytes_per_sec;
+};
+
 /**
  * @brief Initialize DFU Multi Image library context.
  *
@@ -178,6 +199,19 @@ size_t dfu_multi_image_offset(void);
  */
 int dfu_multi_image_done(bool success);
 
+/**
+ * @brief Get write statistics of an image.
+ *
+ * The statistics are reset by @c dfu_multi_image_init.
+ *
+ * @param[in] image_id Identifier of the image.
+ * @param[out] stats Structure to fill with the statistics.
+ * @return -ENOENT  If the image is not in the package or has not been opened yet.
+ * @return -EINVAL  If @c stats is NULL.
+ * @return 0        On success.
+ */
+int dfu_multi_image_stats_get(int image_id, struct dfu_multi_image_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
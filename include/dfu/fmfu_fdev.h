@@ -29,6 +29,8 @@ extern "C" {
  * function.
  *
  * @param[in] buf Pointer to buffer used to read data from external flash.
+ *                When @kconfig{CONFIG_FMFU_FDEV_PIPELINED} is enabled, the
+ *                buffer is split in two halves used for double buffering.
  * @param[in] buf_len Length of provided buffer.
  * @param[in] fdev Flash device to read modem firmware from.
  * @param[in] offset Offset within configured flash device to first byte of
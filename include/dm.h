@@ -148,6 +148,23 @@ struct dm_request {
 	uint32_t extra_window_time_us;
 };
 
+/** @brief Per-peer timeslot scheduling statistics. */
+struct dm_peer_stats {
+	/** Number of timeslots added to the queue. */
+	uint32_t scheduled;
+
+	/** Number of requests rejected because the queue was full,
+	 *  the peer limit was reached or the timeslot collided with a previous one.
+	 */
+	uint32_t dropped;
+
+	/** Number of timeslots that were blocked or cancelled by the scheduler. */
+	uint32_t late;
+
+	/** Number of timeslots currently in the queue. */
+	uint32_t queued;
+};
+
 /** @brief Initialize the DM.
  *
  *  Initialize the DM by specifying a list of supported operations.
@@ -170,6 +187,20 @@ int dm_init(struct dm_init_param *init_param);
  */
 int dm_request_add(struct dm_request *req);
 
+/** @brief Get timeslot scheduling statistics for a peer.
+ *
+ *  Statistics are kept for up to @kconfig{CONFIG_DM_TIMESLOT_QUEUE_PEER_COUNT} peers.
+ *  A peer with no timeslots in the queue may be evicted to make room for a new one.
+ *
+ *  @param[in] bt_addr Bluetooth LE address of the peer.
+ *  @param[out] stats Structure to fill with the statistics.
+ *
+ *  @retval 0 if the operation was successful.
+ *  @retval -EINVAL if an argument is NULL.
+ *  @retval -ENOENT if the peer is not tracked.
+ */
+int dm_peer_stats_get(const bt_addr_le_t *bt_addr, struct dm_peer_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,6 +50,11 @@ enum location_req_mode {
 	LOCATION_REQ_MODE_FALLBACK = 0,
 	/** All requested methods are used sequentially. */
 	LOCATION_REQ_MODE_ALL,
+	/**
+	 * Wi-Fi and cellular methods are run at the same time as GNSS and the first location
+	 * acquired wins. Requires CONFIG_LOCATION_REQUEST_MODE_CONCURRENT.
+	 */
+	LOCATION_REQ_MODE_CONCURRENT,
 };
 
 /** Event IDs. */
@@ -442,6 +447,9 @@ struct location_config {
 	 *   - Methods are one after the other in location request method list
 	 *   - @ref mode is @ref LOCATION_REQ_MODE_FALLBACK
 	 *   - Requested cloud service for Wi-Fi and cellular is the same
+	 *
+	 * If @ref mode is @ref LOCATION_REQ_MODE_CONCURRENT, Wi-Fi and cellular are combined
+	 * whenever they use the same cloud service, regardless of their position in the list.
 	 */
 	struct location_method_config methods[CONFIG_LOCATION_METHODS_LIST_SIZE];
 
@@ -477,6 +485,31 @@ struct location_config {
 	enum location_req_mode mode;
 };
 
+/** Statistics of a single location method. */
+struct location_method_metrics {
+	/** Number of times the method has completed, either with or without a location. */
+	uint32_t attempts;
+
+	/** Number of times the method has acquired a location. */
+	uint32_t fixes;
+
+	/** Time-to-fix of the latest location acquired with the method in milliseconds. */
+	uint32_t ttf_last_ms;
+
+	/**
+	 * Sum of time-to-fix of all locations acquired with the method in milliseconds.
+	 * Divide by @ref fixes to get the average.
+	 */
+	uint64_t ttf_total_ms;
+
+	/**
+	 * Time in milliseconds the method has kept its receiver running: GNSS search time,
+	 * Wi-Fi scan time or LTE neighbor cell measurement time. This is a proxy for the energy
+	 * used by the method. Time spent on cloud requests is not included.
+	 */
+	uint64_t active_ms;
+};
+
 /**
  * @brief Event handler prototype.
  *
@@ -618,6 +651,27 @@ void location_cloud_location_ext_result_set(
 	enum location_ext_result result,
 	struct location_data *location);
 
+/**
+ * @brief Get statistics of a location method.
+ *
+ * @details Statistics are collected for all location requests since the library was initialized
+ * or since @ref location_method_metrics_reset was called.
+ *
+ * @param[in] method Location method.
+ * @param[out] metrics Method statistics.
+ *
+ * @return 0 on success, or negative error code on failure.
+ * @retval -EINVAL Unknown location method or metrics is NULL.
+ */
+int location_method_metrics_get(
+	enum location_method method,
+	struct location_method_metrics *metrics);
+
+/**
+ * @brief Reset statistics of all location methods.
+ */
+void location_method_metrics_reset(void);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -35,6 +35,9 @@ enum mqtt_state {
 enum mqtt_helper_error {
 	/** The received payload is larger than the payload buffer. */
 	MQTT_HELPER_ERROR_MSG_SIZE,
+
+	/** Reading the payload failed before its last chunk was received. */
+	MQTT_HELPER_ERROR_PAYLOAD_READ,
 };
 
 struct mqtt_helper_buf {
@@ -50,6 +53,10 @@ typedef void (*mqtt_helper_on_connack_t)(enum mqtt_conn_return_code return_code)
 typedef void (*mqtt_helper_on_disconnect_t)(int result);
 typedef void (*mqtt_helper_on_publish_t)(struct mqtt_helper_buf topic_buf,
 					 struct mqtt_helper_buf payload_buf);
+typedef void (*mqtt_helper_on_publish_chunk_t)(struct mqtt_helper_buf topic_buf,
+					       struct mqtt_helper_buf chunk_buf,
+					       size_t offset,
+					       size_t total_len);
 typedef void (*mqtt_helper_on_puback_t)(uint16_t message_id, int result);
 typedef void (*mqtt_helper_on_suback_t)(uint16_t message_id, int result);
 typedef void (*mqtt_helper_on_pingresp_t)(void);
@@ -60,6 +67,14 @@ struct mqtt_helper_cfg {
 		mqtt_helper_on_connack_t on_connack;
 		mqtt_helper_on_disconnect_t on_disconnect;
 		mqtt_helper_on_publish_t on_publish;
+
+		/** If set, incoming payloads are read from the socket in chunks of up to
+		 *  CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN bytes and passed to this callback as
+		 *  they arrive, instead of to @c on_publish. The chunk buffer is only valid
+		 *  during the callback. The last chunk of a message is the one for which
+		 *  offset + chunk_buf.size equals total_len.
+		 */
+		mqtt_helper_on_publish_chunk_t on_publish_chunk;
 		mqtt_helper_on_puback_t on_puback;
 		mqtt_helper_on_suback_t on_suback;
 		mqtt_helper_on_pingresp_t on_pingresp;
@@ -135,11 +135,43 @@ struct rest_client_resp_context {
 	int used_socket_is_alive;
 };
 
+/**
+ * @brief REST client connection statistics.
+ *
+ * @details Read with @ref rest_client_conn_stats_get.
+ */
+struct rest_client_conn_stats {
+	/** Number of new connections, including their TLS handshakes. */
+	uint32_t connects;
+
+	/** Number of requests sent on a reused pooled connection, that is,
+	 *  the number of connection and TLS handshakes avoided.
+	 */
+	uint32_t reuses;
+
+	/** Estimated number of bytes saved by the avoided handshakes. */
+	uint32_t bytes_saved;
+
+	/** Number of requests retried on a new connection after a pooled connection
+	 *  turned out to be closed by the server.
+	 */
+	uint32_t stale_retries;
+
+	/** Number of pooled connections closed after being idle. */
+	uint32_t idle_closed;
+};
+
 /**
  * @brief REST client request.
  *
  * @details This function will block the calling thread until the request completes.
  *
+ *          If @kconfig{CONFIG_REST_CLIENT_CONN_POOL} is enabled and the request does not
+ *          manage its own connection, that is, connect_socket is REST_CLIENT_SCKT_CONNECT
+ *          and keep_alive is false, an idle pooled connection to the same host, port
+ *          and security tag is used if there is one. The connection is returned to the
+ *          pool afterwards unless the server closes it.
+ *
  * @param[in] req_ctx Request context containing input parameters to REST request
  * @param[out] resp_ctx Response context for returning the response data.
  *
@@ -160,6 +192,44 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
  */
 void rest_client_request_defaults_set(struct rest_client_req_context *req_ctx);
 
+/**
+ * @brief REST client requests sent back to back over a shared connection.
+ *
+ * @details Consecutive requests to the same host, port and security tag use one
+ *          connection. Each response is read before the next request is sent.
+ *          Without @kconfig{CONFIG_REST_CLIENT_CONN_POOL}, the connect_socket and
+ *          keep_alive fields of the request contexts are overwritten, and the shared
+ *          connection is closed when the function returns.
+ *          This function will block the calling thread until the requests complete
+ *          or one of them fails.
+ *
+ * @param[in] req_ctxs Request contexts, see @ref rest_client_request.
+ * @param[out] resp_ctxs Response contexts, one for each request.
+ * @param[in] count Number of requests.
+ *
+ * @retval 0, if all the REST responses were received successfully.
+ *         Otherwise, the (negative) error code of the first failed request is returned.
+ *         The requests after it are not sent.
+ */
+int rest_client_requests(struct rest_client_req_context *req_ctxs,
+			 struct rest_client_resp_context *resp_ctxs,
+			 size_t count);
+
+/**
+ * @brief Close the idle connections of the connection pool.
+ *
+ * @details Use this when the network connection is lost, for example.
+ *          Does nothing if @kconfig{CONFIG_REST_CLIENT_CONN_POOL} is disabled.
+ */
+void rest_client_conn_pool_flush(void);
+
+/**
+ * @brief Get REST client connection statistics.
+ *
+ * @param[out] stats Statistics since boot.
+ */
+void rest_client_conn_stats_get(struct rest_client_conn_stats *stats);
+
 /** @} */
 
 #endif /* REST_CLIENT_H__ */
@@ -104,7 +104,44 @@ enum nfc_t4t_isodep_fsd {
 	NFC_T4T_ISODEP_FSD_128,
 
 	/** 256-byte frame size. */
-	NFC_T4T_ISODEP_FSD_256
+	NFC_T4T_ISODEP_FSD_256,
+
+	/** 512-byte frame size. Requires CONFIG_NFC_T4T_ISODEP_FSC_EXTENDED. */
+	NFC_T4T_ISODEP_FSD_512,
+
+	/** 1024-byte frame size. Requires CONFIG_NFC_T4T_ISODEP_FSC_EXTENDED. */
+	NFC_T4T_ISODEP_FSD_1024,
+
+	/** 2048-byte frame size. Requires CONFIG_NFC_T4T_ISODEP_FSC_EXTENDED. */
+	NFC_T4T_ISODEP_FSD_2048,
+
+	/** 4096-byte frame size. Requires CONFIG_NFC_T4T_ISODEP_FSC_EXTENDED. */
+	NFC_T4T_ISODEP_FSD_4096
+};
+
+/**@brief ISO-DEP Protocol transfer statistics.
+ */
+struct nfc_t4t_isodep_stats {
+	/** Number of completed data exchanges. */
+	uint32_t exchanges;
+
+	/** Number of I-blocks sent. */
+	uint32_t i_blocks_tx;
+
+	/** Number of I-blocks received. */
+	uint32_t i_blocks_rx;
+
+	/** Number of retransmitted I-blocks. */
+	uint32_t retransmissions;
+
+	/** Number of data bytes sent. */
+	uint32_t bytes_tx;
+
+	/** Number of data bytes received. */
+	uint32_t bytes_rx;
+
+	/** Total time of the completed data exchanges in microseconds. */
+	uint64_t exchange_time_us;
 };
 
 /**@brief ISO-DEP Protocol callback structure.
@@ -207,6 +244,11 @@ int nfc_t4t_isodep_data_received(const uint8_t *data, size_t data_len, int err);
  * This function can be called when a Tag is in selected state after
  * calling @ref nfc_t4t_isodep_rats_send.
  *
+ * The data is sent in I-blocks as large as the frame size of the Listener
+ * (FSC) and the Tx buffer allow. If the Tx buffer can hold two such
+ * blocks, the next chained block is prepared while the current one is
+ * exchanged, so it can be sent as soon as the R(ACK) frame is received.
+ *
  * @param[in] data     Pointer to the data to transfer over ISO-DEP protocol.
  * @param[in] data_len Length of the data to transmit.
  *
@@ -215,6 +257,16 @@ int nfc_t4t_isodep_data_received(const uint8_t *data, size_t data_len, int err);
  */
 int nfc_t4t_isodep_transmit(const uint8_t *data, size_t data_len);
 
+/**@brief Get the ISO-DEP Protocol transfer statistics.
+ *
+ * @param[out] stats Transfer statistics.
+ */
+void nfc_t4t_isodep_stats_get(struct nfc_t4t_isodep_stats *stats);
+
+/**@brief Reset the ISO-DEP Protocol transfer statistics.
+ */
+void nfc_t4t_isodep_stats_reset(void);
+
 /**@brief Handle a transmission timeout error.
  *
  * This function must be called when a Reader/Writer
@@ -48,7 +48,7 @@ extern struct nrf_profiler_event_enabled_bm _nrf_profiler_event_enabled_bm;
 
 /** @brief Number of event types registered in the Profiler.
  */
-extern uint8_t nrf_profiler_num_events;
+extern uint16_t nrf_profiler_num_events;
 
 
 /** @brief Data types for profiling.
@@ -71,6 +71,8 @@ struct log_event_buf {
 #ifdef CONFIG_NRF_PROFILER
 	/** Pointer to the end of the payload. */
 	uint8_t *payload;
+	/** Time at which the event was started, in cycles. */
+	uint32_t timestamp;
 	/** Array where the payload is located before it is sent. */
 	uint8_t payload_start[CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN];
 #endif
@@ -293,6 +295,9 @@ static inline void nrf_profiler_log_add_mem_address(struct log_event_buf *buf,
 /** @brief Send data from the buffer to the host.
  *
  * This function only sends data that is already stored in the buffer.
+ * If the backend has no room for the event, the event is dropped and counted.
+ * The number of dropped events is reported to the host with the next event
+ * that fits.
  * Use @ref nrf_profiler_log_encode_uint32, @ref nrf_profiler_log_encode_int32,
  * @ref nrf_profiler_log_encode_uint16, @ref nrf_profiler_log_encode_int16,
  * @ref nrf_profiler_log_encode_uint8, @ref nrf_profiler_log_encode_int8,
@@ -311,6 +316,33 @@ static inline void nrf_profiler_log_send(struct log_event_buf *buf,
 #endif
 
 
+/** @brief Get the number of events dropped because the backend was full.
+ *
+ * @return Number of events dropped since the Profiler was initialized.
+ */
+#ifdef CONFIG_NRF_PROFILER
+uint32_t nrf_profiler_dropped_events_get(void);
+#else
+static inline uint32_t nrf_profiler_dropped_events_get(void) {return 0; }
+#endif
+
+
+/** @brief Read profiling data stored by the RAM backend.
+ *
+ * The data is consumed, so every byte is returned only once. The data uses the
+ * same format as the data sent over the other backends.
+ *
+ * @param data Buffer for the data.
+ * @param len Size of the buffer.
+ * @return Number of bytes written to the buffer.
+ */
+#ifdef CONFIG_NRF_PROFILER_NORDIC_BACKEND_RAM
+size_t nrf_profiler_ram_backend_read(uint8_t *data, size_t len);
+#else
+static inline size_t nrf_profiler_ram_backend_read(uint8_t *data, size_t len) {return 0; }
+#endif
+
+
 /**
  * @}
  */
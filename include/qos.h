@@ -123,6 +123,26 @@ struct qos_evt {
 	struct qos_data message;
 };
 
+/** @brief Library statistics. */
+struct qos_stats {
+	/** Number of messages currently pending acknowledgment. */
+	uint32_t depth;
+
+	/** Highest number of messages pending acknowledgment at the same time. */
+	uint32_t depth_peak;
+
+	/** Number of times that pending messages have been notified again. */
+	uint32_t retries;
+
+	/** Number of messages that have been acknowledged using qos_message_remove(). */
+	uint32_t acked;
+
+	/** Number of messages discarded without being acknowledged, either because the internal
+	 *  list was full or because they were notified CONFIG_QOS_MESSAGE_NOTIFIED_COUNT_MAX times.
+	 */
+	uint32_t dropped;
+};
+
 /** @brief QoS library event handler.
  *
  *  @param[in] evt The event and the associated parameters.
@@ -195,6 +215,12 @@ void qos_message_notify_all(void);
  */
 void qos_message_remove_all(void);
 
+/** @brief Get library statistics. The statistics are reset when the library is initialized.
+ *
+ *  @param[out] stats Pointer to the structure that the statistics are copied to.
+ */
+void qos_stats_get(struct qos_stats *stats);
+
 /** @brief Reset and stop an ongoing timer backoff. */
 void qos_timer_reset(void);
 
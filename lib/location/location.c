@@ -337,6 +337,23 @@ int location_pgps_data_process(const char *buf, size_t buf_len)
 	return -ENOTSUP;
 }
 
+int location_method_metrics_get(
+	enum location_method method,
+	struct location_method_metrics *metrics)
+{
+	if (metrics == NULL) {
+		LOG_ERR("Metrics buffer cannot be a NULL pointer.");
+		return -EINVAL;
+	}
+
+	return location_core_metrics_get(method, metrics);
+}
+
+void location_method_metrics_reset(void)
+{
+	location_core_metrics_reset();
+}
+
 void location_cloud_location_ext_result_set(
 	enum location_ext_result result,
 	struct location_data *location)
@@ -66,9 +66,28 @@ static void location_core_event_cb_fn(struct k_work *work);
 /** Work item for location event callback. */
 K_WORK_DEFINE(location_event_cb_work, location_core_event_cb_fn);
 
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+/** Location event callback for the method running concurrently. */
+static void location_core_concurrent_event_cb_fn(struct k_work *work);
+
+/** Work item for concurrent location event callback. */
+K_WORK_DEFINE(location_concurrent_event_cb_work, location_core_concurrent_event_cb_fn);
+
+/** Event data reported by the method running concurrently. */
+static struct location_event_data concurrent_event_data;
+#endif
+
 /** Semaphore protecting the use of location requests. */
 K_SEM_DEFINE(location_core_sem, 1, 1);
 
+/***** Location method statistics *****/
+
+/** Statistics of each location method, indexed from LOCATION_METHOD_CELLULAR onwards. */
+static struct location_method_metrics method_metrics[LOCATION_METHOD_WIFI];
+
+/** Lock protecting the method statistics. */
+static struct k_spinlock method_metrics_lock;
+
 /***** Location method configurations *****/
 
 #if defined(CONFIG_LOCATION_METHOD_GNSS)
@@ -158,6 +177,8 @@ static void location_core_current_event_data_init(enum location_method method)
 	memset(&loc_req_info.current_event_data, 0, sizeof(loc_req_info.current_event_data));
 
 	loc_req_info.current_method = method;
+	loc_req_info.current_method_uptime = k_uptime_get();
+	loc_req_info.current_method_failed = false;
 }
 
 static void location_core_current_config_clear(void)
@@ -289,6 +310,12 @@ int location_core_validate_params(const struct location_config *config)
 		return -EINVAL;
 	}
 
+	if (config->mode == LOCATION_REQ_MODE_CONCURRENT &&
+	    !IS_ENABLED(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)) {
+		LOG_ERR("Concurrent mode requires CONFIG_LOCATION_REQUEST_MODE_CONCURRENT");
+		return -EINVAL;
+	}
+
 	for (int i = 0; i < config->methods_count; i++) {
 		/* Check if the method is valid */
 		method_api = location_method_api_get(config->methods[i].method);
@@ -370,6 +397,22 @@ static int location_core_location_get_pos(void)
 		k_uptime_get() + loc_req_info.config.timeout : SYS_FOREVER_MS;
 	loc_req_info.execute_fallback = true;
 	loc_req_info.current_method_index = 0;
+	loc_req_info.concurrent_pending = false;
+
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	if (loc_req_info.concurrent_method != 0) {
+		/* Cloud location is started first so that its scans run ahead of GNSS,
+		 * which may still be waiting for the LTE modem to become idle.
+		 */
+		LOG_DBG("Requesting location concurrently with '%s' method",
+			(char *)location_method_api_get(
+				loc_req_info.concurrent_method)->method_string);
+		loc_req_info.concurrent_method_uptime = k_uptime_get();
+		loc_req_info.concurrent_pending = true;
+		(void)method_cloud_location_concurrent_get(&loc_req_info);
+	}
+#endif
+
 	requested_method = loc_req_info.methods[loc_req_info.current_method_index];
 	LOG_DBG("Requesting location with '%s' method",
 		(char *)location_method_api_get(requested_method)->method_string);
@@ -414,8 +457,30 @@ static void location_request_info_create(const struct location_config *config)
 		}
 	}
 
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	/* In concurrent mode, Wi-Fi and cellular are run alongside GNSS. If they use different
+	 * services, the first one of them is run alongside and the other is left as a fallback.
+	 */
+	if (loc_req_info.config.mode == LOCATION_REQ_MODE_CONCURRENT &&
+	    loc_req_info.gnss != NULL &&
+	    (loc_req_info.cellular != NULL || loc_req_info.wifi != NULL)) {
+		if (loc_req_info.cellular != NULL && loc_req_info.wifi != NULL &&
+		    loc_req_info.cellular->service == loc_req_info.wifi->service) {
+			loc_req_info.concurrent_method = LOCATION_METHOD_INTERNAL_WIFI_CELLULAR;
+		} else if (method_cellular_index < method_wifi_index) {
+			loc_req_info.concurrent_method = LOCATION_METHOD_CELLULAR;
+		} else {
+			loc_req_info.concurrent_method = LOCATION_METHOD_WIFI;
+		}
+	} else if (loc_req_info.config.mode == LOCATION_REQ_MODE_CONCURRENT) {
+		LOG_DBG("Concurrent mode requires GNSS and either Wi-Fi or cellular method, "
+			"running methods one after the other");
+	}
+#endif
+
 	/* Wi-Fi and cellular are not combined if LOCATION_REQ_MODE_ALL is used */
-	if (loc_req_info.config.mode == LOCATION_REQ_MODE_FALLBACK) {
+	if (loc_req_info.config.mode != LOCATION_REQ_MODE_ALL &&
+	    loc_req_info.concurrent_method == 0) {
 		/* Wi-Fi and cellular are combined if they are one after the other in method list */
 		if (abs(method_wifi_index - method_cellular_index) == 1) {
 			__ASSERT_NO_MSG(loc_req_info.cellular != NULL);
@@ -436,9 +501,17 @@ static void location_request_info_create(const struct location_config *config)
 
 	/* Compose a list of methods that are really used, including combined internal method */
 	for (int i = 0; i < loc_req_info.config.methods_count; i++) {
+		enum location_method method = loc_req_info.config.methods[i].method;
+
+		if (method == loc_req_info.concurrent_method ||
+		    (loc_req_info.concurrent_method == LOCATION_METHOD_INTERNAL_WIFI_CELLULAR &&
+		     (method == LOCATION_METHOD_WIFI || method == LOCATION_METHOD_CELLULAR))) {
+			/* Method running concurrently is not run one after the other */
+			continue;
+		}
+
 		if (combine_wifi_cell &&
-		    (loc_req_info.config.methods[i].method == LOCATION_METHOD_WIFI ||
-		     loc_req_info.config.methods[i].method == LOCATION_METHOD_CELLULAR)) {
+		    (method == LOCATION_METHOD_WIFI || method == LOCATION_METHOD_CELLULAR)) {
 
 			if (!combined) {
 				LOG_INF("Wi-Fi and cellular methods combined");
@@ -448,14 +521,13 @@ static void location_request_info_create(const struct location_config *config)
 				combined = true;
 			}
 		} else {
-			loc_req_info.methods[loc_req_info.methods_count] =
-				loc_req_info.config.methods[i].method;
+			loc_req_info.methods[loc_req_info.methods_count] = method;
 			loc_req_info.methods_count++;
 		}
 	}
 
 #if defined(CONFIG_LOG)
-	if (combined) {
+	if (combined || loc_req_info.concurrent_method != 0) {
 		/* Log the updated method list */
 		LOG_DBG("Updated location method list:");
 		for (int i = 0; i < loc_req_info.methods_count; i++) {
@@ -616,7 +688,9 @@ static void location_core_event_details_get(struct location_event_data *event)
 #endif
 }
 
-enum location_method location_core_event_method_resolve(enum location_method method)
+static enum location_method location_core_method_resolve(
+	enum location_method method,
+	double accuracy)
 {
 #if defined(CONFIG_LOCATION_METHOD_CELLULAR) && defined(CONFIG_LOCATION_METHOD_WIFI)
 	/* Other than combined Wi-Fi + cellular method is used as is */
@@ -625,12 +699,10 @@ enum location_method location_core_event_method_resolve(enum location_method met
 	}
 
 	/* If Wi-Fi and cellular were requested and location accuracy is available */
-	if (loc_req_info.wifi != NULL && loc_req_info.cellular != NULL &&
-	    loc_req_info.current_event_data.location.accuracy > 0) {
+	if (loc_req_info.wifi != NULL && loc_req_info.cellular != NULL && accuracy > 0) {
 
 		/* If accuracy is higher than Wi-Fi threshold, use cellular, otherwise Wi-Fi */
-		if (loc_req_info.current_event_data.location.accuracy >
-		    METHOD_WIFI_ACCURACY_THRESHOLD) {
+		if (accuracy > METHOD_WIFI_ACCURACY_THRESHOLD) {
 			return LOCATION_METHOD_CELLULAR;
 		} else {
 			return LOCATION_METHOD_WIFI;
@@ -644,17 +716,86 @@ enum location_method location_core_event_method_resolve(enum location_method met
 		return LOCATION_METHOD_CELLULAR;
 	}
 #else
+	ARG_UNUSED(accuracy);
+
 	return method;
 #endif
 }
 
+enum location_method location_core_event_method_resolve(enum location_method method)
+{
+	return location_core_method_resolve(
+		method, loc_req_info.current_event_data.location.accuracy);
+}
+
+static void location_core_metrics_result_update(
+	enum location_method method,
+	bool location_acquired,
+	int64_t start_uptime)
+{
+	struct location_method_metrics *metrics;
+	uint32_t ttf_ms = k_uptime_get() - start_uptime;
+	k_spinlock_key_t key;
+
+	if (method < LOCATION_METHOD_CELLULAR || method > LOCATION_METHOD_WIFI) {
+		return;
+	}
+
+	key = k_spin_lock(&method_metrics_lock);
+
+	metrics = &method_metrics[method - LOCATION_METHOD_CELLULAR];
+	metrics->attempts++;
+	if (location_acquired) {
+		metrics->fixes++;
+		metrics->ttf_last_ms = ttf_ms;
+		metrics->ttf_total_ms += ttf_ms;
+	}
+
+	k_spin_unlock(&method_metrics_lock, key);
+}
+
+void location_core_metrics_active_time_add(enum location_method method, int64_t duration_ms)
+{
+	k_spinlock_key_t key;
+
+	if (method < LOCATION_METHOD_CELLULAR || method > LOCATION_METHOD_WIFI ||
+	    duration_ms < 0) {
+		return;
+	}
+
+	key = k_spin_lock(&method_metrics_lock);
+	method_metrics[method - LOCATION_METHOD_CELLULAR].active_ms += duration_ms;
+	k_spin_unlock(&method_metrics_lock, key);
+}
+
+int location_core_metrics_get(enum location_method method, struct location_method_metrics *metrics)
+{
+	k_spinlock_key_t key;
+
+	if (method < LOCATION_METHOD_CELLULAR || method > LOCATION_METHOD_WIFI) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&method_metrics_lock);
+	*metrics = method_metrics[method - LOCATION_METHOD_CELLULAR];
+	k_spin_unlock(&method_metrics_lock, key);
+
+	return 0;
+}
+
+void location_core_metrics_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&method_metrics_lock);
+
+	memset(method_metrics, 0, sizeof(method_metrics));
+	k_spin_unlock(&method_metrics_lock, key);
+}
+
+static void location_core_event_process(void);
+
 static void location_core_event_cb_fn(struct k_work *work)
 {
-	char latitude_str[12];
-	char longitude_str[12];
-	char accuracy_str[12];
-	enum location_method requested_method;
-	int err;
+	ARG_UNUSED(work);
 
 	k_work_cancel_delayable(&location_core_method_timeout_work);
 	loc_req_info.current_event_data.method =
@@ -663,6 +804,118 @@ static void location_core_event_cb_fn(struct k_work *work)
 	/* Update the event structure with the details of the current method */
 	location_core_event_details_get(&loc_req_info.current_event_data);
 
+	/* Failure has been already accounted if the request timed out while waiting for
+	 * the concurrent method
+	 */
+	if (!loc_req_info.current_method_failed) {
+		location_core_metrics_result_update(
+			loc_req_info.current_event_data.method,
+			loc_req_info.current_event_data.id == LOCATION_EVT_LOCATION,
+			loc_req_info.current_method_uptime);
+	}
+
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	if (loc_req_info.concurrent_pending) {
+		if (loc_req_info.current_event_data.id != LOCATION_EVT_LOCATION) {
+			/* Wait for the concurrent method before falling back or giving up */
+			LOG_INF("Location retrieval failed using '%s', waiting for '%s'",
+				(char *)location_method_api_get(
+					loc_req_info.current_method)->method_string,
+				(char *)location_method_api_get(
+					loc_req_info.concurrent_method)->method_string);
+			loc_req_info.current_method_failed = true;
+			return;
+		}
+
+		/* First location wins */
+		LOG_DBG("Cancelling concurrent '%s' method",
+			(char *)location_method_api_get(
+				loc_req_info.concurrent_method)->method_string);
+		loc_req_info.concurrent_pending = false;
+		(void)method_cloud_location_cancel();
+	}
+#endif
+
+	location_core_event_process();
+}
+
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+static void location_core_concurrent_event_cb_fn(struct k_work *work)
+{
+	enum location_method method;
+
+	ARG_UNUSED(work);
+
+	if (!loc_req_info.concurrent_pending) {
+		/* Location request has been completed, cancelled or timed out meanwhile */
+		return;
+	}
+	loc_req_info.concurrent_pending = false;
+
+	method = location_core_method_resolve(
+		loc_req_info.concurrent_method, concurrent_event_data.location.accuracy);
+
+	location_core_metrics_result_update(
+		method,
+		concurrent_event_data.id == LOCATION_EVT_LOCATION,
+		loc_req_info.concurrent_method_uptime);
+
+	if (concurrent_event_data.id == LOCATION_EVT_LOCATION) {
+		/* First location wins so stop the method running one after the other */
+		if (!loc_req_info.current_method_failed) {
+			LOG_DBG("Cancelling '%s' method",
+				(char *)location_method_api_get(
+					loc_req_info.current_method)->method_string);
+			k_work_cancel_delayable(&location_core_method_timeout_work);
+			k_work_cancel(&location_event_cb_work);
+			(void)location_method_api_get(loc_req_info.current_method)->cancel();
+		}
+
+		location_core_current_event_data_init(loc_req_info.concurrent_method);
+		loc_req_info.current_event_data = concurrent_event_data;
+		loc_req_info.current_event_data.method = method;
+
+		location_core_event_process();
+	} else if (loc_req_info.current_method_failed) {
+		/* The other method failed earlier and was waiting for this one */
+		LOG_INF("Location retrieval failed also using '%s'",
+			(char *)location_method_api_get(
+				loc_req_info.concurrent_method)->method_string);
+
+		location_core_event_process();
+	} else {
+		LOG_INF("Location retrieval failed using '%s', waiting for '%s'",
+			(char *)location_method_api_get(
+				loc_req_info.concurrent_method)->method_string,
+			(char *)location_method_api_get(
+				loc_req_info.current_method)->method_string);
+	}
+}
+
+void location_core_event_cb_concurrent(
+	enum location_event_id id,
+	const struct location_data *location)
+{
+	memset(&concurrent_event_data, 0, sizeof(concurrent_event_data));
+	concurrent_event_data.id = id;
+	if (location) {
+		concurrent_event_data.location = *location;
+	}
+
+	k_work_submit_to_queue(
+		location_core_work_queue_get(),
+		&location_concurrent_event_cb_work);
+}
+#endif
+
+static void location_core_event_process(void)
+{
+	char latitude_str[12];
+	char longitude_str[12];
+	char accuracy_str[12];
+	enum location_method requested_method;
+	int err;
+
 	if (loc_req_info.current_event_data.id == LOCATION_EVT_LOCATION) {
 		/* Location was acquired properly.
 		 * Caller sets loc_req_info.current_event_data.location
@@ -816,6 +1069,12 @@ static void location_core_timeout_work_fn(struct k_work *work)
 	LOG_INF("Timeout for entire location request expired");
 
 	location_method_api_get(current_method)->timeout();
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	if (loc_req_info.concurrent_pending) {
+		loc_req_info.concurrent_pending = false;
+		(void)method_cloud_location_cancel();
+	}
+#endif
 	/* config->timeout needs to expire without fallbacks */
 
 	loc_req_info.current_event_data.id = LOCATION_EVT_TIMEOUT;
@@ -856,6 +1115,16 @@ int location_core_cancel(void)
 	k_work_cancel_delayable(&location_core_timeout_work);
 	k_work_cancel_delayable(&location_periodic_work);
 	k_work_cancel(&location_event_cb_work);
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	k_work_cancel(&location_concurrent_event_cb_work);
+	if (loc_req_info.concurrent_pending) {
+		LOG_DBG("Cancelling concurrent '%s' method",
+			(char *)location_method_api_get(
+				loc_req_info.concurrent_method)->method_string);
+		loc_req_info.concurrent_pending = false;
+		(void)method_cloud_location_cancel();
+	}
+#endif
 
 	/* Check if location has been requested using one of the methods */
 	if (current_method != 0) {
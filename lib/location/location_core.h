@@ -37,6 +37,24 @@ struct location_request_info {
 	/** Whether to perform fallback for current location request processing. */
 	bool execute_fallback;
 
+	/** Device uptime when the currently used method was started. */
+	int64_t current_method_uptime;
+
+	/**
+	 * Cloud location method run at the same time as the other methods in
+	 * LOCATION_REQ_MODE_CONCURRENT, or 0 if there is none.
+	 */
+	int concurrent_method;
+
+	/** Device uptime when the concurrent method was started. */
+	int64_t concurrent_method_uptime;
+
+	/** Whether the concurrent method is still acquiring location. */
+	bool concurrent_pending;
+
+	/** Whether the currently used method has failed while the concurrent one is pending. */
+	bool current_method_failed;
+
 	/**
 	 * Device uptime when location request timer expires.
 	 * This is used in cloud location method to calculate timeout for the cloud operation.
@@ -66,6 +84,11 @@ int location_core_cancel(void);
 void location_core_event_cb(const struct location_data *location);
 void location_core_event_cb_error(void);
 void location_core_event_cb_timeout(void);
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+void location_core_event_cb_concurrent(
+	enum location_event_id id,
+	const struct location_data *location);
+#endif
 #if defined(CONFIG_LOCATION_SERVICE_EXTERNAL) && defined(CONFIG_NRF_CLOUD_AGPS)
 void location_core_event_cb_agps_request(const struct nrf_modem_gnss_agps_data_frame *request);
 #endif
@@ -85,4 +108,8 @@ void location_core_timer_start(int32_t timeout);
 void location_core_timer_stop(void);
 struct k_work_q *location_core_work_queue_get(void);
 
+void location_core_metrics_active_time_add(enum location_method method, int64_t duration_ms);
+int location_core_metrics_get(enum location_method method, struct location_method_metrics *metrics);
+void location_core_metrics_reset(void);
+
 #endif /* LOCATION_CORE_H */
@@ -15,6 +15,7 @@
 #include "location_utils.h"
 #include "scan_cellular.h"
 #include "scan_wifi.h"
+#include "method_cloud_location.h"
 #include "cloud_service/cloud_service.h"
 
 LOG_MODULE_DECLARE(location, CONFIG_LOCATION_LOG_LEVEL);
@@ -31,20 +32,145 @@ struct method_cloud_location_start_work_args {
 	const struct location_wifi_config *wifi_config;
 	const struct location_cellular_config *cell_config;
 	int64_t locreq_timeout_uptime;
+	bool concurrent;
+	/* Generation of the request, zero once the work item has taken the arguments */
+	uint32_t gen;
 };
 
 static struct method_cloud_location_start_work_args method_cloud_location_start_work;
-static bool running;
+
+/* Protects the work item arguments and the request generations */
+static struct k_spinlock lock;
+
+/* Generation of the latest request */
+static uint32_t request_gen;
+
+/* Generation of the running request, zero if not running. A work item of a cancelled request
+ * may still be running in another work queue and must not report results for the next request.
+ */
+static uint32_t running_gen;
+
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+#define METHOD_CLOUD_LOCATION_STACK_SIZE CONFIG_LOCATION_CONCURRENT_WORKQUEUE_STACK_SIZE
+#define METHOD_CLOUD_LOCATION_PRIORITY 5
+K_THREAD_STACK_DEFINE(method_cloud_location_stack, METHOD_CLOUD_LOCATION_STACK_SIZE);
+
+/**
+ * Work queue for running cloud location method at the same time with GNSS, which uses
+ * the library work queue and blocks it while waiting for the LTE modem to become idle.
+ */
+static struct k_work_q method_cloud_location_work_q;
+
+/**
+ * Work item for concurrent mode. A request running in the library work queue may not have
+ * returned yet when a concurrent request is started.
+ */
+static struct method_cloud_location_start_work_args method_cloud_location_concurrent_work;
+
+/** Handler for scan timeout in concurrent mode. */
+static void method_cloud_location_timeout_work_fn(struct k_work *work);
+
+/** Work item for scan timeout in concurrent mode. */
+K_WORK_DELAYABLE_DEFINE(method_cloud_location_timeout_work, method_cloud_location_timeout_work_fn);
+
+static void method_cloud_location_timeout_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	LOG_INF("Cloud location method specific timeout expired");
+
+	if (method_cloud_location_cancel() == 0) {
+		location_core_event_cb_concurrent(LOCATION_EVT_TIMEOUT, NULL);
+	}
+}
+#endif
+
+static bool method_cloud_location_is_running(uint32_t gen)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool ret = (running_gen == gen);
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+/* Returns true if the request was still running and is now stopped by the caller. */
+static bool method_cloud_location_stop(uint32_t gen)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool ret = (running_gen == gen);
+
+	if (ret) {
+		running_gen = 0;
+	}
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+static void method_cloud_location_timer_start(int32_t timeout, bool concurrent)
+{
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	/* Method timer of the library is used by the method running alongside */
+	if (concurrent) {
+		if (timeout != SYS_FOREVER_MS && timeout > 0) {
+			k_work_schedule(&method_cloud_location_timeout_work, K_MSEC(timeout));
+		}
+		return;
+	}
+#endif
+	location_core_timer_start(timeout);
+}
+
+static void method_cloud_location_timer_stop(bool concurrent)
+{
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	if (concurrent) {
+		k_work_cancel_delayable(&method_cloud_location_timeout_work);
+		return;
+	}
+#endif
+	location_core_timer_stop();
+}
+
+static void method_cloud_location_result_report(
+	enum location_event_id id,
+	const struct location_data *location,
+	bool concurrent)
+{
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	if (concurrent) {
+		location_core_event_cb_concurrent(id, location);
+		return;
+	}
+#endif
+	switch (id) {
+	case LOCATION_EVT_LOCATION:
+		location_core_event_cb(location);
+		break;
+	case LOCATION_EVT_TIMEOUT:
+		location_core_event_cb_timeout();
+		break;
+	default:
+		location_core_event_cb_error();
+		break;
+	}
+}
 
 static void method_cloud_location_positioning_work_fn(struct k_work *work)
 {
 	struct method_cloud_location_start_work_args *work_data =
 		CONTAINER_OF(work, struct method_cloud_location_start_work_args, work_item);
-	const struct location_wifi_config *wifi_config = work_data->wifi_config;
-	const struct location_cellular_config *cell_config = work_data->cell_config;
+	const struct location_wifi_config *wifi_config;
+	const struct location_cellular_config *cell_config;
 	struct wifi_scan_info *scan_wifi_info = NULL;
 	struct lte_lc_cells_info *scan_cellular_info = NULL;
+	int64_t locreq_timeout_uptime;
 	int32_t used_timeout_ms;
+	k_spinlock_key_t key;
+	uint32_t gen;
+	bool concurrent;
 	int err = 0;
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
 	struct k_sem wifi_scan_ready;
@@ -52,6 +178,21 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 	k_sem_init(&wifi_scan_ready, 0, 1);
 #endif
 
+	/* Arguments may be rewritten for the next request while this one is running */
+	key = k_spin_lock(&lock);
+	gen = work_data->gen;
+	wifi_config = work_data->wifi_config;
+	cell_config = work_data->cell_config;
+	locreq_timeout_uptime = work_data->locreq_timeout_uptime;
+	concurrent = work_data->concurrent;
+	work_data->gen = 0;
+	k_spin_unlock(&lock, key);
+
+	if (gen == 0 || !method_cloud_location_is_running(gen)) {
+		/* Already run, or cancelled before the work item got to run */
+		return;
+	}
+
 	if (wifi_config != NULL && cell_config != NULL) {
 		used_timeout_ms = MIN(cell_config->timeout, wifi_config->timeout);
 	} else if (cell_config != NULL) {
@@ -61,7 +202,7 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 		used_timeout_ms = wifi_config->timeout;
 	}
 
-	location_core_timer_start(used_timeout_ms);
+	method_cloud_location_timer_start(used_timeout_ms, concurrent);
 
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
 	if (wifi_config != NULL) {
@@ -83,11 +224,11 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 	}
 #endif
 
-	if (!running) {
-		goto end;
+	if (!method_cloud_location_is_running(gen)) {
+		return;
 	}
 
-	location_core_timer_stop();
+	method_cloud_location_timer_stop(concurrent);
 
 	if (scan_cellular_info == NULL && scan_wifi_info == NULL) {
 		LOG_WRN("No cellular neighbor cells or Wi-Fi access points found");
@@ -132,8 +273,8 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 	/* Timeout for cloud request is the remaining time from the location request timeout.
 	 * Notice that it's not from the method timeout, which only applies to the scan procedure.
 	 */
-	if (work_data->locreq_timeout_uptime != SYS_FOREVER_MS) {
-		params.timeout_ms = work_data->locreq_timeout_uptime - k_uptime_get();
+	if (locreq_timeout_uptime != SYS_FOREVER_MS) {
+		params.timeout_ms = locreq_timeout_uptime - k_uptime_get();
 		if (params.timeout_ms < 0) {
 			LOG_WRN("Timeout occurred during scannings");
 			err = -ETIMEDOUT;
@@ -149,74 +290,142 @@ static void method_cloud_location_positioning_work_fn(struct k_work *work)
 		location_result.latitude = location.latitude;
 		location_result.longitude = location.longitude;
 		location_result.accuracy = location.accuracy;
-		if (running) {
-			running = false;
-			location_core_event_cb(&location_result);
+		if (method_cloud_location_stop(gen)) {
+			method_cloud_location_result_report(
+				LOCATION_EVT_LOCATION, &location_result, concurrent);
 		}
 	}
 #endif /* defined(CONFIG_LOCATION_SERVICE_EXTERNAL) */
 
 end:
-	if (err == -ETIMEDOUT) {
-		location_core_event_cb_timeout();
-		running = false;
-	} else if (err) {
-		location_core_event_cb_error();
-		running = false;
+	if (err && method_cloud_location_stop(gen)) {
+		method_cloud_location_result_report(
+			(err == -ETIMEDOUT) ? LOCATION_EVT_TIMEOUT : LOCATION_EVT_ERROR,
+			NULL,
+			concurrent);
 	}
 }
 
 int method_cloud_location_cancel(void)
 {
-	if (running) {
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool running = (running_gen != 0);
+
+	/* A work item still running returns without reporting once it sees this */
+	running_gen = 0;
+	k_spin_unlock(&lock, key);
+
+	if (!running) {
+		return -EPERM;
+	}
+
 #if defined(CONFIG_LOCATION_METHOD_WIFI)
-		scan_wifi_cancel();
+	scan_wifi_cancel();
 #endif
 #if defined(CONFIG_LOCATION_METHOD_CELLULAR)
-		scan_cellular_cancel();
+	scan_cellular_cancel();
+#endif
+	(void)k_work_cancel(&method_cloud_location_start_work.work_item);
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	(void)k_work_cancel(&method_cloud_location_concurrent_work.work_item);
+	(void)k_work_cancel_delayable(&method_cloud_location_timeout_work);
 #endif
-		(void)k_work_cancel(&method_cloud_location_start_work.work_item);
 
-		running = false;
-	} else {
-		return -EPERM;
-	}
 	return 0;
 }
 
-int method_cloud_location_get(const struct location_request_info *request)
+static void method_cloud_location_start(
+	const struct location_request_info *request,
+	int method,
+	struct method_cloud_location_start_work_args *work_data,
+	bool concurrent,
+	struct k_work_q *work_q)
 {
+	k_spinlock_key_t key;
+
 	__ASSERT_NO_MSG(request->cellular != NULL || request->wifi != NULL);
 
-	k_work_init(
-		&method_cloud_location_start_work.work_item,
-		method_cloud_location_positioning_work_fn);
+	key = k_spin_lock(&lock);
 
 	/* Select configurations based on requested method */
-	method_cloud_location_start_work.wifi_config = NULL;
-	method_cloud_location_start_work.cell_config = NULL;
-	if (request->current_method == LOCATION_METHOD_CELLULAR ||
-	    request->current_method == LOCATION_METHOD_INTERNAL_WIFI_CELLULAR) {
-		method_cloud_location_start_work.cell_config = request->cellular;
+	work_data->wifi_config = NULL;
+	work_data->cell_config = NULL;
+	if (method == LOCATION_METHOD_CELLULAR ||
+	    method == LOCATION_METHOD_INTERNAL_WIFI_CELLULAR) {
+		work_data->cell_config = request->cellular;
 	}
-	if (request->current_method == LOCATION_METHOD_WIFI ||
-	    request->current_method == LOCATION_METHOD_INTERNAL_WIFI_CELLULAR) {
-		method_cloud_location_start_work.wifi_config = request->wifi;
+	if (method == LOCATION_METHOD_WIFI ||
+	    method == LOCATION_METHOD_INTERNAL_WIFI_CELLULAR) {
+		work_data->wifi_config = request->wifi;
 	}
 
-	method_cloud_location_start_work.locreq_timeout_uptime = request->timeout_uptime;
-	k_work_submit_to_queue(
-		location_core_work_queue_get(),
-		&method_cloud_location_start_work.work_item);
+	work_data->locreq_timeout_uptime = request->timeout_uptime;
+	work_data->concurrent = concurrent;
 
-	running = true;
+	/* Zero is reserved for a request that is not running */
+	request_gen++;
+	if (request_gen == 0) {
+		request_gen++;
+	}
+	work_data->gen = request_gen;
+	running_gen = request_gen;
+
+	k_spin_unlock(&lock, key);
+
+	k_work_submit_to_queue(work_q, &work_data->work_item);
+}
+
+int method_cloud_location_get(const struct location_request_info *request)
+{
+	method_cloud_location_start(
+		request, request->current_method, &method_cloud_location_start_work, false,
+		location_core_work_queue_get());
 
 	return 0;
 }
 
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+int method_cloud_location_concurrent_get(const struct location_request_info *request)
+{
+	method_cloud_location_start(
+		request, request->concurrent_method, &method_cloud_location_concurrent_work, true,
+		&method_cloud_location_work_q);
+
+	return 0;
+}
+#endif
+
 int method_cloud_location_init(void)
 {
-	running = false;
+	running_gen = 0;
+
+	/* Work items are initialized only once, as a previous request may still be running */
+	k_work_init(
+		&method_cloud_location_start_work.work_item,
+		method_cloud_location_positioning_work_fn);
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	k_work_init(
+		&method_cloud_location_concurrent_work.work_item,
+		method_cloud_location_positioning_work_fn);
+#endif
+
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+	static bool work_q_started;
+	struct k_work_queue_config cfg = {
+		.name = "location_cloud_workq",
+	};
+
+	/* Initialization is repeated if a method initialized before this one fails */
+	if (!work_q_started) {
+		k_work_queue_start(
+			&method_cloud_location_work_q,
+			method_cloud_location_stack,
+			K_THREAD_STACK_SIZEOF(method_cloud_location_stack),
+			METHOD_CLOUD_LOCATION_PRIORITY,
+			&cfg);
+		work_q_started = true;
+	}
+#endif
 
 #if !defined(CONFIG_LOCATION_SERVICE_EXTERNAL)
 	cloud_service_init();
@@ -10,5 +10,8 @@
 int method_cloud_location_get(const struct location_request_info *request);
 int method_cloud_location_init(void);
 int method_cloud_location_cancel(void);
+#if defined(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)
+int method_cloud_location_concurrent_get(const struct location_request_info *request);
+#endif
 
 #endif /* METHOD_CLOUD_LOCATION_H */
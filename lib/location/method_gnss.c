@@ -111,6 +111,7 @@ static struct gps_pgps_request pgps_request;
 #endif
 
 static bool running;
+static int64_t gnss_start_uptime;
 static struct location_gnss_config gnss_config;
 static K_SEM_DEFINE(entered_psm_mode, 0, 1);
 static K_SEM_DEFINE(entered_rrc_idle, 1, 1);
@@ -594,6 +595,12 @@ int method_gnss_cancel(void)
 		LOG_ERR("Failed to stop GNSS");
 	}
 
+	if (gnss_start_uptime != 0) {
+		location_core_metrics_active_time_add(
+			LOCATION_METHOD_GNSS, k_uptime_get() - gnss_start_uptime);
+		gnss_start_uptime = 0;
+	}
+
 	running = false;
 
 	/* Cancel any work that has not been started yet */
@@ -953,6 +960,8 @@ static void method_gnss_positioning_work_fn(struct k_work *work)
 		return;
 	}
 
+	gnss_start_uptime = k_uptime_get();
+
 	location_core_timer_start(gnss_config.timeout);
 }
 
@@ -91,6 +91,7 @@ int scan_cellular_start(uint8_t cell_count)
 		.search_type = LTE_LC_NEIGHBOR_SEARCH_TYPE_EXTENDED_COMPLETE,
 		.gci_count = 0
 	};
+	int64_t start_uptime = k_uptime_get();
 	int err;
 
 	running = true;
@@ -159,6 +160,8 @@ int scan_cellular_start(uint8_t cell_count)
 	}
 
 end:
+	location_core_metrics_active_time_add(
+		LOCATION_METHOD_CELLULAR, k_uptime_get() - start_uptime);
 	running = false;
 	return err;
 }
@@ -27,6 +27,7 @@ static struct wifi_scan_info scan_wifi_info = {
 	.ap_info = scan_results,
 };
 static struct k_sem *scan_wifi_ready;
+static int64_t scan_wifi_start_uptime;
 
 struct wifi_scan_info *scan_wifi_results_get(void)
 {
@@ -55,6 +56,7 @@ int scan_wifi_start(struct k_sem *wifi_scan_ready)
 	LOG_DBG("Triggering start of Wi-Fi scanning");
 
 	scan_wifi_info.cnt = 0;
+	scan_wifi_start_uptime = k_uptime_get();
 
 	__ASSERT_NO_MSG(wifi_iface != NULL);
 	ret = net_mgmt(NET_REQUEST_WIFI_SCAN, wifi_iface, NULL, 0);
@@ -102,6 +104,9 @@ static void scan_wifi_done_handle(struct net_mgmt_event_callback *cb)
 		LOG_DBG("Scan request done with %d Wi-Fi APs", scan_wifi_info.cnt);
 	}
 
+	location_core_metrics_active_time_add(
+		LOCATION_METHOD_WIFI, k_uptime_get() - scan_wifi_start_uptime);
+
 	k_sem_give(scan_wifi_ready);
 	scan_wifi_ready = NULL;
 }
@@ -5,9 +5,14 @@
  */
 
 #include <zephyr/kernel.h>
-#include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 #include <qos.h>
 
+#if defined(CONFIG_QOS_PERSISTENT)
+#include <stdlib.h>
+#include <zephyr/settings/settings.h>
+#endif
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(qos, CONFIG_QOS_LOG_LEVEL);
 
@@ -18,13 +23,30 @@ LOG_MODULE_REGISTER(qos, CONFIG_QOS_LOG_LEVEL);
 #define STATIC static
 #endif
 
+/* Size of the open addressing table used to look up pending messages by ID. Twice the number of
+ * entries keeps the probe sequences short.
+ */
+#define ID_INDEX_SIZE (2 * CONFIG_QOS_PENDING_MESSAGES_MAX)
+
+/* Value of an unused ID index entry. Used entries hold the list index + 1. */
+#define ID_INDEX_EMPTY 0
+
 /* Structure used to keep track of pending messages. Used in combination with a linked list. */
 struct qos_metadata {
 	/* Mandatory variable used to construct a linked list. */
-	sys_snode_t header;
+	sys_dnode_t header;
+
+	/* System uptime in milliseconds when the message is notified next. */
+	int64_t deadline;
+
+	/* Current notification interval in seconds. Doubled after every notification. */
+	uint32_t backoff;
 
 	/* Message associated with each node in the linked list. */
 	struct qos_data message;
+
+	/* The message is stored in non-volatile memory. */
+	bool stored;
 };
 
 /* Structure containing internal variables in the library.  */
@@ -35,8 +57,14 @@ STATIC struct ctx {
 	/* Internal array of pending messages. Used in combination with linked list. */
 	struct qos_metadata list_internal[CONFIG_QOS_PENDING_MESSAGES_MAX];
 
-	/* Linked list used to keep track of pending messages. */
-	sys_slist_t pending_list;
+	/* Linked list used to keep track of pending messages, in the order they were added. */
+	sys_dlist_t pending_list;
+
+	/* Linked list of unused entries in the internal array. */
+	sys_dlist_t free_list;
+
+	/* Table that maps message IDs to entries in the internal array. */
+	uint16_t id_index[ID_INDEX_SIZE];
 
 	/* Variable used to prevent multiple library initializations. */
 	bool initialized;
@@ -46,6 +74,9 @@ STATIC struct ctx {
 
 	/* Internal variable used to generate message IDs. */
 	uint16_t message_id_next;
+
+	/* Library statistics. */
+	struct qos_stats stats;
 } ctx = {
 	.message_id_next = QOS_MESSAGE_ID_BASE
 };
@@ -64,50 +95,190 @@ static void notify_event(struct qos_evt *evt)
 	}
 }
 
-STATIC void timeout_handler_work_fn(struct k_work *work)
+static size_t id_index_home(uint32_t id)
 {
-	struct qos_metadata *node = NULL, *next_node = NULL;
-	struct qos_evt evt = {
-		.type = QOS_EVT_MESSAGE_REMOVED_FROM_LIST
-	};
+	return id % ID_INDEX_SIZE;
+}
 
-	k_mutex_lock(&ctx_lock, K_FOREVER);
+static void id_index_add(uint32_t id, size_t list_index)
+{
+	size_t i = id_index_home(id);
+
+	/* The table is never full, it has twice as many entries as the internal array. */
+	while (ctx.id_index[i] != ID_INDEX_EMPTY) {
+		i = (i + 1) % ID_INDEX_SIZE;
+	}
+
+	ctx.id_index[i] = list_index + 1;
+}
+
+static int id_index_find(uint32_t id)
+{
+	size_t i = id_index_home(id);
+
+	while (ctx.id_index[i] != ID_INDEX_EMPTY) {
+		if (ctx.list_internal[ctx.id_index[i] - 1].message.id == id) {
+			return i;
+		}
+
+		i = (i + 1) % ID_INDEX_SIZE;
+	}
+
+	return -ENODATA;
+}
 
-	/* Remove all messages where the notified_count equals or exceeds
-	 * CONFIG_QOS_MESSAGE_NOTIFIED_COUNT_MAX
+static void id_index_remove(size_t i)
+{
+	size_t j = i;
+
+	/* Shift back the following entries of the probe sequence, so that lookups do not stop
+	 * at the freed entry.
 	 */
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
-		if (node->message.notified_count >= CONFIG_QOS_MESSAGE_NOTIFIED_COUNT_MAX) {
-			LOG_DBG("Notified count for message ID: %d exceeds the maximum allowed "
-				"value, remove message from pending list.", node->message.id);
-			evt.message = node->message;
-			notify_event(&evt);
-			memset(&node->message, 0, sizeof(struct qos_data));
-			sys_slist_find_and_remove(&ctx.pending_list, &node->header);
+	while (true) {
+		size_t home;
+
+		j = (j + 1) % ID_INDEX_SIZE;
+
+		if (ctx.id_index[j] == ID_INDEX_EMPTY) {
+			break;
 		}
-	};
 
-	/* Don't shedule a new work if the pending list is empty. */
-	if (sys_slist_is_empty(&ctx.pending_list)) {
-		LOG_DBG("QoS list is empty, don't reschedule work");
-		goto exit;
+		home = id_index_home(ctx.list_internal[ctx.id_index[j] - 1].message.id);
+
+		/* Skip entries whose home position lies cyclically in (i, j]. */
+		if ((i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j))) {
+			continue;
+		}
+
+		ctx.id_index[i] = ctx.id_index[j];
+		i = j;
 	}
 
-	/* Notify all remaining entries in the list. */
-	evt.type = QOS_EVT_MESSAGE_TIMER_EXPIRED;
+	ctx.id_index[i] = ID_INDEX_EMPTY;
+}
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
-		node->message.notified_count++;
-		evt.message = node->message;
-		notify_event(&evt);
-	};
+#if defined(CONFIG_QOS_PERSISTENT)
+#define SETTINGS_KEY "qos"
+/* Notified counts are kept in a separate subtree, so that a notification does not rewrite
+ * the whole message.
+ */
+#define SETTINGS_COUNT_KEY "qos_cnt"
+#define SETTINGS_KEY_LEN_MAX sizeof(SETTINGS_COUNT_KEY "/4294967295")
+
+/* Format of a message stored in flash. Only the used part of the payload is stored. */
+struct persistent_message {
+	uint32_t flags;
+	uint32_t id;
+	uint16_t notified_count;
+	uint8_t type;
+	uint8_t payload[CONFIG_QOS_PERSISTENT_PAYLOAD_SIZE_MAX];
+};
 
-	k_work_reschedule(&ctx.timeout_handler_work,
-			  K_SECONDS(CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_SECONDS));
-exit:
-	k_mutex_unlock(&ctx_lock);
+#define PERSISTENT_HEADER_SIZE offsetof(struct persistent_message, payload)
+
+/* Buffer protected by ctx_lock. */
+static struct persistent_message persistent_buf;
+
+static void persistent_key_get(char *key, uint32_t id)
+{
+	snprintk(key, SETTINGS_KEY_LEN_MAX, SETTINGS_KEY "/%u", id);
 }
 
+static void persistent_count_key_get(char *key, uint32_t id)
+{
+	snprintk(key, SETTINGS_KEY_LEN_MAX, SETTINGS_COUNT_KEY "/%u", id);
+}
+
+static void persistent_store(struct qos_metadata *node)
+{
+	const struct qos_data *message = &node->message;
+	char key[SETTINGS_KEY_LEN_MAX];
+	int err;
+
+	if (message->data.len > sizeof(persistent_buf.payload)) {
+		LOG_WRN("Message ID: %d payload too large to be stored", message->id);
+		return;
+	}
+
+	persistent_buf.flags = message->flags;
+	persistent_buf.id = message->id;
+	persistent_buf.notified_count = message->notified_count;
+	persistent_buf.type = message->type;
+	memcpy(persistent_buf.payload, message->data.buf, message->data.len);
+
+	persistent_key_get(key, message->id);
+
+	err = settings_save_one(key, &persistent_buf, PERSISTENT_HEADER_SIZE + message->data.len);
+	if (err) {
+		LOG_WRN("Failed to store message ID: %d, error: %d", message->id, err);
+		return;
+	}
+
+	node->stored = true;
+}
+
+/* Update the stored notified count of a message, messages that were not stored are skipped.
+ * The count is stored on its own and overrides the count stored with the message.
+ */
+static void persistent_update(struct qos_metadata *node)
+{
+	const struct qos_data *message = &node->message;
+	char key[SETTINGS_KEY_LEN_MAX];
+	int err;
+
+	if (!node->stored) {
+		return;
+	}
+
+	persistent_count_key_get(key, message->id);
+
+	err = settings_save_one(key, &message->notified_count, sizeof(message->notified_count));
+	if (err) {
+		LOG_WRN("Failed to store notified count of message ID: %d, error: %d",
+			message->id, err);
+	}
+}
+
+static void persistent_delete(struct qos_metadata *node)
+{
+	char key[SETTINGS_KEY_LEN_MAX];
+	int err;
+
+	if (!node->stored) {
+		return;
+	}
+
+	node->stored = false;
+
+	persistent_key_get(key, node->message.id);
+
+	err = settings_delete(key);
+	if (err) {
+		LOG_WRN("Failed to delete message ID: %d, error: %d", node->message.id, err);
+	}
+
+	persistent_count_key_get(key, node->message.id);
+
+	err = settings_delete(key);
+	if (err) {
+		LOG_WRN("Failed to delete notified count of message ID: %d, error: %d",
+			node->message.id, err);
+	}
+}
+#else
+static void persistent_store(struct qos_metadata *node)
+{
+}
+
+static void persistent_update(struct qos_metadata *node)
+{
+}
+
+static void persistent_delete(struct qos_metadata *node)
+{
+}
+#endif /* CONFIG_QOS_PERSISTENT */
+
 /* @brief Function that appends a message to the internal list of pending messages.
  *
  * @returns A positive value indicating the index of the internal list that the message was
@@ -117,51 +288,279 @@ exit:
  */
 static int list_append(struct qos_data *message)
 {
-	/* Mark the initial list index as invalid. */
-	int index_next = -1;
+	struct qos_metadata *node;
+	size_t index;
 
-	/* Find the next available list index. */
-	for (int i = 0; i < ARRAY_SIZE(ctx.list_internal); i++) {
-		if ((ctx.list_internal[i].message.notified_count == 0) &&
-		    (ctx.list_internal[i].message.data.buf == NULL)) {
-			index_next = i;
-			break;
-		}
-	}
-
-	if (index_next == -1) {
+	node = SYS_DLIST_CONTAINER(sys_dlist_get(&ctx.free_list), node, header);
+	if (node == NULL) {
 		LOG_ERR("No available entries in pending message list");
 		return -ENOMEM;
 	}
 
-	ctx.list_internal[index_next].message = *message;
+	index = node - ctx.list_internal;
 
-	sys_slist_append(&ctx.pending_list, &ctx.list_internal[index_next].header);
-	return index_next;
+	node->message = *message;
+	node->stored = false;
+	node->backoff = CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_SECONDS;
+	node->deadline = k_uptime_get() + node->backoff * MSEC_PER_SEC;
+
+	sys_dlist_append(&ctx.pending_list, &node->header);
+	id_index_add(message->id, index);
+
+	ctx.stats.depth++;
+	ctx.stats.depth_peak = MAX(ctx.stats.depth_peak, ctx.stats.depth);
+
+	return index;
 }
 
-static int list_remove(uint32_t id)
+static void list_node_remove(struct qos_metadata *node)
 {
-	struct qos_metadata *node = NULL, *next_node = NULL, *node_prev = NULL;
 	struct qos_evt evt = {
 		.type = QOS_EVT_MESSAGE_REMOVED_FROM_LIST,
+		.message = node->message,
 	};
+	size_t i = id_index_home(node->message.id);
+	uint16_t entry = (node - ctx.list_internal) + 1;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
-		if (node->message.id == id) {
-			evt.message = node->message;
-			notify_event(&evt);
-			memset(&node->message, 0, sizeof(struct qos_data));
-			sys_slist_remove(&ctx.pending_list, &node_prev->header, &node->header);
-			return 0;
+	/* Messages may share an ID, look up the entry of this node. */
+	while (ctx.id_index[i] != entry) {
+		__ASSERT_NO_MSG(ctx.id_index[i] != ID_INDEX_EMPTY);
+		i = (i + 1) % ID_INDEX_SIZE;
+	}
+
+	id_index_remove(i);
+
+	sys_dlist_remove(&node->header);
+	sys_dlist_append(&ctx.free_list, &node->header);
+
+	ctx.stats.depth--;
+
+	persistent_delete(node);
+
+	notify_event(&evt);
+	memset(&node->message, 0, sizeof(struct qos_data));
+}
+
+static int list_remove(uint32_t id)
+{
+	int i = id_index_find(id);
+
+	if (i < 0) {
+		return -ENODATA;
+	}
+
+	list_node_remove(&ctx.list_internal[ctx.id_index[i] - 1]);
+
+	return 0;
+}
+
+/* Reschedule the backoff timer to the earliest deadline of the pending messages. */
+static void timer_update(void)
+{
+	struct qos_metadata *node;
+	int64_t deadline = INT64_MAX;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&ctx.pending_list, node, header) {
+		deadline = MIN(deadline, node->deadline);
+	}
+
+	if (deadline == INT64_MAX) {
+		LOG_DBG("QoS list is empty, cancel ongoing delayed work");
+		k_work_cancel_delayable(&ctx.timeout_handler_work);
+		return;
+	}
+
+	k_work_reschedule(&ctx.timeout_handler_work,
+			  K_MSEC(MAX(deadline - k_uptime_get(), 0)));
+}
+
+STATIC void timeout_handler_work_fn(struct k_work *work)
+{
+	struct qos_metadata *node = NULL, *next_node = NULL;
+	struct qos_evt evt = {
+		.type = QOS_EVT_MESSAGE_TIMER_EXPIRED
+	};
+	int64_t now = k_uptime_get();
+	uint32_t notified = 0;
+
+	k_mutex_lock(&ctx_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+		if (node->deadline > now) {
+			continue;
+		}
+
+		/* Remove messages where the notified_count equals or exceeds
+		 * CONFIG_QOS_MESSAGE_NOTIFIED_COUNT_MAX
+		 */
+		if (node->message.notified_count >= CONFIG_QOS_MESSAGE_NOTIFIED_COUNT_MAX) {
+			LOG_DBG("Notified count for message ID: %d exceeds the maximum allowed "
+				"value, remove message from pending list.", node->message.id);
+			ctx.stats.dropped++;
+			list_node_remove(node);
+			continue;
 		}
 
-		node_prev = node;
+		/* Spread the notifications of a large backlog over multiple batches. */
+		if ((CONFIG_QOS_MESSAGE_NOTIFY_BATCH_SIZE > 0) &&
+		    (notified >= CONFIG_QOS_MESSAGE_NOTIFY_BATCH_SIZE)) {
+			node->deadline = now + CONFIG_QOS_MESSAGE_NOTIFY_BATCH_INTERVAL_MS;
+			continue;
+		}
+
+		node->message.notified_count++;
+		node->deadline = now + node->backoff * MSEC_PER_SEC;
+		node->backoff = MIN(node->backoff * 2,
+				    CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_MAX_SECONDS);
+
+		ctx.stats.retries++;
+		notified++;
+
+		persistent_update(node);
+
+		evt.message = node->message;
+		notify_event(&evt);
 	};
 
-	return -ENODATA;
+	timer_update();
+
+	k_mutex_unlock(&ctx_lock);
 }
 
+#if defined(CONFIG_QOS_PERSISTENT)
+/* Called by settings_load_subtree_direct() for every stored message. Messages are only loaded
+ * from qos_init(), not by the application loading all settings.
+ */
+static int persistent_message_load(const char *key, size_t len, settings_read_cb read_cb,
+				   void *cb_arg, void *param)
+{
+	struct qos_data message = { 0 };
+	size_t payload_len;
+	ssize_t read_len;
+	int ret;
+
+	ARG_UNUSED(param);
+
+	if ((len < PERSISTENT_HEADER_SIZE) || (len > sizeof(persistent_buf))) {
+		LOG_WRN("Invalid stored message size: %zu", len);
+		return -EINVAL;
+	}
+
+	read_len = read_cb(cb_arg, &persistent_buf, len);
+	if (read_len != len) {
+		return -EIO;
+	}
+
+	payload_len = len - PERSISTENT_HEADER_SIZE;
+
+	message.flags = persistent_buf.flags;
+	message.id = persistent_buf.id;
+	message.notified_count = persistent_buf.notified_count;
+	message.type = persistent_buf.type;
+	message.data.len = payload_len;
+
+	if (payload_len > 0) {
+		message.data.buf = k_malloc(payload_len);
+		if (message.data.buf == NULL) {
+			return -ENOMEM;
+		}
+
+		memcpy(message.data.buf, persistent_buf.payload, payload_len);
+		message.heap_allocated = true;
+	}
+
+	ret = list_append(&message);
+	if (ret < 0) {
+		k_free(message.data.buf);
+		return ret;
+	}
+
+	ctx.list_internal[ret].stored = true;
+
+	/* Continue the ID sequence after the restored messages. */
+	if ((message.id >= ctx.message_id_next) && (message.id < UINT16_MAX)) {
+		ctx.message_id_next = message.id + 1;
+	}
+
+	LOG_DBG("Restored message ID: %d", message.id);
+
+	return 0;
+}
+
+/* Called by settings_load_subtree_direct() for every stored notified count, after all messages
+ * have been restored. Counts of messages that were not restored are deleted.
+ */
+static int persistent_count_load(const char *key, size_t len, settings_read_cb read_cb,
+				 void *cb_arg, void *param)
+{
+	char count_key[SETTINGS_KEY_LEN_MAX];
+	uint16_t notified_count;
+	unsigned long id;
+	char *end;
+	ssize_t read_len;
+	int i;
+
+	ARG_UNUSED(param);
+
+	if (key == NULL) {
+		return 0;
+	}
+
+	id = strtoul(key, &end, 10);
+	if ((end == key) || (*end != '\0')) {
+		LOG_WRN("Invalid stored notified count key: %s", key);
+		return 0;
+	}
+
+	i = id_index_find(id);
+	if (i < 0) {
+		persistent_count_key_get(count_key, id);
+		(void)settings_delete(count_key);
+		return 0;
+	}
+
+	if (len != sizeof(notified_count)) {
+		LOG_WRN("Invalid stored notified count size: %zu", len);
+		return 0;
+	}
+
+	read_len = read_cb(cb_arg, &notified_count, len);
+	if (read_len != len) {
+		return -EIO;
+	}
+
+	ctx.list_internal[ctx.id_index[i] - 1].message.notified_count = notified_count;
+
+	return 0;
+}
+
+static void persistent_restore(void)
+{
+	int err;
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("settings_subsys_init, error: %d", err);
+		return;
+	}
+
+	err = settings_load_subtree_direct(SETTINGS_KEY, persistent_message_load, NULL);
+	if (err) {
+		LOG_ERR("settings_load_subtree_direct, error: %d", err);
+		return;
+	}
+
+	err = settings_load_subtree_direct(SETTINGS_COUNT_KEY, persistent_count_load, NULL);
+	if (err) {
+		LOG_ERR("settings_load_subtree_direct, error: %d", err);
+	}
+}
+#else
+static void persistent_restore(void)
+{
+}
+#endif /* CONFIG_QOS_PERSISTENT */
+
 /* Public API functions */
 
 int qos_init(qos_evt_handler_t evt_handler)
@@ -185,10 +584,23 @@ int qos_init(qos_evt_handler_t evt_handler)
 	LOG_DBG("Registering handler %p", evt_handler);
 	ctx.app_evt_handler = evt_handler;
 
-	/* Initializing linked list and delayed work. */
-	sys_slist_init(&ctx.pending_list);
+	/* Initializing linked lists, ID index and delayed work. */
+	sys_dlist_init(&ctx.pending_list);
+	sys_dlist_init(&ctx.free_list);
+
+	for (size_t i = 0; i < ARRAY_SIZE(ctx.list_internal); i++) {
+		sys_dnode_init(&ctx.list_internal[i].header);
+		sys_dlist_append(&ctx.free_list, &ctx.list_internal[i].header);
+	}
+
+	memset(ctx.id_index, 0, sizeof(ctx.id_index));
+	memset(&ctx.stats, 0, sizeof(ctx.stats));
+
 	k_work_init_delayable(&ctx.timeout_handler_work, timeout_handler_work_fn);
 
+	persistent_restore();
+	timer_update();
+
 exit:
 	k_mutex_unlock(&ctx_lock);
 	return err;
@@ -216,6 +628,7 @@ int qos_message_add(struct qos_data *message)
 		ret = list_append(message);
 		if (ret < 0) {
 			LOG_WRN("No list entries available, error: %d", ret);
+			ctx.stats.dropped++;
 			evt.type = QOS_EVT_MESSAGE_REMOVED_FROM_LIST;
 			notify_event(&evt);
 			err = -ENOMEM;
@@ -225,6 +638,9 @@ int qos_message_add(struct qos_data *message)
 		/* Increment notified count before the callback. */
 		ctx.list_internal[ret].message.notified_count++;
 		evt.message = ctx.list_internal[ret].message;
+
+		persistent_store(&ctx.list_internal[ret]);
+
 		notify_event(&evt);
 	} else {
 
@@ -237,11 +653,13 @@ int qos_message_add(struct qos_data *message)
 		notify_event(&evt);
 	}
 
-	/* Start the internal timer if it is not running when there are messages in the
-	 * pending list.
+	/* Start the internal timer if it is not running or set to expire after the deadline of
+	 * the added message.
 	 */
-	if (!k_work_delayable_is_pending(&ctx.timeout_handler_work) &&
-	    !sys_slist_is_empty(&ctx.pending_list)) {
+	if (!sys_dlist_is_empty(&ctx.pending_list) &&
+	    (!k_work_delayable_is_pending(&ctx.timeout_handler_work) ||
+	     (k_ticks_to_ms_floor64(k_work_delayable_remaining_get(&ctx.timeout_handler_work)) >
+	      CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_SECONDS * MSEC_PER_SEC))) {
 		k_work_reschedule(&ctx.timeout_handler_work,
 				  K_SECONDS(CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_SECONDS));
 	}
@@ -263,8 +681,10 @@ int qos_message_remove(uint32_t id)
 		goto exit;
 	}
 
+	ctx.stats.acked++;
+
 	/* If the removed message is the last in the pending list, we stop the internal timer. */
-	if (sys_slist_is_empty(&ctx.pending_list)) {
+	if (sys_dlist_is_empty(&ctx.pending_list)) {
 		LOG_DBG("QoS list is empty, cancel ongoing delayed work");
 		k_work_cancel_delayable(&ctx.timeout_handler_work);
 	}
@@ -316,8 +736,10 @@ void qos_message_notify_all(void)
 
 	k_mutex_lock(&ctx_lock, K_FOREVER);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
 		node->message.notified_count++;
+		ctx.stats.retries++;
+		persistent_update(node);
 		evt.message = node->message;
 		notify_event(&evt);
 	};
@@ -328,17 +750,11 @@ void qos_message_notify_all(void)
 void qos_message_remove_all(void)
 {
 	struct qos_metadata *node = NULL, *next_node = NULL;
-	struct qos_evt evt = {
-		.type = QOS_EVT_MESSAGE_REMOVED_FROM_LIST,
-	};
 
 	k_mutex_lock(&ctx_lock, K_FOREVER);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
-		evt.message = node->message;
-		notify_event(&evt);
-		memset(&node->message, 0, sizeof(struct qos_data));
-		sys_slist_remove(&ctx.pending_list, NULL, &node->header);
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+		list_node_remove(node);
 	};
 
 	k_mutex_unlock(&ctx_lock);
@@ -346,6 +762,17 @@ void qos_message_remove_all(void)
 	qos_timer_reset();
 }
 
+void qos_stats_get(struct qos_stats *stats)
+{
+	__ASSERT_NO_MSG(stats != NULL);
+
+	k_mutex_lock(&ctx_lock, K_FOREVER);
+
+	*stats = ctx.stats;
+
+	k_mutex_unlock(&ctx_lock);
+}
+
 void qos_timer_reset(void)
 {
 	k_mutex_lock(&ctx_lock, K_FOREVER);
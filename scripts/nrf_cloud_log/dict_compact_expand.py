@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""
+Convert compact dictionary-based logs sent by the nRF Cloud logging backend
+(CONFIG_NRF_CLOUD_LOG_DICT_COMPACT) to the Zephyr dictionary-based log format.
+
+The output can be decoded with the Zephyr log parser and the log_dictionary.json
+file built together with the firmware image:
+
+    dict_compact_expand.py logs.bin logs_dict.bin --strip-header
+    zephyr/scripts/logging/dictionary/log_parser.py log_dictionary.json logs_dict.bin
+
+See subsys/net/lib/nrf_cloud/src/nrf_cloud_log_dict_compact.c for the format.
+"""
+
+import argparse
+import struct
+import sys
+
+BINARY_MAGIC = 0x4346526e
+DICT_LOG_FMT = 0x0001
+DICT_LOG_COMPACT_FMT = 0x0002
+
+BIN_HDR = struct.Struct('<IHHqI')
+
+TAG_LEVEL_MASK = 0x07
+TAG_DOMAIN_POS = 3
+TAG_DOMAIN_MASK = 0x0f
+TAG_DATA = 0x80
+TAG_DROPPED = TAG_LEVEL_MASK
+
+MSG_NORMAL = 0
+MSG_DROPPED = 1
+
+
+class CompactLogError(Exception):
+    pass
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def remaining(self):
+        return len(self.data) - self.pos
+
+    def bytes(self, length):
+        if length > self.remaining():
+            raise CompactLogError(f'Unexpected end of data at offset {self.pos}')
+        value = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return value
+
+    def u8(self):
+        return self.bytes(1)[0]
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.u8()
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def zigzag(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def at_header(self):
+        return (self.remaining() >= BIN_HDR.size and
+                struct.unpack_from('<I', self.data, self.pos)[0] == BINARY_MAGIC)
+
+
+def expand(data, ts_size, ptr_size, strip_header):
+    reader = Reader(data)
+    out = bytearray()
+    ts_mask = (1 << (8 * ts_size)) - 1
+    ts_prev = None
+    records = 0
+
+    while reader.remaining():
+        if reader.at_header():
+            magic, fmt, pad, ts, sequence = BIN_HDR.unpack(reader.bytes(BIN_HDR.size))
+            if fmt != DICT_LOG_COMPACT_FMT:
+                raise CompactLogError(f'Unsupported format {fmt:#06x} at offset '
+                                      f'{reader.pos - BIN_HDR.size}')
+            ts_prev = reader.varint()
+            if not strip_header:
+                out += BIN_HDR.pack(magic, DICT_LOG_FMT, pad, ts, sequence)
+            continue
+
+        if ts_prev is None:
+            raise CompactLogError('Data does not start with an nRF Cloud binary header')
+
+        tag = reader.u8()
+        level = tag & TAG_LEVEL_MASK
+
+        if level == TAG_DROPPED:
+            dropped = reader.varint()
+            out += struct.pack('<BH', MSG_DROPPED, min(dropped, 0xffff))
+            records += 1
+            continue
+
+        domain = (tag >> TAG_DOMAIN_POS) & TAG_DOMAIN_MASK
+        source = reader.varint()
+        ts_prev = (ts_prev + reader.zigzag()) & ts_mask
+
+        words = reader.varint()
+        has_tail = words & 1
+        words >>= 1
+
+        counts = bytes(3)
+        tail_len = 0
+        if has_tail:
+            counts = reader.bytes(3)
+            tail_len = reader.varint()
+
+        package = bytearray()
+        if words:
+            package += bytes([words]) + counts
+            for _ in range(words - 1):
+                package += struct.pack('<I', reader.zigzag() & 0xffffffff)
+        package += reader.bytes(tail_len)
+
+        payload = b''
+        if tag & TAG_DATA:
+            payload = reader.bytes(reader.varint())
+
+        fields = domain | (level << 4) | (len(package) << 8) | (len(payload) << 24)
+        out += bytes([MSG_NORMAL]) + fields.to_bytes(5, 'little')
+        out += source.to_bytes(ptr_size, 'little') + ts_prev.to_bytes(ts_size, 'little')
+        out += package + payload
+        records += 1
+
+    return out, records
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='Compact log file downloaded from nRF Cloud')
+    parser.add_argument('output', help='Output file in the Zephyr dictionary-based log format')
+    parser.add_argument('--timestamp-size', type=int, choices=[4, 8], default=4,
+                        help='Size of the log timestamp in bytes, 8 if '
+                             'CONFIG_LOG_TIMESTAMP_64BIT is enabled (default: 4)')
+    parser.add_argument('--pointer-size', type=int, choices=[4, 8], default=4,
+                        help='Pointer size of the target in bytes (default: 4)')
+    parser.add_argument('--strip-header', action='store_true',
+                        help='Omit the nRF Cloud binary headers from the output')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    try:
+        out, records = expand(data, args.timestamp_size, args.pointer_size, args.strip_header)
+    except CompactLogError as e:
+        sys.exit(f'Error: {e}')
+
+    with open(args.output, 'wb') as f:
+        f.write(out)
+
+    reduction = 100 * (1 - len(data) / len(out)) if out else 0
+    print(f'{records} records: {len(data)} compact bytes, {len(out)} dictionary bytes '
+          f'({reduction:.1f}% reduction)')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,42 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+from rtt_nordic_config import RttNordicConfig
+
+BACKENDS = ('rtt', 'uart', 'file')
+
+def add_backend_args(parser):
+    parser.add_argument('--backend', choices=BACKENDS, default='rtt',
+                        help='nrf_profiler backend used by the device (default: rtt)')
+    parser.add_argument('--port', help='Serial port used by the UART backend')
+    parser.add_argument('--baudrate', type=int, default=115200,
+                        help='Baudrate used by the UART backend (default: 115200)')
+    parser.add_argument('--input', help='Base name of the files written by the file backend')
+    parser.add_argument('--clock-freq', type=int,
+                        help='Frequency of the device timestamp clock in Hz (default: 32768)')
+
+def check_backend_args(parser, args):
+    if args.backend == 'uart' and args.port is None:
+        parser.error('--port is required for the UART backend')
+    if args.backend == 'file' and args.input is None:
+        parser.error('--input is required for the file backend')
+
+def get_config(args):
+    config = dict(RttNordicConfig)
+    if args.clock_freq is not None:
+        config['ms_per_timestamp_tick'] = 1000 / args.clock_freq
+    return config
+
+def create_backend_stream(args, stream, event_close, log_lvl):
+    # Imports are done here, so that only the dependencies of the used backend are needed.
+    if args.backend == 'uart':
+        from uart2stream import Uart2Stream
+        return Uart2Stream(stream, event_close, args.port, args.baudrate, log_lvl=log_lvl)
+    if args.backend == 'file':
+        from file2stream import File2Stream
+        return File2Stream(stream, event_close, args.input, log_lvl=log_lvl)
+
+    from rtt2stream import Rtt2Stream
+    return Rtt2Stream(stream, event_close, log_lvl=log_lvl)
@@ -9,7 +9,7 @@ import time
 import logging
 import signal
 from stream import Stream
-from rtt2stream import Rtt2Stream
+from backends import add_backend_args, check_backend_args, create_backend_stream, get_config
 from model_creator import ModelCreator
 
 is_waiting = True
@@ -17,21 +17,22 @@ def signal_handler(sig, frame):
     global is_waiting
     is_waiting = False
 
-def rtt2stream(stream, event, event_close, log_lvl_number):
+def backend2stream(backend_args, stream, event, event_close, log_lvl_number):
     signal.signal(signal.SIGINT, signal.SIG_IGN)
     try:
-        rtt2s = Rtt2Stream(stream, event_close, log_lvl=log_lvl_number)
+        backend2s = create_backend_stream(backend_args, stream, event_close, log_lvl_number)
         event.wait()
-        rtt2s.read_and_transmit_data()
+        backend2s.read_and_transmit_data()
     except Exception as e:
-        print("[ERROR] Unhandled exception in Profiler Rtt to stream module: {}".format(e))
+        print("[ERROR] Unhandled exception in Profiler backend to stream module: {}".format(e))
 
-def model_creator(stream, event, event_close, dataset_name, log_lvl_number):
+def model_creator(stream, event, event_close, dataset_name, config, log_lvl_number):
     signal.signal(signal.SIGINT, signal.SIG_IGN)
     try:
         mc = ModelCreator(stream,
                           event_close,
                           sending_events=False,
+                          config=config,
                           event_filename=dataset_name + ".csv",
                           event_types_filename=dataset_name + ".json",
                           log_lvl=log_lvl_number)
@@ -50,7 +51,9 @@ def main():
     parser.add_argument('time', type=int, help='Time of collecting data [s]')
     parser.add_argument('dataset_name', help='Name of dataset')
     parser.add_argument('--log', help='Log level')
+    add_backend_args(parser)
     args = parser.parse_args()
+    check_backend_args(parser, args)
 
     if args.log is not None:
         log_lvl_number = int(getattr(logging, args.log.upper(), None))
@@ -66,13 +69,13 @@ def main():
     streams = Stream.create_stream(2)
 
     processes = []
-    processes.append((Process(target=rtt2stream,
-                                args=(streams[0], event, event_close_rtt2stream, log_lvl_number),
+    processes.append((Process(target=backend2stream,
+                                args=(args, streams[0], event, event_close_rtt2stream, log_lvl_number),
                                 daemon=True),
                         event_close_rtt2stream))
     processes.append((Process(target=model_creator,
                                 args=(streams[1], event, event_close_model_creator,
-                                    args.dataset_name, log_lvl_number),
+                                    args.dataset_name, get_config(args), log_lvl_number),
                                 daemon=True),
                         event_close_model_creator))
 
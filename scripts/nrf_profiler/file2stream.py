@@ -0,0 +1,52 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import sys
+import logging
+from stream import StreamError, Stream
+
+class File2Stream:
+    """Replays data stored by the host file or RAM backend.
+
+    The descriptions file contains one event type description per line and the
+    data file contains the raw event stream.
+    """
+    def __init__(self, out_stream, event_close, base_name, log_lvl=logging.INFO):
+        self.out_stream = out_stream
+
+        self.event_close = event_close
+
+        self.logger = logging.getLogger('Profiler file to stream')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter('[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+        self.desc_filename = base_name + '.txt'
+        self.data_filename = base_name + '.bin'
+
+    def read_and_transmit_data(self):
+        try:
+            with open(self.desc_filename, 'rb') as f:
+                desc_buf = bytearray(f.read().rstrip(b'\n'))
+            # Empty field is expected after last event description
+            desc_buf.extend(b'\n\n')
+            self.out_stream.send_desc(desc_buf)
+
+            with open(self.data_filename, 'rb') as f:
+                while not self.event_close.is_set():
+                    buf = f.read(Stream.RECV_BUF_SIZE)
+                    if len(buf) == 0:
+                        break
+                    self.out_stream.send_ev(buf)
+        except IOError as err:
+            self.logger.error("Problem with reading file: {}".format(err))
+            sys.exit()
+        except StreamError as err:
+            self.logger.error("Error: {}. Unable to send data".format(err))
+            sys.exit()
+
+        self.logger.info("All data from {} sent".format(self.data_filename))
@@ -19,7 +19,7 @@ class Command(Enum):
     STOP = 2
     INFO = 3
 
-NRF_PROFILER_FATAL_ERROR_EVENT_NAME = "_nrf_profiler_fatal_error_event_"
+NRF_PROFILER_DROPPED_EVENTS_EVENT_NAME = "_nrf_profiler_dropped_events_"
 
 class ModelCreator:
 
@@ -48,6 +48,9 @@ class ModelCreator:
 
         self.timestamp_overflows = 0
         self.after_half = False
+        # Events carry the timestamp difference to the previous event.
+        self.timestamp_raw_last = 0
+        self.dropped_events = 0
 
         self.processed_events = ProcessedEvents()
         self.temp_events = []
@@ -156,19 +159,24 @@ class ModelCreator:
                 self.logger.error("Sending error: {}. Cannot send descriptions.".format(err))
                 sys.exit()
 
+    def _read_varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self._read_bytes(1)[0]
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if byte & 0x80 == 0:
+                return value
+
     def _read_single_event(self):
-        id = int.from_bytes(
-            self._read_bytes(1),
-            byteorder=self.config['byteorder'],
-            signed=False)
+        id = self._read_varint()
         et = self.raw_data.registered_events_types[id]
 
-        buf = self._read_bytes(4)
-        timestamp_raw = (
-            int.from_bytes(
-                buf,
-                byteorder=self.config['byteorder'],
-                signed=False))
+        ts_zigzag = self._read_varint()
+        ts_diff = (ts_zigzag >> 1) ^ -(ts_zigzag & 1)
+        timestamp_raw = (self.timestamp_raw_last + ts_diff) % self.config['timestamp_raw_max']
+        self.timestamp_raw_last = timestamp_raw
 
         if self.after_half \
         and timestamp_raw < 0.4 * self.config['timestamp_raw_max']:
@@ -253,9 +261,13 @@ class ModelCreator:
                 self.event_types_filename)
         while True:
             event = self._read_single_event()
-            if self.raw_data.registered_events_types[event.type_id].name == NRF_PROFILER_FATAL_ERROR_EVENT_NAME:
-                self.logger.error("Fatal error of Profiler on device! Event has been dropped. "
-                                  "Data buffer has overflown. No more events will be received.")
+            if self.raw_data.registered_events_types[event.type_id].name == \
+               NRF_PROFILER_DROPPED_EVENTS_EVENT_NAME:
+                self.dropped_events += event.data[0]
+                self.logger.warning("Profiler data buffer on device has overflown. "
+                                    "{} events dropped ({} in total).".format(
+                                        event.data[0], self.dropped_events))
+                continue
 
             if event.type_id == self.event_processing_start_id:
                 self.start_event = event
@@ -0,0 +1,116 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import sys
+import logging
+import time
+import serial
+from enum import Enum
+from stream import StreamError
+
+class Command(Enum):
+    START = 1
+    STOP = 2
+    INFO = 3
+
+class Uart2Stream:
+    READ_CHUNK_SIZE = 4096
+    # Empty line is sent after last event description
+    DESC_END = bytearray('\n\n', 'utf-8')
+
+    def __init__(self, out_stream, event_close, port, baudrate=115200, log_lvl=logging.INFO):
+        self.out_stream = out_stream
+
+        self.event_close = event_close
+
+        self.logger = logging.getLogger('Profiler UART to stream')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter('[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+        try:
+            self.serial = serial.Serial(port, baudrate, timeout=0.1)
+        except serial.SerialException as err:
+            self.logger.error("Cannot open {}: {}".format(port, err))
+            sys.exit()
+
+        self.logger.info("Connected to device via {}".format(port))
+
+    def _read_bytes(self):
+        try:
+            return self.serial.read(self.READ_CHUNK_SIZE)
+        except serial.SerialException:
+            self.logger.error("Problem with reading UART data")
+            self._disconnect()
+            sys.exit()
+
+    def _disconnect(self):
+        self.serial.close()
+        self.logger.info("Disconnected from device")
+
+    def _read_all_events_descriptions(self):
+        # Drop anything sent before the descriptions were requested.
+        self._send_command(Command.STOP)
+        time.sleep(1)
+        self.serial.reset_input_buffer()
+
+        self._send_command(Command.INFO)
+        desc_buf = bytearray()
+        while True:
+            if self.event_close.is_set():
+                self.logger.info("Module closed before receiving event descriptions.")
+                self._disconnect()
+                sys.exit()
+
+            desc_buf.extend(self._read_bytes())
+            if desc_buf[-2:] == self.DESC_END:
+                return desc_buf
+
+    def read_and_transmit_data(self):
+        desc_buf = self._read_all_events_descriptions()
+        try:
+            self.out_stream.send_desc(desc_buf)
+        except StreamError as err:
+            self.logger.error("Error: {}. Unable to send data".format(err))
+            self._disconnect()
+            sys.exit()
+
+        self._send_command(Command.START)
+        while True:
+            if self.event_close.is_set():
+                self.close()
+
+            buf = self._read_bytes()
+
+            if len(buf) > 0:
+                try:
+                    self.out_stream.send_ev(buf)
+                except StreamError as err:
+                    self.logger.error("Error: {}. Unable to send data".format(err))
+                    self._disconnect()
+                    sys.exit()
+
+    def _send_command(self, command_type):
+        try:
+            self.serial.write(bytes([command_type.value]))
+        except serial.SerialException:
+            self.logger.error("Problem with writing UART data")
+
+    def close(self):
+        self.logger.info("Real time transmission closed")
+        self._send_command(Command.STOP)
+        # Read remaining data from device and send it.
+        buf = self._read_bytes()
+        while len(buf) > 0:
+            try:
+                self.out_stream.send_ev(buf)
+            except StreamError as err:
+                self.logger.error("Error: {}. Unable to send remaining data".format(err))
+                break
+            buf = self._read_bytes()
+        self._disconnect()
+        sys.exit()
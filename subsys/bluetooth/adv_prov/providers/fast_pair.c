@@ -120,6 +120,10 @@ static int get_data(struct bt_data *ad, const struct bt_le_adv_prov_adv_state *s
 					      BT_FAST_PAIR_ADV_MODE_DISCOVERABLE);
 	}
 
+	if (state->rpa_rotated || state->new_adv_session) {
+		bt_fast_pair_adv_salt_rotate();
+	}
+
 	__ASSERT_NO_MSG((bt_fast_pair_adv_data_size(adv_config) <= sizeof(buf)) &&
 			(bt_fast_pair_adv_data_size(adv_config) > 0));
 
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/bluetooth/mesh/access.h>
 #include <bluetooth/mesh/models.h>
 #include <zephyr/sys/byteorder.h>
@@ -32,6 +33,39 @@ struct __packed scene_data {
 
 static sys_slist_t scene_servers;
 
+#if defined(CONFIG_BT_MESH_SCENE_SRV_CACHE)
+/* Scene data cached in RAM. Each scene is stored as a header followed by the
+ * pages of the scene, in the same format as they are stored in settings.
+ */
+struct __packed scene_cache_hdr {
+	uint8_t elem_idx;
+	uint16_t scene;
+	/* Total length of the pages following the header. */
+	uint16_t len;
+};
+
+struct __packed scene_cache_page {
+	uint8_t vnd;
+	uint16_t len;
+	uint8_t data[];
+};
+
+static struct {
+	uint8_t buf[CONFIG_BT_MESH_SCENE_SRV_CACHE_SIZE];
+	size_t used;
+	/* Scene being added. Always the last scene in the buffer. */
+	struct scene_cache_hdr *pending;
+	bool overflow;
+	/* Settings are loaded into the cache instead of being recalled. */
+	bool loading;
+} scene_cache;
+
+/* Serializes access to the cache between Scene Recall, which may be called by
+ * the application, and the mesh thread.
+ */
+static K_MUTEX_DEFINE(scene_cache_mutex);
+#endif
+
 static char *scene_path(char *buf, uint16_t scene, bool vnd, uint8_t page)
 {
 	sprintf(buf, "%x/%c%x", scene, vnd ? 'v' : 's', page);
@@ -83,6 +117,13 @@ entry_find(const struct bt_mesh_model *mod, bool vnd)
 	return NULL;
 }
 
+static char *scene_data_path(char *buf, const struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	sprintf(buf, "bt/mesh/s/%x/data/%x",
+		(srv->model->elem_idx << 8) | srv->model->mod_idx, scene);
+	return buf;
+}
+
 static struct bt_mesh_scene_srv *srv_find(uint16_t elem_idx)
 {
 	struct bt_mesh_scene_srv *srv;
@@ -344,6 +385,178 @@ static void page_recover(struct bt_mesh_scene_srv *srv, bool vnd,
 	}
 }
 
+#if defined(CONFIG_BT_MESH_SCENE_SRV_CACHE)
+static struct scene_cache_hdr *scene_cache_find(const struct bt_mesh_scene_srv *srv,
+						uint16_t scene)
+{
+	size_t off = 0;
+
+	while (off < scene_cache.used) {
+		struct scene_cache_hdr *hdr = (struct scene_cache_hdr *)&scene_cache.buf[off];
+
+		if (hdr->elem_idx == srv->model->elem_idx && hdr->scene == scene &&
+		    hdr != scene_cache.pending) {
+			return hdr;
+		}
+
+		off += sizeof(*hdr) + hdr->len;
+	}
+
+	return NULL;
+}
+
+static void scene_cache_lock(void)
+{
+	(void)k_mutex_lock(&scene_cache_mutex, K_FOREVER);
+}
+
+static void scene_cache_unlock(void)
+{
+	(void)k_mutex_unlock(&scene_cache_mutex);
+}
+
+static void scene_cache_remove(const struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	struct scene_cache_hdr *hdr = scene_cache_find(srv, scene);
+	uint8_t *start = (uint8_t *)hdr;
+	size_t len;
+
+	if (!hdr) {
+		return;
+	}
+
+	len = sizeof(*hdr) + hdr->len;
+	memmove(start, &start[len], &scene_cache.buf[scene_cache.used] - &start[len]);
+	scene_cache.used -= len;
+}
+
+/** Start adding a scene to the cache, replacing the cached data of the scene.
+ *
+ *  The scene data is added with @ref scene_cache_page_add, and is only
+ *  used for recall after @ref scene_cache_end has been called.
+ */
+static void scene_cache_begin(const struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	scene_cache_remove(srv, scene);
+
+	scene_cache.pending = NULL;
+	scene_cache.overflow = (scene_cache.used + sizeof(struct scene_cache_hdr) >
+				sizeof(scene_cache.buf));
+	if (scene_cache.overflow) {
+		return;
+	}
+
+	scene_cache.pending = (struct scene_cache_hdr *)&scene_cache.buf[scene_cache.used];
+	scene_cache.pending->elem_idx = srv->model->elem_idx;
+	scene_cache.pending->scene = scene;
+	scene_cache.pending->len = 0;
+	scene_cache.used += sizeof(struct scene_cache_hdr);
+}
+
+static void scene_cache_page_add(bool vnd, const uint8_t buf[], size_t len)
+{
+	struct scene_cache_page *page;
+	size_t size = sizeof(*page) + len;
+
+	if (!scene_cache.pending || scene_cache.overflow) {
+		return;
+	}
+
+	if (scene_cache.used + size > sizeof(scene_cache.buf)) {
+		scene_cache.overflow = true;
+		return;
+	}
+
+	page = (struct scene_cache_page *)&scene_cache.buf[scene_cache.used];
+	page->vnd = vnd;
+	page->len = len;
+	memcpy(page->data, buf, len);
+
+	scene_cache.pending->len += size;
+	scene_cache.used += size;
+}
+
+/** Drop the scene being added, as the cache could end up out of sync. */
+static void scene_cache_drop(void)
+{
+	scene_cache.overflow = true;
+}
+
+static void scene_cache_end(bool success)
+{
+	struct scene_cache_hdr *hdr = scene_cache.pending;
+
+	if (!hdr) {
+		return;
+	}
+
+	scene_cache.pending = NULL;
+
+	if (!success || scene_cache.overflow) {
+		LOG_WRN("Scene 0x%x not cached", hdr->scene);
+		scene_cache.used = (uint8_t *)hdr - scene_cache.buf;
+	}
+}
+
+static void scene_cache_load(struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	char path[25];
+	int err;
+
+	scene_cache_begin(srv, scene);
+
+	scene_cache.loading = true;
+	err = settings_load_subtree(scene_data_path(path, srv, scene));
+	scene_cache.loading = false;
+
+	scene_cache_end(!err);
+}
+
+static bool scene_cache_recall(struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	struct scene_cache_hdr *hdr = scene_cache_find(srv, scene);
+	size_t off = 0;
+
+	if (!hdr) {
+		return false;
+	}
+
+	while (off < hdr->len) {
+		struct scene_cache_page *page =
+			(struct scene_cache_page *)((uint8_t *)&hdr[1] + off);
+
+		page_recover(srv, page->vnd, page->data, page->len);
+		off += sizeof(*page) + page->len;
+	}
+
+	return true;
+}
+
+static bool scene_cache_loading(void)
+{
+	return scene_cache.loading;
+}
+#else
+static inline void scene_cache_lock(void) {}
+static inline void scene_cache_unlock(void) {}
+static inline void scene_cache_remove(const struct bt_mesh_scene_srv *srv, uint16_t scene) {}
+static inline void scene_cache_begin(const struct bt_mesh_scene_srv *srv, uint16_t scene) {}
+static inline void scene_cache_page_add(bool vnd, const uint8_t buf[], size_t len) {}
+static inline void scene_cache_drop(void) {}
+static inline void scene_cache_end(bool success) {}
+static inline void scene_cache_load(struct bt_mesh_scene_srv *srv, uint16_t scene) {}
+
+static inline bool scene_cache_recall(struct bt_mesh_scene_srv *srv, uint16_t scene)
+{
+	return false;
+}
+
+static inline bool scene_cache_loading(void)
+{
+	return false;
+}
+#endif
+
 static ssize_t entry_store(struct bt_mesh_model *mod,
 			   const struct bt_mesh_scene_entry *entry, bool vnd,
 			   uint8_t buf[])
@@ -402,7 +615,11 @@ static void page_store(struct bt_mesh_scene_srv *srv, uint16_t scene,
 	err = bt_mesh_model_data_store(srv->model, false, path, buf, len);
 	if (err) {
 		LOG_ERR("Failed storing %s: %d", path, err);
+		scene_cache_drop();
+		return;
 	}
+
+	scene_cache_page_add(vnd, buf, len);
 }
 
 /** @brief Get the end of the Scene server's controlled elements.
@@ -465,6 +682,19 @@ static void scene_recall_complete_mod(struct bt_mesh_scene_srv *srv, struct bt_m
 	}
 }
 
+static void recall_stats_update(struct bt_mesh_scene_srv *srv, bool cached, uint32_t time_us)
+{
+	LOG_DBG("Recalled from %s in %u us", cached ? "cache" : "settings", time_us);
+
+#if defined(CONFIG_BT_MESH_SCENE_SRV_RECALL_STATS)
+	srv->recall_stats.recalls++;
+	srv->recall_stats.cache_hits += cached;
+	srv->recall_stats.last_us = time_us;
+	srv->recall_stats.max_us = MAX(srv->recall_stats.max_us, time_us);
+	srv->recall_stats.total_us += time_us;
+#endif
+}
+
 static void scene_recall_complete(struct bt_mesh_scene_srv *srv)
 {
 	const struct bt_mesh_comp *comp = bt_mesh_comp_get();
@@ -545,8 +775,12 @@ static enum bt_mesh_scene_status scene_store(struct bt_mesh_scene_srv *srv,
 		srv->all[srv->count++] = scene;
 	}
 
+	scene_cache_lock();
+	scene_cache_begin(srv, scene);
 	scene_store_mod(srv, scene, false);
 	scene_store_mod(srv, scene, true);
+	scene_cache_end(true);
+	scene_cache_unlock();
 
 	srv->prev = scene;
 	srv->next = BT_MESH_SCENE_NONE;
@@ -572,6 +806,10 @@ static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene)
 		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
 	}
 
+	scene_cache_lock();
+	scene_cache_remove(srv, *scene);
+	scene_cache_unlock();
+
 	uint16_t target = target_scene(srv);
 	uint16_t current = current_scene(srv);
 
@@ -790,10 +1028,39 @@ static int scene_srv_set(struct bt_mesh_model *model, const char *path,
 	}
 
 	LOG_DBG("0x%x: %s", scene, bt_hex(buf, size));
+
+	scene_cache_lock();
+	if (scene_cache_loading()) {
+		scene_cache_page_add(vnd, buf, size);
+		scene_cache_unlock();
+		return 0;
+	}
+	scene_cache_unlock();
+
 	page_recover(srv, vnd, buf, size);
 	return 0;
 }
 
+static int scene_srv_start(struct bt_mesh_model *model)
+{
+	struct bt_mesh_scene_srv *srv = model->user_data;
+
+	if (!IS_ENABLED(CONFIG_BT_MESH_SCENE_SRV_CACHE)) {
+		return 0;
+	}
+
+	/* Load all scenes into the cache once, so that Scene Recall does not
+	 * have to search the settings backend:
+	 */
+	scene_cache_lock();
+	for (int i = 0; i < srv->count; i++) {
+		scene_cache_load(srv, srv->all[i]);
+	}
+	scene_cache_unlock();
+
+	return 0;
+}
+
 static void scene_srv_reset(struct bt_mesh_model *model)
 {
 	struct bt_mesh_scene_srv *srv = model->user_data;
@@ -814,6 +1081,7 @@ static void scene_srv_reset(struct bt_mesh_model *model)
 const struct bt_mesh_model_cb _bt_mesh_scene_srv_cb = {
 	.init = scene_srv_init,
 	.settings_set = scene_srv_set,
+	.start = scene_srv_start,
 	.reset = scene_srv_reset,
 };
 
@@ -868,8 +1136,10 @@ int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 			  struct bt_mesh_model_transition *transition)
 {
 	int32_t transition_time;
+	uint32_t start;
 	uint16_t curr;
 	char path[25];
+	bool cached;
 	int err;
 
 	if (scene == BT_MESH_SCENE_NONE ||
@@ -908,17 +1178,33 @@ int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
 		(void)k_work_cancel_delayable(&srv->work);
 	}
 
-	sprintf(path, "bt/mesh/s/%x/data/%x",
-		(srv->model->elem_idx << 8) | srv->model->mod_idx, scene);
+	start = k_cycle_get_32();
+
+	/* The cache stays locked while loading from settings, as the loaded
+	 * pages would be added to the cache if it was being filled.
+	 */
+	scene_cache_lock();
 
-	LOG_DBG("Loading %s", path);
+	cached = scene_cache_recall(srv, scene);
+	if (!cached) {
+		scene_data_path(path, srv, scene);
 
-	err = settings_load_subtree(path);
-	if (!err) {
-		scene_recall_complete(srv);
+		LOG_DBG("Loading %s", path);
+
+		err = settings_load_subtree(path);
+		if (err) {
+			scene_cache_unlock();
+			return err;
+		}
 	}
 
-	return err;
+	scene_cache_unlock();
+
+	scene_recall_complete(srv);
+
+	recall_stats_update(srv, cached, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+
+	return 0;
 }
 
 int bt_mesh_scene_srv_pub(struct bt_mesh_scene_srv *srv,
@@ -940,3 +1226,16 @@ uint16_t bt_mesh_scene_srv_target_scene_get(const struct bt_mesh_scene_srv *srv)
 {
 	return target_scene(srv);
 }
+
+#if defined(CONFIG_BT_MESH_SCENE_SRV_RECALL_STATS)
+void bt_mesh_scene_srv_recall_stats_get(const struct bt_mesh_scene_srv *srv,
+					struct bt_mesh_scene_srv_recall_stats *stats)
+{
+	*stats = srv->recall_stats;
+}
+
+void bt_mesh_scene_srv_recall_stats_reset(struct bt_mesh_scene_srv *srv)
+{
+	memset(&srv->recall_stats, 0, sizeof(srv->recall_stats));
+}
+#endif
@@ -5,6 +5,7 @@
  */
 
 #include <errno.h>
+#include <string.h>
 #include <zephyr/net/buf.h>
 #include <zephyr/random/rand32.h>
 #include <zephyr/bluetooth/bluetooth.h>
@@ -41,6 +42,23 @@ static const uint16_t fast_pair_uuid = FP_SERVICE_UUID;
 static const uint8_t version_and_flags;
 static const uint8_t empty_account_key_list;
 
+#ifdef CONFIG_BT_FAST_PAIR_ADV_AK_FILTER_CACHE
+/* Hashes used to build the Account Key Filter. A hash only depends on the Account Key, the Salt
+ * and the battery info, so it stays valid until one of them changes.
+ */
+struct ak_filter_cache {
+	struct fp_account_key ak[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX];
+	uint8_t hash[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX][FP_CRYPTO_SHA256_HASH_LEN];
+	size_t ak_cnt;
+	uint8_t battery_info[FP_CRYPTO_BATTERY_INFO_LEN];
+	bool battery_info_present;
+	uint16_t salt;
+	bool salt_valid;
+};
+
+static struct ak_filter_cache ak_filter_cache;
+#endif
+
 static int check_adv_config_range(struct bt_fast_pair_adv_config fp_adv_config)
 {
 	if ((fp_adv_config.adv_mode >= BT_FAST_PAIR_ADV_MODE_COUNT) ||
@@ -140,6 +158,107 @@ static void fp_adv_data_fill_battery_info(uint8_t *battery_info,
 	}
 }
 
+#ifdef CONFIG_BT_FAST_PAIR_ADV_AK_FILTER_CACHE
+static int ak_filter_salt_get(uint16_t *salt)
+{
+	struct ak_filter_cache *cache = &ak_filter_cache;
+	int err;
+
+	if (!cache->salt_valid) {
+		err = sys_csrand_get(&cache->salt, sizeof(cache->salt));
+		if (err) {
+			return err;
+		}
+
+		cache->salt_valid = true;
+		cache->ak_cnt = 0;
+	}
+
+	*salt = cache->salt;
+
+	return 0;
+}
+
+static int ak_filter_compute(uint8_t *out, const struct fp_account_key *ak, size_t ak_cnt,
+			     uint16_t salt, const uint8_t *battery_info)
+{
+	struct ak_filter_cache *cache = &ak_filter_cache;
+	uint8_t hash[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX][FP_CRYPTO_SHA256_HASH_LEN];
+	bool cache_valid;
+	int err;
+
+	__ASSERT_NO_MSG(cache->salt_valid && (cache->salt == salt));
+
+	cache_valid = (cache->battery_info_present == (battery_info != NULL)) &&
+		      (!battery_info ||
+		       !memcmp(cache->battery_info, battery_info, sizeof(cache->battery_info)));
+
+	for (size_t i = 0; i < ak_cnt; i++) {
+		size_t j = cache->ak_cnt;
+
+		if (cache_valid) {
+			for (j = 0; j < cache->ak_cnt; j++) {
+				if (!memcmp(cache->ak[j].key, ak[i].key, FP_ACCOUNT_KEY_LEN)) {
+					break;
+				}
+			}
+		}
+
+		if (j < cache->ak_cnt) {
+			memcpy(hash[i], cache->hash[j], FP_CRYPTO_SHA256_HASH_LEN);
+		} else {
+			err = fp_crypto_account_key_filter_hash(hash[i], &ak[i], salt,
+								battery_info);
+			if (err) {
+				cache->ak_cnt = 0;
+				return err;
+			}
+		}
+	}
+
+	memcpy(cache->ak, ak, ak_cnt * sizeof(ak[0]));
+	memcpy(cache->hash, hash, ak_cnt * sizeof(hash[0]));
+	cache->ak_cnt = ak_cnt;
+	cache->battery_info_present = (battery_info != NULL);
+	if (battery_info) {
+		memcpy(cache->battery_info, battery_info, sizeof(cache->battery_info));
+	}
+
+	fp_crypto_account_key_filter_build(out, cache->hash, ak_cnt);
+
+	return 0;
+}
+
+static void ak_filter_cache_clear(void)
+{
+	memset(&ak_filter_cache, 0, sizeof(ak_filter_cache));
+}
+
+void bt_fast_pair_adv_salt_rotate(void)
+{
+	ak_filter_cache.salt_valid = false;
+}
+#else
+static int ak_filter_salt_get(uint16_t *salt)
+{
+	return sys_csrand_get(salt, sizeof(*salt));
+}
+
+static int ak_filter_compute(uint8_t *out, const struct fp_account_key *ak, size_t ak_cnt,
+			     uint16_t salt, const uint8_t *battery_info)
+{
+	return fp_crypto_account_key_filter(out, ak, ak_cnt, salt, battery_info);
+}
+
+static void ak_filter_cache_clear(void)
+{
+}
+
+void bt_fast_pair_adv_salt_rotate(void)
+{
+}
+#endif /* CONFIG_BT_FAST_PAIR_ADV_AK_FILTER_CACHE */
+
 static int fp_adv_data_fill_non_discoverable(struct net_buf_simple *buf, size_t account_key_cnt,
 					     enum fp_field_type ak_filter_type,
 					     enum bt_fast_pair_adv_battery_mode adv_battery_mode)
@@ -163,6 +282,8 @@ static int fp_adv_data_fill_non_discoverable(struct net_buf_simple *buf, size_t
 	}
 
 	if (account_key_cnt == 0) {
+		/* Do not keep copies of removed Account Keys. */
+		ak_filter_cache_clear();
 		net_buf_simple_add_u8(buf, empty_account_key_list);
 	} else {
 		struct fp_account_key ak[CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX];
@@ -171,7 +292,7 @@ static int fp_adv_data_fill_non_discoverable(struct net_buf_simple *buf, size_t
 		uint16_t salt;
 		int err;
 
-		err = sys_csrand_get(&salt, sizeof(salt));
+		err = ak_filter_salt_get(&salt);
 		if (err) {
 			return err;
 		}
@@ -190,9 +311,9 @@ static int fp_adv_data_fill_non_discoverable(struct net_buf_simple *buf, size_t
 		__ASSERT_NO_MSG(ak_filter_size <= BIT_MASK(LEN_BITS));
 		net_buf_simple_add_u8(buf, ENCODE_FIELD_LEN_TYPE(ak_filter_size, ak_filter_type));
 
-		err = fp_crypto_account_key_filter(net_buf_simple_add(buf, ak_filter_size), ak,
-						   account_key_cnt, salt,
-						   add_battery_info ? battery_info : NULL);
+		err = ak_filter_compute(net_buf_simple_add(buf, ak_filter_size), ak,
+					account_key_cnt, salt,
+					add_battery_info ? battery_info : NULL);
 		if (err) {
 			return err;
 		}
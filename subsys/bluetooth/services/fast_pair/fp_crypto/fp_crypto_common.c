@@ -93,41 +93,66 @@ size_t fp_crypto_account_key_filter_size(size_t n)
 	}
 }
 
-int fp_crypto_account_key_filter(uint8_t *out, const struct fp_account_key *account_key_list,
-				 size_t n, uint16_t salt, const uint8_t *battery_info)
+static void account_key_filter_hash_add(uint8_t *out, size_t s, const uint8_t *h)
 {
-	size_t s = fp_crypto_account_key_filter_size(n);
-	uint8_t v[FP_ACCOUNT_KEY_LEN + sizeof(salt) + FP_CRYPTO_BATTERY_INFO_LEN];
-	uint8_t h[FP_CRYPTO_SHA256_HASH_LEN];
 	uint32_t x;
 	uint32_t m;
-	int err;
 
-	memset(out, 0, s);
-	for (size_t i = 0; i < n; i++) {
-		size_t pos = 0;
+	for (size_t j = 0; j < FP_CRYPTO_SHA256_HASH_LEN / sizeof(x); j++) {
+		x = sys_get_be32(&h[j * sizeof(x)]);
+		m = x % (s * __CHAR_BIT__);
+		WRITE_BIT(out[m / __CHAR_BIT__], m % __CHAR_BIT__, 1);
+	}
+}
 
-		memcpy(v, account_key_list[i].key, FP_ACCOUNT_KEY_LEN);
-		pos += FP_ACCOUNT_KEY_LEN;
+int fp_crypto_account_key_filter_hash(uint8_t *out, const struct fp_account_key *account_key,
+				      uint16_t salt, const uint8_t *battery_info)
+{
+	uint8_t v[FP_ACCOUNT_KEY_LEN + sizeof(salt) + FP_CRYPTO_BATTERY_INFO_LEN];
+	size_t pos = 0;
 
-		sys_put_be16(salt, &v[pos]);
-		pos += sizeof(salt);
+	memcpy(v, account_key->key, FP_ACCOUNT_KEY_LEN);
+	pos += FP_ACCOUNT_KEY_LEN;
 
-		if (battery_info) {
-			memcpy(&v[pos], battery_info, FP_CRYPTO_BATTERY_INFO_LEN);
-			pos += FP_CRYPTO_BATTERY_INFO_LEN;
-		}
+	sys_put_be16(salt, &v[pos]);
+	pos += sizeof(salt);
 
-		err = fp_crypto_sha256(h, v, pos);
+	if (battery_info) {
+		memcpy(&v[pos], battery_info, FP_CRYPTO_BATTERY_INFO_LEN);
+		pos += FP_CRYPTO_BATTERY_INFO_LEN;
+	}
+
+	return fp_crypto_sha256(out, v, pos);
+}
+
+void fp_crypto_account_key_filter_build(uint8_t *out,
+					const uint8_t hashes[][FP_CRYPTO_SHA256_HASH_LEN],
+					size_t n)
+{
+	size_t s = fp_crypto_account_key_filter_size(n);
+
+	memset(out, 0, s);
+	for (size_t i = 0; i < n; i++) {
+		account_key_filter_hash_add(out, s, hashes[i]);
+	}
+}
+
+int fp_crypto_account_key_filter(uint8_t *out, const struct fp_account_key *account_key_list,
+				 size_t n, uint16_t salt, const uint8_t *battery_info)
+{
+	uint8_t h[FP_CRYPTO_SHA256_HASH_LEN];
+	size_t s = fp_crypto_account_key_filter_size(n);
+	int err;
+
+	memset(out, 0, s);
+	for (size_t i = 0; i < n; i++) {
+		err = fp_crypto_account_key_filter_hash(h, &account_key_list[i], salt,
+							battery_info);
 		if (err) {
 			return err;
 		}
 
-		for (size_t j = 0; j < FP_CRYPTO_SHA256_HASH_LEN / sizeof(x); j++) {
-			x = sys_get_be32(&h[j * sizeof(x)]);
-			m = x % (s * __CHAR_BIT__);
-			WRITE_BIT(out[m / __CHAR_BIT__], m % __CHAR_BIT__, 1);
-		}
+		account_key_filter_hash_add(out, s, h);
 	}
 	return 0;
 }
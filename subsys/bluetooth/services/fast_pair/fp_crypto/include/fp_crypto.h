@@ -158,6 +158,36 @@ size_t fp_crypto_account_key_filter_size(size_t n);
 int fp_crypto_account_key_filter(uint8_t *out, const struct fp_account_key *account_key_list,
 				 size_t n, uint16_t salt, const uint8_t *battery_info);
 
+/** Compute the hash of a single Account Key used to build an Account Key Filter.
+ *
+ * The hash depends only on the Account Key, the Salt and the battery info, so it can be reused
+ * as long as none of them change. See @ref fp_crypto_account_key_filter_build.
+ *
+ * @param[out] out 256-bit (32-byte) buffer to receive the hash.
+ * @param[in] account_key Account Key.
+ * @param[in] salt Random 2-byte value - Salt.
+ * @param[in] battery_info Battery info or NULL if there is no battery info. Length of battery info
+ *			   must be equal to @ref FP_CRYPTO_BATTERY_INFO_LEN.
+ *
+ * @return 0 If the operation was successful. Otherwise, a (negative) error code is returned.
+ */
+int fp_crypto_account_key_filter_hash(uint8_t *out, const struct fp_account_key *account_key,
+				      uint16_t salt, const uint8_t *battery_info);
+
+/** Build an Account Key Filter from hashes of Account Keys.
+ *
+ * The result is the same as the one of @ref fp_crypto_account_key_filter called for the Account
+ * Keys, Salt and battery info used to compute the hashes.
+ *
+ * @param[out] out Buffer to receive Account Key Filter. Buffer size must be at least
+ *                 @ref fp_crypto_account_key_filter_size.
+ * @param[in] hashes Hashes computed with @ref fp_crypto_account_key_filter_hash.
+ * @param[in] n Number of hashes (n >= 1).
+ */
+void fp_crypto_account_key_filter_build(uint8_t *out,
+					const uint8_t hashes[][FP_CRYPTO_SHA256_HASH_LEN],
+					size_t n);
+
 /** Encode data to Additional Data packet.
  *
  * @param[out] out_packet Buffer to receive Additional Data packet. Buffer size must be at least
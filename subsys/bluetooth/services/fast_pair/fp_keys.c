@@ -53,11 +53,20 @@ struct fp_procedure {
 struct fp_key_gen_account_key_check_context {
 	const struct bt_conn *conn;
 	struct fp_keys_keygen_params *keygen_params;
+	bool last_used_only;
+	size_t ak_idx;
 };
 
 static uint8_t key_gen_failure_cnt;
 static struct k_work_delayable key_gen_failure_cnt_reset;
 
+/* Position of the Account Key that passed the last Key-based Pairing request. Seekers tend to
+ * reconnect with the same Account Key, so it is checked first to avoid decrypting the request with
+ * every key. Only the position is kept, so no copy of the key outlives its removal from storage.
+ */
+static size_t last_used_ak_idx;
+static bool last_used_ak_valid;
+
 static bool user_pairing_mode = true;
 static struct fp_procedure fp_procedures[CONFIG_BT_MAX_CONN];
 
@@ -228,6 +237,13 @@ static bool key_gen_account_key_check(const struct fp_account_key *account_key,
 	const struct bt_conn *conn = ak_check_context->conn;
 	struct fp_keys_keygen_params *keygen_params = ak_check_context->keygen_params;
 	struct fp_procedure *proc = &fp_procedures[bt_conn_index(conn)];
+	bool last_used = last_used_ak_valid && (ak_check_context->ak_idx == last_used_ak_idx);
+
+	ak_check_context->ak_idx++;
+
+	if (ak_check_context->last_used_only != last_used) {
+		return false;
+	}
 
 	memcpy(proc->aes_key, account_key->key, FP_ACCOUNT_KEY_LEN);
 
@@ -250,12 +266,32 @@ static int key_gen_account_key(const struct bt_conn *conn,
 	struct fp_key_gen_account_key_check_context context = {
 		.conn = conn,
 		.keygen_params = keygen_params,
+		.last_used_only = true,
 	};
+	int err = -ENOENT;
 
-	/* This function call assigns the Account Key internally to the Fast Pair Keys
-	 * module. The assignment happens in the provided callback method.
+	/* These function calls assign the Account Key internally to the Fast Pair Keys
+	 * module. The assignment happens in the provided callback method. The last used
+	 * Account Key is checked first, the remaining keys are checked only if it does not match.
+	 * If the key at the last used position was replaced meanwhile, the first lookup fails and
+	 * all keys are checked.
 	 */
-	return fp_storage_ak_find(NULL, key_gen_account_key_check, &context);
+	if (last_used_ak_valid) {
+		err = fp_storage_ak_find(NULL, key_gen_account_key_check, &context);
+	}
+
+	if (err) {
+		context.last_used_only = false;
+		context.ak_idx = 0;
+		err = fp_storage_ak_find(NULL, key_gen_account_key_check, &context);
+	}
+
+	if (!err) {
+		last_used_ak_idx = context.ak_idx - 1;
+		last_used_ak_valid = true;
+	}
+
+	return err;
 }
 
 int fp_keys_generate_key(const struct bt_conn *conn, struct fp_keys_keygen_params *keygen_params)
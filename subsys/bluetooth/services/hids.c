@@ -53,6 +53,55 @@
 
 LOG_MODULE_REGISTER(bt_hids, CONFIG_BT_HIDS_LOG_LEVEL);
 
+/* Incremented whenever subscriptions may have changed without the subscribed
+ * bitmaps of the Input Reports being updated.
+ */
+static atomic_t sub_gen = ATOMIC_INIT(1);
+
+static void subscriptions_changed(void)
+{
+	atomic_inc(&sub_gen);
+}
+
+static void conn_bitmap_clear(atomic_t *bitmap)
+{
+	for (size_t i = 0; i < ATOMIC_BITMAP_SIZE(CONFIG_BT_MAX_CONN); i++) {
+		atomic_clear(&bitmap[i]);
+	}
+}
+
+static void inp_rep_conn_reset(struct bt_hids *hids_obj, struct bt_conn *conn)
+{
+	uint8_t conn_idx = bt_conn_index(conn);
+	size_t cnt = MIN(hids_obj->inp_rep_group.cnt, ARRAY_SIZE(hids_obj->inp_rep_group.reports));
+
+	for (size_t i = 0; i < cnt; i++) {
+		struct bt_hids_inp_rep *hids_inp_rep = &hids_obj->inp_rep_group.reports[i];
+
+		atomic_clear_bit(hids_inp_rep->subscribed, conn_idx);
+		atomic_clear_bit(hids_inp_rep->shared_refs, conn_idx);
+	}
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	memset(&hids_obj->notify_timing[conn_idx], 0, sizeof(hids_obj->notify_timing[conn_idx]));
+#endif
+
+	subscriptions_changed();
+}
+
+#if defined(CONFIG_BT_SMP)
+static void security_changed(struct bt_conn *conn, bt_security_t level,
+			     enum bt_security_err err)
+{
+	/* Subscriptions of bonded peers are restored once the link is encrypted. */
+	subscriptions_changed();
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.security_changed = security_changed,
+};
+#endif /* CONFIG_BT_SMP */
+
 int bt_hids_connected(struct bt_hids *hids_obj, struct bt_conn *conn)
 {
 	__ASSERT_NO_MSG(conn != NULL);
@@ -96,6 +145,8 @@ int bt_hids_connected(struct bt_hids *hids_obj, struct bt_conn *conn)
 
 	bt_conn_ctx_release(hids_obj->conn_ctx, (void *)conn_data);
 
+	inp_rep_conn_reset(hids_obj, conn);
+
 	return 0;
 }
 
@@ -104,6 +155,8 @@ int bt_hids_disconnected(struct bt_hids *hids_obj, struct bt_conn *conn)
 	__ASSERT_NO_MSG(conn != NULL);
 	__ASSERT_NO_MSG(hids_obj != NULL);
 
+	inp_rep_conn_reset(hids_obj, conn);
+
 	int err = bt_conn_ctx_free(hids_obj->conn_ctx, conn);
 
 	if (err) {
@@ -231,7 +284,11 @@ static ssize_t hids_inp_rep_read(struct bt_conn *conn,
 		return BT_GATT_ERR(BT_ATT_ERR_INSUFFICIENT_RESOURCES);
 	}
 
-	rep_data = conn_data->inp_rep_ctx + rep->offset;
+	if (atomic_test_bit(rep->shared_refs, bt_conn_index(conn))) {
+		rep_data = hids->inp_rep_shared + rep->offset;
+	} else {
+		rep_data = conn_data->inp_rep_ctx + rep->offset;
+	}
 
 	ret_len = bt_gatt_attr_read(conn, attr, buf, len, offset, rep_data,
 				    rep->size);
@@ -465,6 +522,8 @@ static void hids_input_report_ccc_changed(struct bt_gatt_attr const *attr,
 	    CONTAINER_OF((struct _bt_gatt_ccc *)attr->user_data,
 			 struct bt_hids_inp_rep, ccc);
 
+	subscriptions_changed();
+
 	if (value == BT_GATT_CCC_NOTIFY) {
 		LOG_DBG("Notification has been turned on");
 		if (inp_rep->handler != NULL) {
@@ -478,6 +537,23 @@ static void hids_input_report_ccc_changed(struct bt_gatt_attr const *attr,
 	}
 }
 
+static ssize_t hids_input_report_ccc_write(struct bt_conn *conn,
+					   struct bt_gatt_attr const *attr,
+					   uint16_t value)
+{
+	struct bt_hids_inp_rep *inp_rep =
+	    CONTAINER_OF((struct _bt_gatt_ccc *)attr->user_data,
+			 struct bt_hids_inp_rep, ccc);
+
+	if (value & BT_GATT_CCC_NOTIFY) {
+		atomic_set_bit(inp_rep->subscribed, bt_conn_index(conn));
+	} else {
+		atomic_clear_bit(inp_rep->subscribed, bt_conn_index(conn));
+	}
+
+	return sizeof(value);
+}
+
 static ssize_t hids_boot_mouse_inp_report_read(struct bt_conn *conn,
 					       struct bt_gatt_attr const *attr,
 					       void *buf, uint16_t len,
@@ -775,9 +851,16 @@ hids_input_reports_register(struct bt_hids *hids_obj,
 		hids_inp_rep->att_ind = hids_obj->gp.svc.attr_count - 1;
 		hids_inp_rep->offset = offset;
 		hids_inp_rep->idx = i;
+		hids_inp_rep->sub_gen = 0;
+		conn_bitmap_clear(hids_inp_rep->subscribed);
+		conn_bitmap_clear(hids_inp_rep->shared_refs);
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+		memset(hids_inp_rep->notify_cbs, 0, sizeof(hids_inp_rep->notify_cbs));
+#endif
 
 		BT_GATT_POOL_CCC(&hids_obj->gp, hids_inp_rep->ccc,
 				 hids_input_report_ccc_changed,  wperm | rperm);
+		hids_inp_rep->ccc.cfg_write = hids_input_report_ccc_write;
 		BT_GATT_POOL_DESC(&hids_obj->gp, BT_UUID_HIDS_REPORT_REF,
 				  rperm, hids_inp_rep_ref_read,
 				  NULL, &hids_inp_rep->id);
@@ -1013,6 +1096,7 @@ int bt_hids_uninit(struct bt_hids *hids_obj)
 
 	struct bt_gatt_attr *attr_start = hids_obj->gp.svc.attrs;
 	struct bt_conn_ctx_lib *conn_ctx = hids_obj->conn_ctx;
+	uint8_t *inp_rep_shared = hids_obj->inp_rep_shared;
 
 	/* Free the whole GATT pool */
 	bt_gatt_pool_free(&hids_obj->gp);
@@ -1024,6 +1108,7 @@ int bt_hids_uninit(struct bt_hids *hids_obj)
 	memset(hids_obj, 0, sizeof(*hids_obj));
 	hids_obj->gp.svc.attrs = attr_start;
 	hids_obj->conn_ctx = conn_ctx;
+	hids_obj->inp_rep_shared = inp_rep_shared;
 
 	return 0;
 }
@@ -1046,34 +1131,276 @@ static void store_input_report(struct bt_hids_inp_rep *hids_inp_rep,
 	}
 }
 
-static int inp_rep_notify_all(struct bt_hids *hids_obj,
-			      struct bt_hids_inp_rep *hids_inp_rep,
-			      uint8_t const *rep, uint8_t len,
-			      bt_gatt_complete_func_t cb)
+static bool inp_rep_subscribed_any(struct bt_hids_inp_rep *hids_inp_rep)
 {
-	struct bt_hids_conn_data *conn_data;
-	uint8_t *rep_data = NULL;
+	for (size_t i = 0; i < ARRAY_SIZE(hids_inp_rep->subscribed); i++) {
+		if (atomic_get(&hids_inp_rep->subscribed[i])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool inp_rep_shared_refs_stale(struct bt_hids_inp_rep *hids_inp_rep)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(hids_inp_rep->shared_refs); i++) {
+		if (atomic_get(&hids_inp_rep->shared_refs[i]) &
+		    ~atomic_get(&hids_inp_rep->subscribed[i])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void inp_rep_subscribed_update(struct bt_hids *hids_obj,
+				      struct bt_hids_inp_rep *hids_inp_rep,
+				      bool force)
+{
+	atomic_val_t gen = atomic_get(&sub_gen);
 	struct bt_gatt_attr *rep_attr =
 		&hids_obj->gp.svc.attrs[hids_inp_rep->att_ind];
 
-	const size_t contexts =
-	    bt_conn_ctx_count(hids_obj->conn_ctx);
+	if (!force && (hids_inp_rep->sub_gen == gen)) {
+		return;
+	}
+
+	hids_inp_rep->sub_gen = gen;
+	conn_bitmap_clear(hids_inp_rep->subscribed);
+
+	const size_t contexts = bt_conn_ctx_count(hids_obj->conn_ctx);
 
 	for (size_t i = 0; i < contexts; i++) {
 		const struct bt_conn_ctx *ctx =
 			bt_conn_ctx_get_by_id(hids_obj->conn_ctx, i);
 
 		if (ctx) {
-			bool notification_enabled = bt_gatt_is_subscribed(
-				ctx->conn, rep_attr, BT_GATT_CCC_NOTIFY);
+			if (bt_gatt_is_subscribed(ctx->conn, rep_attr,
+						  BT_GATT_CCC_NOTIFY)) {
+				atomic_set_bit(hids_inp_rep->subscribed,
+					       bt_conn_index(ctx->conn));
+			}
 
-			if (notification_enabled) {
-				conn_data = ctx->data;
-				rep_data = conn_data->inp_rep_ctx +
-					   hids_inp_rep->offset;
+			bt_conn_ctx_release(hids_obj->conn_ctx,
+					    (void *)ctx->data);
+		}
+	}
+}
+
+static void inp_rep_shared_detach(struct bt_hids *hids_obj,
+				  struct bt_hids_inp_rep *hids_inp_rep,
+				  struct bt_hids_conn_data *conn_data,
+				  uint8_t conn_idx)
+{
+	/* Give the connection its own copy before the shared report changes. */
+	if (atomic_test_and_clear_bit(hids_inp_rep->shared_refs, conn_idx)) {
+		memcpy(conn_data->inp_rep_ctx + hids_inp_rep->offset,
+		       hids_obj->inp_rep_shared + hids_inp_rep->offset,
+		       hids_inp_rep->size);
+	}
+}
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+static bool notify_timing_available(struct bt_hids *hids_obj, uint8_t conn_idx)
+{
+	struct bt_hids_notify_timing *timing = &hids_obj->notify_timing[conn_idx];
+
+	return (timing->tx_seq - timing->rx_seq) < ARRAY_SIZE(timing->ts);
+}
+
+/* Must be called before the notification is sent, as it may complete before
+ * bt_gatt_notify_cb() returns. Use notify_timing_cancel() if sending fails.
+ */
+static void notify_timing_start(struct bt_hids *hids_obj, uint8_t conn_idx,
+				uint32_t ts)
+{
+	struct bt_hids_notify_timing *timing = &hids_obj->notify_timing[conn_idx];
+
+	timing->ts[timing->tx_seq % ARRAY_SIZE(timing->ts)] = ts;
+	timing->tx_seq++;
+}
+
+static void notify_timing_cancel(struct bt_hids *hids_obj, uint8_t conn_idx)
+{
+	hids_obj->notify_timing[conn_idx].tx_seq--;
+}
+
+static void notify_timing_end(struct bt_hids *hids_obj, uint8_t conn_idx,
+			      uint32_t ts)
+{
+	struct bt_hids_notify_timing *timing = &hids_obj->notify_timing[conn_idx];
+	struct bt_hids_notify_stats *stats = &timing->stats;
+	uint32_t seq = timing->rx_seq;
+	size_t slot = seq % ARRAY_SIZE(timing->ts);
+	uint32_t latency_us;
+
+	if ((int32_t)(timing->tx_seq - seq) <= 0) {
+		/* Timing was reset after the notification was sent. */
+		return;
+	}
+
+	timing->rx_seq++;
+
+	latency_us = k_cyc_to_us_floor32(ts - timing->ts[slot]);
+
+	if ((stats->notify_cnt == 0) || (latency_us < stats->latency_min_us)) {
+		stats->latency_min_us = latency_us;
+	}
+	stats->latency_max_us = MAX(stats->latency_max_us, latency_us);
+	stats->latency_last_us = latency_us;
+	stats->latency_total_us += latency_us;
+	stats->notify_cnt++;
+}
+
+/* Get the entry of the complete callback, which is passed with the timed
+ * notifications. Entries are never reused for another callback, as
+ * notifications may still be pending with them.
+ */
+static struct bt_hids_notify_cb *notify_cb_get(struct bt_hids_inp_rep *hids_inp_rep,
+					       bt_gatt_complete_func_t cb)
+{
+	struct bt_hids_notify_cb *free_cb = NULL;
 
-				store_input_report(hids_inp_rep, rep_data, rep,
-						   len);
+	for (size_t i = 0; i < ARRAY_SIZE(hids_inp_rep->notify_cbs); i++) {
+		struct bt_hids_notify_cb *notify_cb = &hids_inp_rep->notify_cbs[i];
+
+		if (!notify_cb->rep) {
+			free_cb = free_cb ? free_cb : notify_cb;
+		} else if (notify_cb->func == cb) {
+			return notify_cb;
+		}
+	}
+
+	if (free_cb) {
+		free_cb->func = cb;
+		free_cb->rep = hids_inp_rep;
+	}
+
+	return free_cb;
+}
+
+static void inp_rep_notify_complete(struct bt_conn *conn, void *user_data)
+{
+	uint32_t ts = k_cycle_get_32();
+	const struct bt_hids_notify_cb *notify_cb = user_data;
+	struct bt_hids_inp_rep *hids_inp_rep = notify_cb->rep;
+	struct bt_hids *hids_obj = CONTAINER_OF((hids_inp_rep - hids_inp_rep->idx),
+						struct bt_hids,
+						inp_rep_group.reports);
+
+	/* Only the statistics depend on the timing, the callback is always called. */
+	notify_timing_end(hids_obj, bt_conn_index(conn), ts);
+
+	if (notify_cb->func) {
+		notify_cb->func(conn, NULL);
+	}
+}
+
+/* Start timing the notification on all subscribed connections. Returns false
+ * if a connection has too many notifications pending, in which case the
+ * notification is sent without timing.
+ */
+static bool inp_rep_notify_timing_start_all(struct bt_hids *hids_obj,
+					    struct bt_hids_inp_rep *hids_inp_rep)
+{
+	uint32_t ts = k_cycle_get_32();
+
+	for (size_t i = 0; i < CONFIG_BT_MAX_CONN; i++) {
+		if (atomic_test_bit(hids_inp_rep->subscribed, i) &&
+		    !notify_timing_available(hids_obj, i)) {
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < CONFIG_BT_MAX_CONN; i++) {
+		if (atomic_test_bit(hids_inp_rep->subscribed, i)) {
+			notify_timing_start(hids_obj, i, ts);
+		}
+	}
+
+	return true;
+}
+
+static void inp_rep_notify_timing_cancel_all(struct bt_hids *hids_obj,
+					     struct bt_hids_inp_rep *hids_inp_rep)
+{
+	for (size_t i = 0; i < CONFIG_BT_MAX_CONN; i++) {
+		if (atomic_test_bit(hids_inp_rep->subscribed, i)) {
+			notify_timing_cancel(hids_obj, i);
+		}
+	}
+}
+#endif /* CONFIG_BT_HIDS_NOTIFY_STATS */
+
+static void inp_rep_notify_params_init(struct bt_gatt_notify_params *params,
+				       struct bt_gatt_attr *rep_attr,
+				       struct bt_hids_inp_rep *hids_inp_rep,
+				       uint8_t const *rep,
+				       bt_gatt_complete_func_t cb,
+				       struct bt_hids_notify_cb *notify_cb)
+{
+	params->attr = rep_attr;
+	params->data = rep;
+	params->len = hids_inp_rep->size;
+	params->func = cb;
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	if (notify_cb) {
+		/* Timed notification, the callback is called by inp_rep_notify_complete(). */
+		params->func = inp_rep_notify_complete;
+		params->user_data = notify_cb;
+	}
+#endif
+}
+
+static int inp_rep_notify_all(struct bt_hids *hids_obj,
+			      struct bt_hids_inp_rep *hids_inp_rep,
+			      uint8_t const *rep, uint8_t len,
+			      bt_gatt_complete_func_t cb)
+{
+	struct bt_gatt_attr *rep_attr =
+		&hids_obj->gp.svc.attrs[hids_inp_rep->att_ind];
+	/* Reports with a mask are merged into the report of each connection,
+	 * so they can not share a buffer.
+	 */
+	bool use_shared = (hids_obj->inp_rep_shared != NULL) &&
+			  (hids_inp_rep->rep_mask == NULL);
+
+	inp_rep_subscribed_update(hids_obj, hids_inp_rep, false);
+
+	if (!inp_rep_subscribed_any(hids_inp_rep)) {
+		inp_rep_subscribed_update(hids_obj, hids_inp_rep, true);
+
+		if (!inp_rep_subscribed_any(hids_inp_rep)) {
+			return -ENODATA;
+		}
+	}
+
+	if (!use_shared || inp_rep_shared_refs_stale(hids_inp_rep)) {
+		const size_t contexts = bt_conn_ctx_count(hids_obj->conn_ctx);
+
+		for (size_t i = 0; i < contexts; i++) {
+			const struct bt_conn_ctx *ctx =
+				bt_conn_ctx_get_by_id(hids_obj->conn_ctx, i);
+
+			if (!ctx) {
+				continue;
+			}
+
+			struct bt_hids_conn_data *conn_data = ctx->data;
+			uint8_t conn_idx = bt_conn_index(ctx->conn);
+			bool subscribed = atomic_test_bit(hids_inp_rep->subscribed,
+							  conn_idx);
+
+			if (!subscribed) {
+				inp_rep_shared_detach(hids_obj, hids_inp_rep,
+						      conn_data, conn_idx);
+			} else if (!use_shared) {
+				store_input_report(hids_inp_rep,
+						   conn_data->inp_rep_ctx +
+						   hids_inp_rep->offset,
+						   rep, len);
 			}
 
 			bt_conn_ctx_release(hids_obj->conn_ctx,
@@ -1081,18 +1408,37 @@ static int inp_rep_notify_all(struct bt_hids *hids_obj,
 		}
 	}
 
-	if (rep_data != NULL) {
-		struct bt_gatt_notify_params params = {0};
+	if (use_shared) {
+		memcpy(hids_obj->inp_rep_shared + hids_inp_rep->offset, rep, len);
 
-		params.attr = rep_attr;
-		params.data = rep;
-		params.len = hids_inp_rep->size;
-		params.func = cb;
+		for (size_t i = 0; i < ARRAY_SIZE(hids_inp_rep->shared_refs); i++) {
+			atomic_or(&hids_inp_rep->shared_refs[i],
+				  atomic_get(&hids_inp_rep->subscribed[i]));
+		}
+	}
 
-		return bt_gatt_notify_cb(NULL, &params);
-	} else {
-		return -ENODATA;
+	struct bt_gatt_notify_params params = {0};
+	struct bt_hids_notify_cb *notify_cb = NULL;
+	int err;
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	notify_cb = notify_cb_get(hids_inp_rep, cb);
+	if (notify_cb && !inp_rep_notify_timing_start_all(hids_obj, hids_inp_rep)) {
+		notify_cb = NULL;
 	}
+#endif
+
+	inp_rep_notify_params_init(&params, rep_attr, hids_inp_rep, rep, cb, notify_cb);
+
+	err = bt_gatt_notify_cb(NULL, &params);
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	if (err && notify_cb) {
+		inp_rep_notify_timing_cancel_all(hids_obj, hids_inp_rep);
+	}
+#endif
+
+	return err;
 }
 
 int bt_hids_inp_rep_send(struct bt_hids *hids_obj,
@@ -1126,19 +1472,35 @@ int bt_hids_inp_rep_send(struct bt_hids *hids_obj,
 		return -EINVAL;
 	}
 
+	inp_rep_shared_detach(hids_obj, hids_inp_rep, conn_data,
+			      bt_conn_index(conn));
+
 	rep_data = conn_data->inp_rep_ctx + hids_inp_rep->offset;
 
 	store_input_report(hids_inp_rep, rep_data, rep, len);
 
 	struct bt_gatt_notify_params params = {0};
+	struct bt_hids_notify_cb *notify_cb = NULL;
 
-	params.attr = &hids_obj->gp.svc.attrs[hids_inp_rep->att_ind];
-	params.data = rep;
-	params.len = hids_inp_rep->size;
-	params.func = cb;
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	if (notify_timing_available(hids_obj, bt_conn_index(conn))) {
+		notify_cb = notify_cb_get(hids_inp_rep, cb);
+	}
+	if (notify_cb) {
+		notify_timing_start(hids_obj, bt_conn_index(conn), k_cycle_get_32());
+	}
+#endif
+
+	inp_rep_notify_params_init(&params, rep_attr, hids_inp_rep, rep, cb, notify_cb);
 
 	int err = bt_gatt_notify_cb(conn, &params);
 
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	if (err && notify_cb) {
+		notify_timing_cancel(hids_obj, bt_conn_index(conn));
+	}
+#endif
+
 	bt_conn_ctx_release(hids_obj->conn_ctx, (void *)conn_data);
 
 	return err;
@@ -1361,3 +1723,39 @@ int bt_hids_boot_kb_inp_rep_send(struct bt_hids *hids_obj,
 
 	return err;
 }
+
+int bt_hids_notify_stats_get(struct bt_hids *hids_obj, struct bt_conn *conn,
+			     struct bt_hids_notify_stats *stats)
+{
+	if (!IS_ENABLED(CONFIG_BT_HIDS_NOTIFY_STATS)) {
+		return -ENOTSUP;
+	}
+
+	if (!hids_obj || !conn || !stats) {
+		return -EINVAL;
+	}
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	*stats = hids_obj->notify_timing[bt_conn_index(conn)].stats;
+#endif
+
+	return 0;
+}
+
+int bt_hids_notify_stats_reset(struct bt_hids *hids_obj, struct bt_conn *conn)
+{
+	if (!IS_ENABLED(CONFIG_BT_HIDS_NOTIFY_STATS)) {
+		return -ENOTSUP;
+	}
+
+	if (!hids_obj || !conn) {
+		return -EINVAL;
+	}
+
+#if defined(CONFIG_BT_HIDS_NOTIFY_STATS)
+	memset(&hids_obj->notify_timing[bt_conn_index(conn)].stats, 0,
+	       sizeof(hids_obj->notify_timing[bt_conn_index(conn)].stats));
+#endif
+
+	return 0;
+}
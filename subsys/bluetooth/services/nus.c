@@ -4,9 +4,11 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <zephyr/kernel.h>
 #include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/gatt.h>
+#include <zephyr/sys/ring_buffer.h>
 
 #include <bluetooth/services/nus.h>
 #include <zephyr/logging/log.h>
@@ -81,6 +83,273 @@ BT_GATT_PRIMARY_SERVICE(BT_UUID_NUS_SERVICE),
 			       NULL, on_receive, NULL),
 );
 
+#if defined(CONFIG_BT_NUS_STREAM)
+/* Retry period used when the Bluetooth stack is out of buffers and no notification of the
+ * connection is in flight, so no sent callback will trigger the next attempt.
+ */
+#define STREAM_RETRY_DELAY K_MSEC(10)
+
+/* The notification user data holds the low bits of the session it was sent in, so that
+ * completions of a previous connection with the same index are ignored, and the length.
+ */
+#define STREAM_TAG_LEN_MASK BIT_MASK(16)
+#define STREAM_TAG_SESSION_SHIFT 16
+#define STREAM_TAG_SESSION_MASK BIT_MASK(16)
+
+#define STREAM_TAG(_session, _len)                                                             \
+	UINT_TO_POINTER((((_session) & STREAM_TAG_SESSION_MASK) << STREAM_TAG_SESSION_SHIFT) | \
+			((_len) & STREAM_TAG_LEN_MASK))
+
+struct nus_stream {
+	struct bt_conn *conn;
+	uint32_t session;
+	struct ring_buf buf;
+	uint8_t buf_data[CONFIG_BT_NUS_STREAM_BUF_SIZE];
+	struct k_work_delayable work;
+	struct k_spinlock lock;
+	uint8_t inflight;
+	uint8_t inflight_peak;
+	uint32_t sent;
+	int64_t start_time;
+	int64_t last_sent_time;
+};
+
+static struct nus_stream streams[CONFIG_BT_MAX_CONN];
+
+static void stream_on_sent(struct bt_conn *conn, void *user_data)
+{
+	struct nus_stream *stream = &streams[bt_conn_index(conn)];
+	uint32_t tag = POINTER_TO_UINT(user_data);
+	uint32_t session = (tag >> STREAM_TAG_SESSION_SHIFT) & STREAM_TAG_SESSION_MASK;
+	k_spinlock_key_t key = k_spin_lock(&stream->lock);
+
+	if ((session != (stream->session & STREAM_TAG_SESSION_MASK)) ||
+	    (stream->inflight == 0)) {
+		/* Late completion of a previous connection. */
+		k_spin_unlock(&stream->lock, key);
+		return;
+	}
+
+	stream->inflight--;
+	stream->sent += tag & STREAM_TAG_LEN_MASK;
+	stream->last_sent_time = k_uptime_get();
+
+	k_spin_unlock(&stream->lock, key);
+
+	k_work_reschedule(&stream->work, K_NO_WAIT);
+
+	on_sent(conn, NULL);
+}
+
+static void stream_work_handler(struct k_work *work)
+{
+	struct nus_stream *stream = CONTAINER_OF(k_work_delayable_from_work(work),
+						 struct nus_stream, work);
+	struct bt_gatt_notify_params params = {
+		.attr = &nus_svc.attrs[2],
+		.func = stream_on_sent,
+	};
+	struct bt_conn *conn;
+	uint32_t session;
+	uint16_t mtu;
+	k_spinlock_key_t key;
+	int err;
+
+	key = k_spin_lock(&stream->lock);
+	conn = stream->conn ? bt_conn_ref(stream->conn) : NULL;
+	session = stream->session;
+	k_spin_unlock(&stream->lock, key);
+
+	if (!conn) {
+		return;
+	}
+
+	mtu = bt_nus_get_mtu(conn);
+
+	while (true) {
+		uint8_t *data;
+		uint32_t len;
+
+		key = k_spin_lock(&stream->lock);
+
+		if ((stream->session != session) ||
+		    (stream->inflight >= CONFIG_BT_NUS_STREAM_INFLIGHT_MAX)) {
+			k_spin_unlock(&stream->lock, key);
+			break;
+		}
+
+		len = ring_buf_get_claim(&stream->buf, &data, mtu);
+		if (len == 0) {
+			k_spin_unlock(&stream->lock, key);
+			break;
+		}
+
+		if (stream->start_time == 0) {
+			stream->start_time = k_uptime_get();
+		}
+
+		stream->inflight++;
+		stream->inflight_peak = MAX(stream->inflight_peak, stream->inflight);
+
+		k_spin_unlock(&stream->lock, key);
+
+		/* The notification data is copied to the Bluetooth stack buffer, so the claimed
+		 * part of the stream buffer can be released right after the call.
+		 */
+		params.data = data;
+		params.len = len;
+		params.user_data = STREAM_TAG(session, len);
+
+		err = bt_gatt_notify_cb(conn, &params);
+
+		key = k_spin_lock(&stream->lock);
+
+		if (stream->session != session) {
+			/* Disconnected meanwhile, the stream buffer was already reset. */
+			k_spin_unlock(&stream->lock, key);
+			break;
+		}
+
+		if (err) {
+			stream->inflight--;
+			ring_buf_get_finish(&stream->buf, 0);
+
+			if ((err == -ENOMEM) && (stream->inflight == 0)) {
+				k_work_schedule(&stream->work, STREAM_RETRY_DELAY);
+			}
+
+			k_spin_unlock(&stream->lock, key);
+
+			if (err != -ENOMEM) {
+				LOG_WRN("Stream notification failed (err %d)", err);
+			}
+
+			break;
+		}
+
+		ring_buf_get_finish(&stream->buf, len);
+
+		k_spin_unlock(&stream->lock, key);
+	}
+
+	bt_conn_unref(conn);
+}
+
+static void stream_reset(struct nus_stream *stream)
+{
+	k_spinlock_key_t key = k_spin_lock(&stream->lock);
+
+	if (stream->conn) {
+		bt_conn_unref(stream->conn);
+		stream->conn = NULL;
+	}
+
+	stream->session++;
+	ring_buf_reset(&stream->buf);
+	stream->inflight = 0;
+
+	k_spin_unlock(&stream->lock, key);
+
+	k_work_cancel_delayable(&stream->work);
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	stream_reset(&streams[bt_conn_index(conn)]);
+}
+
+BT_CONN_CB_DEFINE(nus_conn_callbacks) = {
+	.disconnected = disconnected,
+};
+
+static void streams_init(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(streams); i++) {
+		struct nus_stream *stream = &streams[i];
+
+		ring_buf_init(&stream->buf, sizeof(stream->buf_data), stream->buf_data);
+		k_work_init_delayable(&stream->work, stream_work_handler);
+	}
+}
+
+int bt_nus_stream_send(struct bt_conn *conn, const uint8_t *data, size_t len)
+{
+	struct nus_stream *stream;
+	k_spinlock_key_t key;
+	uint32_t queued;
+
+	if (!conn) {
+		return -EINVAL;
+	}
+
+	if (!bt_gatt_is_subscribed(conn, &nus_svc.attrs[2], BT_GATT_CCC_NOTIFY)) {
+		return -EINVAL;
+	}
+
+	stream = &streams[bt_conn_index(conn)];
+
+	key = k_spin_lock(&stream->lock);
+
+	if (!stream->conn) {
+		stream->conn = bt_conn_ref(conn);
+	}
+
+	queued = ring_buf_put(&stream->buf, data, len);
+
+	k_spin_unlock(&stream->lock, key);
+
+	if (queued > 0) {
+		k_work_reschedule(&stream->work, K_NO_WAIT);
+	}
+
+	return queued;
+}
+
+int bt_nus_stream_stats_get(struct bt_conn *conn, struct bt_nus_stream_stats *stats)
+{
+	struct nus_stream *stream;
+	k_spinlock_key_t key;
+	int64_t elapsed;
+
+	if (!conn || !stats) {
+		return -EINVAL;
+	}
+
+	stream = &streams[bt_conn_index(conn)];
+
+	key = k_spin_lock(&stream->lock);
+
+	stats->queued = ring_buf_size_get(&stream->buf);
+	stats->sent = stream->sent;
+	stats->inflight = stream->inflight;
+	stats->inflight_peak = stream->inflight_peak;
+
+	elapsed = stream->last_sent_time - stream->start_time;
+	if ((stream->start_time != 0) && (elapsed > 0)) {
+		stats->throughput = ((uint64_t)stream->sent * MSEC_PER_SEC) / elapsed;
+	} else {
+		stats->throughput = 0;
+	}
+
+	k_spin_unlock(&stream->lock, key);
+
+	return 0;
+}
+
+void bt_nus_stream_stats_reset(struct bt_conn *conn)
+{
+	struct nus_stream *stream = &streams[bt_conn_index(conn)];
+	k_spinlock_key_t key = k_spin_lock(&stream->lock);
+
+	stream->sent = 0;
+	stream->inflight_peak = stream->inflight;
+	stream->start_time = 0;
+	stream->last_sent_time = 0;
+
+	k_spin_unlock(&stream->lock, key);
+}
+#endif /* CONFIG_BT_NUS_STREAM */
+
 int bt_nus_init(struct bt_nus_cb *callbacks)
 {
 	if (callbacks) {
@@ -89,6 +358,10 @@ int bt_nus_init(struct bt_nus_cb *callbacks)
 		nus_cb.send_enabled = callbacks->send_enabled;
 	}
 
+#if defined(CONFIG_BT_NUS_STREAM)
+	streams_init();
+#endif /* CONFIG_BT_NUS_STREAM */
+
 	return 0;
 }
 
@@ -121,6 +121,10 @@ bool bl_validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address)
 #include <pm_config.h>
 #endif
 
+#ifdef CONFIG_SB_VALIDATION_TIMING
+#include <nrfx.h>
+#endif
+
 #define PRINT(...) if (!external) printk(__VA_ARGS__)
 
 struct __packed fw_validation_info {
@@ -298,6 +302,32 @@ static bool validate_hash(const uint32_t fw_src_address, const uint32_t fw_size,
 #endif
 
 
+#ifdef CONFIG_SB_VALIDATION_TIMING
+/* The system timer is not running in the bootloader, so the DWT cycle
+ * counter is used to measure the time spent on hashing and verifying
+ * the firmware.
+ */
+static void timing_start(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void timing_print(uint32_t fw_size, bool external)
+{
+	uint32_t cycles = DWT->CYCCNT;
+	uint32_t cycles_per_us = SystemCoreClock / 1000000;
+
+	PRINT("Validated %u bytes in %u cycles (%u us).\n\r", fw_size, cycles,
+	      cycles / cycles_per_us);
+}
+#else
+static inline void timing_start(void) {}
+static inline void timing_print(uint32_t fw_size, bool external) {}
+#endif /* CONFIG_SB_VALIDATION_TIMING */
+
+
 static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 			      const struct fw_info *fwinfo, bool external)
 {
@@ -407,15 +437,23 @@ static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 		return false;
 	}
 
+	bool valid;
+
+	timing_start();
+
 #ifdef CONFIG_SB_VALIDATE_FW_SIGNATURE
-	return validate_signature(fw_src_address, fwinfo->size, fw_val_info,
+	valid = validate_signature(fw_src_address, fwinfo->size, fw_val_info,
 				external);
 #elif defined(CONFIG_SB_VALIDATE_FW_HASH)
-	return validate_hash(fw_src_address, fwinfo->size, fw_val_info,
+	valid = validate_hash(fw_src_address, fwinfo->size, fw_val_info,
 				external);
 #else
 	#error "Validation not specified."
 #endif
+
+	timing_print(fwinfo->size, external);
+
+	return valid;
 }
 
 
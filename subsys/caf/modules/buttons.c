@@ -27,8 +27,12 @@
 LOG_MODULE_REGISTER(MODULE, CONFIG_CAF_BUTTONS_LOG_LEVEL);
 
 #define SCAN_INTERVAL CONFIG_CAF_BUTTONS_SCAN_INTERVAL
+#define SCAN_INTERVAL_MAX CONFIG_CAF_BUTTONS_SCAN_INTERVAL_MAX
 #define DEBOUNCE_INTERVAL CONFIG_CAF_BUTTONS_DEBOUNCE_INTERVAL
 
+BUILD_ASSERT(SCAN_INTERVAL_MAX >= SCAN_INTERVAL,
+	     "Maximum scan interval must not be shorter than the scan interval");
+
 /* For directly connected GPIO, scan rows once. */
 #define COLUMNS MAX(ARRAY_SIZE(col), 1)
 
@@ -44,6 +48,14 @@ enum state {
 	STATE_SUSPENDING
 };
 
+/* Column pin configurations, cached to reconfigure only the pins that change. */
+enum col_cfg {
+	COL_CFG_UNKNOWN,
+	COL_CFG_INPUT,
+	COL_CFG_OUTPUT_ACTIVE,
+	COL_CFG_OUTPUT_INACTIVE
+};
+
 static const struct device * const gpio_devs[] = {
 	DEVICE_DT_GET_OR_NULL(DT_NODELABEL(gpio0)),
 	DEVICE_DT_GET_OR_NULL(DT_NODELABEL(gpio1)),
@@ -52,6 +64,20 @@ static struct gpio_callback gpio_cb[ARRAY_SIZE(gpio_devs)];
 static struct k_work_delayable matrix_scan;
 static struct k_work_delayable button_pressed;
 static enum state state;
+static uint8_t col_cfg[MAX(ARRAY_SIZE(col), 1)];
+static uint32_t row_port_mask[ARRAY_SIZE(gpio_devs)];
+static uint32_t scan_interval = SCAN_INTERVAL;
+
+static struct {
+	uint32_t scan_cnt;
+	uint64_t scan_time_sum;
+	uint32_t scan_time_max;
+	uint32_t latency_cnt;
+	uint64_t latency_sum;
+	uint32_t latency_max;
+	uint32_t irq_cycles;
+	bool irq_pending;
+} stats;
 
 
 static void scan_fn(struct k_work *work);
@@ -70,10 +96,25 @@ static uint32_t get_wakeup_mask(const struct gpio_pin *pins, size_t cnt)
 static int set_cols(uint32_t mask)
 {
 	for (size_t i = 0; i < ARRAY_SIZE(col); i++) {
-		uint32_t val = (mask & BIT(i)) ? (1) : (0);
+		enum col_cfg cfg;
 		int err;
 
-		if (val || !mask) {
+		if (mask & BIT(i)) {
+			cfg = COL_CFG_OUTPUT_ACTIVE;
+		} else if (!mask) {
+			cfg = COL_CFG_OUTPUT_INACTIVE;
+		} else {
+			cfg = COL_CFG_INPUT;
+		}
+
+		/* While the matrix is scanned only two columns change per step. */
+		if (col_cfg[i] == cfg) {
+			continue;
+		}
+
+		if (cfg != COL_CFG_INPUT) {
+			uint32_t val = (cfg == COL_CFG_OUTPUT_ACTIVE) ? (1) : (0);
+
 			if (IS_ENABLED(CONFIG_CAF_BUTTONS_POLARITY_INVERSED)) {
 				val = !val;
 			}
@@ -98,9 +139,12 @@ static int set_cols(uint32_t mask)
 		}
 
 		if (err) {
+			col_cfg[i] = COL_CFG_UNKNOWN;
 			LOG_ERR("Cannot set pin");
 			return -EFAULT;
 		}
+
+		col_cfg[i] = cfg;
 	}
 
 	return 0;
@@ -108,13 +152,22 @@ static int set_cols(uint32_t mask)
 
 static int get_rows(uint32_t *mask)
 {
-	for (size_t i = 0; i < ARRAY_SIZE(row); i++) {
-		int val = gpio_pin_get_raw(gpio_devs[row[i].port], row[i].pin);
+	gpio_port_value_t port_val[ARRAY_SIZE(gpio_devs)];
+
+	/* Read each port once instead of every row pin separately. */
+	for (size_t i = 0; i < ARRAY_SIZE(gpio_devs); i++) {
+		if (!row_port_mask[i]) {
+			continue;
+		}
 
-		if (val < 0) {
+		if (gpio_port_get_raw(gpio_devs[i], &port_val[i])) {
 			LOG_ERR("Cannot get pin");
 			return -EFAULT;
 		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(row); i++) {
+		uint32_t val = (port_val[row[i].port] & BIT(row[i].pin)) ? (1) : (0);
 
 		if (IS_ENABLED(CONFIG_CAF_BUTTONS_POLARITY_INVERSED)) {
 			val = !val;
@@ -126,6 +179,41 @@ static int get_rows(uint32_t *mask)
 	return 0;
 }
 
+static void stats_scan_update(uint32_t start_cycles)
+{
+	uint32_t scan_time = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+
+	stats.scan_cnt++;
+	stats.scan_time_sum += scan_time;
+	stats.scan_time_max = MAX(stats.scan_time_max, scan_time);
+}
+
+static void stats_event_update(void)
+{
+	if (!stats.irq_pending) {
+		return;
+	}
+
+	uint32_t latency = k_cyc_to_us_floor32(k_cycle_get_32() - stats.irq_cycles);
+
+	stats.irq_pending = false;
+	stats.latency_cnt++;
+	stats.latency_sum += latency;
+	stats.latency_max = MAX(stats.latency_max, latency);
+}
+
+static void stats_print(void)
+{
+	LOG_INF("Scans: %u, scan time avg: %u us, max: %u us",
+		stats.scan_cnt,
+		(uint32_t)(stats.scan_time_sum / MAX(stats.scan_cnt, 1)),
+		stats.scan_time_max);
+	LOG_INF("Events after interrupt: %u, latency avg: %u us, max: %u us",
+		stats.latency_cnt,
+		(uint32_t)(stats.latency_sum / MAX(stats.latency_cnt, 1)),
+		stats.latency_max);
+}
+
 static int set_trig_mode(void)
 {
 	gpio_flags_t flags = (IS_ENABLED(CONFIG_CAF_BUTTONS_POLARITY_INVERSED) ?
@@ -273,6 +361,8 @@ static void scan_fn(struct k_work *work)
 	__ASSERT_NO_MSG((state == STATE_SCANNING) ||
 			(state == STATE_SUSPENDING));
 
+	uint32_t start_cycles = k_cycle_get_32();
+
 	/* Get current state */
 	uint32_t raw_state[COLUMNS];
 	memset(raw_state, 0, sizeof(raw_state));
@@ -297,46 +387,52 @@ static void scan_fn(struct k_work *work)
 	}
 
 	static uint32_t settled_state[COLUMNS];
-
-	/* Prevent bouncing */
 	static uint32_t prev_state[COLUMNS];
+
+	/* Prevent bouncing and collect rows that are pressed in more than one column. */
+	uint32_t rows_any = 0;
+	uint32_t rows_multi = 0;
+	bool bouncing = false;
+
 	for (size_t i = 0; i < COLUMNS; i++) {
 		uint32_t bounce_mask = prev_state[i] ^ raw_state[i];
 		prev_state[i] = raw_state[i];
 		raw_state[i] &= ~bounce_mask;
 		raw_state[i] |= settled_state[i] & bounce_mask;
-	}
 
-	/* Prevent ghosting */
-	uint32_t cur_state[COLUMNS];
-	for (size_t i = 0; i < COLUMNS; i++) {
-		uint32_t blocking_mask = 0;
-		for (size_t j = 0; j < COLUMNS; j++) {
-			if (i == j) {
-				continue;
-			}
-			blocking_mask |= raw_state[j];
-		}
-		blocking_mask ^= raw_state[i];
-		cur_state[i] = raw_state[i];
-		if (!is_power_of_two(raw_state[i])) {
-			/* Power of two means only one bit is set */
-			cur_state[i] &= blocking_mask;
-		}
+		bouncing = bouncing || (bounce_mask != 0);
+		rows_multi |= rows_any & raw_state[i];
+		rows_any |= raw_state[i];
 	}
 
 	/* Emit event for any key state change */
 	bool any_pressed = false;
+	bool any_change = bouncing;
 	size_t evt_limit = 0;
 
 	for (size_t i = 0; i < COLUMNS; i++) {
+		/* Prevent ghosting. If more than one row is pressed in the column,
+		 * ignore the rows that are also pressed in other columns.
+		 */
+		uint32_t cur_state = raw_state[i];
+
+		if (!is_power_of_two(raw_state[i])) {
+			/* Power of two means only one bit is set */
+			cur_state &= ~rows_multi;
+		}
+
 		for (size_t j = 0; j < ARRAY_SIZE(row); j++) {
 			bool is_raw_pressed = raw_state[i] & BIT(j);
-			bool is_pressed = cur_state[i] & BIT(j);
+			bool is_pressed = cur_state & BIT(j);
 			bool was_pressed = settled_state[i] & BIT(j);
 
-			if ((is_pressed != was_pressed) &&
-			    (is_pressed == is_raw_pressed) &&
+			if (is_pressed == was_pressed) {
+				continue;
+			}
+
+			any_change = true;
+
+			if ((is_pressed == is_raw_pressed) &&
 			    (evt_limit < CONFIG_CAF_BUTTONS_EVENT_LIMIT)) {
 				struct button_event *event = new_button_event();
 
@@ -344,6 +440,10 @@ static void scan_fn(struct k_work *work)
 				event->pressed = is_pressed;
 				APP_EVENT_SUBMIT(event);
 
+				if (IS_ENABLED(CONFIG_CAF_BUTTONS_STATS)) {
+					stats_event_update();
+				}
+
 				evt_limit++;
 
 				WRITE_BIT(settled_state[i], j, is_pressed);
@@ -353,17 +453,34 @@ static void scan_fn(struct k_work *work)
 		any_pressed = any_pressed ||
 			      (prev_state[i] != 0) ||
 			      (settled_state[i] != 0) ||
-			      (cur_state[i] != 0);
+			      (cur_state != 0);
+	}
+
+	if (IS_ENABLED(CONFIG_CAF_BUTTONS_STATS)) {
+		stats_scan_update(start_cycles);
 	}
 
 	if (any_pressed) {
+		/* Scan fast while keys change state, slow down while they are held. */
+		if (any_change) {
+			scan_interval = SCAN_INTERVAL;
+		} else {
+			scan_interval = MIN(scan_interval * 2, SCAN_INTERVAL_MAX);
+		}
+
 		/* Schedule next scan */
-		k_work_reschedule(&matrix_scan, K_MSEC(SCAN_INTERVAL));
+		k_work_reschedule(&matrix_scan, K_MSEC(scan_interval));
 	} else {
 		/* If no button is pressed module can switch to callbacks */
 
 		int err = 0;
 
+		scan_interval = SCAN_INTERVAL;
+
+		if (IS_ENABLED(CONFIG_CAF_BUTTONS_STATS)) {
+			stats_print();
+		}
+
 		/* Enable callbacks and switch state, then set pins */
 		switch (state) {
 		case STATE_SCANNING:
@@ -408,6 +525,11 @@ static void button_pressed_isr(const struct device *gpio_dev,
 {
 	int err = 0;
 
+	if (IS_ENABLED(CONFIG_CAF_BUTTONS_STATS)) {
+		stats.irq_cycles = k_cycle_get_32();
+		stats.irq_pending = true;
+	}
+
 	/* Scanning will be scheduled, switch off pins */
 	if (set_cols(0)) {
 		LOG_ERR("Cannot control pins");
@@ -499,6 +621,9 @@ static void init_fn(void)
 			LOG_ERR("Cannot configure cols");
 			goto error;
 		}
+
+		/* Configured without pull, so the next set_cols() must reconfigure the pin. */
+		col_cfg[i] = COL_CFG_UNKNOWN;
 	}
 
 	int err = set_trig_mode();
@@ -521,6 +646,7 @@ static void init_fn(void)
 		}
 
 		pin_mask[row[i].port] |= BIT(row[i].pin);
+		row_port_mask[row[i].port] |= BIT(row[i].pin);
 	}
 
 	for (size_t i = 0; i < ARRAY_SIZE(gpio_devs); i++) {
@@ -11,6 +11,7 @@
 #include <caf/events/sensor_event.h>
 #include <caf/events/sensor_data_aggregator_event.h>
 #include <caf/sensor_manager.h>
+#include <caf/sensor_data_aggregator.h>
 
 #define MODULE sensor_data_aggregator
 #include <caf/events/module_state_event.h>
@@ -32,12 +33,26 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_CAF_SENSOR_DATA_AGGREGATOR_LOG_LEVEL);
 		[DIV_ROUND_UP(size, sizeof(struct sensor_value))]
 /* End of BSS version only macros. */
 
+/* Number of samples that fit in a single aggregator buffer. */
+#define __SAMPLES_IN_BUF(agg_node)                   \
+	(DT_PROP(agg_node, buf_data_length) /        \
+	 (DT_PROP(agg_node, sample_size) * sizeof(struct sensor_value)))
+
+#define __TS_BUFF_NAME(agg_node, n) DT_CAT5(agg_, agg_node,  _buff_,  n,  _ts)
+#define __DEFINE_TS(n, agg_node) \
+	static uint32_t __TS_BUFF_NAME(agg_node, n)[__SAMPLES_IN_BUF(agg_node)]
+
 #define __INITIALIZE_BUFF(n, agg_node)                                                        \
-	COND_CODE_1(DT_NODE_HAS_PROP(agg_node, memory_region),                                \
-		({(struct sensor_value *) (DT_REG_ADDR(DT_PHANDLE(agg_node, memory_region)) + \
-			n * (DT_PROP(agg_node, buf_data_length)))}),                          \
-		({__DATA_BUFF_NAME(agg_node, n)})                                             \
-	)
+	{                                                                                     \
+		.samples = COND_CODE_1(DT_NODE_HAS_PROP(agg_node, memory_region),             \
+			((struct sensor_value *)                                              \
+			 (DT_REG_ADDR(DT_PHANDLE(agg_node, memory_region)) +                  \
+			  n * (DT_PROP(agg_node, buf_data_length)))),                         \
+			(__DATA_BUFF_NAME(agg_node, n))                                       \
+		),                                                                            \
+		IF_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_SAMPLE_TIMESTAMPS,               \
+			(.sample_ts = __TS_BUFF_NAME(agg_node, n),))                          \
+	}
 
 #define __XDEFINE_BUF_DATA(agg_node)                                                    \
 	COND_CODE_0(DT_NODE_HAS_PROP(agg_node, memory_region),                          \
@@ -45,6 +60,8 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_CAF_SENSOR_DATA_AGGREGATOR_LOG_LEVEL);
 			agg_node, DT_PROP(agg_node, buf_data_length));),                \
 		()                                                                      \
 	)                                                                               \
+	IF_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_SAMPLE_TIMESTAMPS,                 \
+		(LISTIFY(DT_PROP(agg_node, buf_count), __DEFINE_TS, (;), agg_node);))   \
 	static struct aggregator_buffer __AGG_BUFFS_NAME(agg_node)[] = {                \
 		LISTIFY(DT_PROP(agg_node, buf_count), __INITIALIZE_BUFF, (,), agg_node) \
 	};                                                                              \
@@ -54,29 +71,45 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_CAF_SENSOR_DATA_AGGREGATOR_LOG_LEVEL);
 
 #define __DEFINE_BUF_DATA(i) __XDEFINE_BUF_DATA(DT_DRV_INST(i))
 
-#define __DEFINE_AGGREGATOR(i)                               \
-	[i].sensor_descr = DT_INST_PROP(i, sensor_descr),    \
-	[i].values_in_sample = DT_INST_PROP(i, sample_size), \
-	[i].buf_count = DT_INST_PROP(i, buf_count),          \
-	[i].buf_len = DT_INST_PROP(i, buf_data_length),      \
-	[i].agg_buffers = __AGG_BUFFS_NAME(DT_DRV_INST(i)),  \
-	[i].active_buf  = __AGG_BUFFS_NAME(DT_DRV_INST(i)),
+#define __DEFINE_AGGREGATOR(i)                                     \
+	[i].sensor_descr = DT_INST_PROP(i, sensor_descr),          \
+	[i].values_in_sample = DT_INST_PROP(i, sample_size),       \
+	[i].buf_count = DT_INST_PROP(i, buf_count),                \
+	[i].samples_in_buf = __SAMPLES_IN_BUF(DT_DRV_INST(i)),     \
+	[i].agg_buffers = __AGG_BUFFS_NAME(DT_DRV_INST(i)),
 
+/* The buffer state and the number of samples in the buffer are kept in a single atomic variable.
+ * This allows the producer to commit samples while the buffer is flushed from another context.
+ */
+#define BUF_STATE_POS		16
+#define BUF_SAMPLE_CNT_MASK	BIT_MASK(BUF_STATE_POS)
+#define BUF_STATE_VAL(state, cnt)	(((state) << BUF_STATE_POS) | (cnt))
+#define BUF_STATE_GET(val)	((val) >> BUF_STATE_POS)
+#define BUF_SAMPLE_CNT_GET(val)	((val) & BUF_SAMPLE_CNT_MASK)
+
+enum buf_state {
+	BUF_STATE_FREE,		/* Buffer can be used to store samples. */
+	BUF_STATE_FILLING,	/* Producer stores samples in the buffer. */
+	BUF_STATE_SENT,		/* Buffer is owned by the listeners until it is released. */
+};
 
 struct aggregator_buffer {
 	struct sensor_value *samples;	/* Dynamic data. */
-	bool busy;			/* Buffer status. */
-	uint8_t sample_cnt;		/* Number of samples already saved in the buffer. */
+	uint32_t *sample_ts;		/* Sample timestamps relative to the buffer timestamp. */
+	int64_t timestamp;		/* Timestamp of the first sample in microseconds. */
+	uint32_t dropped_cnt;		/* Samples dropped right before the first sample. */
+	atomic_t state;			/* Buffer state and number of samples in the buffer. */
 };
 
 struct aggregator {
 	const char *sensor_descr;		/* sensor_description of the sensor. */
-	struct aggregator_buffer *agg_buffers;	/* Buffers. */
-	struct aggregator_buffer *active_buf;	/* Active buffer to which data will be placed. */
+	struct aggregator_buffer *agg_buffers;	/* Buffers, used as a ring. */
 	enum sensor_state sensor_state;		/* Sensors state. */
+	atomic_t dropped_cnt;			/* Samples dropped since the last buffer was taken. */
+	uint8_t active_idx;			/* Index of the buffer filled by the producer. */
 	const uint8_t values_in_sample;		/* Number of sensor values in a sample. */
 	const uint8_t buf_count;		/* Number of buffers. */
-	const uint8_t buf_len;			/* Size of buffor data in bytes. */
+	const uint8_t samples_in_buf;		/* Number of samples in a buffer. */
 };
 
 
@@ -86,14 +119,9 @@ static struct aggregator aggregators[] = {
 };
 
 
-static struct aggregator_buffer *get_free_buffer(struct aggregator *agg)
+static int64_t timestamp_get(void)
 {
-	for (size_t i = 0; i < agg->buf_count; i++) {
-		if (!agg->agg_buffers[i].busy) {
-			return &agg->agg_buffers[i];
-		}
-	}
-	return NULL;
+	return k_ticks_to_us_floor64(k_uptime_ticks());
 }
 
 static struct aggregator *get_aggregator(const char *sensor_descr)
@@ -108,58 +136,207 @@ static struct aggregator *get_aggregator(const char *sensor_descr)
 
 static void release_buffer(struct aggregator *agg, struct aggregator_buffer *ab)
 {
-	__ASSERT_NO_MSG(ab);
+	ARG_UNUSED(agg);
+	__ASSERT_NO_MSG(BUF_STATE_GET(atomic_get(&ab->state)) == BUF_STATE_SENT);
 
-	ab->sample_cnt = 0;
-	ab->busy = false;
-	if (agg->active_buf == NULL) {
-		agg->active_buf = ab;
-	}
+	atomic_set(&ab->state, BUF_STATE_VAL(BUF_STATE_FREE, 0));
 }
 
-static void send_buffer(struct aggregator *agg, struct aggregator_buffer *ab)
+static void send_buffer(struct aggregator *agg, struct aggregator_buffer *ab, uint8_t sample_cnt,
+			int64_t timestamp, uint32_t dropped_cnt)
 {
-	ab->busy = true;
 	struct sensor_data_aggregator_event *event = new_sensor_data_aggregator_event();
+
 	event->values_in_sample = agg->values_in_sample;
 	event->samples = ab->samples;
-	event->sample_cnt = ab->sample_cnt;
+	event->sample_cnt = sample_cnt;
 	event->sensor_state = agg->sensor_state;
 	event->sensor_descr = agg->sensor_descr;
+	event->timestamp = timestamp;
+	event->sample_timestamps = ab->sample_ts;
+	event->dropped_cnt = dropped_cnt;
 	APP_EVENT_SUBMIT(event);
 }
 
-static int enqueue_sample(struct aggregator *agg, struct sensor_event *event)
+/* Get the buffer to which the producer stores samples. Buffers are taken in ring order, so the
+ * samples are delivered in order. Returns NULL if the next buffer is still owned by listeners.
+ */
+static struct aggregator_buffer *active_buffer_get(struct aggregator *agg)
 {
-	size_t chunk_bytes = agg->values_in_sample * sizeof(struct sensor_value);
+	struct aggregator_buffer *ab = &agg->agg_buffers[agg->active_idx];
+	atomic_val_t val = atomic_get(&ab->state);
 
-	if ((event->dyndata.size) != chunk_bytes) {
-		return -EBADMSG;
+	if (BUF_STATE_GET(val) == BUF_STATE_FILLING) {
+		return ab;
 	}
-	if (!agg->active_buf) {
-		return -ENOMEM;
+
+	if (BUF_STATE_GET(val) == BUF_STATE_SENT) {
+		uint8_t next_idx = (agg->active_idx + 1) % agg->buf_count;
+
+		ab = &agg->agg_buffers[next_idx];
+		if (BUF_STATE_GET(atomic_get(&ab->state)) != BUF_STATE_FREE) {
+			return NULL;
+		}
+
+		agg->active_idx = next_idx;
 	}
 
-	struct aggregator_buffer *ab = agg->active_buf;
-	size_t pos_values = ab->sample_cnt * agg->values_in_sample;
-	size_t avail_bytes = agg->buf_len - pos_values * sizeof(struct sensor_value);
+	/* Buffer fields are only written by the producer, before the buffer is published. */
+	ab->dropped_cnt = atomic_clear(&agg->dropped_cnt);
 
-	if (avail_bytes < chunk_bytes) {
-		__ASSERT_NO_MSG(false);
-		return -ENOMEM;
+	if (!atomic_cas(&ab->state, BUF_STATE_VAL(BUF_STATE_FREE, 0),
+			BUF_STATE_VAL(BUF_STATE_FILLING, 0))) {
+		/* Buffer was flushed in the meantime. */
+		atomic_add(&agg->dropped_cnt, ab->dropped_cnt);
+		return NULL;
 	}
-	memcpy(&ab->samples[pos_values], (uint8_t *)event->dyndata.data, chunk_bytes);
-	ab->sample_cnt++;
-	avail_bytes -= chunk_bytes;
 
-	if (avail_bytes < chunk_bytes) {
-		send_buffer(agg, ab);
-		agg->active_buf = get_free_buffer(agg);
+	return ab;
+}
+
+static void sample_drop(struct aggregator *agg)
+{
+	if (atomic_inc(&agg->dropped_cnt) == 0) {
+		LOG_WRN("No free buffer for %s, dropping samples", agg->sensor_descr);
 	}
+}
+
+static int sample_claim(struct aggregator *agg, struct sensor_value **data)
+{
+	struct aggregator_buffer *ab = active_buffer_get(agg);
+	size_t sample_cnt;
+
+	if (!ab) {
+		sample_drop(agg);
+		return -ENOBUFS;
+	}
+
+	sample_cnt = BUF_SAMPLE_CNT_GET(atomic_get(&ab->state));
+	__ASSERT_NO_MSG(sample_cnt < agg->samples_in_buf);
+
+	if (sample_cnt == 0) {
+		ab->timestamp = timestamp_get();
+	}
+
+	if (IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_SAMPLE_TIMESTAMPS)) {
+		ab->sample_ts[sample_cnt] = timestamp_get() - ab->timestamp;
+	}
+
+	*data = &ab->samples[sample_cnt * agg->values_in_sample];
 
 	return 0;
 }
 
+static int sample_commit(struct aggregator *agg)
+{
+	struct aggregator_buffer *ab = &agg->agg_buffers[agg->active_idx];
+	atomic_val_t val;
+	atomic_val_t new_val;
+	size_t sample_cnt;
+
+	do {
+		val = atomic_get(&ab->state);
+		if (BUF_STATE_GET(val) != BUF_STATE_FILLING) {
+			/* Buffer was flushed while the sample was written. */
+			sample_drop(agg);
+			return -ENOBUFS;
+		}
+
+		sample_cnt = BUF_SAMPLE_CNT_GET(val) + 1;
+		new_val = BUF_STATE_VAL((sample_cnt < agg->samples_in_buf) ?
+					BUF_STATE_FILLING : BUF_STATE_SENT, sample_cnt);
+	} while (!atomic_cas(&ab->state, val, new_val));
+
+	if (BUF_STATE_GET(new_val) == BUF_STATE_SENT) {
+		send_buffer(agg, ab, sample_cnt, ab->timestamp, ab->dropped_cnt);
+	}
+
+	return 0;
+}
+
+/* Take the active buffer to report the sensor state. If the buffer was already sent, because it was
+ * filled up, the next buffer in the ring is used. The producer never skips a buffer, so the order
+ * of buffers is kept.
+ */
+static void flush_buffer(struct aggregator *agg)
+{
+	uint8_t idx = agg->active_idx;
+
+	for (size_t i = 0; i < MIN(agg->buf_count, 2); i++) {
+		struct aggregator_buffer *ab = &agg->agg_buffers[(idx + i) % agg->buf_count];
+		atomic_val_t val;
+
+		do {
+			val = atomic_get(&ab->state);
+		} while ((BUF_STATE_GET(val) != BUF_STATE_SENT) &&
+			 !atomic_cas(&ab->state, val, BUF_STATE_VAL(BUF_STATE_SENT,
+								     BUF_SAMPLE_CNT_GET(val))));
+
+		if (BUF_STATE_GET(val) == BUF_STATE_SENT) {
+			continue;
+		}
+
+		if (BUF_STATE_GET(val) == BUF_STATE_FREE) {
+			/* Empty buffer only reports the sensor state change. */
+			send_buffer(agg, ab, 0, timestamp_get(), 0);
+		} else {
+			send_buffer(agg, ab, BUF_SAMPLE_CNT_GET(val), ab->timestamp,
+				    ab->dropped_cnt);
+		}
+
+		return;
+	}
+
+	LOG_WRN("No free buffer to send %s state", agg->sensor_descr);
+}
+
+int sensor_data_aggregator_sample_claim(const char *sensor_descr, size_t value_cnt,
+					struct sensor_value **data)
+{
+	struct aggregator *agg = get_aggregator(sensor_descr);
+
+	if (!agg) {
+		return -ENOENT;
+	}
+
+	if (value_cnt != agg->values_in_sample) {
+		return -EBADMSG;
+	}
+
+	return sample_claim(agg, data);
+}
+
+int sensor_data_aggregator_sample_commit(const char *sensor_descr)
+{
+	struct aggregator *agg = get_aggregator(sensor_descr);
+
+	if (!agg) {
+		return -ENOENT;
+	}
+
+	return sample_commit(agg);
+}
+
+static int enqueue_sample(struct aggregator *agg, struct sensor_event *event)
+{
+	size_t chunk_bytes = agg->values_in_sample * sizeof(struct sensor_value);
+	struct sensor_value *data;
+	int err;
+
+	if ((event->dyndata.size) != chunk_bytes) {
+		return -EBADMSG;
+	}
+
+	err = sample_claim(agg, &data);
+	if (err) {
+		return err;
+	}
+
+	memcpy(data, event->dyndata.data, chunk_bytes);
+
+	return sample_commit(agg);
+}
+
 static bool event_handler(const struct app_event_header *aeh)
 {
 	if (is_sensor_event(aeh)) {
@@ -169,7 +346,7 @@ static bool event_handler(const struct app_event_header *aeh)
 		if (agg) {
 			int err = enqueue_sample(agg, event);
 
-			if (err) {
+			if (err && (err != -ENOBUFS)) {
 				LOG_ERR("Error code: %d", err);
 			}
 		} else {
@@ -201,11 +378,8 @@ static bool event_handler(const struct app_event_header *aeh)
 		struct aggregator *agg = get_aggregator(event->descr);
 
 		if (agg) {
-			struct aggregator_buffer *ab = agg->active_buf;
-
 			agg->sensor_state = event->state;
-			send_buffer(agg, ab);
-			agg->active_buf = get_free_buffer(agg);
+			flush_buffer(agg);
 		}
 
 		return false;
@@ -10,6 +10,7 @@
 
 #include <caf/events/sensor_event.h>
 #include <caf/sensor_manager.h>
+#include <caf/sensor_data_aggregator.h>
 
 #include CONFIG_CAF_SENSOR_MANAGER_DEF_PATH
 
@@ -219,7 +220,23 @@ static void sample_sensor(struct sensor_data *sd, const struct sm_sensor_config
 {
 	size_t data_idx = 0;
 	size_t data_cnt = get_sensor_data_cnt(sc);
-	struct sensor_value data[data_cnt];
+	struct sensor_value local_data[data_cnt];
+	struct sensor_value *data = local_data;
+	bool aggregated = false;
+	bool send_event = true;
+
+	if (IS_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_DIRECT)) {
+		int ret = sensor_data_aggregator_sample_claim(sc->event_descr, data_cnt, &data);
+
+		/* If no aggregator buffer is available, the sample is accounted as dropped by
+		 * the aggregator. It is still read for the activity detection.
+		 */
+		aggregated = (ret == 0);
+		send_event = (ret != 0) && (ret != -ENOBUFS);
+		if (!aggregated) {
+			data = local_data;
+		}
+	}
 
 	int err = sensor_sample_fetch(sc->dev);
 
@@ -234,9 +251,10 @@ static void sample_sensor(struct sensor_data *sd, const struct sm_sensor_config
 		LOG_ERR("Sensor sampling error (err %d)", err);
 		update_sensor_state(sc, sd, SENSOR_STATE_ERROR);
 	} else {
-		if (atomic_get(&sd->event_cnt) < sc->active_events_limit) {
-			send_sensor_event(sc->event_descr, data, ARRAY_SIZE(data),
-					  &sd->event_cnt);
+		if (!send_event) {
+			/* Sample is handled by the aggregator. */
+		} else if (atomic_get(&sd->event_cnt) < sc->active_events_limit) {
+			send_sensor_event(sc->event_descr, data, data_cnt, &sd->event_cnt);
 		} else {
 			LOG_WRN("Did not send event due to too many active events on sensor: %s",
 				sc->dev->name);
@@ -244,10 +262,16 @@ static void sample_sensor(struct sensor_data *sd, const struct sm_sensor_config
 
 		if (sc->trigger && IS_ENABLED(CONFIG_CAF_SENSOR_MANAGER_PM)) {
 			process_sensor_activity(sc, sd, data);
-			if (!is_sensor_active(sd)) {
-				enter_sleep(sc, sd);
-			}
+		}
+
+		/* Commit after the data is processed, the buffer may be sent on commit. */
+		if (aggregated) {
+			(void)sensor_data_aggregator_sample_commit(sc->event_descr);
+		}
 
+		if (sc->trigger && IS_ENABLED(CONFIG_CAF_SENSOR_MANAGER_PM) &&
+		    !is_sensor_active(sd)) {
+			enter_sleep(sc, sd);
 		}
 	}
 }
@@ -5,6 +5,7 @@
  */
 
 #include <dfu/dfu_multi_image.h>
+#include <zephyr/kernel.h>
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/util.h>
 #include <zcbor_decode.h>
@@ -27,6 +28,15 @@ struct header {
 	size_t image_count;
 };
 
+struct image_stats {
+	bool opened;
+	bool closed;
+	size_t bytes_written;
+	uint32_t busy_cyc;
+	int64_t open_time;
+	int64_t close_time;
+};
+
 struct dfu_multi_image_ctx {
 	/* User configuration */
 	uint8_t *buffer;
@@ -37,6 +47,9 @@ struct dfu_multi_image_ctx {
 	/* Parsed header */
 	struct header header;
 
+	/* Per-image statistics, indexed like header.images */
+	struct image_stats stats[CONFIG_DFU_MULTI_IMAGE_MAX_IMAGE_COUNT];
+
 	/* Current parser state */
 	int cur_image_no;
 	size_t cur_offset;
@@ -46,6 +59,222 @@ struct dfu_multi_image_ctx {
 
 static struct dfu_multi_image_ctx ctx;
 
+static int writer_open(const struct dfu_image_writer *writer, int image_no, size_t size)
+{
+	struct image_stats *stats = &ctx.stats[image_no];
+	uint32_t start = k_cycle_get_32();
+	int err;
+
+	stats->opened = true;
+	stats->open_time = k_uptime_get();
+	err = writer->open(writer->image_id, size);
+	stats->busy_cyc += k_cycle_get_32() - start;
+
+	return err;
+}
+
+static int writer_write(const struct dfu_image_writer *writer, int image_no,
+			const uint8_t *chunk, size_t chunk_size)
+{
+	struct image_stats *stats = &ctx.stats[image_no];
+	uint32_t start = k_cycle_get_32();
+	int err;
+
+	err = writer->write(chunk, chunk_size);
+	stats->busy_cyc += k_cycle_get_32() - start;
+
+	if (!err) {
+		stats->bytes_written += chunk_size;
+	}
+
+	return err;
+}
+
+static int writer_close(const struct dfu_image_writer *writer, int image_no, bool success)
+{
+	struct image_stats *stats = &ctx.stats[image_no];
+	uint32_t start = k_cycle_get_32();
+	int err;
+
+	err = writer->close(success);
+	stats->busy_cyc += k_cycle_get_32() - start;
+	stats->closed = true;
+	stats->close_time = k_uptime_get();
+
+	return err;
+}
+
+#ifdef CONFIG_DFU_MULTI_IMAGE_ASYNC
+
+/*
+ * Image data is copied to blocks from a memory slab and handed over to the worker thread,
+ * which calls the image writers. This lets the transport receive the next chunk while the
+ * previous one is written to flash. The writer callbacks are still called in package order,
+ * so an image is always closed before the next one is opened.
+ */
+
+enum async_op_type {
+	ASYNC_OP_OPEN,
+	ASYNC_OP_WRITE,
+	ASYNC_OP_CLOSE,
+	ASYNC_OP_FLUSH,
+};
+
+struct async_op {
+	enum async_op_type type;
+	const struct dfu_image_writer *writer;
+	int image_no;
+	union {
+		size_t size;
+		bool success;
+		struct k_sem *done;
+	};
+	uint8_t *block;
+};
+
+static K_MEM_SLAB_DEFINE(async_blocks, CONFIG_DFU_MULTI_IMAGE_ASYNC_BLOCK_SIZE,
+			 CONFIG_DFU_MULTI_IMAGE_ASYNC_BLOCK_COUNT, sizeof(void *));
+static K_MSGQ_DEFINE(async_ops, sizeof(struct async_op),
+		     CONFIG_DFU_MULTI_IMAGE_ASYNC_BLOCK_COUNT + 2, sizeof(void *));
+
+/* First error reported by an image writer since the last dfu_multi_image_init() */
+static atomic_t async_err;
+
+static void async_worker(void *p1, void *p2, void *p3)
+{
+	struct async_op op;
+	int err;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_msgq_get(&async_ops, &op, K_FOREVER);
+
+		err = (int)atomic_get(&async_err);
+
+		switch (op.type) {
+		case ASYNC_OP_OPEN:
+			if (!err) {
+				err = writer_open(op.writer, op.image_no, op.size);
+			}
+			break;
+		case ASYNC_OP_WRITE:
+			if (!err) {
+				err = writer_write(op.writer, op.image_no, op.block, op.size);
+			}
+			k_mem_slab_free(&async_blocks, (void **)&op.block);
+			break;
+		case ASYNC_OP_CLOSE:
+			/* Always close an opened writer, even after a failure */
+			err = writer_close(op.writer, op.image_no, op.success && !err);
+			break;
+		case ASYNC_OP_FLUSH:
+			k_sem_give(op.done);
+			break;
+		}
+
+		if (err) {
+			atomic_cas(&async_err, 0, err);
+		}
+	}
+}
+
+K_THREAD_DEFINE(dfu_multi_image_worker, CONFIG_DFU_MULTI_IMAGE_ASYNC_STACK_SIZE, async_worker,
+		NULL, NULL, NULL, CONFIG_DFU_MULTI_IMAGE_ASYNC_PRIORITY, 0, 0);
+
+static int async_flush(void)
+{
+	struct k_sem done;
+	struct async_op op = {
+		.type = ASYNC_OP_FLUSH,
+		.done = &done,
+	};
+
+	k_sem_init(&done, 0, 1);
+	k_msgq_put(&async_ops, &op, K_FOREVER);
+	k_sem_take(&done, K_FOREVER);
+
+	return (int)atomic_get(&async_err);
+}
+
+static int image_open(const struct dfu_image_writer *writer, int image_no, size_t size)
+{
+	struct async_op op = {
+		.type = ASYNC_OP_OPEN,
+		.writer = writer,
+		.image_no = image_no,
+		.size = size,
+	};
+
+	return k_msgq_put(&async_ops, &op, K_FOREVER);
+}
+
+static int image_write(const struct dfu_image_writer *writer, int image_no,
+		       const uint8_t *chunk, size_t chunk_size)
+{
+	struct async_op op = {
+		.type = ASYNC_OP_WRITE,
+		.writer = writer,
+		.image_no = image_no,
+	};
+	int err;
+
+	while (chunk_size > 0) {
+		err = (int)atomic_get(&async_err);
+		if (err) {
+			return err;
+		}
+
+		err = k_mem_slab_alloc(&async_blocks, (void **)&op.block, K_FOREVER);
+		if (err) {
+			return err;
+		}
+
+		op.size = MIN(chunk_size, CONFIG_DFU_MULTI_IMAGE_ASYNC_BLOCK_SIZE);
+		memcpy(op.block, chunk, op.size);
+		k_msgq_put(&async_ops, &op, K_FOREVER);
+
+		chunk += op.size;
+		chunk_size -= op.size;
+	}
+
+	return 0;
+}
+
+static int image_close(const struct dfu_image_writer *writer, int image_no, bool success)
+{
+	struct async_op op = {
+		.type = ASYNC_OP_CLOSE,
+		.writer = writer,
+		.image_no = image_no,
+		.success = success,
+	};
+
+	return k_msgq_put(&async_ops, &op, K_FOREVER);
+}
+
+#else
+
+static int image_open(const struct dfu_image_writer *writer, int image_no, size_t size)
+{
+	return writer_open(writer, image_no, size);
+}
+
+static int image_write(const struct dfu_image_writer *writer, int image_no,
+		       const uint8_t *chunk, size_t chunk_size)
+{
+	return writer_write(writer, image_no, chunk, chunk_size);
+}
+
+static int image_close(const struct dfu_image_writer *writer, int image_no, bool success)
+{
+	return writer_close(writer, image_no, success);
+}
+
+#endif /* CONFIG_DFU_MULTI_IMAGE_ASYNC */
+
 static int parse_fixed_header(void)
 {
 	ctx.cur_item_size += sys_get_le16(ctx.buffer);
@@ -149,16 +378,16 @@ static int process_current_item(const uint8_t *chunk, size_t chunk_size)
 		}
 
 		if (!err && ctx.cur_item_offset == 0) {
-			err = writer->open(writer->image_id,
-					   ctx.header.images[ctx.cur_image_no].size);
+			err = image_open(writer, ctx.cur_image_no,
+					 ctx.header.images[ctx.cur_image_no].size);
 		}
 
 		if (!err) {
-			err = writer->write(chunk, chunk_size);
+			err = image_write(writer, ctx.cur_image_no, chunk, chunk_size);
 		}
 
 		if (!err && ctx.cur_item_offset + chunk_size == ctx.cur_item_size) {
-			err = writer->close(true);
+			err = image_close(writer, ctx.cur_image_no, true);
 		}
 	}
 
@@ -182,6 +411,12 @@ int dfu_multi_image_init(uint8_t *buffer, size_t buffer_size)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_ASYNC
+	/* Drain operations left over from a previous, abandoned package */
+	(void)async_flush();
+	atomic_set(&async_err, 0);
+#endif
+
 	memset(&ctx, 0, sizeof(ctx));
 	ctx.buffer = buffer;
 	ctx.buffer_size = buffer_size;
@@ -211,6 +446,13 @@ int dfu_multi_image_write(size_t offset, const uint8_t *chunk, size_t chunk_size
 		return -ESPIPE;
 	}
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_ASYNC
+	result = (int)atomic_get(&async_err);
+	if (result) {
+		return result;
+	}
+#endif
+
 	while (1) {
 		/* Skip ahead to the current write offset */
 		chunk_offset += (ctx.cur_offset - offset);
@@ -244,8 +486,15 @@ int dfu_multi_image_done(bool success)
 
 	/* Close any active writer if such exists */
 	if (writer != NULL) {
-		err = writer->close(success);
+		err = image_close(writer, ctx.cur_image_no, success);
+	}
+
+#ifdef CONFIG_DFU_MULTI_IMAGE_ASYNC
+	/* Wait until all queued data has been written */
+	if (!err) {
+		err = async_flush();
 	}
+#endif
 
 	/* On success, verify that all images have been fully written */
 	if (!err && success && ctx.cur_image_no != ctx.header.image_count) {
@@ -254,3 +503,36 @@ int dfu_multi_image_done(bool success)
 
 	return err;
 }
+
+int dfu_multi_image_stats_get(int image_id, struct dfu_multi_image_stats *stats)
+{
+	if (stats == NULL) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < ctx.header.image_count; i++) {
+		const struct image_stats *image = &ctx.stats[i];
+		int64_t end_time;
+
+		if (ctx.header.images[i].id != image_id) {
+			continue;
+		}
+
+		if (!image->opened) {
+			return -ENOENT;
+		}
+
+		end_time = image->closed ? image->close_time : k_uptime_get();
+
+		stats->bytes_written = image->bytes_written;
+		stats->elapsed_ms = (uint32_t)(end_time - image->open_time);
+		stats->busy_ms = k_cyc_to_ms_floor32(image->busy_cyc);
+		stats->bytes_per_sec = stats->elapsed_ms ?
+			(uint32_t)(((uint64_t)image->bytes_written * MSEC_PER_SEC) /
+				   stats->elapsed_ms) : 0;
+
+		return 0;
+	}
+
+	return -ENOENT;
+}
@@ -110,17 +110,41 @@ static int load_segment(const struct device *fdev, size_t seg_size,
 		read_addr += read_len;
 	}
 
-	if (is_bootloader) {
-		/* We need to explicitly call _apply() once all chunks of the
-		 * bootloader has been written.
-		 */
-		err = nrf_modem_bootloader_update();
-		if (err != 0) {
-			LOG_ERR("nrf_modem_bootloader_update (bl) failed, err: %d", err);
-			return err;
-		}
+	return 0;
+}
+
+static int segment_done(int seg_idx, uint8_t *meta_buf, size_t wrapper_len)
+{
+	int err;
+
+	if (seg_idx != 0) {
+		return 0;
+	}
+
+	/* We need to explicitly call _apply() once all chunks of the
+	 * bootloader has been written.
+	 */
+	err = nrf_modem_bootloader_update();
+	if (err != 0) {
+		LOG_ERR("nrf_modem_bootloader_update (bl) failed, err: %d", err);
+		return err;
 	}
 
+#ifndef CONFIG_FMFU_FDEV_SKIP_PREVALIDATION
+	/* The IPC-DFU bootloader has been written, we can now
+	 * perform the prevalidation.
+	 */
+	LOG_INF("Running prevalidation (can take minutes)");
+	err = nrf_modem_bootloader_verify((void *)meta_buf, wrapper_len);
+	if (err != 0) {
+		LOG_ERR("nrf_fmfu_verify_signature failed, err: %d", err);
+		return err;
+	}
+#else
+	LOG_WRN("[WARNING] Skipping prevalidation, this "
+		"should only be done during development");
+#endif /* CONFIG_FMFU_FDEV_SKIP_PREVALIDATION */
+
 	return 0;
 }
 
@@ -149,22 +173,11 @@ static int load_segments(const struct device *fdev, uint8_t *meta_buf,
 			return err;
 		}
 
-		if (i == 0) {
-#ifndef CONFIG_FMFU_FDEV_SKIP_PREVALIDATION
-			/* The IPC-DFU bootloader has been written, we can now
-			 * perform the prevalidation.
-			 */
-			LOG_INF("Running prevalidation (can take minutes)");
-			err = nrf_modem_bootloader_verify((void *)meta_buf, wrapper_len);
-			if (err != 0) {
-				LOG_ERR("nrf_fmfu_verify_signature failed, err: %d", err);
-				return err;
-			}
-#else
-			LOG_WRN("[WARNING] Skipping prevalidation, this "
-				"should only be done during development");
-#endif /* CONFIG_FMFU_FDEV_SKIP_PREVALIDATION */
+		err = segment_done(i, meta_buf, wrapper_len);
+		if (err != 0) {
+			return err;
 		}
+
 		prev_segments_len += seg_size;
 	}
 
@@ -179,6 +192,213 @@ static int load_segments(const struct device *fdev, uint8_t *meta_buf,
 	return 0;
 }
 
+#if defined(CONFIG_FMFU_FDEV_PIPELINED)
+/* Two buffers are used: the reader thread fills one half of the user buffer
+ * from the flash device while the other half is hashed and written to the
+ * modem.
+ */
+#define PIPE_BUF_COUNT 2
+
+struct pipe_chunk {
+	uint8_t *buf;
+	size_t len;
+	int err;
+};
+
+static struct {
+	const struct device *fdev;
+	const struct Segments *seg;
+	size_t blob_offset;
+	size_t chunk_size;
+	struct pipe_chunk chunk[PIPE_BUF_COUNT];
+	struct k_sem free[PIPE_BUF_COUNT];
+	struct k_sem filled[PIPE_BUF_COUNT];
+	atomic_t abort;
+	uint32_t read_cyc;
+} pipe;
+
+static K_THREAD_STACK_DEFINE(reader_stack, CONFIG_FMFU_FDEV_PIPELINED_READER_STACK_SIZE);
+static struct k_thread reader_thread;
+
+static void reader_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	size_t read_addr = pipe.blob_offset;
+	int idx = 0;
+
+	for (int i = 0; i < pipe.seg->_Segments__Segment_count; i++) {
+		size_t bytes_left = pipe.seg->_Segments__Segment[i]._Segment_len;
+
+		while (bytes_left) {
+			struct pipe_chunk *chunk = &pipe.chunk[idx];
+			uint32_t start;
+
+			k_sem_take(&pipe.free[idx], K_FOREVER);
+			if (atomic_get(&pipe.abort)) {
+				return;
+			}
+
+			chunk->len = MIN(pipe.chunk_size, bytes_left);
+
+			start = k_cycle_get_32();
+			chunk->err = flash_read(pipe.fdev, read_addr, chunk->buf, chunk->len);
+			pipe.read_cyc += k_cycle_get_32() - start;
+
+			k_sem_give(&pipe.filled[idx]);
+			if (chunk->err != 0) {
+				return;
+			}
+
+			read_addr += chunk->len;
+			bytes_left -= chunk->len;
+			idx = (idx + 1) % PIPE_BUF_COUNT;
+		}
+	}
+}
+
+static int load_segments_pipelined(const struct device *fdev, uint8_t *meta_buf,
+				   size_t wrapper_len, const struct Segments *seg,
+				   size_t blob_offset, const uint8_t *expected_hash,
+				   uint8_t *buf, size_t buf_len)
+{
+	int err;
+	int idx = 0;
+	uint8_t hash[32];
+	mbedtls_sha256_context sha256_ctx;
+	uint32_t hash_cyc = 0;
+	uint32_t write_cyc = 0;
+	uint32_t stall_cyc = 0;
+	int64_t start_time = k_uptime_get();
+
+	pipe.chunk_size = ROUND_DOWN(buf_len / PIPE_BUF_COUNT, sizeof(uint32_t));
+	if (pipe.chunk_size == 0) {
+		return -ENOMEM;
+	}
+
+	pipe.fdev = fdev;
+	pipe.seg = seg;
+	pipe.blob_offset = blob_offset;
+	pipe.read_cyc = 0;
+	atomic_set(&pipe.abort, 0);
+
+	for (int i = 0; i < PIPE_BUF_COUNT; i++) {
+		pipe.chunk[i].buf = buf + i * pipe.chunk_size;
+		k_sem_init(&pipe.free[i], 1, 1);
+		k_sem_init(&pipe.filled[i], 0, 1);
+	}
+
+	mbedtls_sha256_init(&sha256_ctx);
+	err = mbedtls_sha256_starts(&sha256_ctx, false);
+	if (err != 0) {
+		return err;
+	}
+
+	k_thread_create(&reader_thread, reader_stack, K_THREAD_STACK_SIZEOF(reader_stack),
+			reader_fn, NULL, NULL, NULL,
+			CONFIG_FMFU_FDEV_PIPELINED_READER_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&reader_thread, "fmfu_fdev_reader");
+
+	for (int i = 0; i < seg->_Segments__Segment_count; i++) {
+		size_t bytes_left = seg->_Segments__Segment[i]._Segment_len;
+		uint32_t seg_addr = seg->_Segments__Segment[i]._Segment_target_addr;
+		bool is_bootloader = i == 0;
+
+		LOG_INF("Writing segment %d/%d, Target addr: 0x%x, size: 0%x",
+			i + 1, seg->_Segments__Segment_count, seg_addr,
+			bytes_left);
+
+		while (bytes_left) {
+			struct pipe_chunk *chunk = &pipe.chunk[idx];
+			uint32_t start;
+
+			start = k_cycle_get_32();
+			k_sem_take(&pipe.filled[idx], K_FOREVER);
+			stall_cyc += k_cycle_get_32() - start;
+
+			err = chunk->err;
+			if (err != 0) {
+				LOG_ERR("flash_read failed: %d", err);
+				goto out;
+			}
+
+			start = k_cycle_get_32();
+			err = mbedtls_sha256_update(&sha256_ctx, chunk->buf, chunk->len);
+			hash_cyc += k_cycle_get_32() - start;
+			if (err != 0) {
+				goto out;
+			}
+
+			start = k_cycle_get_32();
+			err = write_chunk(chunk->buf, chunk->len, seg_addr, is_bootloader);
+			write_cyc += k_cycle_get_32() - start;
+			if (err != 0) {
+				LOG_ERR("write_chunk failed: %d", err);
+				goto out;
+			}
+
+			seg_addr += chunk->len;
+			bytes_left -= chunk->len;
+
+			k_sem_give(&pipe.free[idx]);
+			idx = (idx + 1) % PIPE_BUF_COUNT;
+		}
+
+		err = segment_done(i, meta_buf, wrapper_len);
+		if (err != 0) {
+			goto out;
+		}
+	}
+
+	err = mbedtls_sha256_finish(&sha256_ctx, hash);
+	if (err != 0) {
+		goto out;
+	}
+
+	/* Only commit the firmware if the data read from flash was intact. */
+	if (memcmp(expected_hash, hash, sizeof(hash)) != 0) {
+		LOG_ERR("Invalid hash");
+		err = -EINVAL;
+		goto out;
+	}
+
+	err = nrf_modem_bootloader_update();
+	if (err != 0) {
+		LOG_ERR("nrf_modem_bootloader_update (fw) failed, err: %d", err);
+		goto out;
+	}
+
+	LOG_INF("FMFU finished");
+
+out:
+	if (err != 0) {
+		atomic_set(&pipe.abort, 1);
+		for (int i = 0; i < PIPE_BUF_COUNT; i++) {
+			k_sem_give(&pipe.free[i]);
+		}
+	}
+
+	k_thread_join(&reader_thread, K_FOREVER);
+
+	LOG_INF("FMFU timing: total %u ms, read %u ms, hash %u ms, write %u ms, stall %u ms",
+		(uint32_t)(k_uptime_get() - start_time), k_cyc_to_ms_floor32(pipe.read_cyc),
+		k_cyc_to_ms_floor32(hash_cyc), k_cyc_to_ms_floor32(write_cyc),
+		k_cyc_to_ms_floor32(stall_cyc));
+
+	return err;
+}
+#else
+static int load_segments_pipelined(const struct device *fdev, uint8_t *meta_buf,
+				   size_t wrapper_len, const struct Segments *seg,
+				   size_t blob_offset, const uint8_t *expected_hash,
+				   uint8_t *buf, size_t buf_len)
+{
+	return -ENOTSUP;
+}
+#endif /* CONFIG_FMFU_FDEV_PIPELINED */
+
 int fmfu_fdev_load(uint8_t *buf, size_t buf_len, const struct device *fdev,
 		   size_t offset)
 {
@@ -192,6 +412,7 @@ int fmfu_fdev_load(uint8_t *buf, size_t buf_len, const struct device *fdev,
 	size_t wrapper_len;
 	uint8_t hash[32];
 	size_t blob_len;
+	int64_t start_time;
 	int err;
 
 	if (buf == NULL || fdev == NULL) {
@@ -246,12 +467,24 @@ int fmfu_fdev_load(uint8_t *buf, size_t buf_len, const struct device *fdev,
 		return -EINVAL;
 	}
 
+	if (IS_ENABLED(CONFIG_FMFU_FDEV_PIPELINED)) {
+		/* Hash and write in a single pass over the flash device. */
+		return load_segments_pipelined(fdev, meta_buf, wrapper_len,
+					       (const struct Segments *)&segments,
+					       blob_offset, expected_hash, buf, buf_len);
+	}
+
+	start_time = k_uptime_get();
+
 	err = get_hash_from_flash(fdev, blob_offset, blob_len, hash, buf,
 				  buf_len);
 	if (err != 0) {
 		return err;
 	}
 
+	LOG_INF("FMFU timing: hash pass %u ms",
+		(uint32_t)(k_uptime_get() - start_time));
+
 	if (memcmp(expected_hash, hash, sizeof(hash)) == 0) {
 		hash_valid = true;
 	} else {
@@ -260,9 +493,16 @@ int fmfu_fdev_load(uint8_t *buf, size_t buf_len, const struct device *fdev,
 	}
 
 	if (hash_len_valid && hash_valid) {
-		return load_segments(fdev, meta_buf, wrapper_len,
-				     (const struct Segments *)&segments,
-				     blob_offset, buf, buf_len);
+		start_time = k_uptime_get();
+
+		err = load_segments(fdev, meta_buf, wrapper_len,
+				    (const struct Segments *)&segments,
+				    blob_offset, buf, buf_len);
+
+		LOG_INF("FMFU timing: write pass %u ms",
+			(uint32_t)(k_uptime_get() - start_time));
+
+		return err;
 	} else {
 		return -EINVAL;
 	}
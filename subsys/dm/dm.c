@@ -350,7 +350,8 @@ static void dm_start_ranging(void)
 	memcpy(&timeslot_ctx.curr_req, req, sizeof(timeslot_ctx.curr_req));
 	timeslot_queue_remove_first();
 
-	uint32_t distance = time_distance_get(timeslot_ctx.last_start, req->start_time);
+	uint32_t distance = time_distance_get(timeslot_ctx.last_start,
+					      timeslot_ctx.curr_req.start_time);
 
 	atomic_set(&timeslot_ctx.state, TIMESLOT_STATE_PENDING);
 	err = timeslot_request(TICKS_TO_US(distance));
@@ -445,6 +446,7 @@ static void dm_thread(void)
 				dm_start_ranging();
 				break;
 			case TIMESLOT_RESCHEDULE:
+				timeslot_queue_late_report(&timeslot_ctx.curr_req.dm_req.bt_addr);
 				atomic_set(&timeslot_ctx.state, TIMESLOT_STATE_IDLE);
 				dm_start_ranging();
 				break;
@@ -479,6 +481,15 @@ int dm_request_add(struct dm_request *req)
 	return err;
 }
 
+int dm_peer_stats_get(const bt_addr_le_t *bt_addr, struct dm_peer_stats *stats)
+{
+	if (!bt_addr || !stats) {
+		return -EINVAL;
+	}
+
+	return timeslot_queue_peer_stats_get(bt_addr, stats);
+}
+
 
 int dm_init(struct dm_init_param *init_param)
 {
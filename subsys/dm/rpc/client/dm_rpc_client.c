@@ -49,6 +49,49 @@ int dm_request_add(struct dm_request *req)
 	return res;
 }
 
+struct dm_peer_stats_rsp {
+	int result;
+	struct dm_peer_stats *stats;
+};
+
+static void dm_peer_stats_get_rsp(const struct nrf_rpc_group *group,
+				  struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	struct dm_peer_stats_rsp *rsp = handler_data;
+
+	rsp->result = ser_decode_int(ctx);
+	rsp->stats->scheduled = ser_decode_uint(ctx);
+	rsp->stats->dropped = ser_decode_uint(ctx);
+	rsp->stats->late = ser_decode_uint(ctx);
+	rsp->stats->queued = ser_decode_uint(ctx);
+
+	if (!zcbor_check_error(ctx->zs)) {
+		rsp->result = -EBADMSG;
+	}
+}
+
+int dm_peer_stats_get(const bt_addr_le_t *bt_addr, struct dm_peer_stats *stats)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct dm_peer_stats_rsp rsp = {
+		.stats = stats,
+	};
+	size_t buffer_size_max = 2 + sizeof(bt_addr_le_t);
+
+	if (!bt_addr || !stats) {
+		return -EINVAL;
+	}
+
+	NRF_RPC_CBOR_ALLOC(&dm_rpc_grp, ctx, buffer_size_max);
+
+	ser_encode_buffer(&ctx, bt_addr, sizeof(bt_addr_le_t));
+
+	nrf_rpc_cbor_cmd_no_err(&dm_rpc_grp, DM_PEER_STATS_GET_RPC_CMD, &ctx,
+				dm_peer_stats_get_rsp, &rsp);
+
+	return rsp.result;
+}
+
 int dm_init(struct dm_init_param *init_param)
 {
 	int result;
@@ -15,6 +15,7 @@ enum dm_rpc_cmd {
 	DM_INIT_RPC_CMD,
 	DM_REQUEST_ADD_RPC_CMD,
 	DM_END_PROCESS_RPC_CMD,
+	DM_PEER_STATS_GET_RPC_CMD,
 };
 
 /** @brief Data structure shared between cores.
@@ -72,6 +72,38 @@ static void dm_request_add_rpc_handler(const struct nrf_rpc_group *group,
 NRF_RPC_CBOR_CMD_DECODER(dm_rpc_grp, dm_request_add, DM_REQUEST_ADD_RPC_CMD,
 			 dm_request_add_rpc_handler, NULL);
 
+static void dm_peer_stats_get_rpc_handler(const struct nrf_rpc_group *group,
+					  struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	struct nrf_rpc_cbor_ctx rsp_ctx;
+	struct dm_peer_stats stats = {0};
+	bt_addr_le_t bt_addr;
+	size_t buffer_size_max = 5 * (1 + sizeof(uint32_t));
+	int result;
+
+	ser_decode_buffer(ctx, &bt_addr, sizeof(bt_addr_le_t));
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		report_decoding_error(DM_PEER_STATS_GET_RPC_CMD, handler_data);
+		return;
+	}
+
+	result = dm_peer_stats_get(&bt_addr, &stats);
+
+	NRF_RPC_CBOR_ALLOC(group, rsp_ctx, buffer_size_max);
+
+	ser_encode_int(&rsp_ctx, result);
+	ser_encode_uint(&rsp_ctx, stats.scheduled);
+	ser_encode_uint(&rsp_ctx, stats.dropped);
+	ser_encode_uint(&rsp_ctx, stats.late);
+	ser_encode_uint(&rsp_ctx, stats.queued);
+
+	nrf_rpc_cbor_rsp_no_err(group, &rsp_ctx);
+}
+
+NRF_RPC_CBOR_CMD_DECODER(dm_rpc_grp, dm_peer_stats_get, DM_PEER_STATS_GET_RPC_CMD,
+			 dm_peer_stats_get_rpc_handler, NULL);
+
 
 void *dm_rpc_get_buffer(size_t buffer_len)
 {
@@ -5,143 +5,286 @@
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
 #include "timeslot_queue.h"
 #include "time.h"
 
 #define TIMESLOT_QUEUE_LENGTH            CONFIG_DM_TIMESLOT_QUEUE_LENGTH
 #define TIMESLOT_QUEUE_COUNT_SAME_PEER   CONFIG_DM_TIMESLOT_QUEUE_COUNT_SAME_PEER
+#define PEER_COUNT_MAX                   CONFIG_DM_TIMESLOT_QUEUE_PEER_COUNT
+#define PEER_TABLE_SIZE                  (2 * PEER_COUNT_MAX)
 
 #define MIN_TIME_BETWEEN_TIMESLOTS_US    CONFIG_DM_MIN_TIME_BETWEEN_TIMESLOTS_US
 #define RANGING_OFFSET_US                CONFIG_DM_RANGING_OFFSET_US
 
-static K_MUTEX_DEFINE(list_mtx);
-static sys_slist_t timeslot_list = SYS_SLIST_STATIC_INIT(&timeslot_list);
-
-struct timeslot_entry {
-	struct timeslot_request timeslot_req;
-	sys_snode_t node;
+/* Every queued timeslot belongs to a tracked peer, so while the queue has room there is always
+ * a peer without queued timeslots to evict.
+ */
+BUILD_ASSERT(PEER_COUNT_MAX >= TIMESLOT_QUEUE_LENGTH,
+	     "Number of tracked peers must not be lower than the timeslot queue length");
+
+struct peer_entry {
+	bt_addr_le_t bt_addr;
+	uint8_t queued;
+	bool used;
+	struct dm_peer_stats stats;
 };
 
-static K_HEAP_DEFINE(heap, TIMESLOT_QUEUE_LENGTH * sizeof(struct timeslot_entry));
+static struct k_spinlock lock;
+
+/* Fixed-capacity ring of scheduled timeslots. */
+static struct timeslot_request timeslot_ring[TIMESLOT_QUEUE_LENGTH];
+static size_t ring_head;
+static size_t ring_count;
+
+/* Open-addressing (linear probing) table of peers, indexed by address hash. The table has twice
+ * as many entries as tracked peers, so it is never full and probe sequences stay short.
+ */
+static struct peer_entry peer_table[PEER_TABLE_SIZE];
+static size_t peer_count;
 
-static void list_lock(void)
+static uint32_t peer_hash(const bt_addr_le_t *addr)
 {
-	k_mutex_lock(&list_mtx, K_FOREVER);
+	/* FNV-1a over the address type and value. */
+	uint32_t hash = 2166136261u;
+	const uint8_t *data = (const uint8_t *)addr;
+
+	for (size_t i = 0; i < sizeof(*addr); i++) {
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+
+	return hash;
 }
 
-static void list_unlock(void)
+static size_t peer_home(const bt_addr_le_t *addr)
 {
-	k_mutex_unlock(&list_mtx);
+	return peer_hash(addr) % PEER_TABLE_SIZE;
 }
 
-static size_t get_list_size(void)
+static struct peer_entry *peer_find(const bt_addr_le_t *addr)
 {
-	size_t ret = 0;
-	sys_snode_t *node, *tmp;
+	size_t i = peer_home(addr);
 
-	SYS_SLIST_FOR_EACH_NODE_SAFE(&timeslot_list, node, tmp) {
-		ret++;
+	while (peer_table[i].used) {
+		if (bt_addr_le_cmp(&peer_table[i].bt_addr, addr) == 0) {
+			return &peer_table[i];
+		}
+
+		i = (i + 1) % PEER_TABLE_SIZE;
 	}
 
-	return ret;
+	return NULL;
 }
 
-static bool is_request_exist(struct dm_request *req)
+static void peer_remove(size_t i)
 {
-	uint8_t cnt = 0;
-	sys_snode_t *node, *tmp;
-	struct timeslot_entry *item;
-
-	SYS_SLIST_FOR_EACH_NODE_SAFE(&timeslot_list, node, tmp) {
-		item = CONTAINER_OF(node, struct timeslot_entry, node);
-		if (bt_addr_le_cmp(&item->timeslot_req.dm_req.bt_addr, &req->bt_addr) == 0) {
-			cnt++;
+	size_t j = i;
+
+	/* Shift back the following entries of the probe sequence, so that lookups do not stop
+	 * at the freed entry.
+	 */
+	while (true) {
+		size_t home;
+
+		j = (j + 1) % PEER_TABLE_SIZE;
+
+		if (!peer_table[j].used) {
+			break;
+		}
+
+		home = peer_home(&peer_table[j].bt_addr);
+
+		/* Skip entries whose home position lies cyclically in (i, j]. */
+		if ((i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j))) {
+			continue;
+		}
+
+		peer_table[i] = peer_table[j];
+		i = j;
+	}
+
+	peer_table[i].used = false;
+	peer_count--;
+}
+
+static bool peer_evict(void)
+{
+	/* Continue where the previous eviction stopped, so that peers are evicted in turns. */
+	static size_t next;
+
+	for (size_t n = 0; n < PEER_TABLE_SIZE; n++) {
+		size_t i = next;
+
+		next = (next + 1) % PEER_TABLE_SIZE;
+
+		if (peer_table[i].used && (peer_table[i].queued == 0)) {
+			peer_remove(i);
+			return true;
 		}
 	}
 
-	return cnt >= TIMESLOT_QUEUE_COUNT_SAME_PEER;
+	return false;
+}
+
+static struct peer_entry *peer_get(const bt_addr_le_t *addr)
+{
+	struct peer_entry *peer = peer_find(addr);
+	size_t i;
+
+	if (peer) {
+		return peer;
+	}
+
+	if ((peer_count >= PEER_COUNT_MAX) && !peer_evict()) {
+		return NULL;
+	}
+
+	i = peer_home(addr);
+	while (peer_table[i].used) {
+		i = (i + 1) % PEER_TABLE_SIZE;
+	}
+
+	peer = &peer_table[i];
+	memset(peer, 0, sizeof(*peer));
+	bt_addr_le_copy(&peer->bt_addr, addr);
+	peer->used = true;
+	peer_count++;
+
+	return peer;
+}
+
+static struct timeslot_request *ring_tail(void)
+{
+	return &timeslot_ring[(ring_head + ring_count - 1) % TIMESLOT_QUEUE_LENGTH];
 }
 
 int timeslot_queue_append(struct dm_request *req, uint32_t start_ref_tick,
 			  uint32_t window_len_us, uint32_t timeslot_len_us)
 {
+	int err = 0;
 	uint32_t distance;
 	uint32_t start_time;
 	uint32_t delay;
-	size_t list_size;
-	struct timeslot_entry *last, *item;
+	struct timeslot_request *last, *item;
+	struct peer_entry *peer;
+	k_spinlock_key_t key;
 
 	delay = req->start_delay_us + RANGING_OFFSET_US;
 	start_time = (start_ref_tick + US_TO_RTC_TICKS(delay)) % RTC_COUNTER_MAX;
 
-	list_size = get_list_size();
-	if (list_size >= TIMESLOT_QUEUE_LENGTH) {
-		return -ENOMEM;
+	key = k_spin_lock(&lock);
+
+	peer = peer_get(&req->bt_addr);
+	if (!peer) {
+		err = -ENOMEM;
+		goto out;
+	}
+
+	if (ring_count >= TIMESLOT_QUEUE_LENGTH) {
+		err = -ENOMEM;
+		goto drop;
 	}
 
-	if (list_size != 0) {
-		if (is_request_exist(req)) {
-			return -EAGAIN;
+	if (ring_count != 0) {
+		if (peer->queued >= TIMESLOT_QUEUE_COUNT_SAME_PEER) {
+			err = -EAGAIN;
+			goto drop;
 		}
 
-		list_lock();
-		last = SYS_SLIST_PEEK_TAIL_CONTAINER(&timeslot_list, last, node);
-		list_unlock();
+		last = ring_tail();
 
-		distance = time_distance_get(last->timeslot_req.start_time, start_time);
-		if (distance < US_TO_RTC_TICKS(last->timeslot_req.timeslot_length_us +
+		distance = time_distance_get(last->start_time, start_time);
+		if (distance < US_TO_RTC_TICKS(last->timeslot_length_us +
 					       MIN_TIME_BETWEEN_TIMESLOTS_US)) {
-			return -EBUSY;
+			err = -EBUSY;
+			goto drop;
 		}
 	}
 
-	item = k_heap_alloc(&heap, sizeof(struct timeslot_entry), K_NO_WAIT);
-	if (!item) {
-		return -ENOMEM;
-	}
+	ring_count++;
+	item = ring_tail();
 
-	item->timeslot_req.start_time = start_time;
-	item->timeslot_req.timeslot_length_us = timeslot_len_us;
-	item->timeslot_req.window_length_us = window_len_us;
+	item->start_time = start_time;
+	item->timeslot_length_us = timeslot_len_us;
+	item->window_length_us = window_len_us;
 	req->rng_seed++;
 
-	memcpy(&item->timeslot_req.dm_req, req, sizeof(item->timeslot_req.dm_req));
+	memcpy(&item->dm_req, req, sizeof(item->dm_req));
 
-	list_lock();
-	sys_slist_append(&timeslot_list, &item->node);
-	list_unlock();
+	peer->queued++;
+	peer->stats.scheduled++;
+	goto out;
 
-	return 0;
+drop:
+	peer->stats.dropped++;
+out:
+	k_spin_unlock(&lock, key);
+
+	return err;
 }
 
 struct timeslot_request *timeslot_queue_peek(void)
 {
-	struct timeslot_entry *item;
-
-	list_lock();
-	item = SYS_SLIST_PEEK_HEAD_CONTAINER(&timeslot_list, item, node);
-	list_unlock();
+	struct timeslot_request *req = NULL;
+	k_spinlock_key_t key;
 
-	if (!item) {
-		return NULL;
+	key = k_spin_lock(&lock);
+	if (ring_count != 0) {
+		req = &timeslot_ring[ring_head];
 	}
+	k_spin_unlock(&lock, key);
 
-	return &item->timeslot_req;
+	return req;
 }
 
 void timeslot_queue_remove_first(void)
 {
-	sys_snode_t *node;
-	struct timeslot_entry *item;
+	struct timeslot_request *item;
+	struct peer_entry *peer;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&lock);
+	if (ring_count != 0) {
+		item = &timeslot_ring[ring_head];
+		peer = peer_find(&item->dm_req.bt_addr);
+		if (peer) {
+			peer->queued--;
+		}
+
+		ring_head = (ring_head + 1) % TIMESLOT_QUEUE_LENGTH;
+		ring_count--;
+	}
+	k_spin_unlock(&lock, key);
+}
+
+void timeslot_queue_late_report(const bt_addr_le_t *bt_addr)
+{
+	struct peer_entry *peer;
+	k_spinlock_key_t key;
 
-	list_lock();
-	node = sys_slist_get(&timeslot_list);
-	list_unlock();
+	key = k_spin_lock(&lock);
+	peer = peer_find(bt_addr);
+	if (peer) {
+		peer->stats.late++;
+	}
+	k_spin_unlock(&lock, key);
+}
 
-	if (!node) {
-		return;
+int timeslot_queue_peer_stats_get(const bt_addr_le_t *bt_addr, struct dm_peer_stats *stats)
+{
+	int err = 0;
+	struct peer_entry *peer;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&lock);
+	peer = peer_find(bt_addr);
+	if (peer) {
+		*stats = peer->stats;
+		stats->queued = peer->queued;
+	} else {
+		err = -ENOENT;
 	}
+	k_spin_unlock(&lock, key);
 
-	item = CONTAINER_OF(node, struct timeslot_entry, node);
-	k_heap_free(&heap, item);
+	return err;
 }
@@ -36,7 +36,7 @@ struct timeslot_request {
  *  @param window_len Ranging window length.
  *  @param timeslot_len Timeslot length.
  *
- *  @retval -ENOMEM when the tiemslot queue is full or a memory allocation error.
+ *  @retval -ENOMEM when the timeslot queue or the peer table is full.
  *  @retval -EAGAIN when a single peer has a maximum number of timeslots scheduled.
  *  @retval -EBUSY when the timeslot cannot be scheduled due to time restrictions.
  */
@@ -57,6 +57,22 @@ struct timeslot_request *timeslot_queue_peek(void);
  */
 void timeslot_queue_remove_first(void);
 
+/** @brief Record that a timeslot for the given peer was blocked or cancelled.
+ *
+ *  @param bt_addr Address of the peer.
+ */
+void timeslot_queue_late_report(const bt_addr_le_t *bt_addr);
+
+/** @brief Get the scheduling statistics of a peer.
+ *
+ *  @param bt_addr Address of the peer.
+ *  @param stats Structure to fill with the statistics.
+ *
+ *  @retval 0 if the statistics were found.
+ *  @retval -ENOENT when the peer is not tracked.
+ */
+int timeslot_queue_peer_stats_get(const bt_addr_le_t *bt_addr, struct dm_peer_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
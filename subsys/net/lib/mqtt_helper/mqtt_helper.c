@@ -257,6 +257,32 @@ static void send_ack(struct mqtt_client *const mqtt_client, uint16_t message_id)
 	LOG_DBG("PUBACK sent for message ID %d", message_id);
 }
 
+static int publish_stream_payload(struct mqtt_client *const mqtt_client,
+				  struct mqtt_helper_buf topic,
+				  size_t length)
+{
+	int err;
+	size_t offset = 0;
+	struct mqtt_helper_buf chunk = {
+		.ptr = payload_buf,
+	};
+
+	do {
+		chunk.size = MIN(length - offset, sizeof(payload_buf));
+
+		err = mqtt_readall_publish_payload(mqtt_client, payload_buf, chunk.size);
+		if (err) {
+			return err;
+		}
+
+		current_cfg.cb.on_publish_chunk(topic, chunk, offset, length);
+
+		offset += chunk.size;
+	} while (offset < length);
+
+	return 0;
+}
+
 MQTT_HELPER_STATIC void on_publish(const struct mqtt_evt *mqtt_evt)
 {
 	int err;
@@ -269,6 +295,25 @@ MQTT_HELPER_STATIC void on_publish(const struct mqtt_evt *mqtt_evt)
 		.ptr = payload_buf,
 	};
 
+	if (current_cfg.cb.on_publish_chunk) {
+		err = publish_stream_payload(&mqtt_client, topic, p->message.payload.len);
+		if (err) {
+			LOG_ERR("publish_stream_payload, error: %d", err);
+
+			if (current_cfg.cb.on_error) {
+				current_cfg.cb.on_error(MQTT_HELPER_ERROR_PAYLOAD_READ);
+			}
+
+			return;
+		}
+
+		if (p->message.topic.qos == MQTT_QOS_1_AT_LEAST_ONCE) {
+			send_ack(&mqtt_client, p->message_id);
+		}
+
+		return;
+	}
+
 	err = publish_get_payload(&mqtt_client, p->message.payload.len);
 	if (err) {
 		LOG_ERR("publish_get_payload, error: %d", err);
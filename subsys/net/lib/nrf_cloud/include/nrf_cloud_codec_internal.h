@@ -50,6 +50,9 @@ enum nrf_cloud_rcv_topic {
 /** Format identifier for remainder of this binary blob */
 #define NRF_CLOUD_DICT_LOG_FMT 0x0001
 
+/** Format identifier for compact dictionary-based logs, see nrf_cloud_log_dict_compact.c */
+#define NRF_CLOUD_DICT_LOG_COMPACT_FMT 0x0002
+
 /** @brief Header preceding binary blobs so nRF Cloud can
  *  process them in correct order using ts_ms and sequence fields.
  */
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_LOG_DICT_COMPACT_H_
+#define NRF_CLOUD_LOG_DICT_COMPACT_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_msg.h>
+#include "nrf_cloud_codec_internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum size of the header preceding a batch of compact log records. */
+#define NRF_CLOUD_LOG_DICT_COMPACT_HDR_SIZE_MAX (sizeof(struct nrf_cloud_bin_hdr) + 10)
+
+/** @brief Encode the header of a batch of compact dictionary log records.
+ *
+ * @param ts The time at which the first log entry of the batch was generated.
+ * @param sequence Sequence number of the first log entry of the batch.
+ * @param ts_base Log timestamp that the first record of the batch is relative to.
+ * @param buf Output buffer, at least NRF_CLOUD_LOG_DICT_COMPACT_HDR_SIZE_MAX bytes long.
+ *
+ * @return Number of bytes written to the buffer.
+ */
+size_t nrf_cloud_log_dict_compact_hdr_encode(int64_t ts, uint32_t sequence, uint64_t ts_base,
+					     uint8_t *buf);
+
+/** @brief Encode a log message as a compact dictionary log record.
+ *
+ * @param msg Log message.
+ * @param src_id ID of the log source.
+ * @param ts_prev Log timestamp of the previous record stored in the same batch.
+ * @param buf Output buffer.
+ * @param size Size of the output buffer.
+ *
+ * @retval Number of bytes written to the buffer.
+ * @retval -ENOMEM if the record does not fit in the buffer.
+ */
+int nrf_cloud_log_dict_compact_encode(struct log_msg *msg, uint32_t src_id, uint64_t ts_prev,
+				      uint8_t *buf, size_t size);
+
+/** @brief Encode a compact dictionary log record reporting dropped log messages.
+ *
+ * @param cnt Number of dropped log messages.
+ * @param buf Output buffer.
+ * @param size Size of the output buffer.
+ *
+ * @retval Number of bytes written to the buffer.
+ * @retval -ENOMEM if the record does not fit in the buffer.
+ */
+int nrf_cloud_log_dict_compact_dropped_encode(uint32_t cnt, uint8_t *buf, size_t size);
+
+/** @brief Get the size of a log message in the Zephyr dictionary-based log format.
+ *
+ * @param msg Log message.
+ *
+ * @return Size in bytes.
+ */
+size_t nrf_cloud_log_dict_size_get(struct log_msg *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_LOG_DICT_COMPACT_H_ */
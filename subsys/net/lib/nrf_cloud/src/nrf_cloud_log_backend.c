@@ -18,6 +18,7 @@
 #include "nrf_cloud_codec_internal.h"
 #include "nrf_cloud_transport.h"
 #include "nrf_cloud_log_internal.h"
+#include "nrf_cloud_log_dict_compact.h"
 #include <net/nrf_cloud_rest.h>
 #include <net/nrf_cloud_log.h>
 
@@ -62,6 +63,8 @@ static struct nrf_cloud_log_stats {
 	uint32_t bytes_sent;
 	/** Total number of bytes (before TLS) sent */
 	uint32_t lines_dropped;
+	/** Total number of bytes the compact records take in the Zephyr dictionary format */
+	uint32_t bytes_dict;
 } stats;
 
 /* Information about a log message is stored in the log_context by the logger_process backend
@@ -76,6 +79,12 @@ static int num_msgs;
 static struct nrf_cloud_rest_context *rest_ctx;
 static char device_id[NRF_CLOUD_CLIENT_ID_MAX_LEN];
 
+/* Log timestamp of the last encoded compact record, and the timestamp that the first record
+ * of the current batch is relative to.
+ */
+static uint64_t compact_ts_prev;
+static uint64_t compact_ts_base;
+
 /* Define array of log source names that could generate new log messages as a side effect
  * of sending other log messages to the cloud. We should filter out these log sources
  * to prevent such an unwanted outcome. Otherwise cloud logs never cease.
@@ -116,6 +125,7 @@ LOG_OUTPUT_DEFINE(log_nrf_cloud_output, logger_out, log_buf, (sizeof(log_buf) -
 RING_BUF_DECLARE(log_nrf_cloud_rb, RING_BUF_SIZE);
 
 static int send_ring_buffer(void);
+static int logger_store(uint8_t *buf, size_t size);
 
 static void logger_init(const struct log_backend *const backend)
 {
@@ -218,6 +228,26 @@ static int log_msg_filter(uint32_t src_id, int level)
 	return 0;
 }
 
+static void compact_process(struct log_msg *msg, uint32_t src_id)
+{
+	int len;
+
+	len = nrf_cloud_log_dict_compact_encode(msg, src_id, compact_ts_prev,
+						log_buf, CONFIG_NRF_CLOUD_LOG_BUF_SIZE);
+	if (len < 0) {
+		stats.lines_dropped++;
+		return;
+	}
+
+	compact_ts_base = compact_ts_prev;
+	stats.bytes_dict += nrf_cloud_log_dict_size_get(msg);
+
+	/* The next record is relative to this one only if this one reaches the cloud. */
+	if (logger_store(log_buf, len) == 0) {
+		compact_ts_prev = log_msg_get_timestamp(msg);
+	}
+}
+
 static void logger_process(const struct log_backend *const backend, union log_msg_generic *msg)
 {
 	log_format_func_t log_output_func;
@@ -242,15 +272,35 @@ static void logger_process(const struct log_backend *const backend, union log_ms
 
 	logs_init_context(rest_ctx, device_id, level, src_id, src_name, dom_id, ts, &log_context);
 
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_LOG_DICT_COMPACT) &&
+	    (log_format_current == LOG_OUTPUT_DICT)) {
+		compact_process(&msg->log, src_id);
+		return;
+	}
+
 	log_output_func = log_format_func_t_get(log_format_current);
 	log_output_func(&log_nrf_cloud_output, &msg->log, log_output_flags);
 }
 
 static void logger_dropped(const struct log_backend *const backend, uint32_t cnt)
 {
-	if (backend == &log_nrf_cloud_backend) {
+	if (backend != &log_nrf_cloud_backend) {
+		return;
+	}
+
+	stats.lines_dropped += cnt;
+
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_LOG_DICT_COMPACT) &&
+	    (log_format_current == LOG_OUTPUT_DICT)) {
+		int len = nrf_cloud_log_dict_compact_dropped_encode(cnt, log_buf,
+								    CONFIG_NRF_CLOUD_LOG_BUF_SIZE);
+
+		if (len > 0) {
+			compact_ts_base = compact_ts_prev;
+			logger_out(log_buf, len, NULL);
+		}
+	} else {
 		log_output_dropped_process(&log_nrf_cloud_output, cnt);
-		stats.lines_dropped += cnt;
 	}
 }
 
@@ -320,6 +370,11 @@ static void logger_notify(const struct log_backend *const backend, enum log_back
 			stats.lines_rendered, stats.bytes_rendered,
 			stats.lines_sent, stats.bytes_sent,
 			stats.lines_dropped);
+		if (IS_ENABLED(CONFIG_NRF_CLOUD_LOG_DICT_COMPACT) && stats.bytes_dict) {
+			LOG_DBG("Compact bytes:%u, dictionary bytes:%u, reduction:%u%%",
+				stats.bytes_rendered, stats.bytes_dict,
+				100 - (uint32_t)(100ULL * stats.bytes_rendered / stats.bytes_dict));
+		}
 	} else {
 		LOG_INF("Sent lines:%u, bytes:%u", stats.lines_sent, stats.bytes_sent);
 	}
@@ -409,12 +464,11 @@ cleanup:
 	return err;
 }
 
-static int logger_out(uint8_t *buf, size_t size, void *ctx)
+/* Encode the rendered log and store it in the ring buffer, sending the buffer when it is full. */
+static int logger_store(uint8_t *buf, size_t size)
 {
-	ARG_UNUSED(ctx);
 	int err = 0;
 	struct nrf_cloud_data data;
-	size_t orig_size = size;
 	uint32_t stored;
 	int extra;
 	static int retry_count;
@@ -425,7 +479,7 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 
 	if (k_sem_take(&ncl_active, K_NO_WAIT) < 0) {
 		printk("logger_out: BUSY\n");
-		return 0;
+		return -EBUSY;
 	}
 
 	if (log_format_current == LOG_OUTPUT_TEXT) {
@@ -438,7 +492,8 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 			printk("buf %p..%p is not inside our log_buf %p..%p\n",
 				buf, &buf[size], log_buf,
 				&log_buf[CONFIG_NRF_CLOUD_LOG_BUF_SIZE]);
-			return orig_size;
+			err = -EINVAL;
+			goto end;
 		}
 
 		extra = 3;
@@ -462,7 +517,8 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 			goto end;
 		}
 	} else {
-		extra = sizeof(struct nrf_cloud_bin_hdr);
+		extra = IS_ENABLED(CONFIG_NRF_CLOUD_LOG_DICT_COMPACT) ?
+			NRF_CLOUD_LOG_DICT_COMPACT_HDR_SIZE_MAX : sizeof(struct nrf_cloud_bin_hdr);
 		data.ptr = buf;
 		data.len = size;
 	}
@@ -483,6 +539,14 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 				if (log_format_current == LOG_OUTPUT_TEXT) {
 					/* Open JSON array */
 					ring_buf_put(&log_nrf_cloud_rb, "[", 1);
+				} else if (IS_ENABLED(CONFIG_NRF_CLOUD_LOG_DICT_COMPACT)) {
+					uint8_t hdr[NRF_CLOUD_LOG_DICT_COMPACT_HDR_SIZE_MAX];
+					size_t len;
+
+					len = nrf_cloud_log_dict_compact_hdr_encode(
+						log_context.ts, log_context.sequence,
+						compact_ts_base, hdr);
+					ring_buf_put(&log_nrf_cloud_rb, hdr, len);
 				} else {
 					struct nrf_cloud_bin_hdr hdr;
 
@@ -529,9 +593,18 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 		LOG_ERR("Error sending log: %d", err);
 	}
 end:
+	k_sem_give(&ncl_active);
+	return err;
+}
+
+static int logger_out(uint8_t *buf, size_t size, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	(void)logger_store(buf, size);
+
 	/* Return original size of log buffer. Otherwise, logger_out will be called
 	 * again with the remainder until the full size is sent.
 	 */
-	k_sem_give(&ncl_active);
-	return orig_size;
+	return size;
 }
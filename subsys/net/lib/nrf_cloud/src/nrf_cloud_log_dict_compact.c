@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_msg.h>
+#include <zephyr/logging/log_output_dict.h>
+#include <zephyr/sys/byteorder.h>
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_log_dict_compact.h"
+
+/* Compact records carry the same information as the Zephyr dictionary-based log records, so
+ * scripts/nrf_cloud_log/dict_compact_expand.py can convert them back for the Zephyr parser.
+ * Each record is laid out as follows, with all integers encoded as LEB128 varints:
+ *
+ *  tag        level in bits 0-2, domain in bits 3-6, bit 7 set if hexdump data follows.
+ *             A level of COMPACT_TAG_DROPPED marks a dropped messages record, which only
+ *             contains the number of dropped messages.
+ *  source     Log source ID.
+ *  ts_delta   Zigzag encoded difference to the timestamp of the previous record.
+ *  words      Package length in 32-bit words, shifted left by one. Bit 0 is set if the
+ *             package has a descriptor with string counts and a tail.
+ *  [counts]   Three bytes, the string counts of the package descriptor.
+ *  [tail_len] Number of package bytes following the words.
+ *  args       Zigzag encoded 32-bit words of the package, except the descriptor.
+ *  [tail]     Package bytes following the words, such as appended strings.
+ *  [data_len] Hexdump length, followed by the data.
+ */
+#define COMPACT_TAG_LEVEL_MASK	BIT_MASK(3)
+#define COMPACT_TAG_DOMAIN_POS	3
+#define COMPACT_TAG_DOMAIN_MASK	BIT_MASK(4)
+#define COMPACT_TAG_DATA	BIT(7)
+#define COMPACT_TAG_DROPPED	COMPACT_TAG_LEVEL_MASK
+
+#define VARINT_SIZE_MAX		10
+#define PACKAGE_WORD_SIZE	sizeof(uint32_t)
+
+struct compact_buf {
+	uint8_t *data;
+	size_t size;
+	size_t len;
+	bool overflow;
+};
+
+static void put_u8(struct compact_buf *buf, uint8_t value)
+{
+	if (buf->len >= buf->size) {
+		buf->overflow = true;
+		return;
+	}
+
+	buf->data[buf->len++] = value;
+}
+
+static void put_varint(struct compact_buf *buf, uint64_t value)
+{
+	do {
+		uint8_t byte = value & BIT_MASK(7);
+
+		value >>= 7;
+		put_u8(buf, (value != 0) ? (byte | BIT(7)) : byte);
+	} while (value != 0);
+}
+
+static void put_bytes(struct compact_buf *buf, const uint8_t *data, size_t len)
+{
+	if ((buf->size - buf->len) < len) {
+		buf->overflow = true;
+		return;
+	}
+
+	memcpy(&buf->data[buf->len], data, len);
+	buf->len += len;
+}
+
+static uint64_t zigzag(int64_t value)
+{
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+size_t nrf_cloud_log_dict_compact_hdr_encode(int64_t ts, uint32_t sequence, uint64_t ts_base,
+					     uint8_t *buf)
+{
+	struct compact_buf out = {
+		.data = buf,
+		.size = NRF_CLOUD_LOG_DICT_COMPACT_HDR_SIZE_MAX,
+	};
+	struct nrf_cloud_bin_hdr hdr = {
+		.magic = NRF_CLOUD_BINARY_MAGIC,
+		.format = NRF_CLOUD_DICT_LOG_COMPACT_FMT,
+		.ts = ts,
+		.sequence = sequence,
+	};
+
+	put_bytes(&out, (const uint8_t *)&hdr, sizeof(hdr));
+	put_varint(&out, ts_base);
+
+	return out.len;
+}
+
+int nrf_cloud_log_dict_compact_encode(struct log_msg *msg, uint32_t src_id, uint64_t ts_prev,
+				      uint8_t *buf, size_t size)
+{
+	struct compact_buf out = {
+		.data = buf,
+		.size = size,
+	};
+	size_t package_len;
+	size_t data_len;
+	uint8_t *package = log_msg_get_package(msg, &package_len);
+	uint8_t *data = log_msg_get_data(msg, &data_len);
+	uint64_t ts = log_msg_get_timestamp(msg);
+	size_t words = 0;
+	size_t tail_len = 0;
+	bool tail = false;
+	uint8_t tag;
+
+	if (package_len >= PACKAGE_WORD_SIZE) {
+		words = MIN(package[0], package_len / PACKAGE_WORD_SIZE);
+		tail_len = package_len - (words * PACKAGE_WORD_SIZE);
+		tail = (tail_len != 0) || (package[1] != 0) || (package[2] != 0) ||
+		       (package[3] != 0);
+	}
+
+	tag = (log_msg_get_level(msg) & COMPACT_TAG_LEVEL_MASK) |
+	      ((log_msg_get_domain(msg) & COMPACT_TAG_DOMAIN_MASK) << COMPACT_TAG_DOMAIN_POS) |
+	      ((data_len != 0) ? COMPACT_TAG_DATA : 0);
+
+	put_u8(&out, tag);
+	put_varint(&out, src_id);
+	put_varint(&out, zigzag((int64_t)(ts - ts_prev)));
+	put_varint(&out, (words << 1) | (tail ? 1 : 0));
+
+	if (tail) {
+		put_bytes(&out, &package[1], 3);
+		put_varint(&out, tail_len);
+	}
+
+	/* Argument values are mostly small integers, so they shrink considerably. */
+	for (size_t i = 1; i < words; i++) {
+		put_varint(&out, zigzag((int32_t)sys_get_le32(&package[i * PACKAGE_WORD_SIZE])));
+	}
+
+	if (tail) {
+		put_bytes(&out, &package[words * PACKAGE_WORD_SIZE], tail_len);
+	}
+
+	if (data_len != 0) {
+		put_varint(&out, data_len);
+		put_bytes(&out, data, data_len);
+	}
+
+	return out.overflow ? -ENOMEM : out.len;
+}
+
+int nrf_cloud_log_dict_compact_dropped_encode(uint32_t cnt, uint8_t *buf, size_t size)
+{
+	struct compact_buf out = {
+		.data = buf,
+		.size = size,
+	};
+
+	put_u8(&out, COMPACT_TAG_DROPPED);
+	put_varint(&out, cnt);
+
+	return out.overflow ? -ENOMEM : out.len;
+}
+
+size_t nrf_cloud_log_dict_size_get(struct log_msg *msg)
+{
+	size_t package_len;
+	size_t data_len;
+
+	(void)log_msg_get_package(msg, &package_len);
+	(void)log_msg_get_data(msg, &data_len);
+
+	return sizeof(struct log_dict_output_normal_msg_hdr_t) + package_len + data_len;
+}
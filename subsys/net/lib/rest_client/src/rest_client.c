@@ -30,6 +30,204 @@ LOG_MODULE_REGISTER(rest_client, CONFIG_REST_CLIENT_LOG_LEVEL);
 
 #define HTTP_PROTOCOL "HTTP/1.1"
 
+/* SYN, SYN-ACK, ACK and the FIN exchange, with 40 bytes of IPv4 and TCP headers each. */
+#define REST_CLIENT_TCP_HANDSHAKE_BYTES (7 * 40)
+
+static struct rest_client_conn_stats conn_stats;
+static struct k_spinlock conn_stats_lock;
+
+/* Requests may run in several threads at once. */
+static void conn_stats_add(uint32_t *counter, uint32_t value)
+{
+	k_spinlock_key_t key = k_spin_lock(&conn_stats_lock);
+
+	*counter += value;
+
+	k_spin_unlock(&conn_stats_lock, key);
+}
+
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+#define REST_CLIENT_CONN_POOL_HOST_LEN 64
+#define REST_CLIENT_CONN_POOL_IDLE_TIMEOUT_MS (CONFIG_REST_CLIENT_CONN_POOL_IDLE_TIMEOUT * \
+					       MSEC_PER_SEC)
+
+struct rest_client_pool_conn {
+	/** Socket of the connection, or REST_CLIENT_SCKT_CONNECT if the slot is free. */
+	int fd;
+	/** The connection is used by an ongoing request. */
+	bool in_use;
+	char host[REST_CLIENT_CONN_POOL_HOST_LEN];
+	uint16_t port;
+	int sec_tag;
+	int tls_peer_verify;
+	int64_t last_used;
+};
+
+static struct rest_client_pool_conn conn_pool[CONFIG_REST_CLIENT_CONN_POOL_SIZE] = {
+	[0 ... (CONFIG_REST_CLIENT_CONN_POOL_SIZE - 1)] = {
+		.fd = REST_CLIENT_SCKT_CONNECT,
+	},
+};
+static K_MUTEX_DEFINE(conn_pool_mutex);
+
+static void conn_pool_idle_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(conn_pool_idle_work, conn_pool_idle_work_fn);
+
+static void conn_pool_close(struct rest_client_pool_conn *conn)
+{
+	if (close(conn->fd)) {
+		LOG_WRN("Failed to close socket, error: %d", errno);
+	}
+	conn->fd = REST_CLIENT_SCKT_CONNECT;
+	conn->in_use = false;
+}
+
+static void conn_pool_idle_work_fn(struct k_work *work)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		struct rest_client_pool_conn *conn = &conn_pool[i];
+
+		if (conn->fd == REST_CLIENT_SCKT_CONNECT || conn->in_use) {
+			continue;
+		}
+		if (now - conn->last_used >= REST_CLIENT_CONN_POOL_IDLE_TIMEOUT_MS) {
+			LOG_DBG("Closing idle connection to %s, socket %d", conn->host, conn->fd);
+			conn_pool_close(conn);
+			conn_stats_add(&conn_stats.idle_closed, 1);
+		} else {
+			next = MIN(next, conn->last_used + REST_CLIENT_CONN_POOL_IDLE_TIMEOUT_MS);
+		}
+	}
+	k_mutex_unlock(&conn_pool_mutex);
+
+	if (next != INT64_MAX) {
+		k_work_reschedule(&conn_pool_idle_work, K_MSEC(next - now));
+	}
+}
+
+static bool conn_pool_match(const struct rest_client_pool_conn *conn,
+			    const struct rest_client_req_context *req_ctx)
+{
+	return conn->port == req_ctx->port &&
+	       conn->sec_tag == req_ctx->sec_tag &&
+	       conn->tls_peer_verify == req_ctx->tls_peer_verify &&
+	       strcmp(conn->host, req_ctx->host) == 0;
+}
+
+/* Reserve a pool slot for the request. If an idle connection to the same peer exists,
+ * its socket is assigned to connect_socket. Returns NULL if the request cannot be pooled.
+ */
+static struct rest_client_pool_conn *conn_pool_acquire(
+	struct rest_client_req_context *const req_ctx)
+{
+	struct rest_client_pool_conn *conn = NULL;
+	struct rest_client_pool_conn *free_conn = NULL;
+	struct rest_client_pool_conn *lru_conn = NULL;
+
+	if (strlen(req_ctx->host) >= REST_CLIENT_CONN_POOL_HOST_LEN) {
+		return NULL;
+	}
+
+	k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		struct rest_client_pool_conn *entry = &conn_pool[i];
+
+		if (entry->fd == REST_CLIENT_SCKT_CONNECT) {
+			if (!entry->in_use && !free_conn) {
+				free_conn = entry;
+			}
+			continue;
+		}
+		if (entry->in_use) {
+			continue;
+		}
+		if (conn_pool_match(entry, req_ctx)) {
+			conn = entry;
+			break;
+		}
+		if (!lru_conn || entry->last_used < lru_conn->last_used) {
+			lru_conn = entry;
+		}
+	}
+
+	if (conn) {
+		req_ctx->connect_socket = conn->fd;
+	} else if (free_conn) {
+		conn = free_conn;
+	} else if (lru_conn) {
+		/* Make room by closing the least recently used idle connection. */
+		LOG_DBG("Evicting idle connection to %s", lru_conn->host);
+		conn_pool_close(lru_conn);
+		conn = lru_conn;
+	}
+
+	if (conn) {
+		conn->in_use = true;
+		strcpy(conn->host, req_ctx->host);
+		conn->port = req_ctx->port;
+		conn->sec_tag = req_ctx->sec_tag;
+		conn->tls_peer_verify = req_ctx->tls_peer_verify;
+	}
+	k_mutex_unlock(&conn_pool_mutex);
+
+	return conn;
+}
+
+/* A request that failed on a reused connection may already have been processed by the server,
+ * so it is only sent again if repeating it has no additional effect. A timeout means that the
+ * server is slow rather than that the connection was closed, so it is not retried either.
+ */
+static bool rest_client_retry_allowed(const struct rest_client_req_context *req_ctx, int err)
+{
+	if (err == -ETIMEDOUT || err == -EAGAIN) {
+		return false;
+	}
+
+	switch (req_ctx->http_method) {
+	case HTTP_GET:
+	case HTTP_HEAD:
+	case HTTP_PUT:
+	case HTTP_DELETE:
+	case HTTP_OPTIONS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Return the connection of the request to the pool, or close it if it cannot be reused. */
+static void conn_pool_release(struct rest_client_pool_conn *conn,
+			      struct rest_client_req_context *const req_ctx,
+			      bool reusable)
+{
+	k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+	conn->fd = req_ctx->connect_socket;
+	if (conn->fd == REST_CLIENT_SCKT_CONNECT) {
+		conn->in_use = false;
+	} else if (reusable) {
+		conn->in_use = false;
+		conn->last_used = k_uptime_get();
+		LOG_DBG("Socket %d returned to the connection pool", conn->fd);
+	} else {
+		conn_pool_close(conn);
+	}
+	k_mutex_unlock(&conn_pool_mutex);
+
+	/* The socket is owned by the pool now. */
+	req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+
+	if (reusable && !k_work_delayable_is_pending(&conn_pool_idle_work)) {
+		k_work_schedule(&conn_pool_idle_work, K_MSEC(REST_CLIENT_CONN_POOL_IDLE_TIMEOUT_MS));
+	}
+}
+#endif /* CONFIG_REST_CLIENT_CONN_POOL */
+
 static void rest_client_http_response_cb(struct http_response *rsp,
 					  enum http_final_call final_data,
 					  void *user_data)
@@ -308,6 +506,13 @@ static int rest_client_do_api_call(struct http_request *http_req,
 		if (err) {
 			return err;
 		}
+		conn_stats_add(&conn_stats.connects, 1);
+	} else {
+		/* Timeouts of a reused socket are left from its previous request. */
+		err = rest_client_sckt_timeouts_set(req_ctx->connect_socket, req_ctx->timeout_ms);
+		if (err) {
+			return -EINVAL;
+		}
 	}
 
 	/* Assign the user provided receive buffer into the http request */
@@ -366,6 +571,10 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 
 	struct http_request http_req;
 	int ret;
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	struct rest_client_pool_conn *conn = NULL;
+	bool reused = false;
+#endif
 
 	rest_client_init_request(req_ctx, &http_req);
 
@@ -388,7 +597,42 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 		}
 	}
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	/* Pool the connection unless the caller manages it. */
+	if (req_ctx->connect_socket == REST_CLIENT_SCKT_CONNECT && !req_ctx->keep_alive) {
+		conn = conn_pool_acquire(req_ctx);
+		reused = (req_ctx->connect_socket != REST_CLIENT_SCKT_CONNECT);
+	}
+#endif
+
 	ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	if (ret && reused && resp_ctx->total_response_len == 0 &&
+	    rest_client_retry_allowed(req_ctx, ret)) {
+		/* The server may have closed the idle connection, retry with a new one. */
+		LOG_DBG("Pooled socket %d failed, err %d, reconnecting",
+			req_ctx->connect_socket, ret);
+		(void)close(req_ctx->connect_socket);
+		req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+		reused = false;
+		conn_stats_add(&conn_stats.stale_retries, 1);
+
+		ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+	}
+	if (reused && !ret) {
+		conn_stats_add(&conn_stats.reuses, 1);
+		conn_stats_add(&conn_stats.bytes_saved,
+			       (req_ctx->sec_tag == REST_CLIENT_SEC_TAG_NO_SEC) ?
+			       REST_CLIENT_TCP_HANDSHAKE_BYTES :
+			       CONFIG_REST_CLIENT_CONN_POOL_TLS_HANDSHAKE_BYTES);
+	}
+	if (conn) {
+		conn_pool_release(conn, req_ctx,
+				  !ret && http_should_keep_alive(&http_req.internal.parser));
+	}
+#endif
+
 	if (ret) {
 		LOG_ERR("rest_client_do_api_call() failed, err %d", ret);
 		goto clean_up;
@@ -413,3 +657,68 @@ clean_up:
 	}
 	return ret;
 }
+
+int rest_client_requests(struct rest_client_req_context *req_ctxs,
+			 struct rest_client_resp_context *resp_ctxs,
+			 size_t count)
+{
+	__ASSERT_NO_MSG(req_ctxs != NULL);
+	__ASSERT_NO_MSG(resp_ctxs != NULL);
+
+	int ret = 0;
+	int sock = REST_CLIENT_SCKT_CONNECT;
+
+	for (size_t i = 0; i < count; i++) {
+		struct rest_client_req_context *req_ctx = &req_ctxs[i];
+
+		if (!IS_ENABLED(CONFIG_REST_CLIENT_CONN_POOL)) {
+			/* Pass the connection on to the next request to the same peer. */
+			const struct rest_client_req_context *next = (i + 1 < count) ?
+				&req_ctxs[i + 1] : NULL;
+
+			req_ctx->connect_socket = sock;
+			req_ctx->keep_alive = next &&
+					      next->port == req_ctx->port &&
+					      next->sec_tag == req_ctx->sec_tag &&
+					      next->tls_peer_verify == req_ctx->tls_peer_verify &&
+					      strcmp(next->host, req_ctx->host) == 0;
+		}
+
+		ret = rest_client_request(req_ctx, &resp_ctxs[i]);
+		sock = req_ctx->keep_alive ? req_ctx->connect_socket : REST_CLIENT_SCKT_CONNECT;
+		if (ret) {
+			LOG_ERR("Request %d of %d failed, err %d", i + 1, count, ret);
+			break;
+		}
+	}
+
+	if (sock != REST_CLIENT_SCKT_CONNECT) {
+		(void)close(sock);
+	}
+
+	return ret;
+}
+
+void rest_client_conn_pool_flush(void)
+{
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	k_mutex_lock(&conn_pool_mutex, K_FOREVER);
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		if (conn_pool[i].fd != REST_CLIENT_SCKT_CONNECT && !conn_pool[i].in_use) {
+			conn_pool_close(&conn_pool[i]);
+		}
+	}
+	k_mutex_unlock(&conn_pool_mutex);
+#endif
+}
+
+void rest_client_conn_stats_get(struct rest_client_conn_stats *stats)
+{
+	__ASSERT_NO_MSG(stats != NULL);
+
+	k_spinlock_key_t key = k_spin_lock(&conn_stats_lock);
+
+	*stats = conn_stats;
+
+	k_spin_unlock(&conn_stats_lock, key);
+}
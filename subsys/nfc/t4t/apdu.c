@@ -29,17 +29,29 @@ LOG_MODULE_REGISTER(nfc_t4t_apdu, CONFIG_NFC_T4T_APDU_LOG_LEVEL);
  */
 #define LE_FIELD_ABSENT 0U
 #define LE_LONG_FORMAT_THR 0x0100
+#define LE_LONG_FORMAT_TOKEN 0x00
+#define LE_LONG_FORMAT_TOKEN_SIZE 1U
 #define LE_ENCODED_VAL_256 0x00
 
 /* Size of Status field contained in R-APDU. */
 #define STATUS_SIZE 2U
 
+/* ISO/IEC 7816-4 requires both Lc and Le fields to use the same format. The long
+ * format is used when any of them does not fit the short one.
+ */
+static bool nfc_t4t_apdu_comm_is_extended(const struct nfc_t4t_apdu_comm *cmd_apdu)
+{
+	return ((cmd_apdu->data.buff) && (cmd_apdu->data.len > LC_LONG_FORMAT_THR)) ||
+	       (cmd_apdu->resp_len > LE_LONG_FORMAT_THR);
+}
+
 static uint16_t nfc_t4t_apdu_comm_size_calc(const struct nfc_t4t_apdu_comm *cmd_apdu)
 {
 	uint16_t res = CLASS_TYPE_SIZE + INSTRUCTION_TYPE_SIZE + PARAMETER_SIZE;
+	bool extended = nfc_t4t_apdu_comm_is_extended(cmd_apdu);
 
 	if (cmd_apdu->data.buff) {
-		if (cmd_apdu->data.len > LC_LONG_FORMAT_THR) {
+		if (extended) {
 			res += LC_LONG_FORMAT_SIZE;
 		} else {
 			res += LC_SHORT_FORMAT_SIZE;
@@ -49,10 +61,13 @@ static uint16_t nfc_t4t_apdu_comm_size_calc(const struct nfc_t4t_apdu_comm *cmd_
 	res += cmd_apdu->data.len;
 
 	if (cmd_apdu->resp_len != LE_FIELD_ABSENT) {
-		if (cmd_apdu->resp_len > LE_LONG_FORMAT_THR) {
+		if (!extended) {
+			res += LE_SHORT_FORMAT_SIZE;
+		} else if (cmd_apdu->data.buff) {
 			res += LE_LONG_FORMAT_SIZE;
 		} else {
-			res += LE_SHORT_FORMAT_SIZE;
+			/* Without Lc field, long Le field starts with a token. */
+			res += LE_LONG_FORMAT_TOKEN_SIZE + LE_LONG_FORMAT_SIZE;
 		}
 	}
 
@@ -95,6 +110,8 @@ int nfc_t4t_apdu_comm_encode(const struct nfc_t4t_apdu_comm *cmd_apdu,
 
 	*len = comm_apdu_len;
 
+	bool extended = nfc_t4t_apdu_comm_is_extended(cmd_apdu);
+
 	/* Start to encode described C-APDU in the buffer. */
 	*raw_data++ = cmd_apdu->class_byte;
 	*raw_data++ = cmd_apdu->instruction;
@@ -105,7 +122,7 @@ int nfc_t4t_apdu_comm_encode(const struct nfc_t4t_apdu_comm *cmd_apdu,
 	/* Check if optional data field should be included. */
 	if (cmd_apdu->data.buff) {
 		/* Use long data length encoding. */
-		if (cmd_apdu->data.len > LC_LONG_FORMAT_THR) {
+		if (extended) {
 			*raw_data++ = LC_LONG_FORMAT_TOKEN;
 
 			sys_put_be16(cmd_apdu->data.len, raw_data);
@@ -124,7 +141,11 @@ int nfc_t4t_apdu_comm_encode(const struct nfc_t4t_apdu_comm *cmd_apdu,
 	 */
 	if (cmd_apdu->resp_len != LE_FIELD_ABSENT) {
 		/* Use long response length encoding. */
-		if (cmd_apdu->resp_len > LE_LONG_FORMAT_THR) {
+		if (extended) {
+			if (!cmd_apdu->data.buff) {
+				*raw_data++ = LE_LONG_FORMAT_TOKEN;
+			}
+
 			sys_put_be16(cmd_apdu->resp_len, raw_data);
 			raw_data += sizeof(uint16_t);
 		} else {
@@ -26,6 +26,15 @@ LOG_MODULE_REGISTER(nfc_t4t_hl_procedure,
 #define NFC_T4T_APDU_SELECT_DATA {0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01}
 #define APDU_LE_MAP_2_MAX_VALUE 0xFF
 #define NFC_T4T_APDU_RSP_ALL 256
+#define CAPDU_HEADER_SIZE 4
+#define CAPDU_LC_SHORT_SIZE 1
+#define CAPDU_LC_EXTENDED_SIZE 3
+
+#ifdef CONFIG_NFC_T4T_HL_PROCEDURE_EXTENDED_APDU
+#define RAPDU_DATA_MAX CONFIG_NFC_T4T_HL_PROCEDURE_RAPDU_DATA_MAX
+#else
+#define RAPDU_DATA_MAX APDU_LE_MAP_2_MAX_VALUE
+#endif
 
 enum nfc_t4t_hl_transaction_type {
 	NFC_T4T_HL_SELECT,
@@ -57,6 +66,7 @@ struct t4t_hl_procedure {
 	enum nfc_t4t_hl_transaction_type transaction_type;
 	enum nfc_t4t_hl_procedure_select select_type;
 	uint16_t file_offset;
+	struct nfc_t4t_isodep_stats stats_start;
 	uint8_t apdu_buff[CONFIG_NFC_T4T_HL_PROCEDURE_APDU_BUF_SIZE];
 };
 
@@ -79,6 +89,53 @@ static int t4t_hl_data_exchange(struct nfc_t4t_apdu_comm *comm)
 	return nfc_t4t_isodep_transmit(t4t_hl.apdu_buff, apdu_len);
 }
 
+static uint16_t t4t_hl_rapdu_data_max(const struct nfc_t4t_cc_file *cc)
+{
+	/* Tag supports extended length R-APDUs if its MLe exceeds the short Le range. */
+	if (IS_ENABLED(CONFIG_NFC_T4T_HL_PROCEDURE_EXTENDED_APDU) &&
+	    (cc->max_rapdu_size > APDU_LE_MAP_2_MAX_VALUE)) {
+		return MIN(cc->max_rapdu_size, RAPDU_DATA_MAX);
+	}
+
+	return MIN(APDU_LE_MAP_2_MAX_VALUE, cc->max_rapdu_size);
+}
+
+static uint16_t t4t_hl_capdu_data_max(const struct nfc_t4t_cc_file *cc)
+{
+	uint16_t data_max = MIN(APDU_LE_MAP_2_MAX_VALUE, cc->max_capdu_size);
+	uint16_t header_size = CAPDU_HEADER_SIZE + CAPDU_LC_SHORT_SIZE;
+
+	/* Tag supports extended length C-APDUs if its MLc exceeds the short Lc range. */
+	if (IS_ENABLED(CONFIG_NFC_T4T_HL_PROCEDURE_EXTENDED_APDU) &&
+	    (cc->max_capdu_size > APDU_LE_MAP_2_MAX_VALUE)) {
+		data_max = cc->max_capdu_size;
+		header_size = CAPDU_HEADER_SIZE + CAPDU_LC_EXTENDED_SIZE;
+	}
+
+	/* The whole C-APDU must fit in the APDU buffer. */
+	return MIN(data_max, sizeof(t4t_hl.apdu_buff) - header_size);
+}
+
+static void t4t_hl_stats_start(void)
+{
+	nfc_t4t_isodep_stats_get(&t4t_hl.stats_start);
+}
+
+static void t4t_hl_stats_report(const char *procedure, uint32_t len)
+{
+	struct nfc_t4t_isodep_stats stats;
+	uint32_t exchanges;
+	uint64_t time_us;
+
+	nfc_t4t_isodep_stats_get(&stats);
+
+	exchanges = stats.exchanges - t4t_hl.stats_start.exchanges;
+	time_us = stats.exchange_time_us - t4t_hl.stats_start.exchange_time_us;
+
+	LOG_INF("%s: %u bytes in %u transactions, %u us/kB", procedure, len, exchanges,
+		(uint32_t)(len ? ((time_us * 1024) / len) : 0));
+}
+
 static int on_cc_read(const struct nfc_t4t_apdu_resp *resp)
 {
 	__ASSERT_NO_MSG(resp);
@@ -134,8 +191,9 @@ static int on_ndef_nlen_read(const struct nfc_t4t_apdu_resp *resp)
 	const uint8_t *data = resp->data.buff;
 	uint16_t len = resp->data.len;
 
-	if (len != NDEF_FILE_NLEN_SIZE) {
-		LOG_ERR("NDEF NLEN response is to long");
+	/* The first part of the NDEF message can follow NLEN in the response. */
+	if (len < NDEF_FILE_NLEN_SIZE) {
+		LOG_ERR("NDEF NLEN response is to short");
 		return -EINVAL;
 	}
 
@@ -151,7 +209,7 @@ static int t4t_file_assign(uint16_t id)
 	__ASSERT_NO_MSG(t4t_hl.ndef.cc);
 
 	file.content = t4t_hl.ndef.buff;
-	file.len = t4t_hl.file_offset;
+	file.len = MIN(t4t_hl.file_offset, t4t_hl.ndef.nlen + NDEF_FILE_NLEN_SIZE);
 
 	return nfc_t4t_cc_file_content_set(t4t_hl.ndef.cc, &file, id);
 }
@@ -180,7 +238,7 @@ static int ndef_file_chunk_read(const struct nfc_t4t_apdu_resp *resp)
 		apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_READ;
 		apdu_comm.parameter = t4t_hl.file_offset;
 		apdu_comm.resp_len = MIN(t4t_hl.ndef.nlen - (t4t_hl.file_offset - NDEF_FILE_NLEN_SIZE),
-				MIN(APDU_LE_MAP_2_MAX_VALUE, t4t_hl.ndef.cc->max_rapdu_size));
+				t4t_hl_rapdu_data_max(t4t_hl.ndef.cc));
 
 		t4t_hl.transaction_type = NFC_T4T_HL_NDEF_READ;
 
@@ -194,6 +252,8 @@ static int ndef_file_chunk_read(const struct nfc_t4t_apdu_resp *resp)
 		return err;
 	}
 
+	t4t_hl_stats_report("NDEF read", t4t_hl.ndef.nlen + NDEF_FILE_NLEN_SIZE);
+
 	if (hl_cb->ndef_read) {
 		hl_cb->ndef_read(file_id, t4t_hl.ndef.buff,
 				 t4t_hl.ndef.nlen + NDEF_FILE_NLEN_SIZE);
@@ -215,7 +275,7 @@ static int ndef_file_chunk_update(void)
 		apdu_comm.parameter = t4t_hl.file_offset;
 		apdu_comm.data.buff = t4t_hl.ndef.buff + t4t_hl.file_offset;
 		apdu_comm.data.len = MIN(t4t_hl.ndef.buff_size - t4t_hl.file_offset,
-				MIN(APDU_LE_MAP_2_MAX_VALUE, t4t_hl.ndef.cc->max_capdu_size));
+				t4t_hl_capdu_data_max(t4t_hl.ndef.cc));
 
 		t4t_hl.file_offset += apdu_comm.data.len;
 		t4t_hl.transaction_type = NFC_T4T_HL_NDEF_UPDATE;
@@ -238,6 +298,8 @@ static void on_ndef_nlen_update(void)
 {
 	uint16_t file_id = sys_get_be16(t4t_hl.ndef.file_id);
 
+	t4t_hl_stats_report("NDEF update", t4t_hl.ndef.buff_size);
+
 	if (hl_cb->ndef_updated) {
 		hl_cb->ndef_updated(file_id);
 	}
@@ -399,6 +461,26 @@ int nfc_t4t_hl_procedure_cc_read(struct nfc_t4t_cc_file *cc)
 	return t4t_hl_data_exchange(&apdu_comm);
 }
 
+/* Read NLEN together with the first part of the NDEF message. Reading past
+ * the NDEF message is allowed as long as the read stays within the file.
+ */
+static uint16_t t4t_hl_ndef_first_read_len(struct nfc_t4t_cc_file *cc,
+					   uint16_t ndef_len)
+{
+	uint32_t len;
+	struct nfc_t4t_tlv_block *tlv_block;
+
+	tlv_block = nfc_t4t_cc_file_content_get(cc, sys_get_be16(t4t_hl.ndef.file_id));
+	if (!tlv_block) {
+		return NDEF_FILE_NLEN_SIZE;
+	}
+
+	len = MIN(tlv_block->value.max_file_size, ndef_len);
+	len = MIN(len, t4t_hl_rapdu_data_max(cc));
+
+	return MAX(len, NDEF_FILE_NLEN_SIZE);
+}
+
 int nfc_t4t_hl_procedure_ndef_read(struct nfc_t4t_cc_file *cc,
 				   uint8_t *ndef_buff,
 				   uint16_t ndef_len)
@@ -415,7 +497,9 @@ int nfc_t4t_hl_procedure_ndef_read(struct nfc_t4t_cc_file *cc,
 
 	apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_READ;
 	apdu_comm.parameter = 0;
-	apdu_comm.resp_len = NDEF_FILE_NLEN_SIZE;
+	apdu_comm.resp_len = t4t_hl_ndef_first_read_len(cc, ndef_len);
+
+	t4t_hl_stats_start();
 
 	t4t_hl.ndef.buff = ndef_buff;
 	t4t_hl.ndef.buff_size = ndef_len;
@@ -468,5 +552,7 @@ int nfc_t4t_hl_procedure_ndef_update(struct nfc_t4t_cc_file *cc,
 	t4t_hl.file_offset = NDEF_FILE_NLEN_SIZE;
 	t4t_hl.transaction_type = NFC_T4T_HL_NDEF_NLEN_CLEAR;
 
+	t4t_hl_stats_start();
+
 	return t4t_hl_data_exchange(&apdu_comm);
 }
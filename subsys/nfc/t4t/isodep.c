@@ -39,6 +39,20 @@ LOG_MODULE_REGISTER(nfc_t4t_isodep, CONFIG_NFC_T4T_ISODEP_LOG_LEVEL);
 
 #define T4T_FSD_MIN 16
 
+/* Highest FSDI and FSCI values which can be used. Higher FSCI values are RFU
+ * and are interpreted as the highest supported one.
+ */
+#define T4T_FSCI_MAX (IS_ENABLED(CONFIG_NFC_T4T_ISODEP_FSC_EXTENDED) ? \
+		      NFC_T4T_ISODEP_FSD_4096 : NFC_T4T_ISODEP_FSD_256)
+
+/* Number of I-block slots in the Tx buffer. The next chained block is prepared
+ * in the second slot while the current one is exchanged.
+ */
+#define ISODEP_TX_FRAME_CNT 2
+
+/* R-block and S-block frames contain the PCB, the DID and at most one INF byte. */
+#define ISODEP_CTRL_FRAME_MAX_LEN 3
+
 #define T4T_RATS_CMD 0xE0
 #define T4T_RATS_DID_MASK 0x0F
 #define T4T_RATS_FSDI_MASK 0xF0
@@ -113,26 +127,45 @@ struct nfc_t4t_err {
 	uint8_t wtx;
 };
 
+struct nfc_t4t_tx_frame {
+	uint8_t *data;
+	size_t len;
+	size_t data_len;
+	bool chaining;
+};
+
 struct nfc_t4t_isodep {
 	atomic_t state;
 	struct nfc_t4t_isodep_tag tag;
 	struct nfc_t4t_buf tx_data;
 	struct nfc_t4t_buf rx_data;
 	struct nfc_t4t_err err_status;
+	struct nfc_t4t_tx_frame tx_frame[ISODEP_TX_FRAME_CNT];
+	struct nfc_t4t_isodep_stats stats;
+	int64_t transfer_start;
+	size_t frame_size;
 	uint16_t fsd;
 	uint8_t block_num;
 	uint8_t retransmit_cnt;
+	uint8_t tx_frame_idx;
+	uint8_t ctrl_frame[ISODEP_CTRL_FRAME_MAX_LEN];
+	size_t ctrl_frame_len;
 	const uint8_t *transmit_data;
 	size_t transmit_len;
 	size_t transmitted_len;
 	bool chaining;
+	bool pipelining;
+	bool next_frame_ready;
 	bool equal_divisor;
 	bool ats_expected;
 	bool first_transfer;
 };
 
-/* Map FSD value in terms of FSDI according to NFC Forum Digital Specification 2.0 14.16.1 */
-static const uint16_t fsd_value_map[] = {16, 24, 32, 40, 48, 64, 96, 128, 256};
+/* Map FSD value in terms of FSDI according to NFC Forum Digital Specification 2.0 14.16.1,
+ * followed by the values added in ISO/IEC 14443-4:2018.
+ */
+static const uint16_t fsd_value_map[] = {16, 24, 32, 40, 48, 64, 96, 128, 256,
+					 512, 1024, 2048, 4096};
 
 static struct nfc_t4t_isodep t4t_isodep;
 static const struct nfc_t4t_isodep_cb *t4t_isodep_cb;
@@ -145,6 +178,8 @@ static void isodep_transmission_clear(void)
 	t4t_isodep.transmitted_len            = 0;
 	t4t_isodep.transmit_len               = 0;
 	t4t_isodep.chaining                   = false;
+	t4t_isodep.next_frame_ready           = false;
+	t4t_isodep.tx_frame_idx               = 0;
 	t4t_isodep.retransmit_cnt             = 0;
 	t4t_isodep.err_status.frame_retry_cnt = 0;
 	t4t_isodep.err_status.last_frame      = ISODEP_FRAME_NONE;
@@ -201,7 +236,7 @@ static int ats_parse(const uint8_t *data, size_t len)
 	t0 = data[index];
 	index++;
 
-	fsci = t0 & T4T_ATS_T0_FSCI_MASK;
+	fsci = MIN(t0 & T4T_ATS_T0_FSCI_MASK, T4T_FSCI_MAX);
 
 	/* FSC is mapped from FSCI in the same way like FSD.
 	 * NFC Forum Digital Specification 2.0 14.6.2.
@@ -211,6 +246,23 @@ static int ats_parse(const uint8_t *data, size_t len)
 	/* Include space for CRC */
 	t4t_isodep.tag.fsc -= ISODEP_CRC_LENGTH;
 
+	/* Send frames as large as the Listener accepts and the Tx buffer can hold.
+	 * If the Tx buffer fits two such frames, the next chained block is prepared
+	 * while the current one is exchanged.
+	 */
+	t4t_isodep.frame_size = MIN(t4t_isodep.tag.fsc, t4t_isodep.tx_data.buf_size);
+	t4t_isodep.pipelining = (t4t_isodep.tx_data.buf_size >=
+				 (ISODEP_TX_FRAME_CNT * t4t_isodep.frame_size));
+
+	for (size_t i = 0; i < ISODEP_TX_FRAME_CNT; i++) {
+		t4t_isodep.tx_frame[i].data = t4t_isodep.pipelining ?
+			&t4t_isodep.tx_data.data[i * t4t_isodep.frame_size] :
+			t4t_isodep.tx_data.data;
+	}
+
+	LOG_DBG("FSC: %d, frame size: %d, pipelining %s", t4t_isodep.tag.fsc,
+		t4t_isodep.frame_size, t4t_isodep.pipelining ? "enabled" : "disabled");
+
 	/* Check id ATS contains interface bytes, if not
 	 * set all data to default values according to
 	 * NFC Forum Digital Specification 2.0 14.6.2.
@@ -292,50 +344,80 @@ static int ats_parse(const uint8_t *data, size_t len)
 	return 0;
 }
 
-static void isodep_chunk_send(void)
+static void isodep_chunk_prepare(struct nfc_t4t_tx_frame *frame)
 {
-	size_t data_len;
-	uint32_t fdt;
 	size_t index = 0;
+	size_t remaining = t4t_isodep.transmit_len - t4t_isodep.transmitted_len;
 	const uint8_t *data = t4t_isodep.transmit_data;
-	uint8_t *tx_data = t4t_isodep.tx_data.data;
+	uint8_t *tx_data = frame->data;
 
 	__ASSERT_NO_MSG(data);
 	__ASSERT_NO_MSG(tx_data);
 
-	/* Prepare first chunk. */
-	tx_data[index] = ISODEP_I_BLOCK | (t4t_isodep.block_num & 1);
+	/* The block number is set when the frame is sent. */
+	tx_data[index] = ISODEP_I_BLOCK;
 
 	/* Check if DID field should be included. */
 	index = did_include(tx_data, index);
 
 	/* Use chaining when data is to long. */
-	if ((t4t_isodep.tag.fsc - index) <
-	    (t4t_isodep.transmit_len - t4t_isodep.transmitted_len)) {
+	if ((t4t_isodep.frame_size - index) < remaining) {
 		tx_data[0] |= I_BLOCK_CHAINING_BIT;
-		data_len = t4t_isodep.tag.fsc - index;
-		t4t_isodep.chaining = true;
+		frame->data_len = t4t_isodep.frame_size - index;
+		frame->chaining = true;
+	} else {
+		frame->data_len = remaining;
+		frame->chaining = false;
+	}
+
+	memcpy(&tx_data[index], &data[t4t_isodep.transmitted_len], frame->data_len);
+
+	frame->len = index + frame->data_len;
+}
+
+static void isodep_chunk_send(void)
+{
+	uint32_t fdt;
+	struct nfc_t4t_tx_frame *frame;
+
+	if (t4t_isodep.next_frame_ready) {
+		/* The next block was prepared during the previous exchange. */
+		t4t_isodep.tx_frame_idx = (t4t_isodep.tx_frame_idx + 1) % ISODEP_TX_FRAME_CNT;
+		t4t_isodep.next_frame_ready = false;
+
+		frame = &t4t_isodep.tx_frame[t4t_isodep.tx_frame_idx];
 	} else {
-		data_len = t4t_isodep.transmit_len - t4t_isodep.transmitted_len;
-		t4t_isodep.chaining = false;
+		frame = &t4t_isodep.tx_frame[t4t_isodep.tx_frame_idx];
+
+		isodep_chunk_prepare(frame);
 	}
 
+	frame->data[0] &= ~ISODEP_BLOCK_NUM_MASK;
+	frame->data[0] |= (t4t_isodep.block_num & ISODEP_BLOCK_NUM_MASK);
+
+	t4t_isodep.chaining = frame->chaining;
+	t4t_isodep.transmitted_len += frame->data_len;
+
 	/* Restore last frame type in case nfc_t4t_isodep_transmit() was called
 	 * as it clears the transmission status.
 	 */
 	t4t_isodep.err_status.last_frame = ISODEP_FRAME_I;
 
-	memcpy(&tx_data[index], &data[t4t_isodep.transmitted_len], data_len);
-
-	index += data_len;
-	t4t_isodep.tx_data.len = index;
-	t4t_isodep.transmitted_len += data_len;
+	t4t_isodep.stats.i_blocks_tx++;
+	t4t_isodep.stats.bytes_tx += frame->data_len;
 
 	fdt = t4t_isodep.tag.fwt + T4T_FWT_DELTA + NFCA_T4T_FWT_T_FC;
 
 	if (t4t_isodep_cb->ready_to_send) {
-		t4t_isodep_cb->ready_to_send(t4t_isodep.tx_data.data,
-					     t4t_isodep.tx_data.len, fdt);
+		t4t_isodep_cb->ready_to_send(frame->data, frame->len, fdt);
+	}
+
+	/* Prepare the next chained block while the current one is on air. */
+	if (t4t_isodep.pipelining && t4t_isodep.chaining) {
+		uint8_t next_idx = (t4t_isodep.tx_frame_idx + 1) % ISODEP_TX_FRAME_CNT;
+
+		isodep_chunk_prepare(&t4t_isodep.tx_frame[next_idx]);
+		t4t_isodep.next_frame_ready = true;
 	}
 }
 
@@ -348,7 +430,7 @@ static void isodep_r_frame_send(bool ack)
 {
 	size_t index = 0;
 	uint32_t fdt;
-	uint8_t *tx_data = t4t_isodep.tx_data.data;
+	uint8_t *tx_data = t4t_isodep.ctrl_frame;
 
 	tx_data[index] = ISODEP_R_BLOCK | (t4t_isodep.block_num & 1);
 
@@ -363,6 +445,8 @@ static void isodep_r_frame_send(bool ack)
 	/* Check if DID field should be included. */
 	index = did_include(tx_data, index);
 
+	t4t_isodep.ctrl_frame_len = index;
+
 	fdt = t4t_isodep.tag.fwt + T4T_FWT_DELTA + NFCA_T4T_FWT_T_FC;
 
 	if (t4t_isodep_cb->ready_to_send) {
@@ -424,9 +508,11 @@ static int isodep_s_frame_handle(const uint8_t *data, size_t len)
 		return -NFC_T4T_ISODEP_SYNTAX_ERROR;
 	}
 
-	/* Prepare S(WTX) response. */
+	/* Prepare S(WTX) response. It does not overwrite the I-block
+	 * which might need to be retransmitted.
+	 */
 	index = 0;
-	tx_data = t4t_isodep.tx_data.data;
+	tx_data = t4t_isodep.ctrl_frame;
 
 	tx_data[index] = ISODEP_S_BLOCK | S_BLOCK_WTX_MASK;
 
@@ -437,7 +523,8 @@ static int isodep_s_frame_handle(const uint8_t *data, size_t len)
 	tx_data[index] = wtxm;
 	index++;
 
-	t4t_isodep.tx_data.len = index;
+	t4t_isodep.ctrl_frame_len = index;
+	t4t_isodep.err_status.wtx = wtxm;
 
 	/* Calculate new Frame Delay Time value. */
 	fdt  = t4t_isodep.tag.fwt * wtxm + T4T_FWT_DELTA + NFCA_T4T_FWT_T_FC;
@@ -446,7 +533,7 @@ static int isodep_s_frame_handle(const uint8_t *data, size_t len)
 	t4t_isodep.err_status.last_frame = ISODEP_FRAME_WTX_RESPONSE;
 
 	if (t4t_isodep_cb->ready_to_send) {
-		t4t_isodep_cb->ready_to_send(tx_data, t4t_isodep.tx_data.len, fdt);
+		t4t_isodep_cb->ready_to_send(tx_data, t4t_isodep.ctrl_frame_len, fdt);
 	}
 
 	return 0;
@@ -497,13 +584,15 @@ static int isodep_r_frame_handle(const uint8_t *data, size_t len)
 			return -NFC_T4T_ISODEP_SEMANTIC_ERROR;
 		}
 
+		struct nfc_t4t_tx_frame *frame = &t4t_isodep.tx_frame[t4t_isodep.tx_frame_idx];
+
 		fdt = t4t_isodep.tag.fwt + T4T_FWT_DELTA + NFCA_T4T_FWT_T_FC;
 
 		if (t4t_isodep_cb->ready_to_send) {
-			t4t_isodep_cb->ready_to_send(t4t_isodep.tx_data.data,
-						     t4t_isodep.tx_data.len, fdt);
+			t4t_isodep_cb->ready_to_send(frame->data, frame->len, fdt);
 
 			t4t_isodep.retransmit_cnt++;
+			t4t_isodep.stats.retransmissions++;
 		}
 	}
 
@@ -552,6 +641,9 @@ static int isodep_i_frame_handle(const uint8_t *data, size_t len)
 	       &data[index], len);
 	t4t_isodep.rx_data.len += len;
 
+	t4t_isodep.stats.i_blocks_rx++;
+	t4t_isodep.stats.bytes_rx += len;
+
 	if (i_block & I_BLOCK_CHAINING_BIT) {
 		LOG_DBG("Chanining bit is set.");
 
@@ -563,6 +655,10 @@ static int isodep_i_frame_handle(const uint8_t *data, size_t len)
 
 		t4t_isodep.err_status.last_frame = ISODEP_FRAME_I;
 
+		t4t_isodep.stats.exchanges++;
+		t4t_isodep.stats.exchange_time_us +=
+			k_ticks_to_us_floor64(k_uptime_ticks() - t4t_isodep.transfer_start);
+
 		if (t4t_isodep_cb->data_received) {
 			t4t_isodep_cb->data_received(t4t_isodep.rx_data.data,
 						     t4t_isodep.rx_data.len);
@@ -621,12 +717,10 @@ static void isodep_error_handle(bool timeout)
 			break;
 		}
 
-		/* Resend last S(WTX) response. Last Response should be in
-		 * Tx buffer.
-		 */
+		/* Resend last S(WTX) response. */
 		if (t4t_isodep_cb->ready_to_send) {
-			t4t_isodep_cb->ready_to_send(t4t_isodep.tx_data.data,
-						     t4t_isodep.tx_data.len,
+			t4t_isodep_cb->ready_to_send(t4t_isodep.ctrl_frame,
+						     t4t_isodep.ctrl_frame_len,
 						     err_status->wtx * t4t_isodep.tag.fwt +
 						     T4T_FWT_DELTA + NFCA_T4T_FWT_T_FC);
 		}
@@ -730,6 +824,12 @@ int nfc_t4t_isodep_rats_send(enum nfc_t4t_isodep_fsd fsd, uint8_t did)
 		return -EINVAL;
 	}
 
+	if (fsd > T4T_FSCI_MAX) {
+		LOG_ERR("Unsupported FSD value.");
+
+		return -EINVAL;
+	}
+
 	if (t4t_isodep.tx_data.buf_size < fsd_value_map[fsd]) {
 		LOG_ERR("Invalid FSD value. Increase Tx buffer size or decrease FSD");
 
@@ -871,6 +971,7 @@ int nfc_t4t_isodep_transmit(const uint8_t *data, size_t data_len)
 
 	t4t_isodep.transmit_data = data;
 	t4t_isodep.transmit_len  = data_len;
+	t4t_isodep.transfer_start = k_uptime_ticks();
 
 	if (t4t_isodep.first_transfer) {
 		t4t_isodep.first_transfer = false;
@@ -897,3 +998,15 @@ int nfc_t4t_isodep_transmit(const uint8_t *data, size_t data_len)
 
 	return 0;
 }
+
+void nfc_t4t_isodep_stats_get(struct nfc_t4t_isodep_stats *stats)
+{
+	__ASSERT_NO_MSG(stats);
+
+	*stats = t4t_isodep.stats;
+}
+
+void nfc_t4t_isodep_stats_reset(void)
+{
+	memset(&t4t_isodep.stats, 0, sizeof(t4t_isodep.stats));
+}
@@ -9,11 +9,29 @@
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/kernel.h>
-#include <SEGGER_RTT.h>
 #include <nrf_profiler.h>
 #include <string.h>
+
+#ifdef CONFIG_ARCH_POSIX
+#define MEMORY_BARRIER() __sync_synchronize()
+#else
 #include <nrfx.h>
+#define MEMORY_BARRIER() __DMB()
+#endif
+
+#include "profiler_nordic_backend.h"
+
+/* Every event starts with a header made of the event type ID and the
+ * timestamp difference to the previously sent event, both encoded as
+ * little-endian base-128 varints. The difference is zigzag encoded as events
+ * can be sent in a different order than they were started.
+ */
+#define HEADER_ID_LEN_MAX		3
+#define HEADER_TIMESTAMP_LEN_MAX	5
+#define HEADER_LEN_MAX			(HEADER_ID_LEN_MAX + HEADER_TIMESTAMP_LEN_MAX)
 
+BUILD_ASSERT(CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN > HEADER_LEN_MAX);
+BUILD_ASSERT(NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS <= UINT16_MAX + 1);
 
 enum state {
 	STATE_DISABLED,
@@ -27,9 +45,14 @@ struct nrf_profiler_event_enabled_bm _nrf_profiler_event_enabled_bm;
 
 static K_SEM_DEFINE(nrf_profiler_sem, 0, 1);
 static atomic_t nrf_profiler_state;
-static uint16_t fatal_error_event_id;
+static uint16_t dropped_events_event_id;
 static struct k_spinlock lock;
 
+/* Protected by lock. */
+static uint32_t last_timestamp;
+static uint32_t dropped_events_pending;
+static uint32_t dropped_events_total;
+
 enum nordic_command {
 	NORDIC_COMMAND_START	= 1,
 	NORDIC_COMMAND_STOP	= 2,
@@ -49,11 +72,7 @@ static char *arg_types_encodings[] = {
 					"t"    /* time */
 				     };
 
-uint8_t nrf_profiler_num_events;
-
-static uint8_t buffer_data[CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE];
-static uint8_t buffer_info[CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE];
-static uint8_t buffer_commands[CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
+uint16_t nrf_profiler_num_events;
 
 static k_tid_t protocol_thread_id;
 
@@ -63,33 +82,23 @@ static struct k_thread nrf_profiler_nordic_thread;
 
 static int send_info_data(const char *data, size_t data_len)
 {
-	uint8_t retry_cnt = 0;
-	static const uint8_t retry_cnt_max = 100;
-
-	size_t num_bytes_send;
+	if (!nrf_profiler_backend.info_write) {
+		return -ENOTSUP;
+	}
 
-	num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  data, data_len);
+	return nrf_profiler_backend.info_write(data, data_len);
+}
 
-	while (num_bytes_send != data_len) {
-		/* Give host time to read the data and free some space
-		 * in the buffer. */
-		k_sleep(K_MSEC(100));
-		num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  data, data_len);
+static int send_event_description(uint16_t event_id)
+{
+	char end_line = '\n';
+	int err = send_info_data(descr[event_id], strlen(descr[event_id]));
 
-		/* Avoid being blocked in while loop if host does not read
-		 * the RTT data.
-		 */
-		retry_cnt++;
-		if (retry_cnt > retry_cnt_max) {
-			return -ENOBUFS;
-		}
+	if (!err) {
+		err = send_info_data(&end_line, 1);
 	}
 
-	return 0;
+	return err;
 }
 
 static void send_system_description(void)
@@ -97,36 +106,43 @@ static void send_system_description(void)
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
-	uint8_t ne = nrf_profiler_num_events;
+	uint16_t ne = nrf_profiler_num_events;
 
-	__DMB();
+	MEMORY_BARRIER();
 	char end_line = '\n';
 	int err = 0;
 
 	for (size_t t = 0; ((t < ne) && !err); t++) {
-		err = send_info_data(descr[t], strlen(descr[t]));
-		if (!err) {
-			err = send_info_data(&end_line, 1);
-		}
+		err = send_event_description(t);
 	}
 	if (!err) {
 		(void)send_info_data(&end_line, 1);
 	}
 }
 
+static void start_logging(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* Host starts decoding timestamp differences from zero. */
+	if (atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE)) {
+		last_timestamp = 0;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
 static void nrf_profiler_nordic_thread_fn(void)
 {
 	while (atomic_get(&nrf_profiler_state) != STATE_TERMINATED) {
 		uint8_t read_data;
 		enum nordic_command command;
 
-		if (SEGGER_RTT_Read(
-		     CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		     &read_data, sizeof(read_data))) {
+		if (nrf_profiler_backend.command_read(&read_data)) {
 			command = (enum nordic_command)read_data;
 			switch (command) {
 			case NORDIC_COMMAND_START:
-				atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE);
+				start_logging();
 				break;
 			case NORDIC_COMMAND_STOP:
 				atomic_cas(&nrf_profiler_state, STATE_ACTIVE, STATE_INACTIVE);
@@ -160,46 +176,38 @@ int nrf_profiler_init(void)
 		}
 	}
 
-	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_START_LOGGING_ON_SYSTEM_START)) {
-		atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE);
+	if (nrf_profiler_backend.init) {
+		int ret = nrf_profiler_backend.init();
+
+		if (ret) {
+			atomic_set(&nrf_profiler_state, STATE_DISABLED);
+			k_sched_unlock();
+			return ret;
+		}
+	}
+
+	/* Without a command channel nobody could start logging later on. */
+	if (IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_START_LOGGING_ON_SYSTEM_START) ||
+	    !nrf_profiler_backend.command_read) {
+		start_logging();
+	}
+
+	if (nrf_profiler_backend.command_read) {
+		protocol_thread_id = k_thread_create(&nrf_profiler_nordic_thread,
+				nrf_profiler_nordic_stack,
+				K_THREAD_STACK_SIZEOF(nrf_profiler_nordic_stack),
+				(k_thread_entry_t) nrf_profiler_nordic_thread_fn,
+				NULL, NULL, NULL,
+				CONFIG_NRF_PROFILER_NORDIC_THREAD_PRIORITY, 0, K_NO_WAIT);
 	}
 
-	int ret;
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-		"Nordic nrf_profiler data",
-		buffer_data,
-		CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-		"Nordic nrf_profiler info",
-		buffer_info,
-		CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigDownBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		"Nordic nrf_profiler command",
-		buffer_commands,
-		CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	protocol_thread_id =  k_thread_create(&nrf_profiler_nordic_thread,
-			nrf_profiler_nordic_stack,
-			K_THREAD_STACK_SIZEOF(nrf_profiler_nordic_stack),
-			(k_thread_entry_t) nrf_profiler_nordic_thread_fn,
-			NULL, NULL, NULL,
-			CONFIG_NRF_PROFILER_NORDIC_THREAD_PRIORITY, 0, K_NO_WAIT);
-
-	/* Registering fatal error event */
-	fatal_error_event_id = nrf_profiler_register_event_type("_nrf_profiler_fatal_error_event_",
-							    NULL, NULL, 0);
+	/* Registering dropped events event */
+	static const char * const dropped_events_names[] = {"count"};
+	static const enum nrf_profiler_arg dropped_events_types[] = {NRF_PROFILER_ARG_U32};
+
+	dropped_events_event_id = nrf_profiler_register_event_type(
+					"_nrf_profiler_dropped_events_",
+					dropped_events_names, dropped_events_types, 1);
 
 	k_sched_unlock();
 	return 0;
@@ -212,8 +220,24 @@ void nrf_profiler_term(void)
 		return;
 	}
 
-	k_wakeup(protocol_thread_id);
-	k_sem_take(&nrf_profiler_sem, K_FOREVER);
+	if (protocol_thread_id) {
+		k_wakeup(protocol_thread_id);
+		k_sem_take(&nrf_profiler_sem, K_FOREVER);
+	}
+
+	if (nrf_profiler_backend.flush) {
+		nrf_profiler_backend.flush();
+	}
+}
+
+uint32_t nrf_profiler_dropped_events_get(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint32_t dropped = dropped_events_total;
+
+	k_spin_unlock(&lock, key);
+
+	return dropped;
 }
 
 const char *nrf_profiler_get_event_descr(size_t nrf_profiler_event_id)
@@ -229,7 +253,7 @@ uint16_t nrf_profiler_register_event_type(const char *name, const char * const *
 	 * from multiple threads
 	 */
 	k_sched_lock();
-	uint8_t ne = nrf_profiler_num_events;
+	uint16_t ne = nrf_profiler_num_events;
 
 	__ASSERT_NO_MSG(ne + 1 <= NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS);
 	size_t temp = snprintf(descr[ne],
@@ -262,8 +286,15 @@ uint16_t nrf_profiler_register_event_type(const char *name, const char * const *
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
-	__DMB();
+	MEMORY_BARRIER();
 	nrf_profiler_num_events++;
+
+	/* Backends without a command channel cannot request the descriptions,
+	 * so they are written right away.
+	 */
+	if (!nrf_profiler_backend.command_read) {
+		(void)send_event_description(ne);
+	}
 	k_sched_unlock();
 
 	return ne;
@@ -271,9 +302,9 @@ uint16_t nrf_profiler_register_event_type(const char *name, const char * const *
 
 void nrf_profiler_log_start(struct log_event_buf *buf)
 {
-	/* Adding one to pointer to make space for event type ID */
-	buf->payload = buf->payload_start + sizeof(uint8_t);
-	nrf_profiler_log_encode_uint32(buf, k_cycle_get_32());
+	/* Leaving space for the header, which is encoded when the event is sent */
+	buf->payload = buf->payload_start + HEADER_LEN_MAX;
+	buf->timestamp = k_cycle_get_32();
 }
 
 void nrf_profiler_log_encode_uint32(struct log_event_buf *buf, uint32_t data)
@@ -340,42 +371,73 @@ void nrf_profiler_log_add_mem_address(struct log_event_buf *buf,
 	nrf_profiler_log_encode_uint32(buf, (uint32_t)mem_address);
 }
 
-static bool nrf_profiler_RTT_send(struct log_event_buf *buf, uint8_t type_id)
+static size_t encode_varint(uint8_t *out, uint32_t value)
 {
-	buf->payload_start[0] = type_id;
-	size_t data_len = buf->payload - buf->payload_start;
+	size_t len = 0;
+
+	while (value >= BIT(7)) {
+		out[len++] = (value & BIT_MASK(7)) | BIT(7);
+		value >>= 7;
+	}
+	out[len++] = value;
 
-	size_t num_bytes_send = SEGGER_RTT_WriteNoLock(
-			CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-			buf->payload_start, data_len);
-	return (num_bytes_send == data_len);
+	return len;
 }
 
-static void nrf_profiler_fatal_error(void)
+/* Must be called with the lock held. */
+static bool event_write(struct log_event_buf *buf, uint16_t event_type_id)
+{
+	uint8_t header[HEADER_LEN_MAX];
+	int32_t ts_diff = (int32_t)(buf->timestamp - last_timestamp);
+	uint32_t ts_zigzag = ((uint32_t)ts_diff << 1) ^ (uint32_t)(ts_diff >> 31);
+	size_t header_len;
+	uint8_t *start;
+
+	header_len = encode_varint(header, event_type_id);
+	header_len += encode_varint(header + header_len, ts_zigzag);
+
+	/* Header is placed right in front of the payload */
+	start = buf->payload_start + HEADER_LEN_MAX - header_len;
+	memcpy(start, header, header_len);
+
+	if (!nrf_profiler_backend.data_write(start, buf->payload - start)) {
+		return false;
+	}
+
+	last_timestamp = buf->timestamp;
+	return true;
+}
+
+/* Must be called with the lock held. */
+static bool dropped_events_report(void)
 {
 	struct log_event_buf buf;
 
 	nrf_profiler_log_start(&buf);
-	while (true) {
-		/* Sending Fatal Error event */
-		if (nrf_profiler_RTT_send(&buf, (uint8_t)fatal_error_event_id)) {
-			break;
-		}
+	nrf_profiler_log_encode_uint32(&buf, dropped_events_pending);
+
+	if (!event_write(&buf, dropped_events_event_id)) {
+		return false;
 	}
-	k_oops();
+
+	dropped_events_pending = 0;
+	return true;
 }
 
 void nrf_profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
 {
-	__ASSERT_NO_MSG(event_type_id <= UINT8_MAX);
+	__ASSERT_NO_MSG(event_type_id < nrf_profiler_num_events);
 
 	if (atomic_get(&nrf_profiler_state) == STATE_ACTIVE) {
-		uint8_t type_id = event_type_id & UINT8_MAX;
-
 		k_spinlock_key_t key = k_spin_lock(&lock);
 
-		if (!nrf_profiler_RTT_send(buf, type_id)) {
-			nrf_profiler_fatal_error();
+		/* Host is informed about the lost events before any new event,
+		 * so that the gap shows up at the right place in the stream.
+		 */
+		if (((dropped_events_pending > 0) && !dropped_events_report()) ||
+		    !event_write(buf, event_type_id)) {
+			dropped_events_pending++;
+			dropped_events_total++;
 		}
 		k_spin_unlock(&lock, key);
 	}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _PROFILER_NORDIC_BACKEND_H_
+#define _PROFILER_NORDIC_BACKEND_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Transport used by the Nordic nrf_profiler to reach the host.
+ *
+ * Exactly one backend is linked in, selected with the
+ * CONFIG_NRF_PROFILER_NORDIC_BACKEND_* choice.
+ */
+struct nrf_profiler_backend {
+	/** Prepare the transport. Called once from @ref nrf_profiler_init. */
+	int (*init)(void);
+
+	/** Write a single encoded event.
+	 *
+	 * Called with the nrf_profiler spinlock held, possibly from an
+	 * interrupt. The backend must never block and must either accept
+	 * the whole record or none of it.
+	 *
+	 * @return True if the record was accepted.
+	 */
+	bool (*data_write)(const uint8_t *data, size_t len);
+
+	/** Write event type descriptions. Called from thread context and
+	 *  allowed to block for a while. Can be NULL if the backend does not
+	 *  carry descriptions; the host then needs another way to obtain them.
+	 */
+	int (*info_write)(const char *data, size_t len);
+
+	/** Fetch one pending host command byte without blocking.
+	 *
+	 * Can be NULL if the backend has no host command channel. The
+	 * descriptions are then written as soon as event types are
+	 * registered.
+	 *
+	 * @return True if a command was read.
+	 */
+	bool (*command_read)(uint8_t *command);
+
+	/** Push out any buffered data. Can be NULL. */
+	void (*flush)(void);
+};
+
+/** Backend selected in the configuration. */
+extern const struct nrf_profiler_backend nrf_profiler_backend;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROFILER_NORDIC_BACKEND_H_ */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+
+#include "profiler_nordic_backend.h"
+
+/* Host file backend for native_posix builds. The events are stored in
+ * <name>.bin and the event type descriptions in <name>.txt, ready to be fed
+ * to the scripts in scripts/nrf_profiler.
+ */
+#define FILE_NAME_DATA CONFIG_NRF_PROFILER_NORDIC_BACKEND_FILE_NAME ".bin"
+#define FILE_NAME_INFO CONFIG_NRF_PROFILER_NORDIC_BACKEND_FILE_NAME ".txt"
+
+static FILE *data_file;
+static FILE *info_file;
+
+static int file_init(void)
+{
+	data_file = fopen(FILE_NAME_DATA, "wb");
+	if (!data_file) {
+		return -EIO;
+	}
+
+	info_file = fopen(FILE_NAME_INFO, "w");
+	if (!info_file) {
+		fclose(data_file);
+		data_file = NULL;
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static bool file_data_write(const uint8_t *data, size_t len)
+{
+	return (data_file && (fwrite(data, 1, len, data_file) == len));
+}
+
+static int file_info_write(const char *data, size_t len)
+{
+	if (!info_file || (fwrite(data, 1, len, info_file) != len)) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static void file_flush(void)
+{
+	if (data_file) {
+		fflush(data_file);
+	}
+
+	if (info_file) {
+		fflush(info_file);
+	}
+}
+
+const struct nrf_profiler_backend nrf_profiler_backend = {
+	.init = file_init,
+	.data_write = file_data_write,
+	.info_write = file_info_write,
+	.flush = file_flush,
+};
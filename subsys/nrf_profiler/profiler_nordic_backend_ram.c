@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <nrf_profiler.h>
+
+#include "profiler_nordic_backend.h"
+
+RING_BUF_DECLARE(data_buf, CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE);
+static struct k_spinlock ram_lock;
+
+static bool ram_data_write(const uint8_t *data, size_t len)
+{
+	bool ret = false;
+	k_spinlock_key_t key = k_spin_lock(&ram_lock);
+
+	/* Records are never split, the host side could not resynchronize. */
+	if (ring_buf_space_get(&data_buf) >= len) {
+		ring_buf_put(&data_buf, data, len);
+		ret = true;
+	}
+
+	k_spin_unlock(&ram_lock, key);
+
+	return ret;
+}
+
+size_t nrf_profiler_ram_backend_read(uint8_t *data, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&ram_lock);
+	size_t read = ring_buf_get(&data_buf, data, len);
+
+	k_spin_unlock(&ram_lock, key);
+
+	return read;
+}
+
+const struct nrf_profiler_backend nrf_profiler_backend = {
+	.data_write = ram_data_write,
+};
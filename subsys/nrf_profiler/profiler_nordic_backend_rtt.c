@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <SEGGER_RTT.h>
+
+#include "profiler_nordic_backend.h"
+
+static uint8_t buffer_data[CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE];
+static uint8_t buffer_info[CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE];
+static uint8_t buffer_commands[CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
+
+static int rtt_init(void)
+{
+	int ret;
+
+	ret = SEGGER_RTT_ConfigUpBuffer(
+		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
+		"Nordic nrf_profiler data",
+		buffer_data,
+		CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	__ASSERT_NO_MSG(ret >= 0);
+
+	ret = SEGGER_RTT_ConfigUpBuffer(
+		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
+		"Nordic nrf_profiler info",
+		buffer_info,
+		CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	__ASSERT_NO_MSG(ret >= 0);
+
+	ret = SEGGER_RTT_ConfigDownBuffer(
+		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
+		"Nordic nrf_profiler command",
+		buffer_commands,
+		CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	__ASSERT_NO_MSG(ret >= 0);
+
+	return 0;
+}
+
+static bool rtt_data_write(const uint8_t *data, size_t len)
+{
+	/* In SEGGER_RTT_MODE_NO_BLOCK_SKIP mode either all or none of the
+	 * bytes are written.
+	 */
+	return (SEGGER_RTT_WriteNoLock(CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
+				       data, len) == len);
+}
+
+static int rtt_info_write(const char *data, size_t len)
+{
+	uint8_t retry_cnt = 0;
+	static const uint8_t retry_cnt_max = 100;
+
+	size_t num_bytes_send;
+
+	num_bytes_send = SEGGER_RTT_WriteNoLock(
+				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
+				  data, len);
+
+	while (num_bytes_send != len) {
+		/* Give host time to read the data and free some space
+		 * in the buffer. */
+		k_sleep(K_MSEC(100));
+		num_bytes_send = SEGGER_RTT_WriteNoLock(
+				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
+				  data, len);
+
+		/* Avoid being blocked in while loop if host does not read
+		 * the RTT data.
+		 */
+		retry_cnt++;
+		if (retry_cnt > retry_cnt_max) {
+			return -ENOBUFS;
+		}
+	}
+
+	return 0;
+}
+
+static bool rtt_command_read(uint8_t *command)
+{
+	return (SEGGER_RTT_Read(CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
+				command, sizeof(*command)) > 0);
+}
+
+const struct nrf_profiler_backend nrf_profiler_backend = {
+	.init = rtt_init,
+	.data_write = rtt_data_write,
+	.info_write = rtt_info_write,
+	.command_read = rtt_command_read,
+};
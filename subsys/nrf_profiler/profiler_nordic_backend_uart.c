@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/ring_buffer.h>
+
+#include "profiler_nordic_backend.h"
+
+/* Descriptions and events share the link. The host only requests the
+ * descriptions while logging is stopped, so the two never interleave.
+ */
+RING_BUF_DECLARE(tx_buf, CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE);
+RING_BUF_DECLARE(cmd_buf, CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE);
+static struct k_spinlock tx_lock;
+
+static const struct device *uart_dev = DEVICE_DT_GET(DT_CHOSEN(ncs_nrf_profiler_uart));
+
+static void handle_tx_ready(const struct device *dev)
+{
+	uint8_t *data;
+	uint32_t len;
+	int sent;
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+	len = ring_buf_get_claim(&tx_buf, &data, CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE);
+	if (len == 0) {
+		uart_irq_tx_disable(dev);
+		k_spin_unlock(&tx_lock, key);
+		return;
+	}
+
+	sent = uart_fifo_fill(dev, data, len);
+	ring_buf_get_finish(&tx_buf, MAX(sent, 0));
+
+	k_spin_unlock(&tx_lock, key);
+}
+
+static void handle_rx_ready(const struct device *dev)
+{
+	uint8_t byte;
+
+	while (uart_fifo_read(dev, &byte, sizeof(byte)) == sizeof(byte)) {
+		/* Commands that do not fit are dropped, the host repeats them. */
+		(void)ring_buf_put(&cmd_buf, &byte, sizeof(byte));
+	}
+}
+
+static void uart_isr(const struct device *dev, void *user_data)
+{
+	while (uart_irq_update(dev) && uart_irq_is_pending(dev)) {
+		if (uart_irq_rx_ready(dev)) {
+			handle_rx_ready(dev);
+		}
+
+		if (uart_irq_tx_ready(dev)) {
+			handle_tx_ready(dev);
+		}
+	}
+}
+
+static int uart_backend_init(void)
+{
+	if (!device_is_ready(uart_dev)) {
+		return -ENODEV;
+	}
+
+	uart_irq_callback_set(uart_dev, uart_isr);
+	uart_irq_rx_enable(uart_dev);
+
+	return 0;
+}
+
+static bool tx_buf_put(const uint8_t *data, size_t len)
+{
+	bool ret = false;
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+	if (ring_buf_space_get(&tx_buf) >= len) {
+		ring_buf_put(&tx_buf, data, len);
+		ret = true;
+	}
+
+	k_spin_unlock(&tx_lock, key);
+
+	if (ret) {
+		uart_irq_tx_enable(uart_dev);
+	}
+
+	return ret;
+}
+
+static bool uart_data_write(const uint8_t *data, size_t len)
+{
+	return tx_buf_put(data, len);
+}
+
+static int uart_info_write(const char *data, size_t len)
+{
+	uint8_t retry_cnt = 0;
+	static const uint8_t retry_cnt_max = 100;
+
+	while (!tx_buf_put((const uint8_t *)data, len)) {
+		/* Give the UART time to drain the buffer. */
+		k_sleep(K_MSEC(100));
+
+		retry_cnt++;
+		if (retry_cnt > retry_cnt_max) {
+			return -ENOBUFS;
+		}
+	}
+
+	return 0;
+}
+
+static bool uart_command_read(uint8_t *command)
+{
+	unsigned int key = irq_lock();
+	uint32_t len = ring_buf_get(&cmd_buf, command, sizeof(*command));
+
+	irq_unlock(key);
+
+	return (len > 0);
+}
+
+static void uart_flush(void)
+{
+	uint8_t retry_cnt = 0;
+	static const uint8_t retry_cnt_max = 100;
+
+	while (!ring_buf_is_empty(&tx_buf) && (retry_cnt < retry_cnt_max)) {
+		k_sleep(K_MSEC(10));
+		retry_cnt++;
+	}
+}
+
+const struct nrf_profiler_backend nrf_profiler_backend = {
+	.init = uart_backend_init,
+	.data_write = uart_data_write,
+	.info_write = uart_info_write,
+	.command_read = uart_command_read,
+	.flush = uart_flush,
+};
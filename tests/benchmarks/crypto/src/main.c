@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/ztest.h>
+#include <psa/crypto.h>
+
+#if defined(CONFIG_PSA_CRYPTO_DRIVER_CC3XX) && defined(CONFIG_PSA_CRYPTO_DRIVER_OBERON)
+#define DRIVER_NAME "cc3xx+oberon"
+#elif defined(CONFIG_PSA_CRYPTO_DRIVER_CC3XX)
+#define DRIVER_NAME "cc3xx"
+#elif defined(CONFIG_PSA_CRYPTO_DRIVER_OBERON)
+#define DRIVER_NAME "oberon"
+#else
+#define DRIVER_NAME "builtin"
+#endif
+
+#define MSG_SIZE_MAX CONFIG_CRYPTO_BENCHMARK_MSG_SIZE_MAX
+#define ITERATIONS CONFIG_CRYPTO_BENCHMARK_ITERATIONS
+#define ASYM_ITERATIONS CONFIG_CRYPTO_BENCHMARK_ASYM_ITERATIONS
+
+#define AES_KEY_BITS 128
+#define CHACHA20_KEY_BITS 256
+#define HMAC_KEY_BITS 256
+#define P256_KEY_BITS 256
+#define ED25519_KEY_BITS 255
+
+#define CCM_NONCE_LEN 13
+#define GCM_NONCE_LEN 12
+#define CHACHA20_POLY1305_NONCE_LEN 12
+#define CTR_IV_LEN 16
+#define NONCE_MAX_LEN 16
+
+/* Length of the hash, or the message in case of EdDSA, which is signed. */
+#define SIGNED_DATA_LEN 32
+
+/* Hash large enough for every hash algorithm in the benchmark. */
+#define HASH_MAX_LEN 64
+
+/** Benchmarked operation, processing the first @p len bytes of the message. */
+typedef psa_status_t (*bench_op_t)(size_t len);
+
+static const size_t msg_sizes[] = {16, 64, 256, 1024, 4096};
+
+static uint8_t msg[MSG_SIZE_MAX];
+static uint8_t out[MAX(MSG_SIZE_MAX + PSA_AEAD_TAG_MAX_SIZE, HASH_MAX_LEN)];
+static uint8_t nonce[NONCE_MAX_LEN];
+static size_t nonce_len;
+
+static uint8_t sig[PSA_SIGNATURE_MAX_SIZE];
+static size_t sig_len;
+static uint8_t peer_pub_key[PSA_EXPORT_PUBLIC_KEY_MAX_SIZE];
+static size_t peer_pub_key_len;
+
+static psa_key_id_t key_id;
+static psa_key_id_t peer_key_id;
+static psa_algorithm_t alg;
+
+static void bench_report(const char *name, const char *op, size_t len, uint32_t iterations,
+			 uint64_t cycles)
+{
+	uint64_t ns = timing_cycles_to_ns(cycles);
+	uint64_t bytes_per_s = ns ? ((uint64_t)len * iterations * NSEC_PER_SEC) / ns : 0;
+
+	printk("BENCH,%s,%s,%s,%zu,%u,%llu,%llu,%llu\n", DRIVER_NAME, name, op, len, iterations,
+	       cycles / iterations, ns / iterations, bytes_per_s);
+}
+
+static psa_status_t bench_run(const char *name, const char *op, bench_op_t fn, size_t len,
+			      uint32_t iterations)
+{
+	timing_t start;
+	timing_t end;
+	psa_status_t status;
+
+	/* Warm-up run, which also reveals operations not supported by the driver. */
+	status = fn(len);
+	if (status != PSA_SUCCESS) {
+		return status;
+	}
+
+	start = timing_counter_get();
+
+	for (uint32_t i = 0; i < iterations; i++) {
+		status = fn(len);
+		if (status != PSA_SUCCESS) {
+			return status;
+		}
+	}
+
+	end = timing_counter_get();
+
+	bench_report(name, op, len, iterations, timing_cycles_get(&start, &end));
+
+	return PSA_SUCCESS;
+}
+
+static void bench_check(const char *name, psa_status_t status)
+{
+	if (status == PSA_ERROR_NOT_SUPPORTED) {
+		printk("BENCH_SKIP,%s,%s\n", DRIVER_NAME, name);
+		ztest_test_skip();
+	}
+
+	zassert_equal(status, PSA_SUCCESS, "%s failed (err: %d)", name, status);
+}
+
+static void bench_sizes(const char *name, const char *op, bench_op_t fn)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(msg_sizes); i++) {
+		if (msg_sizes[i] > MSG_SIZE_MAX) {
+			break;
+		}
+
+		bench_check(name, bench_run(name, op, fn, msg_sizes[i], ITERATIONS));
+	}
+}
+
+static psa_status_t key_generate(psa_key_id_t *id, psa_key_type_t type, size_t bits,
+				 psa_key_usage_t usage, psa_algorithm_t key_alg)
+{
+	psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+	psa_status_t status;
+
+	psa_set_key_type(&attr, type);
+	psa_set_key_bits(&attr, bits);
+	psa_set_key_usage_flags(&attr, usage);
+	psa_set_key_algorithm(&attr, key_alg);
+
+	status = psa_generate_key(&attr, id);
+	psa_reset_key_attributes(&attr);
+
+	return status;
+}
+
+static psa_status_t aead_encrypt(size_t len)
+{
+	size_t out_len;
+
+	return psa_aead_encrypt(key_id, alg, nonce, nonce_len, NULL, 0, msg, len, out,
+				sizeof(out), &out_len);
+}
+
+static psa_status_t cipher_encrypt(size_t len)
+{
+	psa_cipher_operation_t op = PSA_CIPHER_OPERATION_INIT;
+	psa_status_t status;
+	size_t out_len;
+	size_t finish_len;
+
+	/* Multi-part API with a fixed IV, so random number generation is not measured. */
+	status = psa_cipher_encrypt_setup(&op, key_id, alg);
+	if (status == PSA_SUCCESS) {
+		status = psa_cipher_set_iv(&op, nonce, nonce_len);
+	}
+	if (status == PSA_SUCCESS) {
+		status = psa_cipher_update(&op, msg, len, out, sizeof(out), &out_len);
+	}
+	if (status == PSA_SUCCESS) {
+		status = psa_cipher_finish(&op, &out[out_len], sizeof(out) - out_len,
+					   &finish_len);
+	}
+	if (status != PSA_SUCCESS) {
+		psa_cipher_abort(&op);
+	}
+
+	return status;
+}
+
+static psa_status_t hash_compute(size_t len)
+{
+	size_t out_len;
+
+	return psa_hash_compute(alg, msg, len, out, sizeof(out), &out_len);
+}
+
+static psa_status_t mac_compute(size_t len)
+{
+	size_t out_len;
+
+	return psa_mac_compute(key_id, alg, msg, len, out, sizeof(out), &out_len);
+}
+
+static psa_status_t hash_sign(size_t len)
+{
+	return psa_sign_hash(key_id, alg, msg, len, sig, sizeof(sig), &sig_len);
+}
+
+static psa_status_t hash_verify(size_t len)
+{
+	return psa_verify_hash(key_id, alg, msg, len, sig, sig_len);
+}
+
+static psa_status_t message_sign(size_t len)
+{
+	return psa_sign_message(key_id, alg, msg, len, sig, sizeof(sig), &sig_len);
+}
+
+static psa_status_t message_verify(size_t len)
+{
+	return psa_verify_message(key_id, alg, msg, len, sig, sig_len);
+}
+
+static psa_status_t key_agreement(size_t len)
+{
+	size_t out_len;
+
+	ARG_UNUSED(len);
+
+	return psa_raw_key_agreement(alg, key_id, peer_pub_key, peer_pub_key_len, out,
+				     sizeof(out), &out_len);
+}
+
+static void aead_bench(const char *name, psa_key_type_t type, size_t bits,
+		       psa_algorithm_t aead_alg, size_t aead_nonce_len)
+{
+	alg = aead_alg;
+	nonce_len = aead_nonce_len;
+
+	bench_check(name, key_generate(&key_id, type, bits, PSA_KEY_USAGE_ENCRYPT, alg));
+	bench_sizes(name, "encrypt", aead_encrypt);
+}
+
+static void hash_bench(const char *name, psa_algorithm_t hash_alg)
+{
+	alg = hash_alg;
+
+	bench_sizes(name, "hash", hash_compute);
+}
+
+static void *crypto_benchmark_setup(void)
+{
+	zassert_equal(psa_crypto_init(), PSA_SUCCESS, "PSA crypto init failed");
+	zassert_equal(psa_generate_random(msg, sizeof(msg)), PSA_SUCCESS,
+		      "Random message generation failed");
+	zassert_equal(psa_generate_random(nonce, sizeof(nonce)), PSA_SUCCESS,
+		      "Random nonce generation failed");
+
+	timing_init();
+	timing_start();
+
+	printk("Timing frequency: %llu Hz\n", timing_freq_get());
+	printk("BENCH,driver,algorithm,operation,size,iterations,cycles_per_op,ns_per_op,"
+	       "bytes_per_s\n");
+
+	return NULL;
+}
+
+static void crypto_benchmark_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	psa_destroy_key(key_id);
+	psa_destroy_key(peer_key_id);
+
+	key_id = PSA_KEY_ID_NULL;
+	peer_key_id = PSA_KEY_ID_NULL;
+}
+
+static void crypto_benchmark_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	timing_stop();
+}
+
+ZTEST(crypto_benchmark, test_aes_ccm)
+{
+	aead_bench("aes-128-ccm", PSA_KEY_TYPE_AES, AES_KEY_BITS,
+		   PSA_ALG_CCM, CCM_NONCE_LEN);
+}
+
+ZTEST(crypto_benchmark, test_aes_gcm)
+{
+	aead_bench("aes-128-gcm", PSA_KEY_TYPE_AES, AES_KEY_BITS,
+		   PSA_ALG_GCM, GCM_NONCE_LEN);
+}
+
+ZTEST(crypto_benchmark, test_chacha20_poly1305)
+{
+	aead_bench("chacha20-poly1305", PSA_KEY_TYPE_CHACHA20, CHACHA20_KEY_BITS,
+		   PSA_ALG_CHACHA20_POLY1305, CHACHA20_POLY1305_NONCE_LEN);
+}
+
+ZTEST(crypto_benchmark, test_aes_ctr)
+{
+	alg = PSA_ALG_CTR;
+	nonce_len = CTR_IV_LEN;
+
+	bench_check("aes-128-ctr", key_generate(&key_id, PSA_KEY_TYPE_AES, AES_KEY_BITS,
+						PSA_KEY_USAGE_ENCRYPT, alg));
+	bench_sizes("aes-128-ctr", "encrypt", cipher_encrypt);
+}
+
+ZTEST(crypto_benchmark, test_sha256)
+{
+	hash_bench("sha-256", PSA_ALG_SHA_256);
+}
+
+ZTEST(crypto_benchmark, test_sha512)
+{
+	hash_bench("sha-512", PSA_ALG_SHA_512);
+}
+
+ZTEST(crypto_benchmark, test_hmac_sha256)
+{
+	alg = PSA_ALG_HMAC(PSA_ALG_SHA_256);
+
+	bench_check("hmac-sha-256", key_generate(&key_id, PSA_KEY_TYPE_HMAC, HMAC_KEY_BITS,
+						 PSA_KEY_USAGE_SIGN_MESSAGE, alg));
+	bench_sizes("hmac-sha-256", "mac", mac_compute);
+}
+
+ZTEST(crypto_benchmark, test_ecdsa_p256)
+{
+	alg = PSA_ALG_ECDSA(PSA_ALG_SHA_256);
+
+	bench_check("ecdsa-p256",
+		    key_generate(&key_id, PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1),
+				 P256_KEY_BITS,
+				 PSA_KEY_USAGE_SIGN_HASH | PSA_KEY_USAGE_VERIFY_HASH, alg));
+	bench_check("ecdsa-p256", bench_run("ecdsa-p256", "sign", hash_sign, SIGNED_DATA_LEN,
+					    ASYM_ITERATIONS));
+	bench_check("ecdsa-p256", bench_run("ecdsa-p256", "verify", hash_verify,
+					    SIGNED_DATA_LEN, ASYM_ITERATIONS));
+}
+
+ZTEST(crypto_benchmark, test_ecdh_p256)
+{
+	psa_key_type_t type = PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1);
+
+	alg = PSA_ALG_ECDH;
+
+	bench_check("ecdh-p256", key_generate(&key_id, type, P256_KEY_BITS,
+					      PSA_KEY_USAGE_DERIVE, alg));
+	bench_check("ecdh-p256", key_generate(&peer_key_id, type, P256_KEY_BITS,
+					      PSA_KEY_USAGE_DERIVE, alg));
+	bench_check("ecdh-p256", psa_export_public_key(peer_key_id, peer_pub_key,
+						       sizeof(peer_pub_key),
+						       &peer_pub_key_len));
+	bench_check("ecdh-p256", bench_run("ecdh-p256", "agree", key_agreement,
+					   P256_KEY_BITS / 8, ASYM_ITERATIONS));
+}
+
+ZTEST(crypto_benchmark, test_ed25519)
+{
+	alg = PSA_ALG_PURE_EDDSA;
+
+	bench_check("ed25519",
+		    key_generate(&key_id,
+				 PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_TWISTED_EDWARDS),
+				 ED25519_KEY_BITS,
+				 PSA_KEY_USAGE_SIGN_MESSAGE | PSA_KEY_USAGE_VERIFY_MESSAGE,
+				 alg));
+	bench_check("ed25519", bench_run("ed25519", "sign", message_sign, SIGNED_DATA_LEN,
+					 ASYM_ITERATIONS));
+	bench_check("ed25519", bench_run("ed25519", "verify", message_verify, SIGNED_DATA_LEN,
+					 ASYM_ITERATIONS));
+}
+
+ZTEST_SUITE(crypto_benchmark, NULL, crypto_benchmark_setup, NULL, crypto_benchmark_after,
+	    crypto_benchmark_teardown);
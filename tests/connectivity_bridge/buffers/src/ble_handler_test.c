@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* The module is included to check the number of UART buffer blocks it holds. */
+#include "ble_handler.c"
+
+#include <zephyr/ztest.h>
+
+#include "bridge_test.h"
+
+#define TEST_CHUNK_LEN 16
+#define TEST_PATH BRIDGE_STATS_UART_0_TO_BLE
+
+/* Connection objects are never dereferenced by the tested module. */
+static uint8_t conn_mem;
+
+/* Error returned by every NUS send, or -ENOMEM once the budget is used up. */
+static int nus_send_err;
+static size_t nus_send_budget;
+static size_t nus_sent_len;
+
+int bt_nus_init(struct bt_nus_cb *callbacks)
+{
+	return 0;
+}
+
+int bt_nus_send(struct bt_conn *conn, const uint8_t *data, uint16_t len)
+{
+	zassert_equal_ptr(conn, current_conn, "Unexpected connection");
+
+	if (nus_send_err) {
+		return nus_send_err;
+	}
+
+	if (nus_send_budget == 0) {
+		return -ENOMEM;
+	}
+
+	nus_send_budget--;
+	nus_sent_len += len;
+
+	return 0;
+}
+
+static void tx_wait(void)
+{
+	struct k_work_sync sync;
+
+	(void)k_work_flush(&bt_send_work, &sync);
+}
+
+static void tx_resume(void)
+{
+	k_work_submit(&bt_send_work);
+	tx_wait();
+}
+
+/* Pass UART_0 data as the UART handler does. The data event holds a reference,
+ * which is released once all subscribers have handled the event.
+ */
+static void uart_data_pass(uint8_t *buf, size_t len)
+{
+	struct uart_data_event *event = new_uart_data_event();
+
+	event->dev_idx = 0;
+	event->buf = buf;
+	event->len = len;
+	event->timestamp = 0;
+
+	bridge_buf_ref(buf);
+	app_event_handler(&event->header);
+	bridge_buf_unref(buf);
+
+	app_event_manager_free(event);
+
+	tx_wait();
+}
+
+static uint32_t buf_free_count(void)
+{
+	return k_mem_slab_num_free_get(&bridge_buf_slab);
+}
+
+static void ble_handler_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	current_conn = (struct bt_conn *)&conn_mem;
+	nus_max_send_len = TEST_CHUNK_LEN;
+	nus_send_err = 0;
+	nus_send_budget = SIZE_MAX;
+	nus_sent_len = 0;
+	stats_reset();
+}
+
+static void ble_handler_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	tx_queue_purge();
+	atomic_set(&tx_flush, false);
+	current_conn = NULL;
+}
+
+ZTEST(ble_handler, test_chunks_same_block)
+{
+	uint8_t *buf = bridge_buf_alloc();
+
+	zassert_not_null(buf, "Allocation failed");
+
+	nus_send_err = -ENOMEM;
+
+	for (size_t i = 0; i < 3; i++) {
+		uart_data_pass(&buf[i * TEST_CHUNK_LEN], TEST_CHUNK_LEN);
+	}
+
+	zassert_equal(k_msgq_num_used_get(&ble_tx_queue), 3, "Chunks not queued");
+	zassert_equal(tx_bufs_held, 1, "Chunks of the same block counted separately");
+
+	/* The UART is done with the block, only the queued chunks hold it. */
+	bridge_buf_unref(buf);
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT - 1, "Block freed with queued chunks");
+
+	nus_send_err = 0;
+	tx_resume();
+
+	zassert_equal(nus_sent_len, 3 * TEST_CHUNK_LEN, "Data not sent");
+	zassert_equal(stats_sent[TEST_PATH], 3 * TEST_CHUNK_LEN, "Sent data not counted");
+	zassert_equal(tx_bufs_held, 0, "Block still counted after sending");
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT, "Block not freed after sending");
+}
+
+ZTEST(ble_handler, test_chunks_block_limit)
+{
+	uint8_t *bufs[BLE_TX_BUF_MAX + 1];
+
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = bridge_buf_alloc();
+		zassert_not_null(bufs[i], "Allocation failed");
+	}
+
+	nus_send_err = -ENOMEM;
+
+	for (size_t i = 0; i < BLE_TX_BUF_MAX; i++) {
+		uart_data_pass(bufs[i], TEST_CHUNK_LEN);
+	}
+
+	zassert_equal(tx_bufs_held, BLE_TX_BUF_MAX, "Invalid number of held blocks");
+
+	/* Another block would take one needed for UART reception. */
+	uart_data_pass(bufs[BLE_TX_BUF_MAX], TEST_CHUNK_LEN);
+	zassert_equal(k_msgq_num_used_get(&ble_tx_queue), BLE_TX_BUF_MAX,
+		      "Chunk of another block queued");
+	zassert_equal(stats_dropped[TEST_PATH], TEST_CHUNK_LEN, "Dropped data not counted");
+
+	/* More data in the last block does not hold another one. */
+	uart_data_pass(&bufs[BLE_TX_BUF_MAX - 1][TEST_CHUNK_LEN], TEST_CHUNK_LEN);
+	zassert_equal(k_msgq_num_used_get(&ble_tx_queue), BLE_TX_BUF_MAX + 1,
+		      "Chunk of the last block not queued");
+	zassert_equal(tx_bufs_held, BLE_TX_BUF_MAX, "Invalid number of held blocks");
+
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bridge_buf_unref(bufs[i]);
+	}
+
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT - BLE_TX_BUF_MAX,
+		      "Invalid number of free blocks");
+
+	nus_send_err = 0;
+	tx_resume();
+
+	zassert_equal(nus_sent_len, (BLE_TX_BUF_MAX + 1) * TEST_CHUNK_LEN, "Data not sent");
+	zassert_equal(tx_bufs_held, 0, "Blocks still counted after sending");
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT, "Blocks not freed after sending");
+}
+
+ZTEST(ble_handler, test_queue_purge)
+{
+	uint8_t *a = bridge_buf_alloc();
+	uint8_t *b = bridge_buf_alloc();
+
+	zassert_not_null(a, "Allocation failed");
+	zassert_not_null(b, "Allocation failed");
+
+	/* Only the first half of the first chunk is sent. */
+	nus_max_send_len = TEST_CHUNK_LEN / 2;
+	nus_send_budget = 1;
+
+	uart_data_pass(a, TEST_CHUNK_LEN);
+	uart_data_pass(&a[TEST_CHUNK_LEN], TEST_CHUNK_LEN);
+	uart_data_pass(b, TEST_CHUNK_LEN);
+
+	zassert_equal(nus_sent_len, TEST_CHUNK_LEN / 2, "Invalid amount of sent data");
+	zassert_equal(tx_bufs_held, 2, "Invalid number of held blocks");
+
+	bridge_buf_unref(a);
+	bridge_buf_unref(b);
+
+	/* The peer has not enabled notifications, the queued data is dropped. */
+	nus_send_err = -EINVAL;
+	tx_resume();
+
+	zassert_equal(k_msgq_num_used_get(&ble_tx_queue), 0, "Queue not purged");
+	zassert_equal(stats_dropped[TEST_PATH], 3 * TEST_CHUNK_LEN - TEST_CHUNK_LEN / 2,
+		      "Invalid amount of dropped data");
+	zassert_equal(tx_bufs_held, 0, "Blocks still counted after purge");
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT, "Blocks not freed after purge");
+}
+
+ZTEST(ble_handler, test_queue_flush)
+{
+	uint8_t *a = bridge_buf_alloc();
+	uint8_t *b = bridge_buf_alloc();
+
+	zassert_not_null(a, "Allocation failed");
+	zassert_not_null(b, "Allocation failed");
+
+	nus_send_err = -ENOMEM;
+
+	uart_data_pass(a, TEST_CHUNK_LEN);
+	uart_data_pass(b, TEST_CHUNK_LEN);
+	uart_data_pass(&b[TEST_CHUNK_LEN], TEST_CHUNK_LEN);
+
+	bridge_buf_unref(a);
+	bridge_buf_unref(b);
+
+	/* Queued data is flushed on disconnection. */
+	atomic_set(&tx_flush, true);
+	nus_send_err = 0;
+	tx_resume();
+
+	zassert_equal(nus_sent_len, 0, "Flushed data sent");
+	zassert_equal(stats_dropped[TEST_PATH], 3 * TEST_CHUNK_LEN,
+		      "Invalid amount of dropped data");
+	zassert_equal(tx_bufs_held, 0, "Blocks still counted after flush");
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT, "Blocks not freed after flush");
+
+	/* Data passed after the flush holds a block again. */
+	a = bridge_buf_alloc();
+	zassert_not_null(a, "Allocation failed");
+
+	nus_send_err = -ENOMEM;
+	uart_data_pass(a, TEST_CHUNK_LEN);
+	zassert_equal(tx_bufs_held, 1, "Invalid number of held blocks");
+
+	bridge_buf_unref(a);
+	nus_send_err = 0;
+	tx_resume();
+
+	zassert_equal(tx_bufs_held, 0, "Block still counted after sending");
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT, "Block not freed after sending");
+}
+
+ZTEST_SUITE(ble_handler, NULL, NULL, ble_handler_before, ble_handler_after, NULL);
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _BRIDGE_TEST_H_
+#define _BRIDGE_TEST_H_
+
+#include <zephyr/kernel.h>
+
+#include "bridge_stats.h"
+
+/* Buffer blocks shared by both UART instances. */
+#define TEST_BUF_COUNT (2 * CONFIG_BRIDGE_UART_BUF_COUNT)
+
+extern struct k_mem_slab bridge_buf_slab;
+
+/* Number of bytes reported to the statistics for every path. */
+extern size_t stats_sent[BRIDGE_STATS_PATH_COUNT];
+extern size_t stats_dropped[BRIDGE_STATS_PATH_COUNT];
+
+void stats_reset(void);
+
+#endif /* _BRIDGE_TEST_H_ */
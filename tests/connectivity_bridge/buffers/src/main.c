@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "bridge_buf.h"
+#include "bridge_test.h"
+
+#define MODULE main
+#include "module_state_event.h"
+
+size_t stats_sent[BRIDGE_STATS_PATH_COUNT];
+size_t stats_dropped[BRIDGE_STATS_PATH_COUNT];
+
+void bridge_stats_sent(enum bridge_stats_path path, size_t len, uint32_t rx_timestamp)
+{
+	zassert_true(path < BRIDGE_STATS_PATH_COUNT, "Invalid path");
+
+	stats_sent[path] += len;
+}
+
+void bridge_stats_dropped(enum bridge_stats_path path, size_t len)
+{
+	zassert_true(path < BRIDGE_STATS_PATH_COUNT, "Invalid path");
+
+	stats_dropped[path] += len;
+}
+
+void stats_reset(void)
+{
+	memset(stats_sent, 0, sizeof(stats_sent));
+	memset(stats_dropped, 0, sizeof(stats_dropped));
+}
+
+static uint32_t buf_free_count(void)
+{
+	return k_mem_slab_num_free_get(&bridge_buf_slab);
+}
+
+ZTEST(bridge_buf, test_alloc_all)
+{
+	uint8_t *bufs[TEST_BUF_COUNT];
+
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = bridge_buf_alloc();
+		zassert_not_null(bufs[i], "Allocation failed");
+	}
+
+	zassert_is_null(bridge_buf_alloc(), "Allocated more blocks than in the pool");
+
+	/* A single reference is taken on allocation. */
+	bridge_buf_unref(bufs[0]);
+	zassert_equal(buf_free_count(), 1, "Block not freed");
+
+	bufs[0] = bridge_buf_alloc();
+	zassert_not_null(bufs[0], "Freed block not reused");
+
+	for (size_t i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bridge_buf_unref(bufs[i]);
+	}
+
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT, "Blocks not freed");
+}
+
+ZTEST(bridge_buf, test_ref_within_block)
+{
+	uint8_t *buf = bridge_buf_alloc();
+
+	zassert_not_null(buf, "Allocation failed");
+
+	/* References are taken and released with pointers to the received data. */
+	bridge_buf_ref(&buf[1]);
+	bridge_buf_ref(&buf[BRIDGE_BUF_DATA_SIZE - 1]);
+
+	bridge_buf_unref(buf);
+	bridge_buf_unref(&buf[BRIDGE_BUF_DATA_SIZE - 1]);
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT - 1, "Referenced block freed");
+
+	bridge_buf_unref(&buf[1]);
+	zassert_equal(buf_free_count(), TEST_BUF_COUNT, "Block not freed");
+}
+
+ZTEST(bridge_buf, test_same)
+{
+	uint8_t *a = bridge_buf_alloc();
+	uint8_t *b = bridge_buf_alloc();
+
+	zassert_not_null(a, "Allocation failed");
+	zassert_not_null(b, "Allocation failed");
+
+	zassert_true(bridge_buf_same(a, &a[BRIDGE_BUF_DATA_SIZE - 1]), "Block not matched");
+	zassert_true(bridge_buf_same(&b[1], &b[2]), "Block not matched");
+	zassert_false(bridge_buf_same(a, b), "Different blocks matched");
+	zassert_false(bridge_buf_same(&a[BRIDGE_BUF_DATA_SIZE - 1], b),
+		      "Different blocks matched");
+
+	bridge_buf_unref(a);
+	bridge_buf_unref(b);
+}
+
+ZTEST_SUITE(bridge_buf, NULL, NULL, NULL, NULL, NULL);
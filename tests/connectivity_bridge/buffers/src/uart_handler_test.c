@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* The module is included to drive the transmission as the UART driver would. */
+#include "uart_handler.c"
+
+#include <zephyr/ztest.h>
+
+#include "bridge_test.h"
+
+#define TEST_DEV_IDX 0
+#define TEST_PATH BRIDGE_STATS_CDC_TO_UART(TEST_DEV_IDX)
+
+static uint8_t test_data[UART_BUF_SIZE];
+
+/* Report the given number of bytes from the TX ringbuffer as transmitted. */
+static void uart_tx_done(size_t len)
+{
+	uint8_t *buf;
+
+	zassert_equal(ring_buf_get_claim(&uart_tx_ringbufs[TEST_DEV_IDX].rb, &buf, len), len,
+		      "Not enough data to transmit");
+
+	uart_tx_finish(TEST_DEV_IDX, len);
+}
+
+static void uart_tx_enqueue_check(size_t len)
+{
+	zassert_ok(uart_tx_enqueue(test_data, len, TEST_DEV_IDX, TEST_PATH, 0),
+		   "Data not enqueued");
+}
+
+static void uart_handler_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	ring_buf_init(&uart_tx_ringbufs[TEST_DEV_IDX].rb,
+		      sizeof(uart_tx_ringbufs[TEST_DEV_IDX].buf),
+		      uart_tx_ringbufs[TEST_DEV_IDX].buf);
+	k_msgq_init(&uart_tx_segs[TEST_DEV_IDX].msgq, uart_tx_segs[TEST_DEV_IDX].msgq_buf,
+		    sizeof(struct uart_tx_seg), UART_TX_SEG_COUNT);
+	uart_tx_segs[TEST_DEV_IDX].offset = 0;
+	atomic_set(&uart_tx_started[TEST_DEV_IDX], false);
+	stats_reset();
+}
+
+ZTEST(uart_handler, test_tx_segs_partial)
+{
+	uart_tx_enqueue_check(10);
+	uart_tx_enqueue_check(20);
+	uart_tx_enqueue_check(5);
+
+	/* The transmission ends within the second segment. */
+	uart_tx_done(15);
+	zassert_equal(stats_sent[TEST_PATH], 15, "Invalid amount of sent data");
+	zassert_equal(k_msgq_num_used_get(&uart_tx_segs[TEST_DEV_IDX].msgq), 2,
+		      "Finished segment not released");
+	zassert_equal(uart_tx_segs[TEST_DEV_IDX].offset, 5, "Invalid segment offset");
+
+	/* Aborted without transmitting anything. */
+	uart_tx_done(0);
+	zassert_equal(stats_sent[TEST_PATH], 15, "Invalid amount of sent data");
+
+	uart_tx_done(20);
+	zassert_equal(stats_sent[TEST_PATH], 35, "Invalid amount of sent data");
+	zassert_equal(k_msgq_num_used_get(&uart_tx_segs[TEST_DEV_IDX].msgq), 0,
+		      "Finished segments not released");
+	zassert_equal(uart_tx_segs[TEST_DEV_IDX].offset, 0, "Invalid segment offset");
+}
+
+ZTEST(uart_handler, test_tx_segs_full)
+{
+	for (size_t i = 0; i < UART_TX_SEG_COUNT; i++) {
+		uart_tx_enqueue_check(1);
+	}
+
+	/* Data is not enqueued without a segment to record its statistics. */
+	zassert_equal(uart_tx_enqueue(test_data, 1, TEST_DEV_IDX, TEST_PATH, 0), -ENOMEM,
+		      "Data enqueued without a free segment");
+	zassert_equal(stats_dropped[TEST_PATH], 1, "Dropped data not counted");
+
+	uart_tx_done(UART_TX_SEG_COUNT);
+	zassert_equal(stats_sent[TEST_PATH], UART_TX_SEG_COUNT, "Invalid amount of sent data");
+	zassert_equal(k_msgq_num_used_get(&uart_tx_segs[TEST_DEV_IDX].msgq), 0,
+		      "Finished segments not released");
+}
+
+ZTEST(uart_handler, test_tx_ringbuf_full)
+{
+	uart_tx_enqueue_check(UART_BUF_SIZE - 4);
+
+	/* Only the data that fits is enqueued, and recorded in the segment. */
+	zassert_equal(uart_tx_enqueue(test_data, 8, TEST_DEV_IDX, TEST_PATH, 0), -ENOMEM,
+		      "Data enqueued without space");
+	zassert_equal(stats_dropped[TEST_PATH], 4, "Dropped data not counted");
+
+	uart_tx_done(UART_BUF_SIZE);
+	zassert_equal(stats_sent[TEST_PATH], UART_BUF_SIZE, "Invalid amount of sent data");
+	zassert_equal(k_msgq_num_used_get(&uart_tx_segs[TEST_DEV_IDX].msgq), 0,
+		      "Finished segments not released");
+}
+
+ZTEST_SUITE(uart_handler, NULL, NULL, uart_handler_before, NULL, NULL);
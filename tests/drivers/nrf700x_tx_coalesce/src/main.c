@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "hal_tx_coalesce.h"
+
+#define RPU_MEM_SIZE 8192
+#define STAGING_BUF_SIZE 2048
+#define TX_BUF_HEADROOM 52
+#define FRAME_LEN 320
+#define NUM_FRAMES 4
+
+/* Mock bus, counts the write transactions and the bytes written */
+struct mock_bus {
+	uint8_t mem[RPU_MEM_SIZE];
+	unsigned int writes;
+	unsigned int bytes;
+};
+
+static struct mock_bus bus;
+static struct mock_bus ref_bus;
+static uint8_t staging_buf[STAGING_BUF_SIZE];
+static uint8_t frames[NUM_FRAMES][FRAME_LEN];
+static struct hal_tx_coalesce txc;
+
+void *wifi_nrf_osal_mem_cpy(struct wifi_nrf_osal_priv *opriv,
+			     void *dest,
+			     const void *src,
+			     size_t count)
+{
+	return memcpy(dest, src, count);
+}
+
+void *wifi_nrf_osal_mem_set(struct wifi_nrf_osal_priv *opriv,
+			     void *start,
+			     int val,
+			     size_t size)
+{
+	return memset(start, val, size);
+}
+
+static enum wifi_nrf_status mock_bus_write(void *ctx,
+					   unsigned int rpu_addr,
+					   void *data,
+					   unsigned int len)
+{
+	struct mock_bus *mock = ctx;
+
+	zassert_true(rpu_addr + len <= RPU_MEM_SIZE, "Write out of bounds");
+
+	memcpy(&mock->mem[rpu_addr], data, len);
+	mock->writes++;
+	mock->bytes += len;
+
+	return WIFI_NRF_STATUS_SUCCESS;
+}
+
+/* Places the frames like wifi_nrf_hal_buf_map_tx() does for one aggregate */
+static unsigned int frame_addr(unsigned int base, unsigned int idx, unsigned int len)
+{
+	return base + idx * (len + TX_BUF_HEADROOM);
+}
+
+static void write_aggregate(unsigned int base, unsigned int num_frames, unsigned int len)
+{
+	for (unsigned int i = 0; i < num_frames; i++) {
+		unsigned int addr = frame_addr(base, i, len);
+
+		zassert_equal(hal_tx_coalesce_add(&txc, addr, frames[i % NUM_FRAMES], len,
+						  mock_bus_write, &bus),
+			      WIFI_NRF_STATUS_SUCCESS);
+		mock_bus_write(&ref_bus, addr, frames[i % NUM_FRAMES], len);
+	}
+
+	zassert_equal(hal_tx_coalesce_flush(&txc, mock_bus_write, &bus),
+		      WIFI_NRF_STATUS_SUCCESS);
+}
+
+static void assert_frames_written(unsigned int base, unsigned int num_frames, unsigned int len)
+{
+	for (unsigned int i = 0; i < num_frames; i++) {
+		unsigned int addr = frame_addr(base, i, len);
+
+		zassert_mem_equal(&bus.mem[addr], &ref_bus.mem[addr], len,
+				  "Frame %u differs", i);
+	}
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&bus, 0, sizeof(bus));
+	memset(&ref_bus, 0, sizeof(ref_bus));
+
+	for (int i = 0; i < NUM_FRAMES; i++) {
+		memset(frames[i], 0xa0 + i, FRAME_LEN);
+	}
+
+	hal_tx_coalesce_init(&txc, NULL, staging_buf, sizeof(staging_buf));
+}
+
+ZTEST(nrf700x_tx_coalesce, test_aggregate_single_write)
+{
+	write_aggregate(0, NUM_FRAMES, FRAME_LEN);
+
+	assert_frames_written(0, NUM_FRAMES, FRAME_LEN);
+
+	/* One transaction instead of one per frame, covering the headroom gaps */
+	zassert_equal(bus.writes, 1);
+	zassert_equal(ref_bus.writes, NUM_FRAMES);
+	zassert_equal(bus.bytes, frame_addr(0, NUM_FRAMES - 1, FRAME_LEN) + FRAME_LEN);
+	zassert_equal(txc.stats.bus_writes, 1);
+	zassert_equal(txc.stats.frames, NUM_FRAMES);
+}
+
+ZTEST(nrf700x_tx_coalesce, test_staging_buffer_full)
+{
+	unsigned int num_frames = 2 * NUM_FRAMES;
+
+	write_aggregate(0, num_frames, FRAME_LEN);
+
+	assert_frames_written(0, num_frames, FRAME_LEN);
+
+	/* Only five frames fit in the staging buffer */
+	zassert_equal(bus.writes, 2);
+	zassert_equal(ref_bus.writes, num_frames);
+}
+
+ZTEST(nrf700x_tx_coalesce, test_non_contiguous_frame_flushes)
+{
+	zassert_equal(hal_tx_coalesce_add(&txc, 1024, frames[0], FRAME_LEN,
+					  mock_bus_write, &bus),
+		      WIFI_NRF_STATUS_SUCCESS);
+	zassert_equal(bus.writes, 0);
+
+	/* A frame placed before the staged one can not be appended */
+	zassert_equal(hal_tx_coalesce_add(&txc, 0, frames[1], FRAME_LEN,
+					  mock_bus_write, &bus),
+		      WIFI_NRF_STATUS_SUCCESS);
+	zassert_equal(bus.writes, 1);
+
+	zassert_equal(hal_tx_coalesce_flush(&txc, mock_bus_write, &bus),
+		      WIFI_NRF_STATUS_SUCCESS);
+	zassert_equal(bus.writes, 2);
+	zassert_mem_equal(&bus.mem[1024], frames[0], FRAME_LEN);
+	zassert_mem_equal(&bus.mem[0], frames[1], FRAME_LEN);
+}
+
+ZTEST(nrf700x_tx_coalesce, test_large_frame_written_directly)
+{
+	static uint8_t large_frame[STAGING_BUF_SIZE + 4];
+
+	memset(large_frame, 0x55, sizeof(large_frame));
+
+	zassert_equal(hal_tx_coalesce_add(&txc, 0, large_frame, sizeof(large_frame),
+					  mock_bus_write, &bus),
+		      WIFI_NRF_STATUS_SUCCESS);
+	zassert_equal(bus.writes, 1);
+	zassert_equal(bus.bytes, sizeof(large_frame));
+	zassert_equal(txc.len, 0);
+	zassert_mem_equal(bus.mem, large_frame, sizeof(large_frame));
+}
+
+ZTEST(nrf700x_tx_coalesce, test_no_staging_buffer)
+{
+	hal_tx_coalesce_init(&txc, NULL, NULL, 0);
+
+	write_aggregate(0, NUM_FRAMES, FRAME_LEN);
+
+	assert_frames_written(0, NUM_FRAMES, FRAME_LEN);
+	zassert_equal(bus.writes, ref_bus.writes);
+	zassert_equal(bus.bytes, ref_bus.bytes);
+}
+
+ZTEST(nrf700x_tx_coalesce, test_discard)
+{
+	zassert_equal(hal_tx_coalesce_add(&txc, 0, frames[0], FRAME_LEN,
+					  mock_bus_write, &bus),
+		      WIFI_NRF_STATUS_SUCCESS);
+
+	hal_tx_coalesce_discard(&txc);
+
+	zassert_equal(hal_tx_coalesce_flush(&txc, mock_bus_write, &bus),
+		      WIFI_NRF_STATUS_SUCCESS);
+	zassert_equal(bus.writes, 0);
+}
+
+ZTEST_SUITE(nrf700x_tx_coalesce, NULL, NULL, before, NULL, NULL);
@@ -423,6 +423,120 @@ void test_location_cellular_cancel_during_ncellmeas(void)
 	k_sleep(K_MSEC(1));
 }
 
+/********* CONCURRENT MODE TESTS ***********************/
+
+static void concurrent_config_set(struct location_config *config)
+{
+	enum location_method methods[] = {LOCATION_METHOD_GNSS, LOCATION_METHOD_CELLULAR};
+
+	location_config_defaults_set(config, 2, methods);
+	config->mode = LOCATION_REQ_MODE_CONCURRENT;
+	config->methods[0].gnss.timeout = 120 * MSEC_PER_SEC;
+	config->methods[0].gnss.accuracy = LOCATION_ACCURACY_NORMAL;
+	config->methods[1].cellular.cell_count = 2;
+}
+
+/* Starts a concurrent location request and lets GNSS start alongside the cellular scan. */
+static void concurrent_request_start(struct location_config *config)
+{
+	int err;
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEAS=2", 0);
+
+	__cmock_nrf_modem_gnss_event_handler_set_ExpectAndReturn(&method_gnss_event_handler, 0);
+	__cmock_nrf_modem_gnss_fix_interval_set_ExpectAndReturn(1, 0);
+	__cmock_nrf_modem_gnss_use_case_set_ExpectAndReturn(
+		NRF_MODEM_GNSS_USE_CASE_MULTIPLE_HOT_START, 0);
+	__cmock_nrf_modem_gnss_start_ExpectAndReturn(0);
+
+	__mock_nrf_modem_at_scanf_ExpectAndReturn(
+		"AT%XSYSTEMMODE?", "%%XSYSTEMMODE: %d,%d,%d,%d", 4);
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* LTE-M support */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* NB-IoT support */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(1); /* GNSS support */
+	__mock_nrf_modem_at_scanf_ReturnVarg_int(0); /* LTE preference */
+
+	err = location_request(config);
+	TEST_ASSERT_EQUAL(0, err);
+
+	/* Wait a bit so that NCELLMEAS is sent from the cloud location work queue */
+	k_sleep(K_MSEC(100));
+
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT%%XMONITOR", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(
+		(char *)xmonitor_resp, sizeof(xmonitor_resp));
+	at_monitor_dispatch("+CSCON: 0");
+	k_sleep(K_MSEC(1));
+}
+
+/* Test concurrent location request where cellular positioning finishes before GNSS. */
+void test_location_concurrent_cellular_first(void)
+{
+	struct location_config config = { 0 };
+
+	if (!IS_ENABLED(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)) {
+		TEST_IGNORE();
+	}
+
+	concurrent_config_set(&config);
+
+	test_location_event_data.id = LOCATION_EVT_LOCATION;
+	test_location_event_data.location.latitude = 61.50375;
+	test_location_event_data.location.longitude = 23.896979;
+	test_location_event_data.location.accuracy = 750.0;
+	test_location_event_data.location.datetime.valid = false;
+
+	location_callback_called_expected = true;
+
+	concurrent_request_start(&config);
+
+	__cmock_nrf_modem_at_cmd_ExpectAndReturn(NULL, 0, "AT+CGACT?", 0);
+	__cmock_nrf_modem_at_cmd_IgnoreArg_buf();
+	__cmock_nrf_modem_at_cmd_IgnoreArg_len();
+	__cmock_nrf_modem_at_cmd_ReturnArrayThruPtr_buf(
+		(char *)cgact_resp_active, sizeof(cgact_resp_active));
+
+	cellular_rest_req_resp_handle();
+
+	/* Select cellular service to be used */
+	rest_req_ctx.url = "here.api"; /* Needs a fix once rest_req_ctx is verified */
+	rest_req_ctx.sec_tag = CONFIG_LOCATION_SERVICE_HERE_TLS_SEC_TAG;
+	rest_req_ctx.port = HTTPS_PORT;
+	rest_req_ctx.host = CONFIG_LOCATION_SERVICE_HERE_HOSTNAME;
+
+	/* First location wins, so GNSS is stopped */
+	__cmock_nrf_modem_gnss_stop_ExpectAndReturn(0);
+
+	at_monitor_dispatch(ncellmeas_resp);
+}
+
+/* Test cancelling concurrent location request while both methods are running. */
+void test_location_concurrent_cancel(void)
+{
+	int err;
+	struct location_config config = { 0 };
+
+	if (!IS_ENABLED(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)) {
+		TEST_IGNORE();
+	}
+
+	concurrent_config_set(&config);
+	location_callback_called_expected = false;
+
+	concurrent_request_start(&config);
+
+	__cmock_nrf_modem_at_printf_ExpectAndReturn("AT%%NCELLMEASSTOP", 0);
+	__cmock_nrf_modem_gnss_stop_ExpectAndReturn(0);
+
+	err = location_request_cancel();
+	TEST_ASSERT_EQUAL(0, err);
+
+	/* The cancelled cloud location work returns without reporting anything */
+	k_sleep(K_MSEC(100));
+}
+
 /********* GENERAL ERROR TESTS ***********************/
 
 /* Test location request with unknown method. */
@@ -468,6 +582,37 @@ void test_error_too_many_methods(void)
 	TEST_ASSERT_EQUAL(-EINVAL, err);
 }
 
+/* Test location request with concurrent mode that is not enabled. */
+void test_error_concurrent_mode_not_enabled(void)
+{
+	int err;
+	struct location_config config = { 0 };
+	enum location_method methods[] = {LOCATION_METHOD_GNSS, LOCATION_METHOD_CELLULAR};
+
+	if (IS_ENABLED(CONFIG_LOCATION_REQUEST_MODE_CONCURRENT)) {
+		TEST_IGNORE();
+	}
+
+	location_config_defaults_set(&config, 2, methods);
+	config.mode = LOCATION_REQ_MODE_CONCURRENT;
+
+	err = location_request(&config);
+	TEST_ASSERT_EQUAL(-EINVAL, err);
+}
+
+/* Test getting method statistics with invalid parameters. */
+void test_error_method_metrics_get(void)
+{
+	int err;
+	struct location_method_metrics metrics;
+
+	err = location_method_metrics_get(99, &metrics);
+	TEST_ASSERT_EQUAL(-EINVAL, err);
+
+	err = location_method_metrics_get(LOCATION_METHOD_CELLULAR, NULL);
+	TEST_ASSERT_EQUAL(-EINVAL, err);
+}
+
 /* Test cancelling location request when there is no pending location request. */
 void test_error_cancel_no_operation(void)
 {
@@ -15,6 +15,9 @@
 /* Test message type. */
 #define TEST_MESSAGE_TYPE 0
 
+/* Size of the internal message ID lookup table. */
+#define ID_INDEX_SIZE (2 * CONFIG_QOS_PENDING_MESSAGES_MAX)
+
 /* Dummy payload. */
 static uint8_t *var = "some text";
 #define DUMMY_SIZE sizeof(var)
@@ -92,6 +95,8 @@ static void init(void)
 	expected.app_evt_handler = &dut_event_handler;
 	expected.initialized = true;
 	expected.timeout_handler_work.work.handler = &timeout_handler_work_fn;
+	expected.pending_list.head = &ctx.pending_list;
+	expected.pending_list.tail = &ctx.pending_list;
 
 	ctx_verify(&expected);
 
@@ -137,7 +142,7 @@ void test_message_add(void)
 	TEST_ASSERT_EQUAL(2, callback_count);
 
 	/* Verify that internal list contains no entries. */
-	TEST_ASSERT_TRUE(sys_slist_is_empty(&ctx.pending_list));
+	TEST_ASSERT_TRUE(sys_dlist_is_empty(&ctx.pending_list));
 
 	/* Fill pending list */
 	callback_count = 0;
@@ -155,7 +160,7 @@ void test_message_add(void)
 	TEST_ASSERT_EQUAL(-ENOMEM, qos_message_add(&message));
 
 	/* Check number of list entries populated. */
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
 		count++;
 	};
 
@@ -196,7 +201,7 @@ void test_message_remove(void)
 	TEST_ASSERT_EQUAL(-ENODATA, qos_message_remove(QOS_MESSAGE_ID_BASE));
 
 	/* Check number of list entries populated. */
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
 		count++;
 	};
 
@@ -225,7 +230,7 @@ void test_message_remove_all(void)
 	/* Verify that the internal list has been emptied and the internal delayed
 	 * work is not running.
 	 */
-	TEST_ASSERT_TRUE(sys_slist_is_empty(&ctx.pending_list));
+	TEST_ASSERT_TRUE(sys_dlist_is_empty(&ctx.pending_list));
 	TEST_ASSERT_EQUAL(CONFIG_QOS_PENDING_MESSAGES_MAX, callback_count);
 	TEST_ASSERT_FALSE(k_work_delayable_is_pending(&ctx.timeout_handler_work));
 }
@@ -306,6 +311,11 @@ void test_message_timeout_work(void)
 
 	k_work_cancel_delayable(&ctx.timeout_handler_work);
 
+	/* Make all messages due. */
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+		node->deadline = 0;
+	};
+
 	callback_count = 0;
 	ctx.app_evt_handler = &dut_event_handler_expired;
 
@@ -320,8 +330,9 @@ void test_message_timeout_work(void)
 	ctx.app_evt_handler = &dut_event_handler_removed;
 
 	/* Set every list item to the maximum allowed notified count. */
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
 		node->message.notified_count = CONFIG_QOS_MESSAGE_NOTIFIED_COUNT_MAX;
+		node->deadline = 0;
 	};
 
 	timeout_handler_work_fn(NULL);
@@ -337,6 +348,137 @@ void test_message_timeout_work(void)
 	TEST_ASSERT_EQUAL(0, callback_count);
 }
 
+void test_message_remove_colliding_ids(void)
+{
+	struct qos_data message = {
+		.data.buf = var,
+		.data.len = DUMMY_SIZE,
+		.type = TEST_MESSAGE_TYPE,
+		.flags = QOS_FLAG_RELIABILITY_ACK_REQUIRED
+	};
+
+	/* Add messages with IDs that map to the same entry in the lookup table. */
+	for (int i = 0; i < CONFIG_QOS_PENDING_MESSAGES_MAX; i++) {
+		message.id = QOS_MESSAGE_ID_BASE + i * ID_INDEX_SIZE;
+		TEST_ASSERT_FALSE(qos_message_add(&message));
+	}
+
+	/* Remove every other message, then the rest in reverse order. */
+	for (int i = 0; i < CONFIG_QOS_PENDING_MESSAGES_MAX; i += 2) {
+		TEST_ASSERT_FALSE(qos_message_remove(QOS_MESSAGE_ID_BASE + i * ID_INDEX_SIZE));
+		TEST_ASSERT_EQUAL(-ENODATA,
+				  qos_message_remove(QOS_MESSAGE_ID_BASE + i * ID_INDEX_SIZE));
+	}
+
+	for (int i = CONFIG_QOS_PENDING_MESSAGES_MAX - 1; i >= 0; i--) {
+		if ((i % 2) == 0) {
+			continue;
+		}
+
+		TEST_ASSERT_FALSE(qos_message_remove(QOS_MESSAGE_ID_BASE + i * ID_INDEX_SIZE));
+	}
+
+	TEST_ASSERT_TRUE(sys_dlist_is_empty(&ctx.pending_list));
+	TEST_ASSERT_FALSE(k_work_delayable_is_pending(&ctx.timeout_handler_work));
+
+	/* Verify that the lookup table is empty. */
+	for (int i = 0; i < ID_INDEX_SIZE; i++) {
+		TEST_ASSERT_EQUAL(0, ctx.id_index[i]);
+	}
+
+	/* All entries are available again. */
+	for (int i = 0; i < CONFIG_QOS_PENDING_MESSAGES_MAX; i++) {
+		message.id = qos_message_id_get_next();
+		TEST_ASSERT_FALSE(qos_message_add(&message));
+	}
+}
+
+void test_message_backoff(void)
+{
+	struct qos_metadata *node;
+	uint32_t backoff = CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_SECONDS;
+	int64_t now;
+	struct qos_data message = {
+		.data.buf = var,
+		.data.len = DUMMY_SIZE,
+		.id = qos_message_id_get_next(),
+		.type = TEST_MESSAGE_TYPE,
+		.flags = QOS_FLAG_RELIABILITY_ACK_REQUIRED
+	};
+
+	TEST_ASSERT_FALSE(qos_message_add(&message));
+
+	node = SYS_DLIST_PEEK_HEAD_CONTAINER(&ctx.pending_list, node, header);
+	TEST_ASSERT_NOT_NULL(node);
+	TEST_ASSERT_EQUAL(CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_SECONDS, node->backoff);
+
+	k_work_cancel_delayable(&ctx.timeout_handler_work);
+	ctx.app_evt_handler = &dut_event_handler_expired;
+
+	/* Expect the notify interval to double until it reaches the maximum value. */
+	for (int i = 0; i < 8; i++) {
+		node->deadline = 0;
+		node->message.notified_count = 0;
+		now = k_uptime_get();
+
+		timeout_handler_work_fn(NULL);
+
+		TEST_ASSERT_TRUE(node->deadline >= now + backoff * MSEC_PER_SEC);
+		TEST_ASSERT_TRUE(k_work_delayable_is_pending(&ctx.timeout_handler_work));
+
+		backoff = MIN(backoff * 2, CONFIG_QOS_MESSAGE_NOTIFY_TIMEOUT_MAX_SECONDS);
+		TEST_ASSERT_EQUAL(backoff, node->backoff);
+	}
+
+	TEST_ASSERT_EQUAL(8, callback_count);
+
+	/* Messages that are not due are not notified. */
+	callback_count = 0;
+	timeout_handler_work_fn(NULL);
+	TEST_ASSERT_EQUAL(0, callback_count);
+}
+
+void test_stats(void)
+{
+	struct qos_stats stats;
+	struct qos_metadata *node = NULL, *next_node = NULL;
+
+	qos_stats_get(&stats);
+	TEST_ASSERT_EQUAL(0, stats.depth);
+	TEST_ASSERT_EQUAL(0, stats.depth_peak);
+
+	/* Fill the list and add one message too many. */
+	test_message_add();
+	TEST_ASSERT_FALSE(qos_message_remove(QOS_MESSAGE_ID_BASE));
+
+	qos_stats_get(&stats);
+	TEST_ASSERT_EQUAL(CONFIG_QOS_PENDING_MESSAGES_MAX - 1, stats.depth);
+	TEST_ASSERT_EQUAL(CONFIG_QOS_PENDING_MESSAGES_MAX, stats.depth_peak);
+	TEST_ASSERT_EQUAL(1, stats.acked);
+	TEST_ASSERT_EQUAL(1, stats.dropped);
+	TEST_ASSERT_EQUAL(0, stats.retries);
+
+	/* Notify all messages once, then drop them. */
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+		node->deadline = 0;
+	};
+
+	timeout_handler_work_fn(NULL);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctx.pending_list, node, next_node, header) {
+		node->message.notified_count = CONFIG_QOS_MESSAGE_NOTIFIED_COUNT_MAX;
+		node->deadline = 0;
+	};
+
+	timeout_handler_work_fn(NULL);
+
+	qos_stats_get(&stats);
+	TEST_ASSERT_EQUAL(0, stats.depth);
+	TEST_ASSERT_EQUAL(CONFIG_QOS_PENDING_MESSAGES_MAX - 1, stats.retries);
+	TEST_ASSERT_EQUAL(CONFIG_QOS_PENDING_MESSAGES_MAX, stats.dropped);
+	TEST_ASSERT_FALSE(k_work_delayable_is_pending(&ctx.timeout_handler_work));
+}
+
 /* It is required to be added to each test. That is because unity's
  * main may return nonzero, while zephyr's main currently must
  * return 0 in all cases (other values are reserved).
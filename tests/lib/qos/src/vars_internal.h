@@ -4,15 +4,24 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
-#include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 #include <qos.h>
 
 struct qos_metadata {
 	/* Mandatory variable used to construct a linked list. */
-	sys_snode_t header;
+	sys_dnode_t header;
+
+	/* System uptime in milliseconds when the message is notified next. */
+	int64_t deadline;
+
+	/* Current notification interval in seconds. Doubled after every notification. */
+	uint32_t backoff;
 
 	/* Message associated with each node in the linked list. */
 	struct qos_data message;
+
+	/* The message is stored in non-volatile memory. */
+	bool stored;
 };
 
 extern struct ctx {
@@ -22,8 +31,14 @@ extern struct ctx {
 	/* Internal array of pending messages. Used in combination with linked list. */
 	struct qos_metadata list_internal[CONFIG_QOS_PENDING_MESSAGES_MAX];
 
-	/* Linked list used to keep track of pending messages. */
-	sys_slist_t pending_list;
+	/* Linked list used to keep track of pending messages, in the order they were added. */
+	sys_dlist_t pending_list;
+
+	/* Linked list of unused entries in the internal array. */
+	sys_dlist_t free_list;
+
+	/* Table that maps message IDs to entries in the internal array. */
+	uint16_t id_index[2 * CONFIG_QOS_PENDING_MESSAGES_MAX];
 
 	/* Variable used to prevent multiple library initializations. */
 	bool initialized;
@@ -33,6 +48,9 @@ extern struct ctx {
 
 	/* Internal variable used to generate message IDs. */
 	uint16_t message_id_next;
+
+	/* Library statistics. */
+	struct qos_stats stats;
 } ctx;
 
 extern void timeout_handler_work_fn(struct k_work *work);
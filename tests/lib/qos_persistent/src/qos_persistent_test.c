@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/settings/settings.h>
+#include <qos.h>
+
+/* Include header that exposes internal variables in QoS library. */
+#include "vars_internal.h"
+
+/* Test message type. */
+#define TEST_MESSAGE_TYPE 3
+
+static uint8_t payload[] = "some text";
+static uint8_t payload_large[CONFIG_QOS_PERSISTENT_PAYLOAD_SIZE_MAX + 1];
+
+static uint8_t removed_count;
+
+static void dut_event_handler(const struct qos_evt *evt)
+{
+	switch (evt->type) {
+	case QOS_EVT_MESSAGE_NEW:
+	case QOS_EVT_MESSAGE_TIMER_EXPIRED:
+		break;
+	case QOS_EVT_MESSAGE_REMOVED_FROM_LIST:
+		removed_count++;
+
+		if (evt->message.heap_allocated) {
+			k_free(evt->message.data.buf);
+		}
+		break;
+	default:
+		TEST_FAIL();
+		break;
+	}
+}
+
+static void message_add(uint32_t id, uint8_t *buf, size_t len)
+{
+	struct qos_data message = {
+		.data.buf = buf,
+		.data.len = len,
+		.id = id,
+		.type = TEST_MESSAGE_TYPE,
+		.flags = QOS_FLAG_RELIABILITY_ACK_REQUIRED
+	};
+
+	TEST_ASSERT_EQUAL(0, qos_message_add(&message));
+}
+
+static struct qos_metadata *message_find(uint32_t id)
+{
+	struct qos_metadata *node;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&ctx.pending_list, node, header) {
+		if (node->message.id == id) {
+			return node;
+		}
+	}
+
+	return NULL;
+}
+
+/* Drop the library state without removing the stored messages, as a reboot would. */
+static void reboot(void)
+{
+	struct qos_metadata *node;
+
+	k_work_cancel_delayable(&ctx.timeout_handler_work);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&ctx.pending_list, node, header) {
+		if (node->message.heap_allocated) {
+			k_free(node->message.data.buf);
+		}
+	}
+
+	memset(&ctx, 0, sizeof(struct ctx));
+	ctx.message_id_next = QOS_MESSAGE_ID_BASE;
+
+	TEST_ASSERT_EQUAL(0, qos_init(dut_event_handler));
+}
+
+void setUp(void)
+{
+	ctx.message_id_next = QOS_MESSAGE_ID_BASE;
+	TEST_ASSERT_EQUAL(0, qos_init(dut_event_handler));
+}
+
+void tearDown(void)
+{
+	/* Deletes the stored messages. */
+	qos_message_remove_all();
+
+	k_work_cancel_delayable(&ctx.timeout_handler_work);
+	memset(&ctx, 0, sizeof(struct ctx));
+	removed_count = 0;
+}
+
+void test_message_restore(void)
+{
+	struct qos_metadata *node;
+	struct qos_stats stats;
+	struct qos_data message = {
+		.data.buf = payload,
+		.data.len = sizeof(payload),
+		.id = qos_message_id_get_next(),
+		.type = TEST_MESSAGE_TYPE,
+		.flags = QOS_FLAG_RELIABILITY_ACK_DISABLED
+	};
+
+	/* Messages without the ACK_REQUIRED flag are not stored. */
+	TEST_ASSERT_EQUAL(0, qos_message_add(&message));
+
+	message_add(qos_message_id_get_next(), payload, sizeof(payload));
+	message_add(qos_message_id_get_next(), NULL, 0);
+
+	reboot();
+
+	qos_stats_get(&stats);
+	TEST_ASSERT_EQUAL(2, stats.depth);
+
+	node = message_find(QOS_MESSAGE_ID_BASE + 1);
+	TEST_ASSERT_NOT_NULL(node);
+	TEST_ASSERT_TRUE(node->stored);
+	TEST_ASSERT_TRUE(node->message.heap_allocated);
+	TEST_ASSERT_EQUAL(sizeof(payload), node->message.data.len);
+	TEST_ASSERT_EQUAL_MEMORY(payload, node->message.data.buf, sizeof(payload));
+	TEST_ASSERT_EQUAL(1, node->message.notified_count);
+	TEST_ASSERT_EQUAL(TEST_MESSAGE_TYPE, node->message.type);
+	TEST_ASSERT_EQUAL(QOS_FLAG_RELIABILITY_ACK_REQUIRED, node->message.flags);
+
+	node = message_find(QOS_MESSAGE_ID_BASE + 2);
+	TEST_ASSERT_NOT_NULL(node);
+	TEST_ASSERT_EQUAL(0, node->message.data.len);
+	TEST_ASSERT_NULL(node->message.data.buf);
+
+	/* The ID sequence continues after the restored messages. */
+	TEST_ASSERT_EQUAL(QOS_MESSAGE_ID_BASE + 3, qos_message_id_get_next());
+
+	/* The backoff timer is running for the restored messages. */
+	TEST_ASSERT_TRUE(k_work_delayable_is_pending(&ctx.timeout_handler_work));
+}
+
+void test_message_restore_once(void)
+{
+	struct qos_stats stats;
+
+	message_add(qos_message_id_get_next(), payload, sizeof(payload));
+
+	reboot();
+
+	/* Loading the settings of the application does not add the messages again. */
+	TEST_ASSERT_EQUAL(0, settings_load());
+
+	qos_stats_get(&stats);
+	TEST_ASSERT_EQUAL(1, stats.depth);
+}
+
+void test_message_remove_deletes_stored(void)
+{
+	struct qos_stats stats;
+
+	message_add(qos_message_id_get_next(), payload, sizeof(payload));
+	message_add(qos_message_id_get_next(), payload, sizeof(payload));
+
+	TEST_ASSERT_EQUAL(0, qos_message_remove(QOS_MESSAGE_ID_BASE));
+
+	reboot();
+
+	qos_stats_get(&stats);
+	TEST_ASSERT_EQUAL(1, stats.depth);
+	TEST_ASSERT_NULL(message_find(QOS_MESSAGE_ID_BASE));
+	TEST_ASSERT_NOT_NULL(message_find(QOS_MESSAGE_ID_BASE + 1));
+}
+
+void test_message_payload_too_large(void)
+{
+	struct qos_metadata *node;
+	struct qos_stats stats;
+
+	message_add(qos_message_id_get_next(), payload_large, sizeof(payload_large));
+
+	node = message_find(QOS_MESSAGE_ID_BASE);
+	TEST_ASSERT_NOT_NULL(node);
+	TEST_ASSERT_FALSE(node->stored);
+
+	/* Removing a message that was never stored does not touch the storage. */
+	TEST_ASSERT_EQUAL(0, qos_message_remove(QOS_MESSAGE_ID_BASE));
+	TEST_ASSERT_EQUAL(1, removed_count);
+
+	message_add(qos_message_id_get_next(), payload_large, sizeof(payload_large));
+
+	reboot();
+
+	qos_stats_get(&stats);
+	TEST_ASSERT_EQUAL(0, stats.depth);
+}
+
+void test_message_notified_count_stored(void)
+{
+	struct qos_metadata *node;
+
+	message_add(qos_message_id_get_next(), payload, sizeof(payload));
+
+	node = message_find(QOS_MESSAGE_ID_BASE);
+	TEST_ASSERT_NOT_NULL(node);
+
+	k_work_cancel_delayable(&ctx.timeout_handler_work);
+	node->deadline = 0;
+	timeout_handler_work_fn(NULL);
+	TEST_ASSERT_EQUAL(2, node->message.notified_count);
+
+	qos_message_notify_all();
+	TEST_ASSERT_EQUAL(3, node->message.notified_count);
+
+	reboot();
+
+	node = message_find(QOS_MESSAGE_ID_BASE);
+	TEST_ASSERT_NOT_NULL(node);
+	TEST_ASSERT_EQUAL(3, node->message.notified_count);
+}
+
+void test_message_notified_count_deleted(void)
+{
+	struct qos_metadata *node;
+
+	message_add(qos_message_id_get_next(), payload, sizeof(payload));
+	qos_message_notify_all();
+
+	TEST_ASSERT_EQUAL(0, qos_message_remove(QOS_MESSAGE_ID_BASE));
+
+	reboot();
+
+	/* A new message with the same ID does not get the count of the removed one. */
+	message_add(qos_message_id_get_next(), payload, sizeof(payload));
+
+	reboot();
+
+	node = message_find(QOS_MESSAGE_ID_BASE);
+	TEST_ASSERT_NOT_NULL(node);
+	TEST_ASSERT_EQUAL(1, node->message.notified_count);
+}
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <zephyr/ztest.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(hid_state_items_test);
+
+#define ITEM_COUNT		8
+#include "hid_state_items.h"
+
+#define USAGE_ID_MAX		(2 * ITEM_COUNT)
+#define TRACE_LEN		20000
+
+/* Item handling used by the HID state before the items were kept sorted.
+ * The value change is applied with a binary search over the whole array
+ * and the array is sorted again with a selection sort.
+ */
+static int ref_usage_id_compare(const void *a, const void *b)
+{
+	const struct item *p_a = a;
+	const struct item *p_b = b;
+
+	return (p_a->usage_id - p_b->usage_id);
+}
+
+static void ref_sort_by_usage_id(struct item items[], size_t array_size)
+{
+	for (size_t k = 0; k < array_size; k++) {
+		size_t id = k;
+
+		for (size_t l = k + 1; l < array_size; l++) {
+			if (items[l].usage_id < items[id].usage_id) {
+				id = l;
+			}
+		}
+		if (id != k) {
+			struct item tmp = items[k];
+
+			items[k] = items[id];
+			items[id] = tmp;
+		}
+	}
+}
+
+static bool ref_key_value_set(struct items *items, uint16_t usage_id, int16_t value)
+{
+	const uint8_t prev_item_count = items->item_count;
+	bool update_needed = false;
+	struct item i = {
+		.usage_id = usage_id,
+	};
+	struct item *p_item = bsearch(&i, items->item, ARRAY_SIZE(items->item),
+				      sizeof(items->item[0]), ref_usage_id_compare);
+
+	if (p_item) {
+		p_item->value += value;
+		if (p_item->value == 0) {
+			items->item_count -= 1;
+			p_item->usage_id = 0;
+		}
+
+		update_needed = true;
+	} else if ((value > 0) && (prev_item_count < items->item_count_max)) {
+		size_t const idx = ARRAY_SIZE(items->item) - prev_item_count - 1;
+
+		items->item[idx].usage_id = usage_id;
+		items->item[idx].value = value;
+		items->item_count += 1;
+
+		update_needed = true;
+	}
+
+	if (prev_item_count != items->item_count) {
+		ref_sort_by_usage_id(items->item, ARRAY_SIZE(items->item));
+	}
+
+	return update_needed;
+}
+
+static uint32_t rand_state;
+
+/* Deterministic pseudo-random generator (xorshift32), so that a failing trace
+ * can be reproduced.
+ */
+static uint32_t rand_get(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static void items_init(struct items *items, uint8_t item_count_max)
+{
+	memset(items, 0, sizeof(*items));
+	items->item_count_max = item_count_max;
+}
+
+static void items_check(const struct items *items, const struct item expected[], size_t cnt)
+{
+	size_t first = ARRAY_SIZE(items->item) - cnt;
+
+	zassert_equal(items->item_count, cnt, "Invalid item count");
+
+	for (size_t i = 0; i < first; i++) {
+		zassert_equal(items->item[i].usage_id, 0, "Free slot %zu not cleared", i);
+		zassert_equal(items->item[i].value, 0, "Free slot %zu not cleared", i);
+	}
+
+	for (size_t i = 0; i < cnt; i++) {
+		zassert_equal(items->item[first + i].usage_id, expected[i].usage_id,
+			      "Invalid usage ID of item %zu", i);
+		zassert_equal(items->item[first + i].value, expected[i].value,
+			      "Invalid value of item %zu", i);
+	}
+}
+
+static void trace_compare(uint32_t seed, uint8_t item_count_max)
+{
+	struct items items;
+	struct items ref_items;
+
+	items_init(&items, item_count_max);
+	items_init(&ref_items, item_count_max);
+	rand_state = seed;
+
+	for (size_t i = 0; i < TRACE_LEN; i++) {
+		uint32_t r = rand_get();
+		uint16_t usage_id = 1 + (r % USAGE_ID_MAX);
+		/* Key presses and releases, including unpaired releases. */
+		int16_t value = ((r >> 16) & 0x1) ? 1 : -1;
+
+		zassert_equal(key_value_set(&items, usage_id, value),
+			      ref_key_value_set(&ref_items, usage_id, value),
+			      "Result differs at step %zu (seed %u)", i, seed);
+		zassert_equal(items.item_count, ref_items.item_count,
+			      "Item count differs at step %zu (seed %u)", i, seed);
+		zassert_mem_equal(items.item, ref_items.item, sizeof(items.item),
+				  "Items differ at step %zu (seed %u)", i, seed);
+	}
+}
+
+ZTEST(hid_state_items, test_sorted_insert)
+{
+	static const struct item expected[] = {
+		{ .usage_id = 0x04, .value = 1 },
+		{ .usage_id = 0x05, .value = 1 },
+		{ .usage_id = 0x10, .value = 1 },
+		{ .usage_id = 0x20, .value = 1 },
+	};
+	struct items items;
+
+	items_init(&items, ITEM_COUNT);
+
+	zassert_true(key_value_set(&items, 0x10, 1));
+	zassert_true(key_value_set(&items, 0x05, 1));
+	zassert_true(key_value_set(&items, 0x20, 1));
+	zassert_true(key_value_set(&items, 0x04, 1));
+
+	items_check(&items, expected, ARRAY_SIZE(expected));
+}
+
+ZTEST(hid_state_items, test_remove)
+{
+	static const struct item expected[] = {
+		{ .usage_id = 0x04, .value = 1 },
+		{ .usage_id = 0x20, .value = 1 },
+	};
+	struct items items;
+
+	items_init(&items, ITEM_COUNT);
+
+	zassert_true(key_value_set(&items, 0x04, 1));
+	zassert_true(key_value_set(&items, 0x10, 1));
+	zassert_true(key_value_set(&items, 0x20, 1));
+
+	/* Removing an item in the middle keeps the other items sorted. */
+	zassert_true(key_value_set(&items, 0x10, -1));
+	items_check(&items, expected, ARRAY_SIZE(expected));
+
+	zassert_true(key_value_set(&items, 0x04, -1));
+	zassert_true(key_value_set(&items, 0x20, -1));
+	items_check(&items, NULL, 0);
+}
+
+ZTEST(hid_state_items, test_reference_count)
+{
+	static const struct item expected[] = {
+		{ .usage_id = 0x04, .value = 2 },
+	};
+	struct items items;
+
+	items_init(&items, ITEM_COUNT);
+
+	/* The same usage can be mapped to more than one key. */
+	zassert_true(key_value_set(&items, 0x04, 1));
+	zassert_true(key_value_set(&items, 0x04, 1));
+	items_check(&items, expected, ARRAY_SIZE(expected));
+
+	zassert_true(key_value_set(&items, 0x04, -1));
+	zassert_true(key_value_set(&items, 0x04, -1));
+	items_check(&items, NULL, 0);
+
+	/* Unpaired release is ignored. */
+	zassert_false(key_value_set(&items, 0x04, -1));
+	items_check(&items, NULL, 0);
+}
+
+ZTEST(hid_state_items, test_full)
+{
+	struct items items;
+
+	items_init(&items, 2);
+
+	zassert_true(key_value_set(&items, 0x04, 1));
+	zassert_true(key_value_set(&items, 0x05, 1));
+	zassert_false(key_value_set(&items, 0x06, 1));
+	zassert_equal(items.item_count, 2, "Item stored above the limit");
+
+	/* Items already stored can still be updated. */
+	zassert_true(key_value_set(&items, 0x05, 1));
+	zassert_true(key_value_set(&items, 0x04, -1));
+	zassert_true(key_value_set(&items, 0x06, 1));
+}
+
+ZTEST(hid_state_items, test_random_trace)
+{
+	static const uint8_t item_count_max[] = {1, ITEM_COUNT / 2, ITEM_COUNT};
+	static const uint32_t seeds[] = {0x12345678, 0xdeadbeef, 0x0badf00d};
+
+	for (size_t i = 0; i < ARRAY_SIZE(item_count_max); i++) {
+		for (size_t j = 0; j < ARRAY_SIZE(seeds); j++) {
+			trace_compare(seeds[j], item_count_max[i]);
+		}
+	}
+}
+
+ZTEST_SUITE(hid_state_items, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <modem/at_cmd_parser.h>
+#include "slm_at_mux.h"
+
+#define TEST_SOCKET 5
+#define TEST_CHANNEL 1
+#define TEST_BUF_SIZE 256
+#define TEST_WAIT K_MSEC(200)
+
+/* AT command handlers of the SLM application. */
+int handle_at_mux(enum at_cmd_type cmd_type);
+int handle_at_muxch(enum at_cmd_type cmd_type);
+
+/* Frames encoded by scripts/slm_mux.py of the SLM application. */
+static const uint8_t frame_at_cmd[] = {
+	0xF9, 0x00, 0x00, 0x04, 0x00, 0x41, 0x54, 0x0D, 0x0A, 0xA2 /* "AT\r\n" */
+};
+static const uint8_t frame_at_rsp[] = {
+	0xF9, 0x00, 0x00, 0x04, 0x00, 0x4F, 0x4B, 0x0D, 0x0A, 0x83 /* "OK\r\n" */
+};
+static const uint8_t frame_credit_initial[] = {
+	0xF9, 0x01, 0x01, 0x01, 0x00, 0x02, 0x28 /* CONFIG_SLM_MUX_RX_CREDITS */
+};
+static const uint8_t frame_credit_one[] = {
+	0xF9, 0x01, 0x01, 0x01, 0x00, 0x01, 0x21
+};
+static const uint8_t frame_data_host[] = {
+	0xF9, 0x01, 0x00, 0x05, 0x00, 0x68, 0x65, 0x6C, 0x6C, 0x6F, 0x4E /* "hello" */
+};
+static const uint8_t frame_data_sock[] = {
+	0xF9, 0x01, 0x00, 0x05, 0x00, 0x77, 0x6F, 0x72, 0x6C, 0x64, 0x6F /* "world" */
+};
+static const uint8_t frame_close[] = {
+	0xF9, 0x01, 0x02, 0x00, 0x00, 0x11
+};
+
+/* Data written to the UART. */
+static uint8_t uart_buf[TEST_BUF_SIZE];
+static size_t uart_len;
+
+/* Payload received on the AT channel. */
+static uint8_t at_buf[TEST_BUF_SIZE];
+static size_t at_len;
+
+/* Data sent to the socket. */
+static uint8_t sock_tx_buf[TEST_BUF_SIZE];
+static size_t sock_tx_len;
+static K_SEM_DEFINE(sock_tx_sem, 0, 1);
+
+/* Receive frame allocation failure. */
+static bool slab_alloc_fail;
+
+/* Data to be received from the socket. */
+static const char *sock_rx_data;
+static K_SEM_DEFINE(sock_rx_sem, 0, 1);
+
+static char rsp_buf[TEST_BUF_SIZE];
+static bool datamode;
+
+struct at_param_list at_param_list;
+static int32_t at_params[3];
+
+int slm_uart_tx_write(const uint8_t *data, size_t len)
+{
+	zassert_true(uart_len + len <= sizeof(uart_buf), "UART buffer overflow");
+
+	memcpy(&uart_buf[uart_len], data, len);
+	uart_len += len;
+
+	return 0;
+}
+
+void rsp_send(const char *fmt, ...)
+{
+	va_list arg_ptr;
+
+	va_start(arg_ptr, fmt);
+	vsnprintf(rsp_buf, sizeof(rsp_buf), fmt, arg_ptr);
+	va_end(arg_ptr);
+}
+
+bool in_datamode(void)
+{
+	return datamode;
+}
+
+int at_params_unsigned_short_get(const struct at_param_list *list, size_t index,
+				 uint16_t *value)
+{
+	*value = at_params[index];
+
+	return 0;
+}
+
+int at_params_int_get(const struct at_param_list *list, size_t index, int32_t *value)
+{
+	*value = at_params[index];
+
+	return 0;
+}
+
+ssize_t __wrap_z_impl_zsock_sendto(int sock, const void *buf, size_t len, int flags,
+				   const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	zassert_equal(sock, TEST_SOCKET);
+	zassert_true(sock_tx_len + len <= sizeof(sock_tx_buf), "Socket buffer overflow");
+
+	memcpy(&sock_tx_buf[sock_tx_len], buf, len);
+	sock_tx_len += len;
+	k_sem_give(&sock_tx_sem);
+
+	return len;
+}
+
+ssize_t __wrap_z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+				     struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	size_t len;
+
+	zassert_equal(sock, TEST_SOCKET);
+
+	if (!sock_rx_data) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	len = strlen(sock_rx_data);
+	zassert_true(len <= max_len);
+	memcpy(buf, sock_rx_data, len);
+	sock_rx_data = NULL;
+
+	return len;
+}
+
+int __wrap_z_impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int poll_timeout)
+{
+	int ret = 0;
+
+	if (k_sem_take(&sock_rx_sem, K_MSEC(poll_timeout))) {
+		return 0;
+	}
+
+	for (int i = 0; i < nfds; i++) {
+		fds[i].revents = (fds[i].fd == TEST_SOCKET) ? ZSOCK_POLLIN : 0;
+		ret += (fds[i].revents != 0);
+	}
+
+	return ret;
+}
+
+int __real_k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout);
+
+int __wrap_k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
+{
+	if (slab_alloc_fail) {
+		return -ENOMEM;
+	}
+
+	return __real_k_mem_slab_alloc(slab, mem, timeout);
+}
+
+static void at_rx(const uint8_t *buf, size_t len)
+{
+	zassert_true(at_len + len <= sizeof(at_buf), "AT buffer overflow");
+
+	memcpy(&at_buf[at_len], buf, len);
+	at_len += len;
+}
+
+static void uart_check(const uint8_t *expected, size_t len)
+{
+	k_sleep(TEST_WAIT);
+
+	zassert_equal(uart_len, len, "Unexpected UART data length %zu", uart_len);
+	zassert_mem_equal(uart_buf, expected, len, "Unexpected UART data");
+	uart_len = 0;
+}
+
+static void uart_check_empty(void)
+{
+	k_sleep(TEST_WAIT);
+
+	zassert_equal(uart_len, 0, "Unexpected UART data");
+}
+
+static int at_cmd_set(int (*handler)(enum at_cmd_type), int32_t param1, int32_t param2)
+{
+	at_params[1] = param1;
+	at_params[2] = param2;
+
+	return handler(AT_CMD_TYPE_SET_COMMAND);
+}
+
+static uint32_t fcs_errors_get(void)
+{
+	int active;
+	int channels;
+	uint32_t fcs_errors;
+
+	zassert_ok(handle_at_mux(AT_CMD_TYPE_READ_COMMAND));
+	zassert_equal(sscanf(rsp_buf, "\r\n#XMUX: %d,%d,%u", &active, &channels, &fcs_errors), 3,
+		      "Invalid response: %s", rsp_buf);
+	zassert_equal(active, 1);
+	zassert_equal(channels, CONFIG_SLM_MUX_CHANNELS);
+
+	return fcs_errors;
+}
+
+static void *mux_setup(void)
+{
+	zassert_ok(slm_at_mux_init());
+
+	datamode = true;
+	zassert_equal(at_cmd_set(handle_at_mux, 1, 0), -EBUSY, "Entered in data mode");
+	datamode = false;
+
+	zassert_ok(at_cmd_set(handle_at_mux, 1, 0));
+	k_sleep(TEST_WAIT);
+	zassert_true(slm_mux_active());
+
+	return NULL;
+}
+
+static void mux_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	uart_len = 0;
+	at_len = 0;
+	sock_tx_len = 0;
+	sock_rx_data = NULL;
+	slab_alloc_fail = false;
+	k_sem_reset(&sock_tx_sem);
+	k_sem_reset(&sock_rx_sem);
+}
+
+ZTEST(slm_mux, test_at_rx)
+{
+	/* The frame is split over two UART buffers. */
+	slm_mux_rx(frame_at_cmd, 3, at_rx);
+	zassert_equal(at_len, 0);
+	slm_mux_rx(&frame_at_cmd[3], sizeof(frame_at_cmd) - 3, at_rx);
+
+	zassert_equal(at_len, 4);
+	zassert_mem_equal(at_buf, "AT\r\n", 4);
+}
+
+ZTEST(slm_mux, test_at_rx_fcs_error)
+{
+	uint8_t frames[2 * sizeof(frame_at_cmd)];
+	uint32_t fcs_errors = fcs_errors_get();
+
+	memcpy(frames, frame_at_cmd, sizeof(frame_at_cmd));
+	memcpy(&frames[sizeof(frame_at_cmd)], frame_at_cmd, sizeof(frame_at_cmd));
+	frames[sizeof(frame_at_cmd) - 1] ^= 0xFF;
+
+	/* The corrupted frame is dropped, the next one is received. */
+	slm_mux_rx(frames, sizeof(frames), at_rx);
+
+	zassert_equal(at_len, 4);
+	zassert_mem_equal(at_buf, "AT\r\n", 4);
+	zassert_equal(fcs_errors_get(), fcs_errors + 1);
+}
+
+ZTEST(slm_mux, test_at_tx)
+{
+	zassert_ok(slm_mux_tx(SLM_MUX_AT_CHANNEL, (const uint8_t *)"OK\r\n", 4));
+
+	uart_check(frame_at_rsp, sizeof(frame_at_rsp));
+}
+
+ZTEST(slm_mux, test_data_channel)
+{
+	zassert_ok(at_cmd_set(handle_at_muxch, TEST_CHANNEL, TEST_SOCKET));
+	uart_check(frame_credit_initial, sizeof(frame_credit_initial));
+
+	/* Host to socket, the credit is returned once the data is sent. */
+	slm_mux_rx(frame_data_host, sizeof(frame_data_host), at_rx);
+	zassert_ok(k_sem_take(&sock_tx_sem, TEST_WAIT));
+	zassert_equal(sock_tx_len, 5);
+	zassert_mem_equal(sock_tx_buf, "hello", 5);
+	uart_check(frame_credit_one, sizeof(frame_credit_one));
+
+	/* Socket to host, after the host has granted a credit. */
+	slm_mux_rx(frame_credit_one, sizeof(frame_credit_one), at_rx);
+	sock_rx_data = "world";
+	k_sem_give(&sock_rx_sem);
+	uart_check(frame_data_sock, sizeof(frame_data_sock));
+
+	/* The credit is used up, the socket is no longer read. */
+	sock_rx_data = "world";
+	k_sem_give(&sock_rx_sem);
+	uart_check_empty();
+
+	/* Closed by the host, the close frame is echoed. */
+	slm_mux_rx(frame_close, sizeof(frame_close), at_rx);
+	uart_check(frame_close, sizeof(frame_close));
+
+	/* Data of a closed channel is dropped. */
+	slm_mux_rx(frame_data_host, sizeof(frame_data_host), at_rx);
+	zassert_equal(k_sem_take(&sock_tx_sem, TEST_WAIT), -EAGAIN);
+	uart_check_empty();
+}
+
+ZTEST(slm_mux, test_data_no_frame)
+{
+	zassert_ok(at_cmd_set(handle_at_muxch, TEST_CHANNEL, TEST_SOCKET));
+	uart_check(frame_credit_initial, sizeof(frame_credit_initial));
+
+	/* Data without a free receive frame is dropped, but its credit is returned. */
+	slab_alloc_fail = true;
+	slm_mux_rx(frame_data_host, sizeof(frame_data_host), at_rx);
+	zassert_equal(k_sem_take(&sock_tx_sem, TEST_WAIT), -EAGAIN);
+	uart_check(frame_credit_one, sizeof(frame_credit_one));
+
+	slab_alloc_fail = false;
+	slm_mux_rx(frame_data_host, sizeof(frame_data_host), at_rx);
+	zassert_ok(k_sem_take(&sock_tx_sem, TEST_WAIT));
+	uart_check(frame_credit_one, sizeof(frame_credit_one));
+
+	slm_mux_rx(frame_close, sizeof(frame_close), at_rx);
+	uart_check(frame_close, sizeof(frame_close));
+}
+
+ZTEST_SUITE(slm_mux, NULL, mux_setup, mux_before, NULL, NULL);
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <bluetooth/services/fast_pair.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(fast_pair, CONFIG_BT_FAST_PAIR_LOG_LEVEL);
+
+#include "fp_battery.h"
+#include "fp_common.h"
+#include "fp_crypto.h"
+#include "fp_registration_data.h"
+#include "fp_storage_ak.h"
+
+#define ACCOUNT_KEY_MAX		CONFIG_BT_FAST_PAIR_STORAGE_ACCOUNT_KEY_MAX
+#define ADV_BUF_SIZE		64
+#define AK_FILTER_OFFSET	4
+#define SALT_FIELD_LEN_TYPE	0x21
+#define SALT_FIELD_SIZE		3
+#define FIRST_SALT		0x1234
+
+/* Account Key List kept the same way as in the Fast Pair storage: the oldest key is replaced
+ * once the list is full.
+ */
+static struct fp_account_key account_key_list[ACCOUNT_KEY_MAX];
+static size_t account_key_cnt;
+static size_t account_key_next_idx;
+
+static struct bt_fast_pair_battery_data battery_data;
+
+static uint16_t next_salt;
+static size_t salt_gen_cnt;
+static size_t hash_cnt;
+
+int __real_fp_crypto_account_key_filter_hash(uint8_t *out,
+					     const struct fp_account_key *account_key,
+					     uint16_t salt, const uint8_t *battery_info);
+
+int __wrap_fp_crypto_account_key_filter_hash(uint8_t *out,
+					     const struct fp_account_key *account_key,
+					     uint16_t salt, const uint8_t *battery_info)
+{
+	hash_cnt++;
+
+	return __real_fp_crypto_account_key_filter_hash(out, account_key, salt, battery_info);
+}
+
+int __wrap_z_impl_sys_csrand_get(void *dst, size_t len)
+{
+	zassert_equal(len, sizeof(next_salt), "Unexpected random data length");
+
+	memcpy(dst, &next_salt, len);
+	next_salt++;
+	salt_gen_cnt++;
+
+	return 0;
+}
+
+int fp_storage_ak_count(void)
+{
+	return account_key_cnt;
+}
+
+int fp_storage_ak_get(struct fp_account_key *buf, size_t *key_count)
+{
+	if (*key_count < account_key_cnt) {
+		return -EINVAL;
+	}
+
+	memcpy(buf, account_key_list, account_key_cnt * sizeof(account_key_list[0]));
+	*key_count = account_key_cnt;
+
+	return 0;
+}
+
+struct bt_fast_pair_battery_data fp_battery_get_battery_data(void)
+{
+	return battery_data;
+}
+
+int fp_reg_data_get_model_id(uint8_t *buf, size_t size)
+{
+	memset(buf, 0, size);
+
+	return 0;
+}
+
+static void account_key_add(uint8_t seed)
+{
+	struct fp_account_key *account_key = &account_key_list[account_key_next_idx];
+
+	memset(account_key->key, seed, sizeof(account_key->key));
+
+	account_key_next_idx = (account_key_next_idx + 1) % ACCOUNT_KEY_MAX;
+	account_key_cnt = MIN(account_key_cnt + 1, ACCOUNT_KEY_MAX);
+}
+
+/* Fill the not discoverable advertising data and check that its Account Key Filter matches the
+ * full computation for the current Account Key List, Salt and battery data.
+ */
+static uint16_t adv_data_check(enum bt_fast_pair_adv_battery_mode adv_battery_mode)
+{
+	struct bt_fast_pair_adv_config fp_adv_config = {
+		.adv_mode = BT_FAST_PAIR_ADV_MODE_NOT_DISCOVERABLE_SHOW_UI_IND,
+		.adv_battery_mode = adv_battery_mode,
+	};
+	size_t ak_filter_size = fp_crypto_account_key_filter_size(account_key_cnt);
+	size_t adv_data_len = AK_FILTER_OFFSET + ak_filter_size + SALT_FIELD_SIZE;
+	const uint8_t *battery_info = NULL;
+	uint8_t expected_ak_filter[ADV_BUF_SIZE];
+	uint8_t buf[ADV_BUF_SIZE];
+	struct bt_data adv_data;
+	const uint8_t *ak_filter;
+	size_t hash_cnt_prev;
+	uint16_t salt;
+
+	if (adv_battery_mode != BT_FAST_PAIR_ADV_BATTERY_MODE_NONE) {
+		adv_data_len += FP_CRYPTO_BATTERY_INFO_LEN;
+	}
+
+	zassert_ok(bt_fast_pair_adv_data_fill(&adv_data, buf, sizeof(buf), fp_adv_config),
+		   "Cannot fill advertising data");
+	zassert_equal(adv_data.data_len, adv_data_len, "Invalid advertising data length");
+
+	ak_filter = &adv_data.data[AK_FILTER_OFFSET];
+	zassert_equal(ak_filter[ak_filter_size], SALT_FIELD_LEN_TYPE, "Invalid Salt field");
+	salt = sys_get_be16(&ak_filter[ak_filter_size + 1]);
+
+	if (adv_battery_mode != BT_FAST_PAIR_ADV_BATTERY_MODE_NONE) {
+		battery_info = &ak_filter[ak_filter_size + SALT_FIELD_SIZE];
+	}
+
+	hash_cnt_prev = hash_cnt;
+	zassert_ok(fp_crypto_account_key_filter(expected_ak_filter, account_key_list,
+						account_key_cnt, salt, battery_info),
+		   "Error during filter computing");
+	hash_cnt = hash_cnt_prev;
+
+	zassert_mem_equal(ak_filter, expected_ak_filter, ak_filter_size,
+			  "Invalid Account Key Filter");
+
+	return salt;
+}
+
+static void adv_data_empty_fill(void)
+{
+	struct bt_fast_pair_adv_config fp_adv_config = {
+		.adv_mode = BT_FAST_PAIR_ADV_MODE_NOT_DISCOVERABLE_SHOW_UI_IND,
+		.adv_battery_mode = BT_FAST_PAIR_ADV_BATTERY_MODE_NONE,
+	};
+	uint8_t buf[ADV_BUF_SIZE];
+	struct bt_data adv_data;
+
+	zassert_ok(bt_fast_pair_adv_data_fill(&adv_data, buf, sizeof(buf), fp_adv_config),
+		   "Cannot fill advertising data");
+}
+
+static void battery_data_set(uint8_t level)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(battery_data.batteries); i++) {
+		battery_data.batteries[i].charging = false;
+		battery_data.batteries[i].level = level;
+	}
+}
+
+static void before_fn(void *f)
+{
+	ARG_UNUSED(f);
+
+	memset(account_key_list, 0, sizeof(account_key_list));
+	account_key_cnt = 0;
+	account_key_next_idx = 0;
+	battery_data_set(BT_FAST_PAIR_BATTERY_LEVEL_UNKNOWN);
+
+	/* Drop the Salt and the hashes cached by the previous test. */
+	bt_fast_pair_adv_salt_rotate();
+	adv_data_empty_fill();
+
+	next_salt = FIRST_SALT;
+	salt_gen_cnt = 0;
+	hash_cnt = 0;
+}
+
+ZTEST(suite_fast_pair_adv, test_refill)
+{
+	account_key_add(1);
+	account_key_add(2);
+	account_key_add(3);
+
+	uint16_t salt = adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+
+	zassert_equal(salt, FIRST_SALT, "Invalid Salt");
+	zassert_equal(hash_cnt, 3, "Invalid number of hash computations");
+
+	/* Nothing changed, the filter is built from the cached hashes. */
+	zassert_equal(adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE), salt, "Salt changed");
+	zassert_equal(hash_cnt, 3, "Hashes not reused");
+	zassert_equal(salt_gen_cnt, 1, "Salt regenerated");
+}
+
+ZTEST(suite_fast_pair_adv, test_salt_rotate)
+{
+	account_key_add(1);
+	account_key_add(2);
+
+	uint16_t salt = adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+
+	bt_fast_pair_adv_salt_rotate();
+
+	zassert_not_equal(adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE), salt,
+			  "Salt not rotated");
+	zassert_equal(salt_gen_cnt, 2, "Invalid number of Salt generations");
+	zassert_equal(hash_cnt, 4, "Hashes not recomputed for the new Salt");
+
+	/* The rotated Salt is kept until the next rotation. */
+	salt = adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+	zassert_equal(adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE), salt, "Salt changed");
+	zassert_equal(salt_gen_cnt, 2, "Salt regenerated");
+	zassert_equal(hash_cnt, 4, "Hashes not reused");
+}
+
+ZTEST(suite_fast_pair_adv, test_battery_change)
+{
+	account_key_add(1);
+	account_key_add(2);
+
+	battery_data_set(50);
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_SHOW_UI_IND);
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_SHOW_UI_IND);
+	zassert_equal(hash_cnt, 2, "Hashes not reused");
+
+	battery_data.batteries[BT_FAST_PAIR_BATTERY_COMP_BUD_CASE].charging = true;
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_SHOW_UI_IND);
+	zassert_equal(hash_cnt, 4, "Hashes not recomputed for the new battery data");
+
+	battery_data_set(40);
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_SHOW_UI_IND);
+	zassert_equal(hash_cnt, 6, "Hashes not recomputed for the new battery data");
+
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_HIDE_UI_IND);
+	zassert_equal(hash_cnt, 8, "Hashes not recomputed for the new battery data");
+
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+	zassert_equal(hash_cnt, 10, "Hashes not recomputed without battery data");
+
+	zassert_equal(salt_gen_cnt, 1, "Salt regenerated");
+}
+
+ZTEST(suite_fast_pair_adv, test_account_key_add)
+{
+	account_key_add(1);
+	account_key_add(2);
+
+	uint16_t salt = adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+
+	zassert_equal(hash_cnt, 2, "Invalid number of hash computations");
+
+	/* Only the hash of the new Account Key is computed. */
+	account_key_add(3);
+	zassert_equal(adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE), salt, "Salt changed");
+	zassert_equal(hash_cnt, 3, "Invalid number of hash computations");
+
+	for (size_t i = account_key_cnt; i < ACCOUNT_KEY_MAX; i++) {
+		account_key_add(i + 1);
+	}
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+	zassert_equal(hash_cnt, ACCOUNT_KEY_MAX, "Invalid number of hash computations");
+
+	/* The oldest Account Key is replaced once the list is full. */
+	account_key_add(ACCOUNT_KEY_MAX + 1);
+	(void)adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+	zassert_equal(hash_cnt, ACCOUNT_KEY_MAX + 1, "Invalid number of hash computations");
+
+	zassert_equal(salt_gen_cnt, 1, "Salt regenerated");
+}
+
+ZTEST(suite_fast_pair_adv, test_account_keys_removed)
+{
+	account_key_add(1);
+	account_key_add(2);
+
+	uint16_t salt = adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE);
+
+	/* Removing all Account Keys drops the cache, including the Salt. */
+	account_key_cnt = 0;
+	account_key_next_idx = 0;
+	adv_data_empty_fill();
+
+	account_key_add(1);
+	account_key_add(2);
+	zassert_not_equal(adv_data_check(BT_FAST_PAIR_ADV_BATTERY_MODE_NONE), salt,
+			  "Salt not rotated");
+	zassert_equal(salt_gen_cnt, 2, "Invalid number of Salt generations");
+	zassert_equal(hash_cnt, 4, "Hashes not recomputed");
+}
+
+ZTEST_SUITE(suite_fast_pair_adv, NULL, NULL, before_fn, NULL, NULL);
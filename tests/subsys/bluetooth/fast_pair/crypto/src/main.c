@@ -253,6 +253,46 @@ ZTEST(suite_crypto, test_bloom_filter)
 			  "Invalid resulting filter.");
 }
 
+ZTEST(suite_crypto, test_bloom_filter_from_hashes)
+{
+	static const uint16_t salt = 0xC7C8;
+
+	static const struct fp_account_key account_key_list[] = {
+		{ .key = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0x00, 0xAA, 0xBB,
+			  0xCC, 0xDD, 0xEE, 0xFF} },
+		{ .key = {0x11, 0x11, 0x22, 0x22, 0x33, 0x33, 0x44, 0x44, 0x55, 0x55, 0x66, 0x66,
+			  0x77, 0x77, 0x88, 0x88} }
+		};
+
+	static const uint8_t battery_info[] = {0b00110011, 0b01000000, 0b01000000, 0b01000000};
+
+	static const uint8_t bloom_filter[] = {0x84, 0x4A, 0x62, 0x20, 0x8B};
+	static const uint8_t bloom_filter_with_battery_info[] = {0x46, 0x15, 0x24, 0xD0, 0x08};
+
+	uint8_t hashes[ARRAY_SIZE(account_key_list)][FP_CRYPTO_SHA256_HASH_LEN];
+	uint8_t result_buf[sizeof(bloom_filter)];
+
+	for (size_t i = 0; i < ARRAY_SIZE(account_key_list); i++) {
+		zassert_ok(fp_crypto_account_key_filter_hash(hashes[i], &account_key_list[i], salt,
+							     NULL),
+			   "Error during hash computing");
+	}
+
+	fp_crypto_account_key_filter_build(result_buf, hashes, ARRAY_SIZE(account_key_list));
+	zassert_mem_equal(result_buf, bloom_filter, sizeof(bloom_filter),
+			  "Invalid resulting filter.");
+
+	for (size_t i = 0; i < ARRAY_SIZE(account_key_list); i++) {
+		zassert_ok(fp_crypto_account_key_filter_hash(hashes[i], &account_key_list[i], salt,
+							     battery_info),
+			   "Error during hash computing");
+	}
+
+	fp_crypto_account_key_filter_build(result_buf, hashes, ARRAY_SIZE(account_key_list));
+	zassert_mem_equal(result_buf, bloom_filter_with_battery_info,
+			  sizeof(bloom_filter_with_battery_info), "Invalid resulting filter.");
+}
+
 ZTEST(suite_crypto, test_additional_data_packet)
 {
 	static const uint8_t input_data[] = {0x53, 0x6F, 0x6D, 0x65, 0x6F, 0x6E, 0x65, 0x27, 0x73,
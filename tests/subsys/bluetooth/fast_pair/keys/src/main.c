@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(fast_pair, CONFIG_BT_FAST_PAIR_LOG_LEVEL);
+
+#include "fp_common.h"
+#include "fp_crypto.h"
+#include "fp_keys.h"
+#include "fp_registration_data.h"
+#include "fp_storage_ak.h"
+#include "fp_storage_pn.h"
+
+#define ACCOUNT_KEY_MAX		5
+
+static const uint8_t request[FP_CRYPTO_AES128_BLOCK_LEN] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+
+/* Connection objects are never dereferenced by the tested module. */
+static uint8_t conn_mem;
+static struct bt_conn *conn = (struct bt_conn *)&conn_mem;
+
+/* Account Key List kept the same way as in the Fast Pair storage: the oldest key is replaced
+ * once the list is full.
+ */
+static struct fp_account_key account_key_list[ACCOUNT_KEY_MAX];
+static size_t account_key_cnt;
+static size_t account_key_next_idx;
+
+/* Number of Account Keys the Key-based Pairing request was checked with. */
+static size_t req_check_cnt;
+
+uint8_t __wrap_bt_conn_index(const struct bt_conn *c)
+{
+	zassert_equal_ptr(c, conn, "Unexpected connection");
+
+	return 0;
+}
+
+int fp_storage_ak_save(const struct fp_account_key *account_key)
+{
+	return -ENOTSUP;
+}
+
+int fp_storage_ak_find(struct fp_account_key *account_key,
+		       fp_storage_ak_check_cb account_key_check_cb, void *context)
+{
+	for (size_t i = 0; i < account_key_cnt; i++) {
+		if (account_key_check_cb(&account_key_list[i], context)) {
+			if (account_key) {
+				*account_key = account_key_list[i];
+			}
+
+			return 0;
+		}
+	}
+
+	return -ESRCH;
+}
+
+int fp_storage_pn_save(const char *pn_to_save)
+{
+	return -ENOTSUP;
+}
+
+int fp_get_anti_spoofing_priv_key(uint8_t *buf, size_t size)
+{
+	return -ENOTSUP;
+}
+
+static void account_key_add(uint8_t seed)
+{
+	memset(account_key_list[account_key_next_idx].key, seed, FP_ACCOUNT_KEY_LEN);
+
+	account_key_next_idx = (account_key_next_idx + 1) % ACCOUNT_KEY_MAX;
+	account_key_cnt = MIN(account_key_cnt + 1, ACCOUNT_KEY_MAX);
+}
+
+static void account_keys_remove(void)
+{
+	memset(account_key_list, 0, sizeof(account_key_list));
+	account_key_cnt = 0;
+	account_key_next_idx = 0;
+}
+
+static int req_validate(const struct bt_conn *c, const uint8_t *req, void *context)
+{
+	req_check_cnt++;
+
+	return memcmp(req, request, sizeof(request)) ? -EINVAL : 0;
+}
+
+/* Run the Key-based Pairing request encrypted with the Account Key of the given seed. */
+static int key_gen(uint8_t seed)
+{
+	uint8_t key[FP_ACCOUNT_KEY_LEN];
+	uint8_t req_enc[FP_CRYPTO_AES128_BLOCK_LEN];
+	struct fp_keys_keygen_params keygen_params = {
+		.req_enc = req_enc,
+		.public_key = NULL,
+		.req_validate_cb = req_validate,
+		.context = NULL,
+	};
+	int err;
+
+	memset(key, seed, sizeof(key));
+	zassert_ok(fp_crypto_aes128_ecb_encrypt(req_enc, request, key),
+		   "Error during encryption");
+
+	req_check_cnt = 0;
+	err = fp_keys_generate_key(conn, &keygen_params);
+
+	/* Allow the next Key-based Pairing request. */
+	fp_keys_drop_key(conn);
+
+	return err;
+}
+
+static void last_used_set(uint8_t seed)
+{
+	zassert_ok(key_gen(seed), "Key generation failed");
+}
+
+static void before_fn(void *f)
+{
+	ARG_UNUSED(f);
+
+	account_keys_remove();
+}
+
+ZTEST(suite_fast_pair_keys, test_last_used_first)
+{
+	for (uint8_t i = 1; i <= ACCOUNT_KEY_MAX; i++) {
+		account_key_add(i);
+	}
+
+	last_used_set(1);
+
+	/* The last used key is checked first, then the remaining keys in storage order. */
+	zassert_ok(key_gen(4), "Key generation failed");
+	zassert_equal(req_check_cnt, 4, "Invalid number of checked keys");
+
+	zassert_ok(key_gen(4), "Key generation failed");
+	zassert_equal(req_check_cnt, 1, "Last used key not checked first");
+
+	zassert_ok(key_gen(2), "Key generation failed");
+	zassert_equal(req_check_cnt, 3, "Invalid number of checked keys");
+
+	zassert_ok(key_gen(2), "Key generation failed");
+	zassert_equal(req_check_cnt, 1, "Last used key not checked first");
+}
+
+ZTEST(suite_fast_pair_keys, test_last_used_replaced)
+{
+	for (uint8_t i = 1; i <= ACCOUNT_KEY_MAX; i++) {
+		account_key_add(i);
+	}
+
+	last_used_set(ACCOUNT_KEY_MAX);
+
+	/* Replace all Account Keys, the last used one included. */
+	for (uint8_t i = 1; i <= ACCOUNT_KEY_MAX; i++) {
+		account_key_add(ACCOUNT_KEY_MAX + i);
+	}
+
+	zassert_equal(key_gen(ACCOUNT_KEY_MAX), -ESRCH, "Removed key accepted");
+	zassert_equal(req_check_cnt, ACCOUNT_KEY_MAX, "Invalid number of checked keys");
+
+	/* The new key at the position of the last used one is checked first. */
+	zassert_ok(key_gen(2 * ACCOUNT_KEY_MAX), "Key generation failed");
+	zassert_equal(req_check_cnt, 1, "Last used key not checked first");
+}
+
+ZTEST(suite_fast_pair_keys, test_factory_reset)
+{
+	account_key_add(1);
+	account_key_add(2);
+	account_key_add(3);
+
+	last_used_set(3);
+
+	account_keys_remove();
+
+	zassert_equal(key_gen(3), -ESRCH, "Removed key accepted");
+	zassert_equal(req_check_cnt, 0, "Request checked without Account Keys");
+
+	account_key_add(4);
+	account_key_add(5);
+
+	zassert_equal(key_gen(3), -ESRCH, "Removed key accepted");
+	zassert_equal(req_check_cnt, 2, "Invalid number of checked keys");
+
+	zassert_ok(key_gen(5), "Key generation failed");
+	zassert_equal(req_check_cnt, 2, "Invalid number of checked keys");
+}
+
+ZTEST_SUITE(suite_fast_pair_keys, NULL, NULL, before_fn, NULL, NULL);
@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <bluetooth/services/hids.h>
+
+#define INPUT_REP_SIZE 2
+#define INPUT_REP_ID 1
+#define MASKED_REP_IDX 1
+#define MASKED_REP_ID 2
+#define PENDING_MAX CONFIG_BT_HIDS_NOTIFY_STATS_PENDING_MAX
+#define NOTIFY_MAX (2 * PENDING_MAX * CONFIG_BT_MAX_CONN)
+
+BT_HIDS_DEF(hids_obj, INPUT_REP_SIZE, INPUT_REP_SIZE);
+
+/* Only the first byte of the masked report is stored. */
+static const uint8_t masked_rep_mask[] = {0x01};
+
+static const uint8_t report_map[] = {
+	0x06, 0x00, 0xFF, /* Usage Page (Vendor Defined) */
+	0x09, 0x01,       /* Usage (Vendor Usage 1) */
+	0xA1, 0x01,       /* Collection (Application) */
+	0x85, INPUT_REP_ID, /* Report ID */
+	0x15, 0x00,       /* Logical Minimum (0) */
+	0x26, 0xFF, 0x00, /* Logical Maximum (255) */
+	0x75, 0x08,       /* Report Size (8) */
+	0x95, INPUT_REP_SIZE, /* Report Count */
+	0x09, 0x01,       /* Usage (Vendor Usage 1) */
+	0x81, 0x02,       /* Input (Data, Variable, Absolute) */
+	0x85, MASKED_REP_ID, /* Report ID */
+	0x95, INPUT_REP_SIZE, /* Report Count */
+	0x09, 0x01,       /* Usage (Vendor Usage 1) */
+	0x81, 0x02,       /* Input (Data, Variable, Absolute) */
+	0xC0              /* End Collection */
+};
+
+/* Connection objects are never dereferenced by HIDS, so any distinct
+ * addresses will do.
+ */
+static uint8_t conn_mem[CONFIG_BT_MAX_CONN];
+static bool conn_subscribed[CONFIG_BT_MAX_CONN];
+
+struct notification {
+	struct bt_conn *conn;
+	bt_gatt_complete_func_t func;
+	void *user_data;
+};
+
+static struct notification notifications[NOTIFY_MAX];
+static size_t notify_head;
+static size_t notify_tail;
+static int notify_err;
+
+struct completion {
+	char id;
+	struct bt_conn *conn;
+};
+
+static struct completion completions[NOTIFY_MAX];
+static size_t completion_cnt;
+
+static struct bt_conn *conn_get(size_t idx)
+{
+	return (struct bt_conn *)&conn_mem[idx];
+}
+
+uint8_t __wrap_bt_conn_index(const struct bt_conn *conn)
+{
+	return (const uint8_t *)conn - conn_mem;
+}
+
+bool __wrap_bt_gatt_is_subscribed(struct bt_conn *conn,
+				  const struct bt_gatt_attr *attr, uint16_t ccc_type)
+{
+	return conn_subscribed[__wrap_bt_conn_index(conn)];
+}
+
+int __wrap_bt_gatt_service_register(struct bt_gatt_service *svc)
+{
+	return 0;
+}
+
+int __wrap_bt_gatt_service_unregister(struct bt_gatt_service *svc)
+{
+	return 0;
+}
+
+static void notification_queue(struct bt_conn *conn, struct bt_gatt_notify_params *params)
+{
+	zassert_true(notify_tail - notify_head < ARRAY_SIZE(notifications),
+		     "Too many pending notifications");
+
+	notifications[notify_tail % ARRAY_SIZE(notifications)] = (struct notification) {
+		.conn = conn,
+		.func = params->func,
+		.user_data = params->user_data,
+	};
+	notify_tail++;
+}
+
+int __wrap_bt_gatt_notify_cb(struct bt_conn *conn, struct bt_gatt_notify_params *params)
+{
+	if (notify_err) {
+		return notify_err;
+	}
+
+	if (conn) {
+		notification_queue(conn, params);
+		return 0;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_subscribed); i++) {
+		if (conn_subscribed[i]) {
+			notification_queue(conn_get(i), params);
+		}
+	}
+
+	return 0;
+}
+
+static const struct notification *notification_peek(void)
+{
+	zassert_true(notify_head != notify_tail, "No pending notification");
+
+	return &notifications[notify_head % ARRAY_SIZE(notifications)];
+}
+
+static void notification_complete(void)
+{
+	const struct notification *n = notification_peek();
+
+	notify_head++;
+
+	if (n->func) {
+		n->func(n->conn, n->user_data);
+	}
+}
+
+static void completion_log(char id, struct bt_conn *conn)
+{
+	zassert_true(completion_cnt < ARRAY_SIZE(completions), "Too many completions");
+
+	completions[completion_cnt++] = (struct completion) {
+		.id = id,
+		.conn = conn,
+	};
+}
+
+static void complete_a(struct bt_conn *conn, void *user_data)
+{
+	completion_log('a', conn);
+}
+
+static void complete_b(struct bt_conn *conn, void *user_data)
+{
+	completion_log('b', conn);
+}
+
+static void complete_c(struct bt_conn *conn, void *user_data)
+{
+	completion_log('c', conn);
+}
+
+static void completion_check(size_t idx, char id, struct bt_conn *conn)
+{
+	zassert_true(idx < completion_cnt, "Completion %zu missing", idx);
+	zassert_equal(completions[idx].id, id, "Completion %zu: unexpected callback", idx);
+	zassert_equal_ptr(completions[idx].conn, conn, "Completion %zu: unexpected connection",
+			  idx);
+}
+
+static uint32_t notify_cnt_get(struct bt_conn *conn)
+{
+	struct bt_hids_notify_stats stats;
+
+	zassert_ok(bt_hids_notify_stats_get(&hids_obj, conn, &stats));
+
+	return stats.notify_cnt;
+}
+
+static int report_send(struct bt_conn *conn, bt_gatt_complete_func_t cb)
+{
+	static uint8_t rep[INPUT_REP_SIZE];
+
+	rep[0]++;
+
+	return bt_hids_inp_rep_send(&hids_obj, conn, 0, rep, sizeof(rep), cb);
+}
+
+static int report_fill_send(struct bt_conn *conn, uint8_t rep_idx, uint8_t value)
+{
+	uint8_t rep[INPUT_REP_SIZE];
+
+	memset(rep, value, sizeof(rep));
+
+	return bt_hids_inp_rep_send(&hids_obj, conn, rep_idx, rep, sizeof(rep), NULL);
+}
+
+static void report_check(struct bt_conn *conn, uint8_t rep_idx, uint8_t first, uint8_t rest)
+{
+	const struct bt_hids_inp_rep *inp_rep = &hids_obj.inp_rep_group.reports[rep_idx];
+	const struct bt_gatt_attr *attr = &hids_obj.gp.svc.attrs[inp_rep->att_ind];
+	uint8_t rep[INPUT_REP_SIZE];
+
+	zassert_equal(attr->read(conn, attr, rep, sizeof(rep), 0), sizeof(rep));
+
+	zassert_equal(rep[0], first, "Connection %u: unexpected report",
+		      __wrap_bt_conn_index(conn));
+	for (size_t i = 1; i < sizeof(rep); i++) {
+		zassert_equal(rep[i], rest, "Connection %u: unexpected report",
+			      __wrap_bt_conn_index(conn));
+	}
+}
+
+static bool shared_ref_check(struct bt_conn *conn, uint8_t rep_idx)
+{
+	return atomic_test_bit(hids_obj.inp_rep_group.reports[rep_idx].shared_refs,
+			       __wrap_bt_conn_index(conn));
+}
+
+static void subscription_set(struct bt_conn *conn, bool subscribed)
+{
+	conn_subscribed[__wrap_bt_conn_index(conn)] = subscribed;
+
+	for (size_t i = 0; i < hids_obj.inp_rep_group.cnt; i++) {
+		const struct bt_hids_inp_rep *inp_rep = &hids_obj.inp_rep_group.reports[i];
+		const struct bt_gatt_attr *ccc_attr =
+			&hids_obj.gp.svc.attrs[inp_rep->att_ind + 1];
+		const struct _bt_gatt_ccc *ccc = ccc_attr->user_data;
+
+		ccc->cfg_changed(ccc_attr, subscribed ? BT_GATT_CCC_NOTIFY : 0);
+	}
+}
+
+static void *hids_setup(void)
+{
+	struct bt_hids_init_param init_param = {0};
+	struct bt_hids_inp_rep *inp_rep = &init_param.inp_rep_group_init.reports[0];
+	struct bt_hids_inp_rep *masked_rep =
+		&init_param.inp_rep_group_init.reports[MASKED_REP_IDX];
+
+	init_param.rep_map.data = report_map;
+	init_param.rep_map.size = sizeof(report_map);
+	init_param.info.bcd_hid = 0x0101;
+	init_param.info.flags = BT_HIDS_REMOTE_WAKE | BT_HIDS_NORMALLY_CONNECTABLE;
+
+	inp_rep->size = INPUT_REP_SIZE;
+	inp_rep->id = INPUT_REP_ID;
+	masked_rep->size = INPUT_REP_SIZE;
+	masked_rep->id = MASKED_REP_ID;
+	masked_rep->rep_mask = masked_rep_mask;
+	init_param.inp_rep_group_init.cnt = 2;
+
+	zassert_ok(bt_hids_init(&hids_obj, &init_param));
+
+	return NULL;
+}
+
+static void hids_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	notify_head = 0;
+	notify_tail = 0;
+	notify_err = 0;
+	completion_cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_subscribed); i++) {
+		conn_subscribed[i] = true;
+		zassert_ok(bt_hids_connected(&hids_obj, conn_get(i)));
+	}
+}
+
+static void hids_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_subscribed); i++) {
+		zassert_ok(bt_hids_disconnected(&hids_obj, conn_get(i)));
+	}
+}
+
+ZTEST(hids, test_overlapping_notifications)
+{
+	struct bt_conn *conn = conn_get(0);
+
+	zassert_ok(report_send(conn, complete_a));
+	zassert_ok(report_send(conn, complete_b));
+	zassert_ok(report_send(conn, NULL));
+
+	notification_complete();
+	notification_complete();
+	notification_complete();
+
+	zassert_equal(completion_cnt, 2);
+	completion_check(0, 'a', conn);
+	completion_check(1, 'b', conn);
+	zassert_equal(notify_cnt_get(conn), 3);
+}
+
+ZTEST(hids, test_notify_all_overlapping)
+{
+	zassert_ok(report_send(NULL, complete_a));
+	zassert_ok(report_send(conn_get(1), complete_b));
+
+	/* Notifications to all connections are queued per connection. */
+	for (size_t i = 0; i < (CONFIG_BT_MAX_CONN + 1); i++) {
+		notification_complete();
+	}
+
+	zassert_equal(completion_cnt, CONFIG_BT_MAX_CONN + 1);
+	completion_check(0, 'a', conn_get(0));
+	completion_check(1, 'a', conn_get(1));
+	completion_check(2, 'b', conn_get(1));
+	zassert_equal(notify_cnt_get(conn_get(0)), 1);
+	zassert_equal(notify_cnt_get(conn_get(1)), 2);
+}
+
+ZTEST(hids, test_failed_notification)
+{
+	struct bt_conn *conn = conn_get(0);
+	struct bt_hids_notify_timing *timing = &hids_obj.notify_timing[0];
+
+	notify_err = -ENOMEM;
+	zassert_equal(report_send(conn, complete_a), -ENOMEM);
+	zassert_equal(report_send(NULL, complete_a), -ENOMEM);
+	zassert_equal(timing->tx_seq, timing->rx_seq, "Failed notification left pending");
+
+	notify_err = 0;
+	zassert_ok(report_send(conn, complete_b));
+	notification_complete();
+
+	zassert_equal(completion_cnt, 1);
+	completion_check(0, 'b', conn);
+	zassert_equal(notify_cnt_get(conn), 1);
+	zassert_equal(timing->tx_seq, timing->rx_seq);
+}
+
+ZTEST(hids, test_pending_limit)
+{
+	struct bt_conn *conn = conn_get(0);
+
+	for (size_t i = 0; i < PENDING_MAX; i++) {
+		zassert_ok(report_send(conn, complete_a));
+	}
+
+	/* Sent without timing, the callback is passed to GATT directly. */
+	zassert_ok(report_send(conn, complete_b));
+	zassert_equal_ptr(notifications[PENDING_MAX].func, complete_b);
+
+	for (size_t i = 0; i <= PENDING_MAX; i++) {
+		notification_complete();
+	}
+
+	zassert_equal(completion_cnt, PENDING_MAX + 1);
+	for (size_t i = 0; i < PENDING_MAX; i++) {
+		completion_check(i, 'a', conn);
+	}
+	completion_check(PENDING_MAX, 'b', conn);
+	zassert_equal(notify_cnt_get(conn), PENDING_MAX);
+}
+
+ZTEST(hids, test_disconnect_with_pending)
+{
+	struct bt_conn *conn = conn_get(0);
+
+	zassert_ok(report_send(conn, complete_a));
+
+	zassert_ok(bt_hids_disconnected(&hids_obj, conn));
+	zassert_ok(bt_hids_connected(&hids_obj, conn));
+
+	/* A notification pending across the reset is not counted, but its
+	 * callback is still called.
+	 */
+	notification_complete();
+	zassert_equal(notify_cnt_get(conn), 0);
+
+	zassert_ok(report_send(conn, complete_b));
+	notification_complete();
+
+	zassert_equal(completion_cnt, 2);
+	completion_check(0, 'a', conn);
+	completion_check(1, 'b', conn);
+	zassert_equal(notify_cnt_get(conn), 1);
+}
+
+ZTEST(hids, test_callback_limit)
+{
+	struct bt_conn *conn = conn_get(0);
+
+	/* Use up all callback entries of the report. */
+	zassert_ok(report_send(conn, complete_a));
+	zassert_ok(report_send(conn, complete_b));
+	zassert_ok(report_send(conn, NULL));
+
+	/* Sent without timing, the callback is passed to GATT directly. */
+	zassert_ok(report_send(conn, complete_c));
+	zassert_equal_ptr(notifications[3].func, complete_c);
+
+	for (size_t i = 0; i < 4; i++) {
+		notification_complete();
+	}
+
+	zassert_equal(completion_cnt, 3);
+	completion_check(0, 'a', conn);
+	completion_check(1, 'b', conn);
+	completion_check(2, 'c', conn);
+	zassert_equal(notify_cnt_get(conn), 3);
+}
+
+ZTEST(hids, test_shared_report)
+{
+	zassert_ok(report_fill_send(NULL, 0, 1));
+
+	for (size_t i = 0; i < CONFIG_BT_MAX_CONN; i++) {
+		zassert_true(shared_ref_check(conn_get(i), 0));
+		report_check(conn_get(i), 0, 1, 1);
+	}
+
+	/* Sending to one connection gives it its own copy of the report. */
+	zassert_ok(report_fill_send(conn_get(0), 0, 2));
+	zassert_false(shared_ref_check(conn_get(0), 0));
+	zassert_true(shared_ref_check(conn_get(1), 0));
+	report_check(conn_get(0), 0, 2, 2);
+	report_check(conn_get(1), 0, 1, 1);
+
+	zassert_ok(report_fill_send(NULL, 0, 3));
+
+	for (size_t i = 0; i < CONFIG_BT_MAX_CONN; i++) {
+		zassert_true(shared_ref_check(conn_get(i), 0));
+		report_check(conn_get(i), 0, 3, 3);
+	}
+}
+
+ZTEST(hids, test_shared_report_unsubscribe)
+{
+	zassert_ok(report_fill_send(NULL, 0, 1));
+
+	subscription_set(conn_get(1), false);
+	zassert_ok(report_fill_send(NULL, 0, 2));
+
+	/* The unsubscribed connection keeps the last report it was sent. */
+	zassert_true(shared_ref_check(conn_get(0), 0));
+	zassert_false(shared_ref_check(conn_get(1), 0));
+	report_check(conn_get(0), 0, 2, 2);
+	report_check(conn_get(1), 0, 1, 1);
+
+	subscription_set(conn_get(1), true);
+	zassert_ok(report_fill_send(NULL, 0, 3));
+
+	for (size_t i = 0; i < CONFIG_BT_MAX_CONN; i++) {
+		zassert_true(shared_ref_check(conn_get(i), 0));
+		report_check(conn_get(i), 0, 3, 3);
+	}
+}
+
+ZTEST(hids, test_shared_report_disconnect)
+{
+	zassert_ok(report_fill_send(NULL, 0, 1));
+
+	zassert_ok(bt_hids_disconnected(&hids_obj, conn_get(1)));
+	zassert_false(shared_ref_check(conn_get(1), 0));
+
+	/* A new connection does not see the report of the previous one. */
+	zassert_ok(bt_hids_connected(&hids_obj, conn_get(1)));
+	zassert_false(shared_ref_check(conn_get(1), 0));
+	report_check(conn_get(0), 0, 1, 1);
+	report_check(conn_get(1), 0, 0, 0);
+
+	zassert_ok(report_fill_send(NULL, 0, 2));
+	report_check(conn_get(0), 0, 2, 2);
+	report_check(conn_get(1), 0, 2, 2);
+}
+
+ZTEST(hids, test_masked_report)
+{
+	zassert_ok(report_fill_send(NULL, MASKED_REP_IDX, 1));
+
+	/* Masked reports are stored per connection. */
+	for (size_t i = 0; i < CONFIG_BT_MAX_CONN; i++) {
+		zassert_false(shared_ref_check(conn_get(i), MASKED_REP_IDX));
+		report_check(conn_get(i), MASKED_REP_IDX, 1, 0);
+	}
+
+	subscription_set(conn_get(1), false);
+	zassert_ok(report_fill_send(NULL, MASKED_REP_IDX, 2));
+
+	report_check(conn_get(0), MASKED_REP_IDX, 2, 0);
+	report_check(conn_get(1), MASKED_REP_IDX, 1, 0);
+
+	/* The report sharing the buffer is not affected. */
+	zassert_ok(report_fill_send(NULL, 0, 3));
+	report_check(conn_get(0), 0, 3, 3);
+	report_check(conn_get(0), MASKED_REP_IDX, 2, 0);
+}
+
+ZTEST_SUITE(hids, NULL, hids_setup, hids_before, hids_after, NULL);
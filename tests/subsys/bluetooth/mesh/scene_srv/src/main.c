@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <bluetooth/mesh/models.h>
+#include "mesh/access.h"
+
+#define TEST_MODEL_ID BT_MESH_MODEL_ID_GEN_ONOFF_SRV
+/* Every scene is stored in a single page. The cache fits two of them. */
+#define TEST_ENTRY_LEN 100
+#define TEST_PAGES_MAX 8
+
+struct test_page {
+	uint16_t scene;
+	uint8_t page;
+	uint8_t data[SETTINGS_MAX_VAL_LEN];
+	size_t len;
+};
+
+static struct bt_mesh_scene_srv scene_srv;
+
+static struct bt_mesh_model models[] = {
+	BT_MESH_MODEL_SCENE_SRV(&scene_srv),
+	BT_MESH_MODEL(TEST_MODEL_ID, NULL, NULL, NULL),
+};
+
+static struct bt_mesh_model *test_model = &models[2];
+static struct bt_mesh_model *setup_model = &models[1];
+
+static struct bt_mesh_elem elems[] = {
+	BT_MESH_ELEM(0, models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem = elems,
+	.elem_count = ARRAY_SIZE(elems),
+};
+
+/* Scene data stored in settings. */
+static struct test_page store[TEST_PAGES_MAX];
+static size_t settings_loads;
+static bool provisioned;
+
+/* State of the test model. */
+static uint8_t test_state;
+static uint8_t recalled_state;
+
+static ssize_t test_entry_store(struct bt_mesh_model *model, uint8_t data[])
+{
+	memset(data, test_state, TEST_ENTRY_LEN);
+
+	return TEST_ENTRY_LEN;
+}
+
+static void test_entry_recall(struct bt_mesh_model *model, const uint8_t data[], size_t len,
+			      struct bt_mesh_model_transition *transition)
+{
+	zassert_equal(model, test_model);
+	zassert_equal(len, TEST_ENTRY_LEN);
+
+	recalled_state = data[0];
+}
+
+BT_MESH_SCENE_ENTRY_SIG(test) = {
+	.id.sig = TEST_MODEL_ID,
+	.maxlen = TEST_ENTRY_LEN,
+	.store = test_entry_store,
+	.recall = test_entry_recall,
+};
+
+static struct test_page *page_find(uint16_t scene, uint8_t page)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(store); i++) {
+		if (store[i].len && store[i].scene == scene && store[i].page == page) {
+			return &store[i];
+		}
+	}
+
+	return NULL;
+}
+
+static ssize_t page_read(void *cb_arg, void *data, size_t len)
+{
+	struct test_page *page = cb_arg;
+
+	zassert_true(len >= page->len);
+	memcpy(data, page->data, page->len);
+
+	return page->len;
+}
+
+/* Pass the stored pages of a scene, or of all scenes, to the Scene Server. */
+static void pages_load(uint16_t scene)
+{
+	char path[9];
+
+	for (size_t i = 0; i < ARRAY_SIZE(store); i++) {
+		struct test_page *page = &store[i];
+
+		if (!page->len || (scene != BT_MESH_SCENE_NONE && page->scene != scene)) {
+			continue;
+		}
+
+		sprintf(path, "%x/s%x", page->scene, page->page);
+		zassert_ok(_bt_mesh_scene_srv_cb.settings_set(scene_srv.model, path, page->len,
+							       page_read, page));
+	}
+}
+
+/* Redefined mocks */
+
+const struct bt_mesh_comp *bt_mesh_comp_get(void)
+{
+	return &comp;
+}
+
+uint16_t bt_mesh_elem_count(void)
+{
+	return comp.elem_count;
+}
+
+struct bt_mesh_elem *bt_mesh_model_elem(struct bt_mesh_model *mod)
+{
+	return &elems[mod->elem_idx];
+}
+
+struct bt_mesh_model *bt_mesh_model_find(const struct bt_mesh_elem *elem, uint16_t id)
+{
+	for (int i = 0; i < elem->model_count; i++) {
+		if (elem->models[i].id == id) {
+			return &elem->models[i];
+		}
+	}
+
+	return NULL;
+}
+
+struct bt_mesh_model *bt_mesh_model_find_vnd(const struct bt_mesh_elem *elem, uint16_t company,
+					     uint16_t id)
+{
+	return NULL;
+}
+
+bool bt_mesh_model_is_extended(struct bt_mesh_model *model)
+{
+	return false;
+}
+
+int bt_mesh_model_extend(struct bt_mesh_model *extending_mod, struct bt_mesh_model *base_mod)
+{
+	return 0;
+}
+
+struct bt_mesh_dtt_srv *bt_mesh_dtt_srv_get(const struct bt_mesh_elem *elem)
+{
+	return NULL;
+}
+
+bool bt_mesh_is_provisioned(void)
+{
+	return provisioned;
+}
+
+void bt_mesh_model_msg_init(struct net_buf_simple *msg, uint32_t opcode)
+{
+	net_buf_simple_init(msg, 0);
+}
+
+int bt_mesh_msg_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		     struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+const char *bt_hex(const void *buf, size_t len)
+{
+	return "";
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd, const char *name,
+			     const void *data, size_t data_len)
+{
+	struct test_page *page;
+	unsigned int scene;
+	unsigned int idx;
+	char type;
+
+	zassert_equal(mod, scene_srv.model);
+	zassert_equal(sscanf(name, "%x/%c%x", &scene, &type, &idx), 3, "Invalid path %s", name);
+	zassert_equal(type, 's', "Unexpected vendor model data");
+
+	page = page_find(scene, idx);
+	if (!data_len) {
+		if (page) {
+			page->len = 0;
+		}
+
+		return 0;
+	}
+
+	for (size_t i = 0; !page && i < ARRAY_SIZE(store); i++) {
+		if (!store[i].len) {
+			page = &store[i];
+		}
+	}
+
+	zassert_not_null(page, "Out of pages");
+	zassert_true(data_len <= sizeof(page->data));
+
+	page->scene = scene;
+	page->page = idx;
+	page->len = data_len;
+	memcpy(page->data, data, data_len);
+
+	return 0;
+}
+
+int settings_load_subtree(const char *subtree)
+{
+	char path[25];
+	uint16_t scene;
+
+	scene = strtol(strrchr(subtree, '/') + 1, NULL, 16);
+	sprintf(path, "bt/mesh/s/%x/data/%x",
+		(scene_srv.model->elem_idx << 8) | scene_srv.model->mod_idx, scene);
+	zassert_equal(strcmp(subtree, path), 0, "Unexpected subtree %s", subtree);
+
+	settings_loads++;
+	pages_load(scene);
+
+	return 0;
+}
+
+int settings_name_next(const char *name, const char **next)
+{
+	const char *sep = strchr(name, '/');
+
+	if (!sep) {
+		*next = NULL;
+		return strlen(name);
+	}
+
+	*next = sep + 1;
+
+	return sep - name;
+}
+
+/* Redefined mocks */
+
+/* Send a Scene Store or Scene Delete message to the Scene Setup Server. */
+static void setup_msg_send(uint32_t opcode, uint16_t scene)
+{
+	const struct bt_mesh_model_op *op;
+	struct bt_mesh_msg_ctx ctx = { 0 };
+
+	NET_BUF_SIMPLE_DEFINE(buf, sizeof(scene));
+	net_buf_simple_add_le16(&buf, scene);
+
+	for (op = _bt_mesh_scene_setup_srv_op; op->func; op++) {
+		if (op->opcode == opcode) {
+			zassert_ok(op->func(setup_model, &ctx, &buf));
+			return;
+		}
+	}
+
+	zassert_unreachable("No handler for opcode 0x%x", opcode);
+}
+
+static void scene_store(uint16_t scene, uint8_t state)
+{
+	test_state = state;
+	setup_msg_send(BT_MESH_SCENE_OP_STORE, scene);
+}
+
+static void scene_delete(uint16_t scene)
+{
+	setup_msg_send(BT_MESH_SCENE_OP_DELETE, scene);
+}
+
+static void recall_check(uint16_t scene, uint8_t state, bool cached)
+{
+	struct bt_mesh_scene_srv_recall_stats stats;
+	size_t loads = settings_loads;
+
+	/* Recalling the current scene is ignored. */
+	bt_mesh_scene_invalidate(test_model);
+	bt_mesh_scene_srv_recall_stats_reset(&scene_srv);
+	recalled_state = 0;
+
+	zassert_ok(bt_mesh_scene_srv_set(&scene_srv, scene, NULL));
+	zassert_equal(recalled_state, state, "Scene 0x%x: wrong state 0x%x", scene,
+		      recalled_state);
+
+	bt_mesh_scene_srv_recall_stats_get(&scene_srv, &stats);
+	zassert_equal(stats.recalls, 1);
+	zassert_equal(stats.cache_hits, cached, "Scene 0x%x: cache hits %u", scene,
+		      stats.cache_hits);
+	zassert_equal(settings_loads - loads, cached ? 0 : 1,
+		      "Scene 0x%x: %zu settings loads", scene, settings_loads - loads);
+}
+
+static void *scene_srv_setup(void)
+{
+	zassert_ok(_bt_mesh_scene_srv_cb.init(&models[0]));
+
+	return NULL;
+}
+
+static void scene_srv_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	provisioned = true;
+	_bt_mesh_scene_srv_cb.reset(scene_srv.model);
+	zassert_equal(scene_srv.count, 0);
+
+	memset(store, 0, sizeof(store));
+	settings_loads = 0;
+	recalled_state = 0;
+}
+
+ZTEST(bt_mesh_scene_srv, test_recall_cached)
+{
+	scene_store(1, 0x11);
+	scene_store(2, 0x22);
+
+	recall_check(1, 0x11, true);
+	recall_check(2, 0x22, true);
+
+	/* The cached scene is replaced when the scene is stored again. */
+	scene_store(1, 0x33);
+	recall_check(1, 0x33, true);
+	recall_check(2, 0x22, true);
+}
+
+ZTEST(bt_mesh_scene_srv, test_cache_overflow)
+{
+	scene_store(1, 0x11);
+	scene_store(2, 0x22);
+	scene_store(3, 0x33);
+
+	/* The scene that does not fit is recalled from settings. */
+	recall_check(3, 0x33, false);
+	recall_check(1, 0x11, true);
+	recall_check(2, 0x22, true);
+}
+
+ZTEST(bt_mesh_scene_srv, test_delete)
+{
+	scene_store(1, 0x11);
+	scene_store(2, 0x22);
+	scene_store(3, 0x33);
+
+	/* The scenes after the deleted scene are moved up in the cache. */
+	scene_delete(1);
+	zassert_equal(bt_mesh_scene_srv_set(&scene_srv, 1, NULL), -ENOENT);
+	recall_check(2, 0x22, true);
+
+	/* Storing the scene again after the deletion made room for it. */
+	scene_store(3, 0x44);
+	recall_check(3, 0x44, true);
+	recall_check(2, 0x22, true);
+}
+
+ZTEST(bt_mesh_scene_srv, test_reset)
+{
+	scene_store(1, 0x11);
+	scene_store(2, 0x22);
+
+	_bt_mesh_scene_srv_cb.reset(scene_srv.model);
+	zassert_equal(scene_srv.count, 0);
+
+	/* The cache is emptied along with the settings. */
+	scene_store(3, 0x33);
+	scene_store(4, 0x44);
+	recall_check(3, 0x33, true);
+	recall_check(4, 0x44, true);
+}
+
+ZTEST(bt_mesh_scene_srv, test_start_fill)
+{
+	struct test_page stored[ARRAY_SIZE(store)];
+
+	scene_store(1, 0x11);
+	scene_store(2, 0x22);
+	scene_store(3, 0x33);
+
+	/* Reboot, keeping the stored scenes. */
+	memcpy(stored, store, sizeof(store));
+	_bt_mesh_scene_srv_cb.reset(scene_srv.model);
+	memcpy(store, stored, sizeof(store));
+
+	/* The scenes are only registered when the settings are loaded. */
+	provisioned = false;
+	pages_load(BT_MESH_SCENE_NONE);
+	provisioned = true;
+	zassert_equal(scene_srv.count, 3);
+	zassert_equal(recalled_state, 0);
+
+	settings_loads = 0;
+	zassert_ok(_bt_mesh_scene_srv_cb.start(scene_srv.model));
+	zassert_equal(settings_loads, 3);
+	zassert_equal(recalled_state, 0, "Scene recalled when loading the cache");
+
+	recall_check(1, 0x11, true);
+	recall_check(2, 0x22, true);
+	recall_check(3, 0x33, false);
+}
+
+ZTEST_SUITE(bt_mesh_scene_srv, NULL, scene_srv_setup, scene_srv_before, NULL, NULL);
@@ -26,6 +26,9 @@ enum test_id {
 	TEST_BASIC,
 	TEST_ORDER,
 	TEST_STATUS,
+	TEST_OVERRUN,
+	TEST_STATUS_FULL,
+	TEST_DIRECT,
 
 	TEST_CNT
 };
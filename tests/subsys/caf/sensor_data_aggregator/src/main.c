@@ -11,6 +11,8 @@
 #include <caf/events/sensor_event.h>
 #include "test_config.h"
 #include <zephyr/drivers/sensor.h>
+#include <caf/events/sensor_data_aggregator_event.h>
+#include <caf/sensor_data_aggregator.h>
 
 static enum test_id cur_test_id;
 static K_SEM_DEFINE(test_end_sem, 0, 1);
@@ -96,11 +98,98 @@ ZTEST(caf_sensor_aggregator_tests, test_order)
 	zassert_ok(err, "Test execution hanged");
 }
 
+static void submit_overrun_samples(size_t cnt)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		struct sensor_event *se = new_sensor_event(sizeof(struct sensor_value));
+
+		zassert_not_null(se, "Failed to allocate event");
+		se->descr = OVERRUN_TEST_AGG_DESCR;
+		se->dyndata.size = sizeof(struct sensor_value);
+		APP_EVENT_SUBMIT(se);
+	}
+}
+
+ZTEST(caf_sensor_aggregator_tests, test_overrun)
+{
+	cur_test_id = TEST_OVERRUN;
+	struct test_start_event *ts = new_test_start_event();
+
+	zassert_not_null(ts, "Failed to allocate event");
+	ts->test_id = cur_test_id;
+	APP_EVENT_SUBMIT(ts);
+
+	/* Fill the only buffer. The receiver holds it, so the following samples are dropped. */
+	submit_overrun_samples(OVERRUN_TEST_SAMPLES_IN_AGG_BUF + OVERRUN_TEST_DROPPED_SAMPLES);
+	k_sleep(K_MSEC(100));
+
+	zassert_not_null(overrun_held_samples, "Buffer not received");
+
+	struct sensor_data_aggregator_release_buffer_event *release_evt =
+		new_sensor_data_aggregator_release_buffer_event();
+
+	zassert_not_null(release_evt, "Failed to allocate event");
+	release_evt->samples = overrun_held_samples;
+	release_evt->sensor_descr = OVERRUN_TEST_AGG_DESCR;
+	APP_EVENT_SUBMIT(release_evt);
+
+	/* The next buffer reports the dropped samples. */
+	submit_overrun_samples(OVERRUN_TEST_SAMPLES_IN_AGG_BUF);
+
+	int err = k_sem_take(&test_end_sem, K_SECONDS(30));
+
+	zassert_ok(err, "Test execution hanged");
+}
+
 ZTEST(caf_sensor_aggregator_tests, test_status)
 {
 	test_start(TEST_STATUS);
 }
 
+ZTEST(caf_sensor_aggregator_tests, test_status_full)
+{
+	test_start(TEST_STATUS_FULL);
+}
+
+ZTEST(caf_sensor_aggregator_tests, test_direct)
+{
+	struct sensor_value *data;
+
+	zassert_equal(sensor_data_aggregator_sample_claim("void_unknown_sensor",
+							  DIRECT_TEST_SENSOR_SAMPLE_SIZE, &data),
+		      -ENOENT, "Claimed sample of unknown sensor");
+	zassert_equal(sensor_data_aggregator_sample_commit("void_unknown_sensor"), -ENOENT,
+		      "Committed sample of unknown sensor");
+	zassert_equal(sensor_data_aggregator_sample_claim(DIRECT_TEST_AGG_DESCR,
+							  DIRECT_TEST_SENSOR_SAMPLE_SIZE + 1,
+							  &data),
+		      -EBADMSG, "Claimed sample of invalid size");
+
+	cur_test_id = TEST_DIRECT;
+	struct test_start_event *ts = new_test_start_event();
+
+	zassert_not_null(ts, "Failed to allocate event");
+	ts->test_id = cur_test_id;
+	APP_EVENT_SUBMIT(ts);
+
+	for (size_t i = 0; i < DIRECT_TEST_SAMPLES_IN_AGG_BUF; i++) {
+		zassert_ok(sensor_data_aggregator_sample_claim(DIRECT_TEST_AGG_DESCR,
+							       DIRECT_TEST_SENSOR_SAMPLE_SIZE,
+							       &data),
+			   "Failed to claim sample");
+
+		data[0].val1 = (int32_t)i;
+		data[1].val1 = -(int32_t)i;
+
+		zassert_ok(sensor_data_aggregator_sample_commit(DIRECT_TEST_AGG_DESCR),
+			   "Failed to commit sample");
+	}
+
+	int err = k_sem_take(&test_end_sem, K_SECONDS(30));
+
+	zassert_ok(err, "Test execution hanged");
+}
+
 static bool app_event_handler(const struct app_event_header *aeh)
 {
 	if (is_test_end_event(aeh)) {
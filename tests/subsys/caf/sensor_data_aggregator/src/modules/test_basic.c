@@ -65,6 +65,29 @@ static bool app_event_handler(const struct app_event_header *aeh)
 			break;
 		}
 
+		case TEST_STATUS_FULL:
+		{
+			/* The state change follows the sample that fills the buffer. */
+			for (size_t i = 0; i < STATUS_FULL_TEST_SAMPLES_IN_AGG_BUF; i++) {
+				struct sensor_event *se = new_sensor_event(sizeof(struct sensor_value));
+
+				zassert_not_null(se, "Failed to allocate event");
+				se->descr = STATUS_FULL_TEST_AGG_DESCR;
+				se->dyndata.size = sizeof(struct sensor_value);
+				se->dyndata.data[0] = i;
+				APP_EVENT_SUBMIT(se);
+			}
+
+			struct sensor_state_event *sse = new_sensor_state_event();
+
+			zassert_not_null(sse, "Failed to allocate event");
+			sse->descr = STATUS_FULL_TEST_AGG_DESCR;
+			sse->state = SENSOR_STATE_SLEEP;
+			APP_EVENT_SUBMIT(sse);
+
+			break;
+		}
+
 		default:
 			/* Ignore other test cases, check if proper test_id. */
 			zassert_true(st->test_id < TEST_CNT,
@@ -16,3 +16,14 @@
 #define BASIC_TEST_AGG_DESCR "void_basic_test_sensor"
 #define ORDER_TEST_AGG_DESCR "void_order_test_sensor"
 #define STATUS_TEST_AGG_DESCR "void_status_test_sensor"
+#define OVERRUN_TEST_SAMPLES_IN_AGG_BUF 5
+#define OVERRUN_TEST_DROPPED_SAMPLES 3
+#define OVERRUN_TEST_AGG_DESCR "void_overrun_test_sensor"
+#define STATUS_FULL_TEST_SAMPLES_IN_AGG_BUF 5
+#define STATUS_FULL_TEST_AGG_DESCR "void_status_full_test_sensor"
+#define DIRECT_TEST_SAMPLES_IN_AGG_BUF 5
+#define DIRECT_TEST_SENSOR_SAMPLE_SIZE 2
+#define DIRECT_TEST_AGG_DESCR "void_direct_test_sensor"
+
+/* Buffer held by the data receiver during the overrun test. */
+extern struct sensor_value *overrun_held_samples;
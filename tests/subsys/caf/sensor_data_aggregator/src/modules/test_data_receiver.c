@@ -19,6 +19,9 @@
 static enum test_id cur_test_id;
 int msg_num;
 int order_event_indicator = SAMPLES_IN_AGG_BUF * ORDER_TEST_AGG_EVENTS;
+struct sensor_value *overrun_held_samples;
+static int64_t overrun_timestamp;
+static size_t status_full_buf_cnt;
 
 static bool app_event_handler(const struct app_event_header *aeh)
 {
@@ -34,6 +37,24 @@ static bool app_event_handler(const struct app_event_header *aeh)
 		const struct sensor_data_aggregator_event *event =
 			cast_sensor_data_aggregator_event(aeh);
 
+		if (strcmp(event->sensor_descr, OVERRUN_TEST_AGG_DESCR) == 0) {
+			zassert_equal(event->sample_cnt, OVERRUN_TEST_SAMPLES_IN_AGG_BUF,
+				      "Buffer not full");
+
+			if (!overrun_held_samples) {
+				/* Hold the only buffer, so that the next samples are dropped. */
+				zassert_equal(event->dropped_cnt, 0, "Unexpected dropped samples");
+				overrun_held_samples = event->samples;
+				overrun_timestamp = event->timestamp;
+				return false;
+			}
+
+			zassert_equal(event->dropped_cnt, OVERRUN_TEST_DROPPED_SAMPLES,
+				      "Invalid number of dropped samples");
+			zassert_true(event->timestamp >= overrun_timestamp,
+				     "Invalid buffer timestamp");
+		}
+
 		struct sensor_data_aggregator_release_buffer_event *release_evt =
 		new_sensor_data_aggregator_release_buffer_event();
 
@@ -71,6 +92,12 @@ static bool app_event_handler(const struct app_event_header *aeh)
 				APP_EVENT_SUBMIT(te);
 			}
 
+		} else if (strcmp(event->sensor_descr, OVERRUN_TEST_AGG_DESCR) == 0) {
+			struct test_end_event *te = new_test_end_event();
+
+			zassert_not_null(te, "Failed to allocate event");
+			te->test_id = cur_test_id;
+			APP_EVENT_SUBMIT(te);
 		} else if (strcmp(event->sensor_descr, STATUS_TEST_AGG_DESCR) == 0) {
 
 			for (int k = 0; k < STATUS_TEST_SENSOR_EVENTS; k++) {
@@ -82,6 +109,49 @@ static bool app_event_handler(const struct app_event_header *aeh)
 
 			struct test_end_event *te = new_test_end_event();
 
+			zassert_not_null(te, "Failed to allocate event");
+			te->test_id = cur_test_id;
+			APP_EVENT_SUBMIT(te);
+		} else if (strcmp(event->sensor_descr, STATUS_FULL_TEST_AGG_DESCR) == 0) {
+
+			if (status_full_buf_cnt++ == 0) {
+				zassert_equal(event->sample_cnt, STATUS_FULL_TEST_SAMPLES_IN_AGG_BUF,
+					      "Buffer not full");
+
+				for (int k = 0; k < STATUS_FULL_TEST_SAMPLES_IN_AGG_BUF; k++) {
+					uint8_t *event_data = (uint8_t *)&event->samples[k];
+
+					zassert_equal(*event_data, k, "Incorrent event order");
+				}
+				return false;
+			}
+
+			/* The full buffer is still held, the state is sent in the next one. */
+			zassert_equal(event->sample_cnt, 0, "Unexpected samples");
+			zassert_equal(event->sensor_state, SENSOR_STATE_SLEEP,
+				      "Sensor state not reported");
+
+			struct test_end_event *te = new_test_end_event();
+
+			zassert_not_null(te, "Failed to allocate event");
+			te->test_id = cur_test_id;
+			APP_EVENT_SUBMIT(te);
+		} else if (strcmp(event->sensor_descr, DIRECT_TEST_AGG_DESCR) == 0) {
+			zassert_equal(event->sample_cnt, DIRECT_TEST_SAMPLES_IN_AGG_BUF,
+				      "Buffer not full");
+			zassert_equal(event->values_in_sample, DIRECT_TEST_SENSOR_SAMPLE_SIZE,
+				      "Invalid sample size");
+
+			for (int k = 0; k < DIRECT_TEST_SAMPLES_IN_AGG_BUF; k++) {
+				const struct sensor_value *sample =
+					&event->samples[k * DIRECT_TEST_SENSOR_SAMPLE_SIZE];
+
+				zassert_equal(sample[0].val1, k, "Incorrent sample order");
+				zassert_equal(sample[1].val1, -k, "Invalid sample value");
+			}
+
+			struct test_end_event *te = new_test_end_event();
+
 			zassert_not_null(te, "Failed to allocate event");
 			te->test_id = cur_test_id;
 			APP_EVENT_SUBMIT(te);
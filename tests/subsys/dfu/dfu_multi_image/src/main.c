@@ -243,6 +243,28 @@ ZTEST(dfu_multi_image_test, test_skipped_image)
 		   "DFU failed");
 }
 
+ZTEST(dfu_multi_image_test, test_stats)
+{
+	uint8_t buffer[128];
+	struct dfu_multi_image_stats stats;
+
+	zassert_ok(comparison_test(two_image_package, sizeof(two_image_package),
+				   &two_image_package_expected, buffer, sizeof(buffer), 1),
+		   "DFU failed");
+
+	for (size_t i = 0; i < two_image_package_expected.image_count; i++) {
+		const struct expected_image *image = &two_image_package_expected.images[i];
+
+		zassert_ok(dfu_multi_image_stats_get(image->image_id, &stats),
+			   "Failed to get image stats");
+		zassert_equal(stats.bytes_written, image->content_size,
+			      "Unexpected number of bytes written");
+	}
+
+	zassert_equal(dfu_multi_image_stats_get(1, &stats), -ENOENT,
+		      "Stats returned for image not in the package");
+}
+
 /*
  * See CMakeLists.txt of the test project for parameters passed to the script generating
  * the DFU Multi Image package. The expected values below should match the parameters.
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/addr.h>
+#include <dm.h>
+#include "timeslot_queue.h"
+
+#define QUEUE_LENGTH CONFIG_DM_TIMESLOT_QUEUE_LENGTH
+#define COUNT_SAME_PEER CONFIG_DM_TIMESLOT_QUEUE_COUNT_SAME_PEER
+#define PEER_COUNT CONFIG_DM_TIMESLOT_QUEUE_PEER_COUNT
+
+#define TIMESLOT_LEN_US 1000
+#define WINDOW_LEN_US 500
+/* Far enough apart for the timeslots not to collide. */
+#define TIMESLOT_TICKS 1000
+#define CHURN_PEERS 50
+
+/* The peer table is kept between tests, so each test uses its own peers. */
+#define PEER_FIFO 1
+#define PEER_ADMISSION 10
+#define PEER_FULL 20
+#define PEER_LATE 40
+#define PEER_CHURN 50
+
+static uint32_t ref_tick;
+
+static bt_addr_le_t addr_get(uint8_t id)
+{
+	bt_addr_le_t addr = {
+		.type = BT_ADDR_LE_RANDOM,
+		.a.val = { id, 0x12, 0x34, 0x56, 0x78, 0xC0 },
+	};
+
+	return addr;
+}
+
+/* Append a timeslot after the previous one, or at the same time when it should collide. */
+static int timeslot_add(uint8_t id, bool collide)
+{
+	struct dm_request req = {
+		.role = DM_ROLE_INITIATOR,
+		.bt_addr = addr_get(id),
+	};
+
+	if (!collide) {
+		ref_tick += TIMESLOT_TICKS;
+	}
+
+	return timeslot_queue_append(&req, ref_tick, WINDOW_LEN_US, TIMESLOT_LEN_US);
+}
+
+static struct dm_peer_stats stats_get(uint8_t id)
+{
+	bt_addr_le_t addr = addr_get(id);
+	struct dm_peer_stats stats;
+
+	zassert_ok(timeslot_queue_peer_stats_get(&addr, &stats), "Peer %u not tracked", id);
+
+	return stats;
+}
+
+static bool peer_tracked(uint8_t id)
+{
+	bt_addr_le_t addr = addr_get(id);
+	struct dm_peer_stats stats;
+
+	return timeslot_queue_peer_stats_get(&addr, &stats) == 0;
+}
+
+static void timeslot_queue_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	while (timeslot_queue_peek()) {
+		timeslot_queue_remove_first();
+	}
+
+	ref_tick = 0;
+}
+
+ZTEST(dm_timeslot_queue, test_fifo)
+{
+	struct timeslot_request *req;
+	bt_addr_le_t addr;
+
+	zassert_ok(timeslot_add(PEER_FIFO, false));
+	zassert_ok(timeslot_add(PEER_FIFO + 1, false));
+
+	req = timeslot_queue_peek();
+	zassert_not_null(req);
+	addr = addr_get(PEER_FIFO);
+	zassert_equal(bt_addr_le_cmp(&req->dm_req.bt_addr, &addr), 0);
+	zassert_equal(req->timeslot_length_us, TIMESLOT_LEN_US);
+	zassert_equal(req->window_length_us, WINDOW_LEN_US);
+
+	timeslot_queue_remove_first();
+
+	req = timeslot_queue_peek();
+	zassert_not_null(req);
+	addr = addr_get(PEER_FIFO + 1);
+	zassert_equal(bt_addr_le_cmp(&req->dm_req.bt_addr, &addr), 0);
+
+	timeslot_queue_remove_first();
+	zassert_is_null(timeslot_queue_peek());
+}
+
+ZTEST(dm_timeslot_queue, test_admission)
+{
+	struct dm_peer_stats stats;
+
+	zassert_ok(timeslot_add(PEER_ADMISSION, false));
+	zassert_equal(timeslot_add(PEER_ADMISSION, true), -EBUSY);
+
+	for (size_t i = 1; i < COUNT_SAME_PEER; i++) {
+		zassert_ok(timeslot_add(PEER_ADMISSION, false));
+	}
+	zassert_equal(timeslot_add(PEER_ADMISSION, false), -EAGAIN);
+
+	stats = stats_get(PEER_ADMISSION);
+	zassert_equal(stats.scheduled, COUNT_SAME_PEER);
+	zassert_equal(stats.dropped, 2);
+	zassert_equal(stats.late, 0);
+	zassert_equal(stats.queued, COUNT_SAME_PEER);
+
+	timeslot_queue_remove_first();
+	zassert_equal(stats_get(PEER_ADMISSION).queued, COUNT_SAME_PEER - 1);
+}
+
+ZTEST(dm_timeslot_queue, test_queue_full)
+{
+	const uint8_t last = PEER_FULL + QUEUE_LENGTH;
+
+	for (uint8_t id = PEER_FULL; id < last; id++) {
+		zassert_ok(timeslot_add(id, false));
+	}
+
+	/* All tracked peers have queued timeslots, so there is no room for a new one. */
+	zassert_equal(timeslot_add(last, false), -ENOMEM);
+	zassert_false(peer_tracked(last));
+
+	zassert_equal(timeslot_add(PEER_FULL, false), -ENOMEM);
+	zassert_equal(stats_get(PEER_FULL).dropped, 1);
+	zassert_equal(stats_get(PEER_FULL).queued, 1);
+
+	/* The peer of the removed timeslot is evicted for the new one. */
+	timeslot_queue_remove_first();
+	zassert_ok(timeslot_add(last, false));
+	zassert_false(peer_tracked(PEER_FULL));
+
+	for (uint8_t id = PEER_FULL + 1; id <= last; id++) {
+		zassert_equal(stats_get(id).queued, 1);
+	}
+}
+
+ZTEST(dm_timeslot_queue, test_late_report)
+{
+	bt_addr_le_t addr = addr_get(PEER_LATE);
+
+	zassert_ok(timeslot_add(PEER_LATE, false));
+	zassert_equal(stats_get(PEER_LATE).late, 0);
+
+	timeslot_queue_late_report(&addr);
+	timeslot_queue_late_report(&addr);
+	zassert_equal(stats_get(PEER_LATE).late, 2);
+}
+
+ZTEST(dm_timeslot_queue, test_peer_churn)
+{
+	const uint8_t busy_end = PEER_CHURN + PEER_COUNT - 1;
+
+	/* Peers with queued timeslots stay tracked while other peers are added and evicted
+	 * around them in the peer table.
+	 */
+	for (uint8_t id = PEER_CHURN; id < busy_end; id++) {
+		zassert_ok(timeslot_add(id, false));
+	}
+
+	for (uint8_t id = busy_end; id < busy_end + CHURN_PEERS; id++) {
+		/* The peer is tracked even though its timeslot is dropped. */
+		zassert_equal(timeslot_add(id, true), -EBUSY);
+		zassert_equal(stats_get(id).dropped, 1);
+		zassert_equal(stats_get(id).queued, 0);
+
+		if (id > busy_end) {
+			zassert_false(peer_tracked(id - 1), "Peer %u not evicted", id - 1);
+		}
+
+		for (uint8_t i = PEER_CHURN; i < busy_end; i++) {
+			zassert_equal(stats_get(i).queued, 1, "Peer %u lost", i);
+		}
+	}
+
+	for (uint8_t id = PEER_CHURN; id < busy_end; id++) {
+		timeslot_queue_remove_first();
+		zassert_equal(stats_get(id).queued, 0);
+	}
+}
+
+ZTEST_SUITE(dm_timeslot_queue, NULL, NULL, timeslot_queue_before, NULL, NULL);
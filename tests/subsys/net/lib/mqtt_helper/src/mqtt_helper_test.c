@@ -33,6 +33,9 @@
 #define TEST_PAYLOAD		"This is a test payload"
 #define TEST_PAYLOAD_LEN	(sizeof(TEST_PAYLOAD) - 1)
 
+/* Spans two full chunks and a partial one. */
+#define TEST_STREAM_PAYLOAD_LEN	(2 * CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN + 100)
+
 /* Pull in variables and functions from the MQTT helper library. */
 extern struct mqtt_client mqtt_client;
 extern enum mqtt_state mqtt_state;
@@ -59,6 +62,12 @@ static K_SEM_DEFINE(puback_sem, 0, 1);
 static K_SEM_DEFINE(suback_sem, 0, 1);
 static K_SEM_DEFINE(publish_sem, 0, 1);
 static K_SEM_DEFINE(error_msg_size_sem, 0, 1);
+static K_SEM_DEFINE(error_payload_read_sem, 0, 1);
+
+/* State of the streamed payload */
+static size_t stream_read_offset;
+static size_t stream_rx_offset;
+static int stream_chunk_count;
 
 void setUp(void)
 {
@@ -80,6 +89,37 @@ static int mqtt_readall_publish_payload_stub(struct mqtt_client *client, uint8_t
 	return 0;
 }
 
+static uint8_t stream_payload_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7);
+}
+
+static int mqtt_readall_publish_payload_stream_stub(struct mqtt_client *client, uint8_t *buffer,
+						    size_t length, int num_calls)
+{
+	TEST_ASSERT_TRUE(length <= CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN);
+
+	for (size_t i = 0; i < length; i++) {
+		buffer[i] = stream_payload_byte(stream_read_offset + i);
+	}
+
+	stream_read_offset += length;
+
+	return 0;
+}
+
+static int mqtt_readall_publish_payload_stream_error_stub(struct mqtt_client *client,
+							  uint8_t *buffer, size_t length,
+							  int num_calls)
+{
+	/* Fail the second chunk. */
+	if (num_calls > 0) {
+		return -EIO;
+	}
+
+	return mqtt_readall_publish_payload_stream_stub(client, buffer, length, num_calls);
+}
+
 static int poll_stub_pollin(struct pollfd *fds, int nfds, int timeout, int num_calls)
 {
 	fds[0].revents = fds[0].events & POLLIN;
@@ -180,6 +220,27 @@ static void cb_on_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf p
 	k_sem_give(&publish_sem);
 }
 
+static void cb_on_publish_chunk(struct mqtt_helper_buf topic, struct mqtt_helper_buf chunk,
+				size_t offset, size_t total_len)
+{
+	TEST_ASSERT_EQUAL(TEST_TOPIC_1_LEN, topic.size);
+	TEST_ASSERT_EQUAL_MEMORY(TEST_TOPIC_1, topic.ptr, TEST_TOPIC_1_LEN);
+	TEST_ASSERT_EQUAL(TEST_STREAM_PAYLOAD_LEN, total_len);
+	TEST_ASSERT_EQUAL(stream_rx_offset, offset);
+	TEST_ASSERT_TRUE(chunk.size <= CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN);
+
+	for (size_t i = 0; i < chunk.size; i++) {
+		TEST_ASSERT_EQUAL_UINT8(stream_payload_byte(offset + i), (uint8_t)chunk.ptr[i]);
+	}
+
+	stream_rx_offset += chunk.size;
+	stream_chunk_count++;
+
+	if (stream_rx_offset == total_len) {
+		k_sem_give(&publish_sem);
+	}
+}
+
 static void cb_on_connack(enum mqtt_conn_return_code return_code)
 {
 	switch (return_code) {
@@ -219,25 +280,27 @@ static void cb_on_error(enum mqtt_helper_error error)
 {
 	if (error == MQTT_HELPER_ERROR_MSG_SIZE) {
 		k_sem_give(&error_msg_size_sem);
+	} else if (error == MQTT_HELPER_ERROR_PAYLOAD_READ) {
+		k_sem_give(&error_payload_read_sem);
 	}
 }
 
 /* Tests */
 
+static struct mqtt_helper_cfg test_cfg = {
+	.cb = {
+		.on_connack = cb_on_connack,
+		.on_disconnect = cb_on_disconnect,
+		.on_publish = cb_on_publish,
+		.on_puback = cb_on_puback,
+		.on_suback = cb_on_suback,
+		.on_error = cb_on_error,
+	},
+};
+
 void test_mqtt_helper_init_when_unitialized(void)
 {
-	struct mqtt_helper_cfg cfg = {
-		.cb = {
-			.on_connack = cb_on_connack,
-			.on_disconnect = cb_on_disconnect,
-			.on_publish = cb_on_publish,
-			.on_puback = cb_on_puback,
-			.on_suback = cb_on_suback,
-			.on_error = cb_on_error,
-		},
-	};
-
-	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&test_cfg));
 	TEST_ASSERT_EQUAL(mqtt_state_get(), MQTT_STATE_DISCONNECTED);
 }
 
@@ -393,6 +456,69 @@ void test_on_publish_too_large_incoming_msg(void)
 	TEST_ASSERT_EQUAL(0, k_sem_take(&error_msg_size_sem, K_SECONDS(1)));
 }
 
+static void stream_publish_event_send(void)
+{
+	struct mqtt_helper_cfg cfg = {
+		.cb = {
+			.on_publish_chunk = cb_on_publish_chunk,
+			.on_error = cb_on_error,
+		},
+	};
+	struct mqtt_evt evt = {
+		.type = MQTT_EVT_PUBLISH,
+		.param.publish.message_id = TEST_MESSAGE_ID,
+		.param.publish.message = {
+			.topic = {
+				.topic = {
+					.utf8 = TEST_TOPIC_1,
+					.size = TEST_TOPIC_1_LEN,
+				},
+				.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+			},
+			.payload = {
+				.len = TEST_STREAM_PAYLOAD_LEN,
+			},
+		}
+	};
+
+	stream_read_offset = 0;
+	stream_rx_offset = 0;
+	stream_chunk_count = 0;
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+
+	mqtt_evt_handler(&mqtt_client, &evt);
+}
+
+void test_on_publish_streaming(void)
+{
+	__cmock_mqtt_readall_publish_payload_Stub(mqtt_readall_publish_payload_stream_stub);
+	__cmock_mqtt_publish_qos1_ack_ExpectAnyArgsAndReturn(0);
+
+	stream_publish_event_send();
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&publish_sem, K_SECONDS(1)));
+	TEST_ASSERT_EQUAL(3, stream_chunk_count);
+	TEST_ASSERT_EQUAL(TEST_STREAM_PAYLOAD_LEN, stream_read_offset);
+
+	/* Restore the callbacks used by the other tests. */
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&test_cfg));
+}
+
+void test_on_publish_streaming_read_error(void)
+{
+	__cmock_mqtt_readall_publish_payload_Stub(
+		mqtt_readall_publish_payload_stream_error_stub);
+
+	stream_publish_event_send();
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&error_payload_read_sem, K_SECONDS(1)));
+	TEST_ASSERT_EQUAL(1, stream_chunk_count);
+
+	/* Restore the callbacks used by the other tests. */
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&test_cfg));
+}
+
 void test_mqtt_helper_disconnect_when_connected(void)
 {
 	__cmock_mqtt_disconnect_ExpectAndReturn(&mqtt_client, 0);
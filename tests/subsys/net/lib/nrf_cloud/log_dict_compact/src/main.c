@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_msg.h>
+#include <zephyr/logging/log_output_dict.h>
+#include <zephyr/sys/byteorder.h>
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_log_dict_compact.h"
+
+#define TEST_BATCH_TS 1672531200000LL
+#define TEST_BATCH_SEQUENCE 42
+#define TEST_TS_BASE 1000
+#define TEST_SOURCE_A 3
+#define TEST_SOURCE_B 200
+#define TEST_DROPPED 5
+#define TEST_PACKAGE_SIZE_MAX 16
+#define TEST_DATA_SIZE_MAX 8
+#define TEST_RECORDS_MAX 4
+#define TEST_BUF_SIZE 128
+
+/* Packages as created by cbprintf, the first word is the package descriptor. */
+static const uint8_t package_args[] = {
+	3, 0, 0, 0,
+	0x00, 0x10, 0x00, 0x00, /* Format string address */
+	0xFB, 0xFF, 0xFF, 0xFF /* -5 */
+};
+static const uint8_t package_str[] = {
+	2, 0, 1, 0, /* One read-only string */
+	0x40, 0x10, 0x00, 0x00,
+	1 /* String index */
+};
+static const uint8_t package_no_args[] = {
+	2, 0, 0, 0,
+	0x80, 0x10, 0x00, 0x00
+};
+static const uint8_t hexdump[] = { 0xDE, 0xAD, 0xBE };
+
+static uint8_t msg_buf[TEST_RECORDS_MAX]
+		      [sizeof(struct log_msg) + TEST_PACKAGE_SIZE_MAX + TEST_DATA_SIZE_MAX]
+		      __aligned(sizeof(uint64_t));
+
+struct decoded_record {
+	bool dropped;
+	uint32_t dropped_cnt;
+	uint8_t level;
+	uint8_t domain;
+	uint32_t source;
+	uint64_t ts;
+	uint8_t package[TEST_PACKAGE_SIZE_MAX];
+	size_t package_len;
+	uint8_t data[TEST_DATA_SIZE_MAX];
+	size_t data_len;
+};
+
+static struct decoded_record records[TEST_RECORDS_MAX];
+
+struct reader {
+	const uint8_t *data;
+	size_t len;
+	size_t pos;
+};
+
+static void get_bytes(struct reader *r, uint8_t *out, size_t len)
+{
+	zassert_true(len <= (r->len - r->pos), "Unexpected end of data at %zu", r->pos);
+
+	memcpy(out, &r->data[r->pos], len);
+	r->pos += len;
+}
+
+static uint8_t get_u8(struct reader *r)
+{
+	uint8_t value;
+
+	get_bytes(r, &value, sizeof(value));
+
+	return value;
+}
+
+static uint64_t get_varint(struct reader *r)
+{
+	uint64_t value = 0;
+	uint8_t byte;
+
+	for (int shift = 0; ; shift += 7) {
+		zassert_true(shift < 64, "Varint too long at %zu", r->pos);
+		byte = get_u8(r);
+		value |= (uint64_t)(byte & BIT_MASK(7)) << shift;
+		if (!(byte & BIT(7))) {
+			return value;
+		}
+	}
+}
+
+static int64_t get_zigzag(struct reader *r)
+{
+	uint64_t value = get_varint(r);
+
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/* Decodes a batch the same way as scripts/nrf_cloud_log/dict_compact_expand.py. */
+static size_t batch_decode(const uint8_t *buf, size_t len)
+{
+	struct reader r = {
+		.data = buf,
+		.len = len,
+	};
+	struct nrf_cloud_bin_hdr hdr;
+	uint64_t ts;
+	size_t cnt = 0;
+
+	get_bytes(&r, (uint8_t *)&hdr, sizeof(hdr));
+	zassert_equal(hdr.magic, NRF_CLOUD_BINARY_MAGIC);
+	zassert_equal(hdr.format, NRF_CLOUD_DICT_LOG_COMPACT_FMT);
+	zassert_equal(hdr.ts, TEST_BATCH_TS);
+	zassert_equal(hdr.sequence, TEST_BATCH_SEQUENCE);
+	ts = get_varint(&r);
+
+	while (r.pos < r.len) {
+		struct decoded_record *rec = &records[cnt++];
+		uint8_t counts[3] = { 0 };
+		size_t tail_len = 0;
+		size_t words;
+		uint8_t tag;
+
+		zassert_true(cnt <= ARRAY_SIZE(records), "Too many records");
+		memset(rec, 0, sizeof(*rec));
+
+		tag = get_u8(&r);
+		if ((tag & BIT_MASK(3)) == BIT_MASK(3)) {
+			rec->dropped = true;
+			rec->dropped_cnt = get_varint(&r);
+			continue;
+		}
+
+		rec->level = tag & BIT_MASK(3);
+		rec->domain = (tag >> 3) & BIT_MASK(4);
+		rec->source = get_varint(&r);
+		ts += get_zigzag(&r);
+		rec->ts = ts;
+
+		words = get_varint(&r);
+		if (words & 1) {
+			get_bytes(&r, counts, sizeof(counts));
+			tail_len = get_varint(&r);
+		}
+		words >>= 1;
+
+		rec->package_len = (words * sizeof(uint32_t)) + tail_len;
+		zassert_true(rec->package_len <= sizeof(rec->package), "Package too long");
+
+		if (words) {
+			rec->package[0] = words;
+			memcpy(&rec->package[1], counts, sizeof(counts));
+			for (size_t i = 1; i < words; i++) {
+				sys_put_le32((uint32_t)get_zigzag(&r),
+					     &rec->package[i * sizeof(uint32_t)]);
+			}
+		}
+		get_bytes(&r, &rec->package[words * sizeof(uint32_t)], tail_len);
+
+		if (tag & BIT(7)) {
+			rec->data_len = get_varint(&r);
+			zassert_true(rec->data_len <= sizeof(rec->data), "Data too long");
+			get_bytes(&r, rec->data, rec->data_len);
+		}
+	}
+
+	return cnt;
+}
+
+static struct log_msg *msg_create(size_t idx, uint8_t level, uint8_t domain, log_timestamp_t ts,
+				  const uint8_t *package, size_t package_len,
+				  const uint8_t *data, size_t data_len)
+{
+	struct log_msg *msg = (struct log_msg *)msg_buf[idx];
+
+	zassert_true(package_len <= TEST_PACKAGE_SIZE_MAX);
+	zassert_true(data_len <= TEST_DATA_SIZE_MAX);
+
+	memset(msg_buf[idx], 0, sizeof(msg_buf[idx]));
+	msg->hdr.desc.level = level;
+	msg->hdr.desc.domain = domain;
+	msg->hdr.desc.package_len = package_len;
+	msg->hdr.desc.data_len = data_len;
+	msg->hdr.timestamp = ts;
+	memcpy(msg->data, package, package_len);
+	memcpy(&msg->data[package_len], data, data_len);
+
+	return msg;
+}
+
+static void record_check(const struct decoded_record *rec, struct log_msg *msg, uint32_t src_id)
+{
+	size_t package_len;
+	size_t data_len;
+	uint8_t *package = log_msg_get_package(msg, &package_len);
+	uint8_t *data = log_msg_get_data(msg, &data_len);
+
+	zassert_false(rec->dropped);
+	zassert_equal(rec->level, log_msg_get_level(msg));
+	zassert_equal(rec->domain, log_msg_get_domain(msg));
+	zassert_equal(rec->source, src_id);
+	zassert_equal(rec->ts, log_msg_get_timestamp(msg));
+	zassert_equal(rec->package_len, package_len);
+	zassert_mem_equal(rec->package, package, package_len);
+	zassert_equal(rec->data_len, data_len);
+	zassert_mem_equal(rec->data, data, data_len);
+}
+
+ZTEST(nrf_cloud_log_dict_compact, test_round_trip)
+{
+	static uint8_t buf[TEST_BUF_SIZE];
+	struct log_msg *msg_a = msg_create(0, LOG_LEVEL_ERR, 0, 1500,
+					   package_args, sizeof(package_args), NULL, 0);
+	struct log_msg *msg_b = msg_create(1, LOG_LEVEL_DBG, 1, 1500,
+					   package_str, sizeof(package_str),
+					   hexdump, sizeof(hexdump));
+	struct log_msg *msg_c = msg_create(2, LOG_LEVEL_INF, 0, 70000,
+					   package_no_args, sizeof(package_no_args), NULL, 0);
+	size_t len;
+	int ret;
+
+	len = nrf_cloud_log_dict_compact_hdr_encode(TEST_BATCH_TS, TEST_BATCH_SEQUENCE,
+						    TEST_TS_BASE, buf);
+	zassert_true(len <= NRF_CLOUD_LOG_DICT_COMPACT_HDR_SIZE_MAX);
+
+	ret = nrf_cloud_log_dict_compact_encode(msg_a, TEST_SOURCE_A, TEST_TS_BASE,
+						&buf[len], sizeof(buf) - len);
+	zassert_true(ret > 0);
+	zassert_true(ret < nrf_cloud_log_dict_size_get(msg_a), "Record not compacted");
+	len += ret;
+
+	ret = nrf_cloud_log_dict_compact_encode(msg_b, TEST_SOURCE_B,
+						log_msg_get_timestamp(msg_a),
+						&buf[len], sizeof(buf) - len);
+	zassert_true(ret > 0);
+	len += ret;
+
+	ret = nrf_cloud_log_dict_compact_dropped_encode(TEST_DROPPED, &buf[len], sizeof(buf) - len);
+	zassert_true(ret > 0);
+	len += ret;
+
+	ret = nrf_cloud_log_dict_compact_encode(msg_c, TEST_SOURCE_A,
+						log_msg_get_timestamp(msg_b),
+						&buf[len], sizeof(buf) - len);
+	zassert_true(ret > 0);
+	len += ret;
+
+	zassert_equal(batch_decode(buf, len), 4);
+	record_check(&records[0], msg_a, TEST_SOURCE_A);
+	record_check(&records[1], msg_b, TEST_SOURCE_B);
+	zassert_true(records[2].dropped);
+	zassert_equal(records[2].dropped_cnt, TEST_DROPPED);
+	record_check(&records[3], msg_c, TEST_SOURCE_A);
+}
+
+ZTEST(nrf_cloud_log_dict_compact, test_record_not_stored)
+{
+	static uint8_t buf[TEST_BUF_SIZE];
+	static uint8_t scratch[TEST_BUF_SIZE];
+	struct log_msg *msg_a = msg_create(0, LOG_LEVEL_WRN, 0, 2000,
+					   package_args, sizeof(package_args), NULL, 0);
+	struct log_msg *msg_b = msg_create(1, LOG_LEVEL_WRN, 0, 2500,
+					   package_args, sizeof(package_args), NULL, 0);
+	struct log_msg *msg_c = msg_create(2, LOG_LEVEL_WRN, 0, 3000,
+					   package_args, sizeof(package_args), NULL, 0);
+	size_t len;
+	int ret;
+
+	len = nrf_cloud_log_dict_compact_hdr_encode(TEST_BATCH_TS, TEST_BATCH_SEQUENCE,
+						    TEST_TS_BASE, buf);
+
+	ret = nrf_cloud_log_dict_compact_encode(msg_a, TEST_SOURCE_A, TEST_TS_BASE,
+						&buf[len], sizeof(buf) - len);
+	zassert_true(ret > 0);
+	len += ret;
+
+	/* The second record is encoded but never reaches the ring buffer, so the third one
+	 * stays relative to the first one.
+	 */
+	zassert_true(nrf_cloud_log_dict_compact_encode(msg_b, TEST_SOURCE_A,
+						       log_msg_get_timestamp(msg_a),
+						       scratch, sizeof(scratch)) > 0);
+
+	ret = nrf_cloud_log_dict_compact_encode(msg_c, TEST_SOURCE_A,
+						log_msg_get_timestamp(msg_a),
+						&buf[len], sizeof(buf) - len);
+	zassert_true(ret > 0);
+	len += ret;
+
+	zassert_equal(batch_decode(buf, len), 2);
+	record_check(&records[0], msg_a, TEST_SOURCE_A);
+	record_check(&records[1], msg_c, TEST_SOURCE_A);
+}
+
+ZTEST(nrf_cloud_log_dict_compact, test_buffer_too_small)
+{
+	uint8_t buf[4];
+	struct log_msg *msg = msg_create(0, LOG_LEVEL_ERR, 0, 1500,
+					 package_args, sizeof(package_args), NULL, 0);
+
+	zassert_equal(nrf_cloud_log_dict_compact_encode(msg, TEST_SOURCE_A, TEST_TS_BASE,
+							buf, sizeof(buf)), -ENOMEM);
+	zassert_equal(nrf_cloud_log_dict_compact_dropped_encode(TEST_DROPPED, buf, 1), -ENOMEM);
+}
+
+ZTEST(nrf_cloud_log_dict_compact, test_dict_size)
+{
+	struct log_msg *msg = msg_create(0, LOG_LEVEL_DBG, 0, 1500,
+					 package_str, sizeof(package_str),
+					 hexdump, sizeof(hexdump));
+
+	zassert_equal(nrf_cloud_log_dict_size_get(msg),
+		      sizeof(struct log_dict_output_normal_msg_hdr_t) +
+		      sizeof(package_str) + sizeof(hexdump));
+}
+
+ZTEST_SUITE(nrf_cloud_log_dict_compact, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/client.h>
+#include <zephyr/net/http/parser.h>
+#include <net/rest_client.h>
+
+#define TEST_HOST "example.com"
+#define TEST_PORT 80
+#define TEST_SOCKET_BASE 10
+#define TEST_RESULTS_MAX 4
+
+/* Results of the next HTTP requests, 0 for a successful response. */
+static int http_results[TEST_RESULTS_MAX];
+static size_t http_result_cnt;
+static size_t http_req_cnt;
+static int socket_next;
+static size_t close_cnt;
+
+static struct sockaddr_in test_addr = {
+	.sin_family = AF_INET,
+};
+
+static struct zsock_addrinfo test_addrinfo = {
+	.ai_family = AF_INET,
+	.ai_socktype = SOCK_STREAM,
+	.ai_addr = (struct sockaddr *)&test_addr,
+	.ai_addrlen = sizeof(test_addr),
+};
+
+int __wrap_zsock_getaddrinfo(const char *host, const char *service,
+			     const struct zsock_addrinfo *hints, struct zsock_addrinfo **res)
+{
+	*res = &test_addrinfo;
+
+	return 0;
+}
+
+void __wrap_zsock_freeaddrinfo(struct zsock_addrinfo *ai)
+{
+}
+
+int __wrap_z_impl_zsock_socket(int family, int type, int proto)
+{
+	return socket_next++;
+}
+
+int __wrap_z_impl_zsock_connect(int sock, const struct sockaddr *addr, socklen_t addrlen)
+{
+	return 0;
+}
+
+int __wrap_z_impl_zsock_close(int sock)
+{
+	close_cnt++;
+
+	return 0;
+}
+
+int __wrap_z_impl_zsock_setsockopt(int sock, int level, int optname, const void *optval,
+				   socklen_t optlen)
+{
+	return 0;
+}
+
+int __wrap_http_should_keep_alive(const struct http_parser *parser)
+{
+	return 1;
+}
+
+int __wrap_http_client_req(int sock, struct http_request *req, int32_t timeout,
+			   void *user_data)
+{
+	struct http_response rsp = {
+		.http_status_code = 200,
+	};
+	int result;
+
+	zassert_true(http_req_cnt < http_result_cnt, "Unexpected HTTP request");
+	result = http_results[http_req_cnt++];
+
+	if (result) {
+		return result;
+	}
+
+	strcpy(rsp.http_status, "OK");
+	req->response(&rsp, HTTP_DATA_FINAL, user_data);
+
+	return 0;
+}
+
+static void http_results_set(size_t cnt, const int *results)
+{
+	zassert_true(cnt <= ARRAY_SIZE(http_results));
+
+	memcpy(http_results, results, cnt * sizeof(results[0]));
+	http_result_cnt = cnt;
+	http_req_cnt = 0;
+}
+
+static int request_send(enum http_method method)
+{
+	static char resp_buf[64];
+	struct rest_client_req_context req_ctx;
+	struct rest_client_resp_context resp_ctx = { 0 };
+
+	rest_client_request_defaults_set(&req_ctx);
+	req_ctx.http_method = method;
+	req_ctx.host = TEST_HOST;
+	req_ctx.port = TEST_PORT;
+	req_ctx.url = "/";
+	req_ctx.resp_buff = resp_buf;
+	req_ctx.resp_buff_len = sizeof(resp_buf);
+
+	return rest_client_request(&req_ctx, &resp_ctx);
+}
+
+static struct rest_client_conn_stats stats_prev;
+
+/* Statistics accumulated since the start of the test. */
+static struct rest_client_conn_stats stats_get(void)
+{
+	struct rest_client_conn_stats stats;
+
+	rest_client_conn_stats_get(&stats);
+
+	stats.connects -= stats_prev.connects;
+	stats.reuses -= stats_prev.reuses;
+	stats.stale_retries -= stats_prev.stale_retries;
+
+	return stats;
+}
+
+static void rest_client_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	rest_client_conn_pool_flush();
+	rest_client_conn_stats_get(&stats_prev);
+
+	socket_next = TEST_SOCKET_BASE;
+	close_cnt = 0;
+	http_result_cnt = 0;
+	http_req_cnt = 0;
+}
+
+ZTEST(rest_client_conn_pool, test_reuse)
+{
+	http_results_set(2, (const int[]){ 0, 0 });
+
+	zassert_ok(request_send(HTTP_GET));
+	zassert_ok(request_send(HTTP_GET));
+
+	zassert_equal(stats_get().connects, 1);
+	zassert_equal(stats_get().reuses, 1);
+	zassert_equal(close_cnt, 0);
+}
+
+ZTEST(rest_client_conn_pool, test_retry_idempotent)
+{
+	static const enum http_method methods[] = {
+		HTTP_GET, HTTP_HEAD, HTTP_PUT, HTTP_DELETE,
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(methods); i++) {
+		rest_client_before(NULL);
+
+		/* The reused connection was closed by the server. */
+		http_results_set(3, (const int[]){ 0, -ECONNRESET, 0 });
+
+		zassert_ok(request_send(methods[i]));
+		zassert_ok(request_send(methods[i]), "Method %d not retried", methods[i]);
+
+		zassert_equal(http_req_cnt, 3);
+		zassert_equal(stats_get().stale_retries, 1);
+		zassert_equal(stats_get().connects, 2);
+		zassert_equal(close_cnt, 1);
+	}
+}
+
+ZTEST(rest_client_conn_pool, test_no_retry_non_idempotent)
+{
+	static const enum http_method methods[] = {
+		HTTP_POST, HTTP_PATCH,
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(methods); i++) {
+		rest_client_before(NULL);
+
+		http_results_set(2, (const int[]){ 0, -ECONNRESET });
+
+		zassert_ok(request_send(methods[i]));
+		zassert_equal(request_send(methods[i]), -ECONNRESET,
+			      "Method %d retried", methods[i]);
+
+		zassert_equal(http_req_cnt, 2);
+		zassert_equal(stats_get().stale_retries, 0);
+		zassert_equal(stats_get().connects, 1);
+	}
+}
+
+ZTEST(rest_client_conn_pool, test_no_retry_timeout)
+{
+	http_results_set(2, (const int[]){ 0, -ETIMEDOUT });
+
+	zassert_ok(request_send(HTTP_GET));
+	zassert_equal(request_send(HTTP_GET), -ETIMEDOUT);
+
+	zassert_equal(http_req_cnt, 2);
+	zassert_equal(stats_get().stale_retries, 0);
+	zassert_equal(stats_get().connects, 1);
+
+	/* The failed connection is not returned to the pool. */
+	zassert_equal(close_cnt, 1);
+}
+
+ZTEST_SUITE(rest_client_conn_pool, NULL, NULL, rest_client_before, NULL, NULL);
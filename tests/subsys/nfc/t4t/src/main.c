@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <nfc/t4t/apdu.h>
+#include <nfc/t4t/cc_file.h>
+#include <nfc/t4t/hl_procedure.h>
+#include <nfc/t4t/isodep.h>
+
+#include "tag_sim.h"
+
+#define MAX_TLV_BLOCKS 2
+#define NDEF_FILE_SIZE 1024
+#define FRAME_WAIT_TIMEOUT K_MSEC(100)
+
+NFC_T4T_CC_DESC_DEF(t4t_cc, MAX_TLV_BLOCKS);
+
+static uint8_t tx_buf[2048];
+static uint8_t rx_buf[1100];
+static uint8_t frame[TAG_SIM_FRAME_MAX_LEN];
+static size_t frame_len;
+static uint8_t resp[TAG_SIM_FRAME_MAX_LEN];
+static uint8_t ndef_data[NDEF_FILE_SIZE];
+static uint8_t ndef_read_buf[NDEF_FILE_SIZE];
+static size_t ndef_read_len;
+static bool procedure_done;
+static int isodep_err;
+static int hl_err;
+
+static K_SEM_DEFINE(frame_sem, 0, 1);
+
+static void isodep_data_received(const uint8_t *data, size_t data_len)
+{
+	int err = nfc_t4t_hl_procedure_on_data_received(data, data_len);
+
+	if (err) {
+		hl_err = err;
+	}
+}
+
+static void isodep_selected(const struct nfc_t4t_isodep_tag *t4t_tag)
+{
+	procedure_done = true;
+}
+
+static void isodep_ready_to_send(uint8_t *data, size_t data_len, uint32_t ftd)
+{
+	if (data_len > sizeof(frame)) {
+		isodep_err = -ENOMEM;
+		return;
+	}
+
+	memcpy(frame, data, data_len);
+	frame_len = data_len;
+
+	k_sem_give(&frame_sem);
+}
+
+static void isodep_error(int err)
+{
+	isodep_err = err;
+}
+
+static const struct nfc_t4t_isodep_cb isodep_cb = {
+	.data_received = isodep_data_received,
+	.selected = isodep_selected,
+	.ready_to_send = isodep_ready_to_send,
+	.error = isodep_error,
+};
+
+static void hl_selected(enum nfc_t4t_hl_procedure_select type)
+{
+	procedure_done = true;
+}
+
+static void hl_cc_read(struct nfc_t4t_cc_file *cc)
+{
+	procedure_done = true;
+}
+
+static void hl_ndef_read(uint16_t file_id, const uint8_t *data, size_t len)
+{
+	zassert_equal(file_id, TAG_SIM_NDEF_FILE_ID, "Unexpected file read");
+
+	ndef_read_len = len;
+	procedure_done = true;
+}
+
+static void hl_ndef_updated(uint16_t file_id)
+{
+	zassert_equal(file_id, TAG_SIM_NDEF_FILE_ID, "Unexpected file updated");
+
+	procedure_done = true;
+}
+
+static const struct nfc_t4t_hl_procedure_cb hl_cb = {
+	.selected = hl_selected,
+	.cc_read = hl_cc_read,
+	.ndef_read = hl_ndef_read,
+	.ndef_updated = hl_ndef_updated,
+};
+
+/* Pass the frames between the ISO-DEP Reader/Writer and the simulated tag
+ * until the procedure completes.
+ */
+static void procedure_run(int err)
+{
+	zassert_ok(err, "Procedure start failed: %d", err);
+
+	while (!procedure_done) {
+		size_t resp_len;
+
+		zassert_ok(k_sem_take(&frame_sem, FRAME_WAIT_TIMEOUT),
+			   "No frame from Reader/Writer");
+
+		resp_len = tag_sim_frame_process(frame, frame_len, resp);
+		if (resp_len) {
+			zassert_ok(nfc_t4t_isodep_data_received(resp, resp_len, 0),
+				   "Data receive failed");
+		} else {
+			nfc_t4t_isodep_on_timeout();
+		}
+
+		zassert_ok(isodep_err, "ISO-DEP error: %d", isodep_err);
+		zassert_ok(hl_err, "HL Procedure error: %d", hl_err);
+	}
+
+	procedure_done = false;
+}
+
+static void tag_detect(const struct tag_sim_cfg *cfg)
+{
+	tag_sim_init(cfg, ndef_data, sizeof(ndef_data));
+
+	procedure_run(nfc_t4t_isodep_rats_send(NFC_T4T_ISODEP_FSD_256, 0));
+	procedure_run(nfc_t4t_hl_procedure_ndef_tag_app_select());
+	procedure_run(nfc_t4t_hl_procedure_cc_select());
+	procedure_run(nfc_t4t_hl_procedure_cc_read(&NFC_T4T_CC_DESC(t4t_cc)));
+	procedure_run(nfc_t4t_hl_procedure_ndef_file_select(TAG_SIM_NDEF_FILE_ID));
+
+	nfc_t4t_isodep_stats_reset();
+}
+
+static void ndef_read_verify(void)
+{
+	memset(ndef_read_buf, 0, sizeof(ndef_read_buf));
+
+	procedure_run(nfc_t4t_hl_procedure_ndef_read(&NFC_T4T_CC_DESC(t4t_cc),
+						     ndef_read_buf, sizeof(ndef_read_buf)));
+
+	zassert_equal(ndef_read_len, sizeof(ndef_data), "Invalid NDEF file length");
+	zassert_mem_equal(ndef_read_buf, ndef_data, sizeof(ndef_data),
+			  "Invalid NDEF file content");
+}
+
+static void ndef_update_verify(void)
+{
+	procedure_run(nfc_t4t_hl_procedure_ndef_update(&NFC_T4T_CC_DESC(t4t_cc),
+						       ndef_data, sizeof(ndef_data)));
+
+	zassert_mem_equal(tag_sim_ndef_get(), ndef_data, sizeof(ndef_data),
+			  "Invalid NDEF file content on tag");
+}
+
+static void ndef_data_fill(uint8_t seed)
+{
+	sys_put_be16(sizeof(ndef_data) - sizeof(uint16_t), ndef_data);
+
+	for (size_t i = sizeof(uint16_t); i < sizeof(ndef_data); i++) {
+		ndef_data[i] = (uint8_t)(i * 7 + seed);
+	}
+}
+
+static void *suite_setup(void)
+{
+	int err;
+
+	err = nfc_t4t_isodep_init(tx_buf, sizeof(tx_buf), rx_buf, sizeof(rx_buf), &isodep_cb);
+	zassert_ok(err, "ISO-DEP init failed: %d", err);
+
+	err = nfc_t4t_hl_procedure_cb_register(&hl_cb);
+	zassert_ok(err, "HL Procedure callback register failed: %d", err);
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_reset(&frame_sem);
+	procedure_done = false;
+	isodep_err = 0;
+	hl_err = 0;
+}
+
+ZTEST_SUITE(nfc_t4t, NULL, suite_setup, test_before, NULL, NULL);
+
+ZTEST(nfc_t4t, test_ndef_read_short_apdu)
+{
+	const struct tag_sim_cfg cfg = {
+		.fsci = NFC_T4T_ISODEP_FSD_32,
+		.mle = 0xFF,
+		.mlc = 0xFF,
+		.ndef_file_size = NDEF_FILE_SIZE,
+		.drop_i_block = -1,
+	};
+	struct nfc_t4t_isodep_stats stats;
+
+	ndef_data_fill(1);
+	tag_detect(&cfg);
+	ndef_read_verify();
+
+	nfc_t4t_isodep_stats_get(&stats);
+
+	/* NLEN is read with the first part of the file, in 255-byte steps. */
+	zassert_equal(stats.exchanges, DIV_ROUND_UP(sizeof(ndef_data), 0xFF),
+		      "Unexpected number of exchanges: %u", stats.exchanges);
+	zassert_equal(tag_sim_stats_get()->capdu_extended_cnt, 0,
+		      "Extended APDU used with short MLe");
+}
+
+ZTEST(nfc_t4t, test_ndef_read_extended_apdu)
+{
+	const struct tag_sim_cfg cfg = {
+		.fsci = NFC_T4T_ISODEP_FSD_1024,
+		.mle = NDEF_FILE_SIZE,
+		.mlc = NDEF_FILE_SIZE,
+		.ndef_file_size = NDEF_FILE_SIZE,
+		.drop_i_block = -1,
+	};
+	struct nfc_t4t_isodep_stats stats;
+
+	ndef_data_fill(2);
+	tag_detect(&cfg);
+	ndef_read_verify();
+
+	nfc_t4t_isodep_stats_get(&stats);
+
+	/* The whole file is read with a single extended READ BINARY command. */
+	zassert_equal(stats.exchanges, 1, "Unexpected number of exchanges: %u",
+		      stats.exchanges);
+	zassert_equal(stats.bytes_rx, sizeof(ndef_data) + sizeof(uint16_t),
+		      "Unexpected number of received bytes: %u", stats.bytes_rx);
+	zassert_equal(tag_sim_stats_get()->capdu_extended_cnt, 1,
+		      "Extended APDU not used");
+}
+
+ZTEST(nfc_t4t, test_ndef_update_chaining_retransmission)
+{
+	const struct tag_sim_cfg cfg = {
+		.fsci = NFC_T4T_ISODEP_FSD_32,
+		.mle = 0xFF,
+		.mlc = 0xFF,
+		.ndef_file_size = NDEF_FILE_SIZE,
+		.drop_i_block = 3,
+	};
+	struct nfc_t4t_isodep_stats stats;
+
+	ndef_data_fill(3);
+	tag_detect(&cfg);
+	ndef_update_verify();
+
+	nfc_t4t_isodep_stats_get(&stats);
+
+	/* The lost block must be retransmitted intact, even though the next
+	 * block was already prepared.
+	 */
+	zassert_equal(stats.retransmissions, 1, "Unexpected number of retransmissions: %u",
+		      stats.retransmissions);
+}
+
+ZTEST(nfc_t4t, test_ndef_update_extended_apdu)
+{
+	const struct tag_sim_cfg cfg = {
+		.fsci = NFC_T4T_ISODEP_FSD_256,
+		.mle = NDEF_FILE_SIZE,
+		.mlc = NDEF_FILE_SIZE,
+		.ndef_file_size = NDEF_FILE_SIZE,
+		.drop_i_block = 1,
+	};
+	struct nfc_t4t_isodep_stats stats;
+
+	ndef_data_fill(4);
+	tag_detect(&cfg);
+	ndef_update_verify();
+
+	nfc_t4t_isodep_stats_get(&stats);
+
+	/* NLEN clear, a single chained UPDATE BINARY with the whole message
+	 * and NLEN update.
+	 */
+	zassert_equal(stats.exchanges, 3, "Unexpected number of exchanges: %u",
+		      stats.exchanges);
+	zassert_equal(stats.retransmissions, 1, "Unexpected number of retransmissions: %u",
+		      stats.retransmissions);
+	zassert_equal(tag_sim_stats_get()->capdu_extended_cnt, 1,
+		      "Extended APDU not used");
+}
+
+ZTEST(nfc_t4t, test_apdu_extended_encode)
+{
+	struct nfc_t4t_apdu_comm apdu_comm;
+	uint8_t buf[300 + 7];
+	uint8_t data[300] = {0};
+	uint16_t len;
+	const uint8_t read_expected[] = {0x00, 0xB0, 0x00, 0x10, 0x00, 0x03, 0xE8};
+
+	/* Extended Le without Lc starts with a zero byte. */
+	nfc_t4t_apdu_comm_clear(&apdu_comm);
+	apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_READ;
+	apdu_comm.parameter = 0x0010;
+	apdu_comm.resp_len = 1000;
+
+	len = sizeof(buf);
+	zassert_ok(nfc_t4t_apdu_comm_encode(&apdu_comm, buf, &len), "Encode failed");
+	zassert_equal(len, sizeof(read_expected), "Invalid C-APDU length: %u", len);
+	zassert_mem_equal(buf, read_expected, sizeof(read_expected), "Invalid C-APDU");
+
+	/* Extended Lc forces extended Le. */
+	nfc_t4t_apdu_comm_clear(&apdu_comm);
+	apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_UPDATE;
+	apdu_comm.data.buff = data;
+	apdu_comm.data.len = sizeof(data);
+	apdu_comm.resp_len = 0x10;
+
+	len = sizeof(buf);
+	zassert_equal(nfc_t4t_apdu_comm_encode(&apdu_comm, buf, &len), -ENOMEM,
+		      "Too small buffer not detected");
+
+	apdu_comm.resp_len = 0;
+
+	len = sizeof(buf);
+	zassert_ok(nfc_t4t_apdu_comm_encode(&apdu_comm, buf, &len), "Encode failed");
+	zassert_equal(len, sizeof(buf), "Invalid C-APDU length: %u", len);
+	zassert_equal(buf[4], 0x00, "Invalid extended Lc token");
+	zassert_equal(sys_get_be16(&buf[5]), sizeof(data), "Invalid Lc");
+}
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include "tag_sim.h"
+
+#define RATS_CMD 0xE0
+#define RATS_FSDI_OFFSET 4
+#define CRC_LEN 2
+
+#define PCB_BLOCK_NUM BIT(0)
+#define PCB_CHAINING BIT(4)
+#define PCB_NAK BIT(4)
+#define PCB_I_BLOCK 0x02
+#define PCB_R_BLOCK 0xA2
+#define PCB_I_BLOCK_MASK 0xE2
+#define PCB_R_BLOCK_MASK 0xE6
+
+/* ATS with TA, TB and TC interface bytes present, FWI = 4 and DID supported. */
+#define ATS_LEN 5
+#define ATS_T0_INTERFACE_BYTES 0x70
+#define ATS_TA 0x00
+#define ATS_TB 0x40
+#define ATS_TC 0x02
+
+#define INS_SELECT 0xA4
+#define INS_READ 0xB0
+#define INS_UPDATE 0xD6
+#define SELECT_BY_NAME 0x0400
+#define SELECT_BY_FILE_ID 0x000C
+#define CC_FILE_ID 0xE103
+#define CC_FILE_LEN 15
+
+#define SW_OK 0x9000
+#define SW_WRONG_LENGTH 0x6700
+#define SW_NOT_FOUND 0x6A82
+#define SW_WRONG_PARAMS 0x6B00
+#define SW_INS_NOT_SUPPORTED 0x6D00
+
+#define CAPDU_HEADER_LEN 4
+#define CAPDU_MAX_LEN (TAG_SIM_NDEF_FILE_SIZE_MAX + 16)
+#define STATUS_LEN 2
+
+static const uint16_t fsd_map[] = {16, 24, 32, 40, 48, 64, 96, 128, 256,
+				   512, 1024, 2048, 4096};
+
+static struct {
+	struct tag_sim_cfg cfg;
+	struct tag_sim_stats stats;
+	size_t fsd;
+	uint8_t capdu[CAPDU_MAX_LEN];
+	size_t capdu_len;
+	uint8_t rapdu[TAG_SIM_NDEF_FILE_SIZE_MAX + STATUS_LEN];
+	size_t rapdu_len;
+	size_t rapdu_sent;
+	uint8_t cc[CC_FILE_LEN];
+	uint8_t ndef[TAG_SIM_NDEF_FILE_SIZE_MAX];
+	uint8_t *file;
+	size_t file_size;
+	int chained_cnt;
+	bool dropped;
+} tag;
+
+static void rapdu_status_set(uint16_t status)
+{
+	sys_put_be16(status, &tag.rapdu[tag.rapdu_len]);
+	tag.rapdu_len += STATUS_LEN;
+}
+
+static uint16_t select_process(uint16_t p1p2, const uint8_t *data, size_t lc)
+{
+	if (p1p2 == SELECT_BY_NAME) {
+		return SW_OK;
+	}
+
+	if ((p1p2 != SELECT_BY_FILE_ID) || (lc != sizeof(uint16_t))) {
+		return SW_WRONG_PARAMS;
+	}
+
+	switch (sys_get_be16(data)) {
+	case CC_FILE_ID:
+		tag.file = tag.cc;
+		tag.file_size = sizeof(tag.cc);
+		return SW_OK;
+
+	case TAG_SIM_NDEF_FILE_ID:
+		tag.file = tag.ndef;
+		tag.file_size = tag.cfg.ndef_file_size;
+		return SW_OK;
+
+	default:
+		return SW_NOT_FOUND;
+	}
+}
+
+static uint16_t read_process(uint16_t offset, uint32_t le)
+{
+	if (!tag.file) {
+		return SW_NOT_FOUND;
+	}
+
+	if (le > tag.cfg.mle) {
+		return SW_WRONG_LENGTH;
+	}
+
+	if ((offset + le) > tag.file_size) {
+		return SW_WRONG_PARAMS;
+	}
+
+	memcpy(tag.rapdu, &tag.file[offset], le);
+	tag.rapdu_len = le;
+
+	return SW_OK;
+}
+
+static uint16_t update_process(uint16_t offset, const uint8_t *data, size_t lc)
+{
+	if (tag.file != tag.ndef) {
+		return SW_NOT_FOUND;
+	}
+
+	if (lc > tag.cfg.mlc) {
+		return SW_WRONG_LENGTH;
+	}
+
+	if ((offset + lc) > tag.file_size) {
+		return SW_WRONG_PARAMS;
+	}
+
+	memcpy(&tag.file[offset], data, lc);
+
+	return SW_OK;
+}
+
+static void capdu_process(const uint8_t *apdu, size_t len)
+{
+	const uint8_t *body = &apdu[CAPDU_HEADER_LEN];
+	const uint8_t *data = NULL;
+	size_t body_len;
+	size_t lc = 0;
+	size_t rest;
+	uint32_t le = 0;
+	uint16_t status;
+
+	tag.rapdu_len = 0;
+	tag.stats.capdu_cnt++;
+
+	if (len < CAPDU_HEADER_LEN) {
+		rapdu_status_set(SW_WRONG_LENGTH);
+		return;
+	}
+
+	body_len = len - CAPDU_HEADER_LEN;
+
+	/* Decode Lc and Le fields, ISO/IEC 7816-4 5.1. */
+	if (body_len == 0) {
+		rest = 0;
+	} else if (body_len == 1) {
+		le = body[0] ? body[0] : 256;
+		rest = 0;
+	} else if ((body[0] == 0) && (body_len == 3)) {
+		tag.stats.capdu_extended_cnt++;
+		le = sys_get_be16(&body[1]);
+		le = le ? le : 65536;
+		rest = 0;
+	} else if (body[0] == 0) {
+		tag.stats.capdu_extended_cnt++;
+		lc = sys_get_be16(&body[1]);
+		data = &body[3];
+		rest = body_len - 3;
+		if (lc > rest) {
+			rapdu_status_set(SW_WRONG_LENGTH);
+			return;
+		}
+
+		rest -= lc;
+		if (rest == sizeof(uint16_t)) {
+			le = sys_get_be16(&data[lc]);
+			le = le ? le : 65536;
+			rest = 0;
+		}
+	} else {
+		lc = body[0];
+		data = &body[1];
+		rest = body_len - 1;
+		if (lc > rest) {
+			rapdu_status_set(SW_WRONG_LENGTH);
+			return;
+		}
+
+		rest -= lc;
+		if (rest == 1) {
+			le = data[lc] ? data[lc] : 256;
+			rest = 0;
+		}
+	}
+
+	if (rest != 0) {
+		rapdu_status_set(SW_WRONG_LENGTH);
+		return;
+	}
+
+	switch (apdu[1]) {
+	case INS_SELECT:
+		status = select_process(sys_get_be16(&apdu[2]), data, lc);
+		break;
+
+	case INS_READ:
+		status = read_process(sys_get_be16(&apdu[2]), le);
+		break;
+
+	case INS_UPDATE:
+		status = update_process(sys_get_be16(&apdu[2]), data, lc);
+		break;
+
+	default:
+		status = SW_INS_NOT_SUPPORTED;
+		break;
+	}
+
+	if (status != SW_OK) {
+		tag.rapdu_len = 0;
+	}
+
+	rapdu_status_set(status);
+}
+
+static size_t rapdu_chunk_send(uint8_t block_num, uint8_t *resp)
+{
+	size_t remaining = tag.rapdu_len - tag.rapdu_sent;
+	size_t chunk = MIN(remaining, tag.fsd - 1);
+
+	resp[0] = PCB_I_BLOCK | block_num;
+	if (chunk < remaining) {
+		resp[0] |= PCB_CHAINING;
+	}
+
+	memcpy(&resp[1], &tag.rapdu[tag.rapdu_sent], chunk);
+	tag.rapdu_sent += chunk;
+
+	return chunk + 1;
+}
+
+static size_t i_block_process(const uint8_t *frame, size_t len, uint8_t *resp)
+{
+	uint8_t pcb = frame[0];
+
+	tag.stats.i_block_cnt++;
+
+	if (pcb & PCB_CHAINING) {
+		/* Simulate a block lost on air. The Reader/Writer recovers with R(NAK). */
+		if (!tag.dropped && (tag.chained_cnt == tag.cfg.drop_i_block)) {
+			tag.dropped = true;
+			return 0;
+		}
+
+		tag.chained_cnt++;
+	}
+
+	if ((tag.capdu_len + len - 1) > sizeof(tag.capdu)) {
+		return 0;
+	}
+
+	memcpy(&tag.capdu[tag.capdu_len], &frame[1], len - 1);
+	tag.capdu_len += len - 1;
+
+	if (pcb & PCB_CHAINING) {
+		resp[0] = PCB_R_BLOCK | (pcb & PCB_BLOCK_NUM);
+		return 1;
+	}
+
+	capdu_process(tag.capdu, tag.capdu_len);
+
+	tag.capdu_len = 0;
+	tag.rapdu_sent = 0;
+
+	return rapdu_chunk_send(pcb & PCB_BLOCK_NUM, resp);
+}
+
+static size_t r_block_process(const uint8_t *frame, uint8_t *resp)
+{
+	uint8_t pcb = frame[0];
+
+	if (pcb & PCB_NAK) {
+		/* Acknowledge the previous block, so the current one is retransmitted. */
+		resp[0] = PCB_R_BLOCK | ((pcb & PCB_BLOCK_NUM) ^ PCB_BLOCK_NUM);
+		return 1;
+	}
+
+	if (tag.rapdu_sent < tag.rapdu_len) {
+		return rapdu_chunk_send(pcb & PCB_BLOCK_NUM, resp);
+	}
+
+	return 0;
+}
+
+void tag_sim_init(const struct tag_sim_cfg *cfg, const uint8_t *ndef, size_t ndef_len)
+{
+	__ASSERT_NO_MSG(cfg->ndef_file_size <= sizeof(tag.ndef));
+	__ASSERT_NO_MSG(ndef_len <= cfg->ndef_file_size);
+
+	memset(&tag, 0, sizeof(tag));
+
+	tag.cfg = *cfg;
+
+	memcpy(tag.ndef, ndef, ndef_len);
+
+	/* Capability Container with a single NDEF File Control TLV. */
+	sys_put_be16(CC_FILE_LEN, &tag.cc[0]);
+	tag.cc[2] = 0x20;
+	sys_put_be16(cfg->mle, &tag.cc[3]);
+	sys_put_be16(cfg->mlc, &tag.cc[5]);
+	tag.cc[7] = 0x04;
+	tag.cc[8] = 0x06;
+	sys_put_be16(TAG_SIM_NDEF_FILE_ID, &tag.cc[9]);
+	sys_put_be16(cfg->ndef_file_size, &tag.cc[11]);
+	tag.cc[13] = 0x00;
+	tag.cc[14] = 0x00;
+}
+
+size_t tag_sim_frame_process(const uint8_t *frame, size_t len, uint8_t *resp)
+{
+	if (len < 1) {
+		return 0;
+	}
+
+	if (frame[0] == RATS_CMD) {
+		uint8_t fsdi = frame[1] >> RATS_FSDI_OFFSET;
+
+		if ((len != 2) || (fsdi >= ARRAY_SIZE(fsd_map))) {
+			return 0;
+		}
+
+		tag.fsd = MIN(fsd_map[fsdi] - CRC_LEN, TAG_SIM_FRAME_MAX_LEN);
+
+		resp[0] = ATS_LEN;
+		resp[1] = ATS_T0_INTERFACE_BYTES | tag.cfg.fsci;
+		resp[2] = ATS_TA;
+		resp[3] = ATS_TB;
+		resp[4] = ATS_TC;
+
+		return ATS_LEN;
+	}
+
+	if ((frame[0] & PCB_I_BLOCK_MASK) == PCB_I_BLOCK) {
+		return i_block_process(frame, len, resp);
+	}
+
+	if ((frame[0] & PCB_R_BLOCK_MASK) == PCB_R_BLOCK) {
+		return r_block_process(frame, resp);
+	}
+
+	return 0;
+}
+
+const uint8_t *tag_sim_ndef_get(void)
+{
+	return tag.ndef;
+}
+
+const struct tag_sim_stats *tag_sim_stats_get(void)
+{
+	return &tag.stats;
+}
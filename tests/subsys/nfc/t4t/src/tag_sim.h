@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _TAG_SIM_H_
+#define _TAG_SIM_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** NDEF file identifier used by the simulated tag. */
+#define TAG_SIM_NDEF_FILE_ID 0xE104
+
+/** Maximum size of the NDEF file of the simulated tag. */
+#define TAG_SIM_NDEF_FILE_SIZE_MAX 2048
+
+/** Maximum length of a frame exchanged with the simulated tag. */
+#define TAG_SIM_FRAME_MAX_LEN 4096
+
+/** Simulated NFC Type 4 Tag configuration. */
+struct tag_sim_cfg {
+	/** FSCI announced in the ATS. */
+	uint8_t fsci;
+
+	/** MLe field of the Capability Container. */
+	uint16_t mle;
+
+	/** MLc field of the Capability Container. */
+	uint16_t mlc;
+
+	/** Maximum NDEF file size, including the NLEN field. */
+	uint16_t ndef_file_size;
+
+	/** Index of the I-block which is lost once, or a negative value. */
+	int drop_i_block;
+};
+
+/** Simulated NFC Type 4 Tag statistics. */
+struct tag_sim_stats {
+	/** Number of C-APDUs processed. */
+	uint32_t capdu_cnt;
+
+	/** Number of C-APDUs using the extended length format. */
+	uint32_t capdu_extended_cnt;
+
+	/** Number of I-blocks received. */
+	uint32_t i_block_cnt;
+};
+
+/** Initialize the simulated tag.
+ *
+ * @param cfg      Tag configuration.
+ * @param ndef     NDEF file content, including the NLEN field.
+ * @param ndef_len NDEF file content length.
+ */
+void tag_sim_init(const struct tag_sim_cfg *cfg, const uint8_t *ndef, size_t ndef_len);
+
+/** Process a frame sent by the Reader/Writer.
+ *
+ * @param frame Received frame.
+ * @param len   Received frame length.
+ * @param resp  Buffer for the response frame, at least @ref TAG_SIM_FRAME_MAX_LEN bytes.
+ *
+ * @return Response frame length. Zero if the tag does not respond.
+ */
+size_t tag_sim_frame_process(const uint8_t *frame, size_t len, uint8_t *resp);
+
+/** Get the NDEF file content of the simulated tag.
+ *
+ * @return Pointer to the NDEF file content, including the NLEN field.
+ */
+const uint8_t *tag_sim_ndef_get(void);
+
+/** Get the simulated tag statistics.
+ *
+ * @return Pointer to the statistics.
+ */
+const struct tag_sim_stats *tag_sim_stats_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TAG_SIM_H_ */
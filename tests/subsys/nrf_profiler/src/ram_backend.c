@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <nrf_profiler.h>
+
+#define DROPPED_EVENTS_NAME "_nrf_profiler_dropped_events_"
+#define EVENT_VALUE 0xBEEF
+#define OVERFLOW_EXTRA_EVENTS 9
+
+static uint16_t wide_event_id;
+static uint16_t dropped_events_id;
+static uint8_t rx_buf[CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE];
+
+static size_t decode_varint(const uint8_t *data, uint32_t *value)
+{
+	size_t len = 0;
+	uint8_t shift = 0;
+
+	*value = 0;
+	do {
+		*value |= (uint32_t)(data[len] & BIT_MASK(7)) << shift;
+		shift += 7;
+	} while (data[len++] & BIT(7));
+
+	return len;
+}
+
+static size_t decode_header(const uint8_t *data, uint16_t *event_id, int32_t *ts_diff)
+{
+	uint32_t value;
+	size_t len;
+
+	len = decode_varint(data, &value);
+	*event_id = value;
+	len += decode_varint(data + len, &value);
+	*ts_diff = (int32_t)((value >> 1) ^ -(value & 1));
+
+	return len;
+}
+
+static void drain(void)
+{
+	while (nrf_profiler_ram_backend_read(rx_buf, sizeof(rx_buf)) > 0) {
+	}
+}
+
+static void send_wide_event(struct log_event_buf *buf)
+{
+	nrf_profiler_log_encode_uint16(buf, EVENT_VALUE);
+	nrf_profiler_log_send(buf, wide_event_id);
+}
+
+static void *ram_backend_setup(void)
+{
+	static const char * const data_names[] = {"value"};
+	static const enum nrf_profiler_arg data_types[] = {NRF_PROFILER_ARG_U16};
+	char name[16];
+
+	zassert_ok(nrf_profiler_init(), "Error when initializing");
+
+	/* Fill the event type table so that the last ID does not fit in a byte.
+	 * The suite runs after suite_nrf_profiler, which registers its own events.
+	 */
+	while (nrf_profiler_num_events < NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS) {
+		snprintf(name, sizeof(name), "event %u", nrf_profiler_num_events);
+		wide_event_id = nrf_profiler_register_event_type(name, data_names, data_types, 1);
+	}
+	zassert_true(wide_event_id > UINT8_MAX, "Event ID does not exceed 8 bits");
+
+	for (size_t i = 0; i < nrf_profiler_num_events; i++) {
+		const char *descr = nrf_profiler_get_event_descr(i);
+
+		if (!strncmp(descr, DROPPED_EVENTS_NAME, strlen(DROPPED_EVENTS_NAME))) {
+			dropped_events_id = i;
+		}
+	}
+	zassert_equal(strncmp(nrf_profiler_get_event_descr(dropped_events_id),
+			      DROPPED_EVENTS_NAME, strlen(DROPPED_EVENTS_NAME)), 0,
+		      "Dropped events event type not registered");
+
+	return NULL;
+}
+
+static void ram_backend_before(void *fixture)
+{
+	drain();
+}
+
+ZTEST(suite_nrf_profiler_ram, test_wide_event_id)
+{
+	struct log_event_buf buf;
+	uint16_t event_id;
+	int32_t ts_diff;
+	size_t len;
+	size_t pos;
+
+	nrf_profiler_log_start(&buf);
+	send_wide_event(&buf);
+
+	len = nrf_profiler_ram_backend_read(rx_buf, sizeof(rx_buf));
+	pos = decode_header(rx_buf, &event_id, &ts_diff);
+
+	zassert_equal(event_id, wide_event_id, "Invalid event ID");
+	zassert_equal(len, pos + sizeof(uint16_t), "Invalid record length");
+	zassert_equal(sys_get_le16(&rx_buf[pos]), EVENT_VALUE, "Invalid payload");
+}
+
+ZTEST(suite_nrf_profiler_ram, test_timestamp_diff)
+{
+	struct log_event_buf first;
+	struct log_event_buf second;
+	uint16_t event_id;
+	int32_t ts_diff;
+	size_t pos;
+
+	nrf_profiler_log_start(&first);
+	k_busy_wait(100);
+	nrf_profiler_log_start(&second);
+
+	/* Sending in reverse order results in a negative difference. */
+	send_wide_event(&second);
+	send_wide_event(&first);
+
+	zassert_true(nrf_profiler_ram_backend_read(rx_buf, sizeof(rx_buf)) > 0, "No data");
+
+	pos = decode_header(rx_buf, &event_id, &ts_diff);
+	pos += sizeof(uint16_t);
+	pos += decode_header(&rx_buf[pos], &event_id, &ts_diff);
+
+	zassert_equal(ts_diff, (int32_t)(first.timestamp - second.timestamp),
+		      "Invalid timestamp difference");
+	zassert_true(ts_diff <= 0, "Timestamp difference should not be positive");
+}
+
+ZTEST(suite_nrf_profiler_ram, test_overflow_drops_events)
+{
+	struct log_event_buf buf;
+	uint32_t dropped_start = nrf_profiler_dropped_events_get();
+	uint32_t dropped;
+	uint16_t event_id;
+	int32_t ts_diff;
+	size_t pos;
+
+	/* Fill the buffer until the first event is dropped. */
+	for (size_t i = 0; i < sizeof(rx_buf); i++) {
+		nrf_profiler_log_start(&buf);
+		send_wide_event(&buf);
+
+		if (nrf_profiler_dropped_events_get() != dropped_start) {
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < OVERFLOW_EXTRA_EVENTS; i++) {
+		nrf_profiler_log_start(&buf);
+		send_wide_event(&buf);
+	}
+
+	dropped = nrf_profiler_dropped_events_get() - dropped_start;
+	zassert_equal(dropped, OVERFLOW_EXTRA_EVENTS + 1, "Invalid number of dropped events");
+
+	drain();
+
+	/* Drop count is reported ahead of the next event. */
+	nrf_profiler_log_start(&buf);
+	send_wide_event(&buf);
+
+	zassert_true(nrf_profiler_ram_backend_read(rx_buf, sizeof(rx_buf)) > 0, "No data");
+
+	pos = decode_header(rx_buf, &event_id, &ts_diff);
+	zassert_equal(event_id, dropped_events_id, "Dropped events not reported");
+	zassert_equal(sys_get_le32(&rx_buf[pos]), dropped, "Invalid dropped events count");
+	pos += sizeof(uint32_t);
+
+	decode_header(&rx_buf[pos], &event_id, &ts_diff);
+	zassert_equal(event_id, wide_event_id, "Event not sent after the report");
+}
+
+ZTEST_SUITE(suite_nrf_profiler_ram, NULL, ram_backend_setup, ram_backend_before, NULL, NULL);